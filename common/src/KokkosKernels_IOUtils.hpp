@@ -24,6 +24,7 @@
 #include <unordered_set>
 #include <stdexcept>
 #include <type_traits>
+#include <cstdint>
 #ifndef _KOKKOSKERNELSIOUTILS_HPP
 #define _KOKKOSKERNELSIOUTILS_HPP
 
@@ -32,6 +33,11 @@
 #include "Kokkos_Random.hpp"
 #include "KokkosKernels_SimpleUtils.hpp"
 #include <sys/stat.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 namespace KokkosKernels {
 
@@ -97,6 +103,86 @@ inline size_t kk_get_file_size(const char *file) {
   return retval == 0 ? size_t(stat_buf.st_size) : size_t(0);
 }
 
+// Last modification time of a file, in seconds since the epoch. 0 if the file
+// does not exist.
+inline int64_t kk_get_file_mtime(const char *file) {
+#ifdef _WIN32
+  struct _stat stat_buf;
+  int retval = _stat(file, &stat_buf);
+#else
+  struct stat stat_buf;
+  int retval = stat(file, &stat_buf);
+#endif
+
+  return retval == 0 ? int64_t(stat_buf.st_mtime) : int64_t(0);
+}
+
+/// \brief The whole content of a file, memory-mapped where mmap is
+/// available (and read into memory otherwise).
+///
+/// Pages of a mapped file are loaded on first access, so threads working on
+/// different parts of the file read it in parallel. With \c copyOnWrite the
+/// data may be modified in memory; the changes are never written back.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &filename, bool copyOnWrite = false)
+      : data_(nullptr), size_(0), mapped_(false) {
+#ifndef _WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open file " + filename);
+    struct stat stat_buf;
+    if (fstat(fd, &stat_buf) != 0) {
+      close(fd);
+      throw std::runtime_error("Cannot stat file " + filename);
+    }
+    size_ = size_t(stat_buf.st_size);
+    if (size_) {
+      int prot   = copyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ;
+      void *addr = mmap(nullptr, size_, prot, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        data_   = static_cast<char *>(addr);
+        mapped_ = true;
+      }
+    }
+    close(fd);
+    if (size_ && !mapped_) readAll(filename);
+#else
+    (void)copyOnWrite;
+    size_ = kk_get_file_size(filename.c_str());
+    readAll(filename);
+#endif
+  }
+
+  ~MappedFile() {
+#ifndef _WIN32
+    if (mapped_) munmap(data_, size_);
+#endif
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  char *data() const { return data_; }
+  size_t size() const { return size_; }
+  bool isMapped() const { return mapped_; }
+
+ private:
+  void readAll(const std::string &filename) {
+    std::ifstream is(filename, std::ios::in | std::ios::binary);
+    if (!is.is_open()) throw std::runtime_error("Cannot open file " + filename);
+    buffer_.resize(size_);
+    is.read(buffer_.data(), size_);
+    if (size_t(is.gcount()) != size_)
+      throw std::runtime_error("Cannot read file " + filename);
+    data_ = buffer_.data();
+  }
+
+  char *data_;
+  size_t size_;
+  bool mapped_;
+  std::vector<char> buffer_;
+};
+
 template <typename lno_t>
 void buildEdgeListFromBinSrcTarg_undirected(const char *fnameSrc,
                                             const char *fnameTarg,
@@ -19,8 +19,12 @@
 
 #include "Kokkos_Core.hpp"
 #include "KokkosKernels_Utils.hpp"
+#include "KokkosKernels_SimpleUtils.hpp"
+#include "KokkosKernels_Sorting.hpp"
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <utility>
 
 namespace KokkosGraph {
 namespace Experimental {
@@ -117,6 +121,817 @@ struct SerialRCM {
   }
 };
 
+// Level-synchronous parallel reverse Cuthill-McKee.
+//
+// Each connected component is numbered by a BFS from a pseudo-peripheral
+// vertex (George-Liu search). The vertices of level L+1 are numbered in the
+// same order as the serial algorithm: grouped by the first vertex of level L
+// (in Cuthill-McKee order) that reaches them, and by increasing degree inside
+// each group. One level costs a fixed number of kernels:
+//   - every unnumbered neighbor of level L records its lowest-numbered
+//     parent with an atomic min,
+//   - each parent counts the children it owns, a prefix sum over the
+//     parents gives each group its slot in level L+1,
+//   - each parent writes its children to its slot and radix-sorts them by
+//     degree.
+// Vertices without neighbors are numbered last (first in the reversed
+// ordering) without running a BFS for each of them.
+template <typename device_t, typename rowmap_t, typename entries_t,
+          typename lno_view_t>
+struct ParallelRCM {
+  using exec_space   = typename device_t::execution_space;
+  using mem_space    = typename device_t::memory_space;
+  using size_type    = typename rowmap_t::non_const_value_type;
+  using lno_t        = typename entries_t::non_const_value_type;
+  using key_t        = typename std::make_unsigned<lno_t>::type;
+  using work_view_t  = Kokkos::View<lno_t*, mem_space>;
+  using key_view_t   = Kokkos::View<key_t*, mem_space>;
+  using count_view_t = Kokkos::View<lno_t, mem_space>;
+  using range_pol    = Kokkos::RangePolicy<exec_space>;
+
+  static constexpr lno_t NO_PARENT = Kokkos::ArithTraits<lno_t>::max();
+
+  rowmap_t rowmap;
+  entries_t entries;
+  lno_t numVerts;
+  // Cuthill-McKee position of each vertex, -1 if not numbered yet
+  lno_view_t label;
+  // Vertex at each Cuthill-McKee position
+  work_view_t order;
+  work_view_t orderAux;
+  // Lowest position of a parent in the current level
+  work_view_t parent;
+  // Number of children of each parent, then their offset in the next level
+  work_view_t childOffsets;
+  key_view_t keys;
+  key_view_t keysAux;
+  // Scratch space of the pseudo-peripheral search
+  work_view_t bfsLevel;
+  work_view_t bfsQueue;
+  count_view_t bfsTail;
+  // All vertices before this one are numbered
+  lno_t searchCursor;
+
+  ParallelRCM(const rowmap_t& rowmap_, const entries_t& entries_)
+      : rowmap(rowmap_),
+        entries(entries_),
+        numVerts(rowmap_.extent(0) - 1),
+        searchCursor(0) {
+    label = lno_view_t(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "RCM Permutation"),
+        numVerts);
+    order = work_view_t(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "CM Order"), numVerts);
+    orderAux = work_view_t(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "CM Order Aux"),
+        numVerts);
+    parent = work_view_t(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "Parent"), numVerts);
+    childOffsets = work_view_t(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "Child Offsets"),
+        numVerts);
+    keys = key_view_t(Kokkos::view_alloc(Kokkos::WithoutInitializing, "Keys"),
+                      numVerts);
+    keysAux = key_view_t(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "Keys Aux"), numVerts);
+    bfsLevel = work_view_t(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "BFS Level"),
+        numVerts);
+    bfsQueue = work_view_t(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "BFS Queue"),
+        numVerts);
+    bfsTail = count_view_t("BFS Tail");
+    Kokkos::deep_copy(parent, NO_PARENT);
+    Kokkos::deep_copy(bfsLevel, lno_t(-1));
+  }
+
+  // Number vertices without neighbors last, all other vertices -1.
+  // Self-loops and out-of-range column indices are ignored, as in SerialRCM.
+  struct NumberIsolated {
+    NumberIsolated(const rowmap_t& rowmap_, const entries_t& entries_,
+                   const lno_view_t& label_, lno_t firstLabel_)
+        : rowmap(rowmap_),
+          entries(entries_),
+          label(label_),
+          numVerts(rowmap_.extent(0) - 1),
+          firstLabel(firstLabel_) {}
+
+    KOKKOS_INLINE_FUNCTION bool isolated(lno_t v) const {
+      for (size_type j = rowmap(v); j < rowmap(v + 1); j++) {
+        lno_t nei = entries(j);
+        if (nei != v && nei >= 0 && nei < numVerts) return false;
+      }
+      return true;
+    }
+
+    // Count
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t v, lno_t& lcount) const {
+      if (isolated(v)) lcount++;
+    }
+
+    // Number
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t v, lno_t& lcount,
+                                           bool finalPass) const {
+      bool iso = isolated(v);
+      if (finalPass) label(v) = iso ? firstLabel + lcount : lno_t(-1);
+      if (iso) lcount++;
+    }
+
+    rowmap_t rowmap;
+    entries_t entries;
+    lno_view_t label;
+    lno_t numVerts;
+    lno_t firstLabel;
+  };
+
+  // Encode (degree, vertex) so that a min-reduction picks the lowest-degree
+  // vertex and breaks ties by ID, independently of the thread schedule
+  struct MinDegreeVertex {
+    MinDegreeVertex(const rowmap_t& rowmap_, const work_view_t& candidates_,
+                    const lno_view_t& label_, bool unlabeledOnly_,
+                    lno_t numVerts_)
+        : rowmap(rowmap_),
+          candidates(candidates_),
+          label(label_),
+          unlabeledOnly(unlabeledOnly_),
+          numVerts(numVerts_) {}
+
+    // i is a vertex if candidates is empty, otherwise an index in candidates
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i, int64_t& lmin) const {
+      lno_t v = candidates.extent(0) ? candidates(i) : i;
+      if (unlabeledOnly && label(v) != -1) return;
+      int64_t key = int64_t(rowmap(v + 1) - rowmap(v)) * numVerts + v;
+      if (key < lmin) lmin = key;
+    }
+
+    rowmap_t rowmap;
+    work_view_t candidates;
+    lno_view_t label;
+    bool unlabeledOnly;
+    lno_t numVerts;
+  };
+
+  struct FirstUnlabeled {
+    FirstUnlabeled(const lno_view_t& label_, lno_t numVerts_)
+        : label(label_), numVerts(numVerts_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t v, lno_t& lmin) const {
+      if (label(v) == -1 && v < lmin) lmin = v;
+    }
+
+    lno_view_t label;
+    lno_t numVerts;
+  };
+
+  // Expand one BFS level of the pseudo-peripheral search
+  struct BFSExpand {
+    BFSExpand(const rowmap_t& rowmap_, const entries_t& entries_,
+              const work_view_t& level_, const work_view_t& queue_,
+              const count_view_t& tail_, lno_t depth_)
+        : rowmap(rowmap_),
+          entries(entries_),
+          level(level_),
+          queue(queue_),
+          tail(tail_),
+          numVerts(rowmap_.extent(0) - 1),
+          depth(depth_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const {
+      lno_t v = queue(i);
+      for (size_type j = rowmap(v); j < rowmap(v + 1); j++) {
+        lno_t nei = entries(j);
+        if (nei == v || nei < 0 || nei >= numVerts) continue;
+        if (level(nei) != -1) continue;
+        if (Kokkos::atomic_compare_exchange(&level(nei), lno_t(-1),
+                                            lno_t(depth + 1)) == -1) {
+          queue(Kokkos::atomic_fetch_add(&tail(), lno_t(1))) = nei;
+        }
+      }
+    }
+
+    rowmap_t rowmap;
+    entries_t entries;
+    work_view_t level;
+    work_view_t queue;
+    count_view_t tail;
+    lno_t numVerts;
+    lno_t depth;
+  };
+
+  struct BFSReset {
+    BFSReset(const work_view_t& level_, const work_view_t& queue_)
+        : level(level_), queue(queue_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const {
+      level(queue(i)) = -1;
+    }
+
+    work_view_t level;
+    work_view_t queue;
+  };
+
+  // Each unnumbered neighbor of the current level records its parent
+  // with the lowest Cuthill-McKee position
+  struct ClaimChildren {
+    ClaimChildren(const rowmap_t& rowmap_, const entries_t& entries_,
+                  const lno_view_t& label_, const work_view_t& order_,
+                  const work_view_t& parent_)
+        : rowmap(rowmap_),
+          entries(entries_),
+          label(label_),
+          order(order_),
+          parent(parent_),
+          numVerts(rowmap_.extent(0) - 1) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const {
+      lno_t v = order(i);
+      for (size_type j = rowmap(v); j < rowmap(v + 1); j++) {
+        lno_t nei = entries(j);
+        if (nei == v || nei < 0 || nei >= numVerts) continue;
+        if (label(nei) == -1) Kokkos::atomic_min(&parent(nei), i);
+      }
+    }
+
+    rowmap_t rowmap;
+    entries_t entries;
+    lno_view_t label;
+    work_view_t order;
+    work_view_t parent;
+    lno_t numVerts;
+  };
+
+  // Count (then place and sort) the children owned by each parent
+  struct PlaceChildren {
+    PlaceChildren(const rowmap_t& rowmap_, const entries_t& entries_,
+                  const lno_view_t& label_, const work_view_t& order_,
+                  const work_view_t& orderAux_, const work_view_t& parent_,
+                  const work_view_t& childOffsets_, const key_view_t& keys_,
+                  const key_view_t& keysAux_, lno_t levelEnd_)
+        : rowmap(rowmap_),
+          entries(entries_),
+          label(label_),
+          order(order_),
+          orderAux(orderAux_),
+          parent(parent_),
+          childOffsets(childOffsets_),
+          keys(keys_),
+          keysAux(keysAux_),
+          numVerts(rowmap_.extent(0) - 1),
+          levelEnd(levelEnd_) {}
+
+    struct CountTag {};
+    struct FillTag {};
+
+    KOKKOS_INLINE_FUNCTION bool owns(lno_t i, lno_t v, lno_t nei) const {
+      return nei != v && nei >= 0 && nei < numVerts && label(nei) == -1 &&
+             parent(nei) == i;
+    }
+
+    KOKKOS_INLINE_FUNCTION void operator()(const CountTag&, lno_t i) const {
+      lno_t v     = order(i);
+      lno_t count = 0;
+      for (size_type j = rowmap(v); j < rowmap(v + 1); j++) {
+        if (owns(i, v, entries(j))) count++;
+      }
+      childOffsets(i) = count;
+    }
+
+    KOKKOS_INLINE_FUNCTION void operator()(const FillTag&, lno_t i) const {
+      lno_t v     = order(i);
+      lno_t begin = levelEnd + childOffsets(i);
+      lno_t count = 0;
+      for (size_type j = rowmap(v); j < rowmap(v + 1); j++) {
+        lno_t nei = entries(j);
+        if (!owns(i, v, nei)) continue;
+        order(begin + count) = nei;
+        keys(begin + count)  = key_t(rowmap(nei + 1) - rowmap(nei));
+        count++;
+      }
+      // Stable sort by increasing degree
+      if (count > 1) {
+        KokkosKernels::SerialRadixSort2<lno_t, key_t, lno_t>(
+            &keys(begin), &keysAux(begin), &order(begin), &orderAux(begin),
+            count);
+      }
+    }
+
+    rowmap_t rowmap;
+    entries_t entries;
+    lno_view_t label;
+    work_view_t order;
+    work_view_t orderAux;
+    work_view_t parent;
+    work_view_t childOffsets;
+    key_view_t keys;
+    key_view_t keysAux;
+    lno_t numVerts;
+    lno_t levelEnd;
+  };
+
+  struct NumberLevel {
+    NumberLevel(const lno_view_t& label_, const work_view_t& order_)
+        : label(label_), order(order_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const {
+      label(order(i)) = i;
+    }
+
+    lno_view_t label;
+    work_view_t order;
+  };
+
+  struct ReverseLabels {
+    ReverseLabels(const lno_view_t& label_, lno_t numVerts_)
+        : label(label_), numVerts(numVerts_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t v) const {
+      label(v) = numVerts - label(v) - 1;
+    }
+
+    lno_view_t label;
+    lno_t numVerts;
+  };
+
+  // Vertex with the lowest (degree, ID) among candidates[begin, end)
+  lno_t minDegreeVertex(const work_view_t& candidates, lno_t begin,
+                        lno_t end) {
+    int64_t key = Kokkos::ArithTraits<int64_t>::max();
+    Kokkos::parallel_reduce(
+        "KokkosGraph::RCM::MinDegreeVertex", range_pol(begin, end),
+        MinDegreeVertex(rowmap, candidates, label, candidates.extent(0) == 0,
+                        numVerts),
+        Kokkos::Min<int64_t>(key));
+    return key % numVerts;
+  }
+
+  // Lowest-numbered vertex that is not numbered yet, numVerts if none.
+  // Scans blocks of growing size from searchCursor, so that finding all
+  // components costs O(numVerts) overall.
+  lno_t firstUnlabeled() {
+    lno_t blockSize = 1024;
+    while (searchCursor < numVerts) {
+      lno_t blockEnd = (numVerts - searchCursor > blockSize)
+                           ? searchCursor + blockSize
+                           : numVerts;
+      lno_t found    = numVerts;
+      Kokkos::parallel_reduce("KokkosGraph::RCM::FirstUnlabeled",
+                              range_pol(searchCursor, blockEnd),
+                              FirstUnlabeled(label, numVerts),
+                              Kokkos::Min<lno_t>(found));
+      if (found < numVerts) {
+        searchCursor = found;
+        return found;
+      }
+      searchCursor = blockEnd;
+      if (blockSize < numVerts / 2) blockSize *= 2;
+    }
+    return numVerts;
+  }
+
+  // BFS from root over the (unnumbered) component of root. Returns the
+  // eccentricity of root; bfsQueue[lastBegin, lastEnd) is the last level.
+  lno_t bfs(lno_t root, lno_t& lastBegin, lno_t& lastEnd) {
+    Kokkos::deep_copy(Kokkos::subview(bfsLevel, root), lno_t(0));
+    Kokkos::deep_copy(Kokkos::subview(bfsQueue, 0), root);
+    Kokkos::deep_copy(bfsTail, lno_t(1));
+    lno_t begin = 0, end = 1, depth = 0;
+    while (true) {
+      Kokkos::parallel_for(
+          "KokkosGraph::RCM::BFSExpand", range_pol(begin, end),
+          BFSExpand(rowmap, entries, bfsLevel, bfsQueue, bfsTail, depth));
+      lno_t tail;
+      Kokkos::deep_copy(tail, bfsTail);
+      if (tail == end) break;
+      begin = end;
+      end   = tail;
+      depth++;
+    }
+    lastBegin = begin;
+    lastEnd   = end;
+    // Reset the levels of the visited vertices for the next search
+    Kokkos::parallel_for("KokkosGraph::RCM::BFSReset", range_pol(0, end),
+                         BFSReset(bfsLevel, bfsQueue));
+    return depth;
+  }
+
+  // George-Liu: restart the BFS from a lowest-degree vertex of the last
+  // level for as long as this increases the eccentricity.
+  lno_t findPseudoPeripheral(lno_t seed) {
+    lno_t lastBegin, lastEnd;
+    lno_t root = seed;
+    lno_t ecc  = bfs(root, lastBegin, lastEnd);
+    while (true) {
+      lno_t candidate = minDegreeVertex(bfsQueue, lastBegin, lastEnd);
+      if (candidate == root) break;
+      lno_t candBegin, candEnd;
+      lno_t candEcc = bfs(candidate, candBegin, candEnd);
+      if (candEcc <= ecc) break;
+      root      = candidate;
+      ecc       = candEcc;
+      lastBegin = candBegin;
+      lastEnd   = candEnd;
+    }
+    return root;
+  }
+
+  // Number the component of root in Cuthill-McKee order, starting at
+  // position first. Returns the position after the component.
+  lno_t cuthillMcKee(lno_t root, lno_t first) {
+    Kokkos::deep_copy(Kokkos::subview(order, first), root);
+    Kokkos::deep_copy(Kokkos::subview(label, root), first);
+    lno_t levelBegin = first;
+    lno_t levelEnd   = first + 1;
+    while (levelEnd > levelBegin) {
+      Kokkos::parallel_for(
+          "KokkosGraph::RCM::ClaimChildren", range_pol(levelBegin, levelEnd),
+          ClaimChildren(rowmap, entries, label, order, parent));
+      PlaceChildren place(rowmap, entries, label, order, orderAux, parent,
+                          childOffsets, keys, keysAux, levelEnd);
+      using count_pol = Kokkos::RangePolicy<
+          exec_space, typename PlaceChildren::CountTag>;
+      using fill_pol =
+          Kokkos::RangePolicy<exec_space, typename PlaceChildren::FillTag>;
+      Kokkos::parallel_for("KokkosGraph::RCM::CountChildren",
+                           count_pol(levelBegin, levelEnd), place);
+      auto levelOffsets = Kokkos::subview(
+          childOffsets, Kokkos::make_pair(levelBegin, levelEnd));
+      lno_t numChildren = 0;
+      KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<
+          decltype(levelOffsets), exec_space>(levelEnd - levelBegin,
+                                              levelOffsets, numChildren);
+      if (numChildren == 0) break;
+      Kokkos::parallel_for("KokkosGraph::RCM::FillChildren",
+                           fill_pol(levelBegin, levelEnd), place);
+      Kokkos::parallel_for("KokkosGraph::RCM::NumberLevel",
+                           range_pol(levelEnd, levelEnd + numChildren),
+                           NumberLevel(label, order));
+      levelBegin = levelEnd;
+      levelEnd += numChildren;
+    }
+    return levelEnd;
+  }
+
+  lno_view_t rcm() {
+    lno_t numIsolated = 0;
+    Kokkos::parallel_reduce(
+        "KokkosGraph::RCM::CountIsolated", range_pol(0, numVerts),
+        NumberIsolated(rowmap, entries, label, 0), numIsolated);
+    lno_t numConnected = numVerts - numIsolated;
+    Kokkos::parallel_scan(
+        "KokkosGraph::RCM::NumberIsolated", range_pol(0, numVerts),
+        NumberIsolated(rowmap, entries, label, numConnected));
+    lno_t numbered = 0;
+    if (numConnected) {
+      // Like SerialRCM, start the first component from a vertex of lowest
+      // degree, the others from their lowest-numbered vertex
+      lno_t seed = minDegreeVertex(work_view_t(), 0, numVerts);
+      while (true) {
+        numbered = cuthillMcKee(findPseudoPeripheral(seed), numbered);
+        if (numbered >= numConnected) break;
+        seed = firstUnlabeled();
+      }
+    }
+    Kokkos::parallel_for("KokkosGraph::RCM::Reverse", range_pol(0, numVerts),
+                         ReverseLabels(label, numVerts));
+    return label;
+  }
+};
+
+// Direction-optimizing BFS from one source (Beamer, Asanovic, Patterson).
+//
+// A top-down step expands the frontier queue, claiming each unvisited
+// neighbor with a compare-and-swap on its level. A bottom-up step scans the
+// unvisited vertices instead, each looking for a neighbor in the frontier
+// and stopping at the first one; it wins once the frontier touches a large
+// share of the remaining edges. Both steps append the next frontier to a
+// queue and sum its degrees, which drives the switch:
+//   - bottom-up when the frontier has more than 1/alpha of the unvisited
+//     edges,
+//   - back to top-down when it has fewer than 1/beta of the vertices.
+template <typename device_t, typename rowmap_t, typename entries_t,
+          typename levels_t, typename parents_t>
+struct DirectionOptimizingBFS {
+  using exec_space   = typename device_t::execution_space;
+  using mem_space    = typename device_t::memory_space;
+  using size_type    = typename rowmap_t::non_const_value_type;
+  using lno_t        = typename entries_t::non_const_value_type;
+  using work_view_t  = Kokkos::View<lno_t*, mem_space>;
+  using count_view_t = Kokkos::View<lno_t, mem_space>;
+  using range_pol    = Kokkos::RangePolicy<exec_space>;
+
+  static constexpr size_type alpha = 14;
+  static constexpr lno_t beta      = 24;
+
+  rowmap_t rowmap;
+  entries_t entries;
+  lno_t numVerts;
+  levels_t levels;
+  parents_t parents;
+  work_view_t queue;
+  work_view_t nextQueue;
+  count_view_t tail;
+
+  DirectionOptimizingBFS(const rowmap_t& rowmap_, const entries_t& entries_,
+                         const levels_t& levels_, const parents_t& parents_)
+      : rowmap(rowmap_),
+        entries(entries_),
+        numVerts(rowmap_.extent(0) - 1),
+        levels(levels_),
+        parents(parents_) {
+    queue = work_view_t(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "BFS Queue"),
+        numVerts);
+    nextQueue = work_view_t(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "BFS Next Queue"),
+        numVerts);
+    tail = count_view_t("BFS Tail");
+  }
+
+  struct Init {
+    Init(const levels_t& levels_, const parents_t& parents_,
+         const work_view_t& queue_, lno_t source_)
+        : levels(levels_), parents(parents_), queue(queue_), source(source_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t v) const {
+      levels(v) = v == source ? 0 : -1;
+      if (parents.extent(0)) parents(v) = v == source ? source : lno_t(-1);
+      if (v == source) queue(0) = source;
+    }
+
+    levels_t levels;
+    parents_t parents;
+    work_view_t queue;
+    lno_t source;
+  };
+
+  // Expand queue[i], summing the degrees of the claimed vertices
+  struct TopDown {
+    TopDown(const DirectionOptimizingBFS& bfs, lno_t depth_)
+        : rowmap(bfs.rowmap),
+          entries(bfs.entries),
+          levels(bfs.levels),
+          parents(bfs.parents),
+          queue(bfs.queue),
+          nextQueue(bfs.nextQueue),
+          tail(bfs.tail),
+          numVerts(bfs.numVerts),
+          depth(depth_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i, size_type& edges) const {
+      lno_t v = queue(i);
+      for (size_type j = rowmap(v); j < rowmap(v + 1); j++) {
+        lno_t nei = entries(j);
+        if (nei == v || nei < 0 || nei >= numVerts) continue;
+        if (levels(nei) != -1) continue;
+        if (Kokkos::atomic_compare_exchange(&levels(nei), lno_t(-1),
+                                            lno_t(depth + 1)) == -1) {
+          if (parents.extent(0)) parents(nei) = v;
+          nextQueue(Kokkos::atomic_fetch_add(&tail(), lno_t(1))) = nei;
+          edges += rowmap(nei + 1) - rowmap(nei);
+        }
+      }
+    }
+
+    rowmap_t rowmap;
+    entries_t entries;
+    levels_t levels;
+    parents_t parents;
+    work_view_t queue;
+    work_view_t nextQueue;
+    count_view_t tail;
+    lno_t numVerts;
+    lno_t depth;
+  };
+
+  // An unvisited vertex joins the next level through its first neighbor in
+  // the current one. Only v writes levels(v), and the new level is not the
+  // one being searched for, so the scan needs no atomics on the levels.
+  struct BottomUp {
+    BottomUp(const DirectionOptimizingBFS& bfs, lno_t depth_)
+        : rowmap(bfs.rowmap),
+          entries(bfs.entries),
+          levels(bfs.levels),
+          parents(bfs.parents),
+          nextQueue(bfs.nextQueue),
+          tail(bfs.tail),
+          numVerts(bfs.numVerts),
+          depth(depth_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t v, size_type& edges) const {
+      if (levels(v) != -1) return;
+      for (size_type j = rowmap(v); j < rowmap(v + 1); j++) {
+        lno_t nei = entries(j);
+        if (nei == v || nei < 0 || nei >= numVerts) continue;
+        if (levels(nei) != depth) continue;
+        levels(v) = depth + 1;
+        if (parents.extent(0)) parents(v) = nei;
+        nextQueue(Kokkos::atomic_fetch_add(&tail(), lno_t(1))) = v;
+        edges += rowmap(v + 1) - rowmap(v);
+        return;
+      }
+    }
+
+    rowmap_t rowmap;
+    entries_t entries;
+    levels_t levels;
+    parents_t parents;
+    work_view_t nextQueue;
+    count_view_t tail;
+    lno_t numVerts;
+    lno_t depth;
+  };
+
+  // Returns the number of levels, the eccentricity of source plus one
+  lno_t run(lno_t source) {
+    Kokkos::parallel_for("KokkosGraph::BFS::Init", range_pol(0, numVerts),
+                         Init(levels, parents, queue, source));
+    // Degree of the source, and number of edges of the graph
+    size_type srcBounds[2], allBounds[2];
+    Kokkos::deep_copy(
+        Kokkos::View<size_type*, Kokkos::HostSpace>(srcBounds, 2),
+        Kokkos::subview(rowmap, Kokkos::make_pair(source, source + 2)));
+    Kokkos::deep_copy(
+        Kokkos::View<size_type*, Kokkos::HostSpace>(allBounds, 1),
+        Kokkos::subview(rowmap, Kokkos::make_pair(0, 1)));
+    Kokkos::deep_copy(
+        Kokkos::View<size_type*, Kokkos::HostSpace>(allBounds + 1, 1),
+        Kokkos::subview(rowmap, Kokkos::make_pair(numVerts, numVerts + 1)));
+    size_type unvisitedEdges = allBounds[1] - allBounds[0];
+    size_type frontierEdges  = srcBounds[1] - srcBounds[0];
+    lno_t frontierSize       = 1;
+    lno_t depth              = 0;
+    bool bottomUp            = false;
+    while (frontierSize) {
+      unvisitedEdges -= frontierEdges;
+      if (!bottomUp && frontierEdges > unvisitedEdges / alpha)
+        bottomUp = true;
+      else if (bottomUp && frontierSize < numVerts / beta)
+        bottomUp = false;
+      Kokkos::deep_copy(tail, lno_t(0));
+      size_type nextEdges = 0;
+      if (bottomUp)
+        Kokkos::parallel_reduce("KokkosGraph::BFS::BottomUp",
+                                range_pol(0, numVerts), BottomUp(*this, depth),
+                                nextEdges);
+      else
+        Kokkos::parallel_reduce("KokkosGraph::BFS::TopDown",
+                                range_pol(0, frontierSize),
+                                TopDown(*this, depth), nextEdges);
+      Kokkos::deep_copy(frontierSize, tail);
+      std::swap(queue, nextQueue);
+      frontierEdges = nextEdges;
+      depth++;
+    }
+    return depth;
+  }
+};
+
+// Batched BFS from many sources, 64 at a time (Then et al., MS-BFS). Each
+// vertex keeps one bit per source of the batch for the sources that have
+// reached it and for those in the current frontier, so a single pass over
+// the vertices advances all the searches of the batch by one level.
+template <typename device_t, typename rowmap_t, typename entries_t,
+          typename sources_t, typename levels_t>
+struct MultiSourceBFS {
+  using exec_space  = typename device_t::execution_space;
+  using mem_space   = typename device_t::memory_space;
+  using size_type   = typename rowmap_t::non_const_value_type;
+  using lno_t       = typename entries_t::non_const_value_type;
+  using word_t      = uint64_t;
+  using word_view_t = Kokkos::View<word_t*, mem_space>;
+  using range_pol   = Kokkos::RangePolicy<exec_space>;
+
+  static constexpr lno_t batchSize = 8 * sizeof(word_t);
+
+  rowmap_t rowmap;
+  entries_t entries;
+  lno_t numVerts;
+  sources_t sources;
+  levels_t levels;
+  // Sources that have reached each vertex
+  word_view_t seen;
+  // Sources for which each vertex is in the frontier
+  word_view_t frontier;
+  word_view_t nextFrontier;
+
+  MultiSourceBFS(const rowmap_t& rowmap_, const entries_t& entries_,
+                 const sources_t& sources_, const levels_t& levels_)
+      : rowmap(rowmap_),
+        entries(entries_),
+        numVerts(rowmap_.extent(0) - 1),
+        sources(sources_),
+        levels(levels_) {
+    seen     = word_view_t("MS-BFS Seen", numVerts);
+    frontier = word_view_t("MS-BFS Frontier", numVerts);
+    nextFrontier = word_view_t(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "MS-BFS Next"),
+        numVerts);
+  }
+
+  struct InitBatch {
+    InitBatch(const MultiSourceBFS& bfs, lno_t batchBegin_)
+        : sources(bfs.sources),
+          levels(bfs.levels),
+          seen(bfs.seen),
+          frontier(bfs.frontier),
+          batchBegin(batchBegin_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const {
+      lno_t s    = sources(batchBegin + i);
+      word_t bit = word_t(1) << i;
+      Kokkos::atomic_fetch_or(&seen(s), bit);
+      Kokkos::atomic_fetch_or(&frontier(s), bit);
+      levels(s, batchBegin + i) = 0;
+    }
+
+    sources_t sources;
+    levels_t levels;
+    word_view_t seen;
+    word_view_t frontier;
+    lno_t batchBegin;
+  };
+
+  // Pull the frontier bits of the neighbors; the new ones give the level of
+  // v for their sources. Counts the vertices that got a new source.
+  struct Expand {
+    Expand(const MultiSourceBFS& bfs, lno_t batchBegin_, lno_t batchLen_,
+           lno_t depth_)
+        : rowmap(bfs.rowmap),
+          entries(bfs.entries),
+          levels(bfs.levels),
+          seen(bfs.seen),
+          frontier(bfs.frontier),
+          nextFrontier(bfs.nextFrontier),
+          numVerts(bfs.numVerts),
+          batchBegin(batchBegin_),
+          batchLen(batchLen_),
+          depth(depth_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t v, lno_t& changed) const {
+      word_t reach = 0;
+      word_t known = seen(v);
+      if (~known) {
+        for (size_type j = rowmap(v); j < rowmap(v + 1); j++) {
+          lno_t nei = entries(j);
+          if (nei == v || nei < 0 || nei >= numVerts) continue;
+          reach |= frontier(nei);
+        }
+        reach &= ~known;
+      }
+      nextFrontier(v) = reach;
+      if (!reach) return;
+      seen(v) = known | reach;
+      for (lno_t b = 0; b < batchLen; b++) {
+        if ((reach >> b) & 1) levels(v, batchBegin + b) = depth + 1;
+      }
+      changed++;
+    }
+
+    rowmap_t rowmap;
+    entries_t entries;
+    levels_t levels;
+    word_view_t seen;
+    word_view_t frontier;
+    word_view_t nextFrontier;
+    lno_t numVerts;
+    lno_t batchBegin;
+    lno_t batchLen;
+    lno_t depth;
+  };
+
+  // Returns the largest number of levels over all the sources
+  lno_t run() {
+    const lno_t numSources = sources.extent(0);
+    Kokkos::deep_copy(levels, lno_t(-1));
+    lno_t maxLevels = 0;
+    for (lno_t batchBegin = 0; batchBegin < numSources;
+         batchBegin += batchSize) {
+      const lno_t batchLen = numSources - batchBegin < batchSize
+                                 ? numSources - batchBegin
+                                 : batchSize;
+      if (batchBegin) {
+        Kokkos::deep_copy(seen, word_t(0));
+        Kokkos::deep_copy(frontier, word_t(0));
+      }
+      Kokkos::parallel_for("KokkosGraph::MultiSourceBFS::InitBatch",
+                           range_pol(0, batchLen),
+                           InitBatch(*this, batchBegin));
+      lno_t depth = 0;
+      while (true) {
+        lno_t changed = 0;
+        Kokkos::parallel_reduce(
+            "KokkosGraph::MultiSourceBFS::Expand", range_pol(0, numVerts),
+            Expand(*this, batchBegin, batchLen, depth), changed);
+        depth++;
+        if (!changed) break;
+        std::swap(frontier, nextFrontier);
+      }
+      if (depth > maxLevels) maxLevels = depth;
+    }
+    return maxLevels;
+  }
+};
+
 }  // namespace Impl
 }  // namespace Experimental
 }  // namespace KokkosGraph
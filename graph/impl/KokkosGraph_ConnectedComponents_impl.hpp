@@ -0,0 +1,240 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#ifndef _KOKKOSGRAPH_CONNECTED_COMPONENTS_IMPL_HPP
+#define _KOKKOSGRAPH_CONNECTED_COMPONENTS_IMPL_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include "Kokkos_Core.hpp"
+#include "KokkosKernels_SimpleUtils.hpp"
+
+namespace KokkosGraph {
+namespace Impl {
+
+// Connected components by Afforest (Sutton, Ben-Nun, Barak), a
+// Shiloach-Vishkin style union-find:
+//   - each vertex is hooked to its first few neighbors, and the trees are
+//     compressed by pointer jumping,
+//   - the most frequent root, found from a sample, is likely the largest
+//     component,
+//   - the vertices outside of it hook their remaining neighbors, and the
+//     trees are compressed again.
+// Hooking always points the higher root at the lower one with a
+// compare-and-swap, so every tree is rooted at the lowest vertex of its
+// component. The components are then numbered in the order of their roots.
+template <typename device_t, typename rowmap_t, typename entries_t,
+          typename labels_t>
+struct Afforest {
+  using exec_space = typename device_t::execution_space;
+  using mem_space  = typename device_t::memory_space;
+  using size_type  = typename rowmap_t::non_const_value_type;
+  using lno_t      = typename entries_t::non_const_value_type;
+  using range_pol  = Kokkos::RangePolicy<exec_space>;
+  using dynamic_pol =
+      Kokkos::RangePolicy<exec_space, Kokkos::Schedule<Kokkos::Dynamic>>;
+
+  // Neighbors hooked by every vertex before the sampling
+  static constexpr lno_t neighborRounds = 2;
+  static constexpr lno_t numSamples     = 1024;
+
+  rowmap_t rowmap;
+  entries_t entries;
+  lno_t numVerts;
+  // Union-find parent of each vertex, then its component
+  labels_t parent;
+
+  Afforest(const rowmap_t& rowmap_, const entries_t& entries_)
+      : rowmap(rowmap_),
+        entries(entries_),
+        numVerts(rowmap_.extent(0) - 1),
+        parent(Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                                  "Component Labels"),
+               numVerts) {}
+
+  struct Init {
+    Init(const labels_t& parent_) : parent(parent_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t v) const { parent(v) = v; }
+
+    labels_t parent;
+  };
+
+  // Merge the trees of u and v
+  KOKKOS_INLINE_FUNCTION static void link(const labels_t& parent, lno_t u,
+                                          lno_t v) {
+    lno_t p1 = parent(u);
+    lno_t p2 = parent(v);
+    while (p1 != p2) {
+      lno_t high  = p1 > p2 ? p1 : p2;
+      lno_t low   = p1 > p2 ? p2 : p1;
+      lno_t pHigh = parent(high);
+      // Already linked, or high is a root that can be pointed at low
+      if (pHigh == low) break;
+      if (pHigh == high &&
+          Kokkos::atomic_compare_exchange(&parent(high), high, low) == high)
+        break;
+      p1 = parent(parent(high));
+      p2 = parent(low);
+    }
+  }
+
+  // Hooks each vertex to its neighbors in [first, last) of its row, skipping
+  // the vertices already in component skip (none if skip < 0)
+  struct Hook {
+    Hook(const rowmap_t& rowmap_, const entries_t& entries_,
+         const labels_t& parent_, lno_t first_, lno_t last_, lno_t skip_)
+        : rowmap(rowmap_),
+          entries(entries_),
+          parent(parent_),
+          numVerts(rowmap_.extent(0) - 1),
+          first(first_),
+          last(last_),
+          skip(skip_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t v) const {
+      if (skip >= 0 && parent(v) == skip) return;
+      size_type begin = rowmap(v) + first;
+      size_type end   = rowmap(v + 1);
+      if (last >= 0 && begin + (last - first) < end)
+        end = begin + (last - first);
+      for (size_type j = begin; j < end; j++) {
+        lno_t nei = entries(j);
+        if (nei == v || nei < 0 || nei >= numVerts) continue;
+        link(parent, v, nei);
+      }
+    }
+
+    rowmap_t rowmap;
+    entries_t entries;
+    labels_t parent;
+    lno_t numVerts;
+    lno_t first;
+    lno_t last;
+    lno_t skip;
+  };
+
+  // Pointer jumping: point every vertex at its root
+  struct Compress {
+    Compress(const labels_t& parent_) : parent(parent_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t v) const {
+      while (parent(parent(v)) != parent(v)) parent(v) = parent(parent(v));
+    }
+
+    labels_t parent;
+  };
+
+  struct Sample {
+    Sample(const labels_t& parent_, const labels_t& samples_, lno_t numVerts_)
+        : parent(parent_), samples(samples_), numVerts(numVerts_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t i) const {
+      samples(i) = parent((uint64_t(i) * 2654435761ull) % numVerts);
+    }
+
+    labels_t parent;
+    labels_t samples;
+    lno_t numVerts;
+  };
+
+  // Root of the vertices of the sample that share the most common root
+  lno_t mostFrequentRoot() {
+    lno_t n = numVerts < numSamples ? numVerts : numSamples;
+    labels_t samples(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "Samples"), n);
+    Kokkos::parallel_for("KokkosGraph::ConnectedComponents::Sample",
+                         range_pol(0, n), Sample(parent, samples, numVerts));
+    auto samplesHost =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), samples);
+    std::sort(samplesHost.data(), samplesHost.data() + n);
+    lno_t best = samplesHost(0), bestCount = 0;
+    for (lno_t i = 0; i < n;) {
+      lno_t j = i;
+      while (j < n && samplesHost(j) == samplesHost(i)) j++;
+      if (j - i > bestCount) {
+        best      = samplesHost(i);
+        bestCount = j - i;
+      }
+      i = j;
+    }
+    return best;
+  }
+
+  // Number the roots in increasing order, then give every vertex the
+  // number of its root
+  struct NumberRoots {
+    NumberRoots(const labels_t& parent_, const labels_t& number_)
+        : parent(parent_), number(number_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t v, lno_t& lcount,
+                                           bool finalPass) const {
+      bool root = parent(v) == v;
+      if (finalPass && root) number(v) = lcount;
+      if (root) lcount++;
+    }
+
+    labels_t parent;
+    labels_t number;
+  };
+
+  struct Relabel {
+    Relabel(const labels_t& parent_, const labels_t& number_)
+        : parent(parent_), number(number_) {}
+
+    KOKKOS_INLINE_FUNCTION void operator()(lno_t v) const {
+      parent(v) = number(parent(v));
+    }
+
+    labels_t parent;
+    labels_t number;
+  };
+
+  labels_t compute(lno_t& numComponents) {
+    Kokkos::parallel_for("KokkosGraph::ConnectedComponents::Init",
+                         range_pol(0, numVerts), Init(parent));
+    for (lno_t r = 0; r < neighborRounds; r++) {
+      Kokkos::parallel_for(
+          "KokkosGraph::ConnectedComponents::HookSample",
+          range_pol(0, numVerts),
+          Hook(rowmap, entries, parent, r, r + 1, lno_t(-1)));
+      Kokkos::parallel_for("KokkosGraph::ConnectedComponents::Compress",
+                           range_pol(0, numVerts), Compress(parent));
+    }
+    lno_t largest = mostFrequentRoot();
+    // Rows are long in the dense parts of the graph, so balance dynamically
+    Kokkos::parallel_for(
+        "KokkosGraph::ConnectedComponents::HookRest", dynamic_pol(0, numVerts),
+        Hook(rowmap, entries, parent, neighborRounds, lno_t(-1), largest));
+    Kokkos::parallel_for("KokkosGraph::ConnectedComponents::Compress",
+                         range_pol(0, numVerts), Compress(parent));
+    labels_t number(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "Component Numbers"),
+        numVerts);
+    numComponents = 0;
+    Kokkos::parallel_scan("KokkosGraph::ConnectedComponents::NumberRoots",
+                          range_pol(0, numVerts), NumberRoots(parent, number),
+                          numComponents);
+    Kokkos::parallel_for("KokkosGraph::ConnectedComponents::Relabel",
+                         range_pol(0, numVerts), Relabel(parent, number));
+    return parent;
+  }
+};
+
+}  // namespace Impl
+}  // namespace KokkosGraph
+
+#endif
@@ -0,0 +1,382 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#ifndef _KOKKOSGRAPH_TRIANGLE_COUNT_IMPL_HPP
+#define _KOKKOSGRAPH_TRIANGLE_COUNT_IMPL_HPP
+
+#include <type_traits>
+#include "Kokkos_Core.hpp"
+#include "KokkosKernels_SimpleUtils.hpp"
+#include "KokkosKernels_Uniform_Initialized_MemoryPool.hpp"
+#include "KokkosSparse_SortCrs.hpp"
+#include "KokkosSparse_spgemm_accumulator_impl.hpp"
+
+namespace KokkosGraph {
+
+// How the out-neighbors of a vertex are intersected with those of its
+// out-neighbors. AUTO chooses per vertex; the others force one method.
+enum TriangleIntersection {
+  TRIANGLE_INTERSECT_AUTO,
+  TRIANGLE_INTERSECT_MERGE,
+  TRIANGLE_INTERSECT_HASH,
+  TRIANGLE_INTERSECT_BITMAP
+};
+
+namespace Impl {
+
+// A visitor that ignores the triangles, for counting only
+struct TriangleNoopVisitor {
+  template <typename lno_t>
+  KOKKOS_INLINE_FUNCTION void operator()(lno_t, lno_t, lno_t) const {}
+};
+
+// The graph oriented from the lower to the higher vertex of each edge in the
+// (degree, id) order, with the sorted out-neighbors N+(u) of each vertex
+template <typename device_t, typename rowmap_t, typename entries_t>
+struct OrientedTriangleGraph {
+  using mem_space   = typename device_t::memory_space;
+  using size_type   = typename rowmap_t::non_const_value_type;
+  using lno_t       = typename entries_t::non_const_value_type;
+  using lno_view_t  = Kokkos::View<lno_t*, mem_space>;
+  using size_view_t = Kokkos::View<size_type*, mem_space>;
+
+  KOKKOS_INLINE_FUNCTION bool precedes(const lno_t u, const lno_t v) const {
+    return degrees(u) < degrees(v) || (degrees(u) == degrees(v) && u < v);
+  }
+
+  rowmap_t rowmap;
+  entries_t entries;
+  lno_t numVerts;
+  lno_view_t degrees;
+  size_view_t outRowmap;
+  lno_view_t outEntries;
+};
+
+// Triangles of a symmetric graph, each found once on the oriented graph.
+// Its out-degrees are O(sqrt(#edges)), so the high degree vertices of a
+// skewed graph no longer dominate the intersections. Triangle (u,v,w) with
+// u < v < w in the (degree, id) order is found at u, as w in N+(u) and N+(v).
+template <typename device_t, typename rowmap_t, typename entries_t>
+struct OrientedTriangles {
+  using exec_space   = typename device_t::execution_space;
+  using mem_space    = typename device_t::memory_space;
+  using graph_t      = OrientedTriangleGraph<device_t, rowmap_t, entries_t>;
+  using size_type    = typename graph_t::size_type;
+  using lno_t        = typename graph_t::lno_t;
+  using word_t       = typename std::make_unsigned<lno_t>::type;
+  using lno_view_t   = typename graph_t::lno_view_t;
+  using size_view_t  = typename graph_t::size_view_t;
+  using pool_t       = KokkosKernels::Impl::UniformMemoryPool<device_t, lno_t>;
+  using range_pol    = Kokkos::RangePolicy<exec_space>;
+  using dynamic_pol  = Kokkos::RangePolicy<exec_space,
+                                          Kokkos::Schedule<Kokkos::Dynamic>>;
+  using count_view_t = Kokkos::View<size_t*, mem_space>;
+
+  static constexpr lno_t wordBits = 8 * sizeof(word_t);
+  // Vertices with at most this many out-neighbors merge in AUTO
+  static constexpr lno_t mergeMaxDegree = 16;
+
+  OrientedTriangles(const rowmap_t& rowmap, const entries_t& entries) {
+    const lno_t numVerts = rowmap.extent(0) ? rowmap.extent(0) - 1 : 0;
+    g.rowmap             = rowmap;
+    g.entries            = entries;
+    g.numVerts           = numVerts;
+    g.degrees   = lno_view_t(Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                                              "Triangle degrees"),
+                           numVerts);
+    g.outRowmap = size_view_t(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "Triangle out rowmap"),
+        numVerts + 1);
+    Kokkos::parallel_for("KokkosGraph::Triangle::Degrees",
+                         range_pol(0, numVerts), DegreeFunctor{g});
+    Kokkos::parallel_for("KokkosGraph::Triangle::OutDegrees",
+                         range_pol(0, numVerts), OrientFunctor<false>{g});
+    size_type numOutEdges = 0;
+    KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<size_view_t,
+                                                          exec_space>(
+        numVerts + 1, g.outRowmap, numOutEdges);
+    g.outEntries = lno_view_t(Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                                                 "Triangle out entries"),
+                              numOutEdges);
+    Kokkos::parallel_for("KokkosGraph::Triangle::Orient",
+                         range_pol(0, numVerts), OrientFunctor<true>{g});
+    KokkosSparse::sort_crs_graph<exec_space, size_view_t, lno_view_t>(
+        g.outRowmap, g.outEntries);
+    maxOutDegree = 0;
+    Kokkos::parallel_reduce("KokkosGraph::Triangle::MaxOutDegree",
+                            range_pol(0, numVerts), MaxOutDegreeFunctor{g},
+                            Kokkos::Max<lno_t>(maxOutDegree));
+  }
+
+  // Degree of each vertex, without self loops and out of range columns
+  struct DegreeFunctor {
+    graph_t t;
+
+    KOKKOS_INLINE_FUNCTION void operator()(const lno_t u) const {
+      lno_t d = 0;
+      for (size_type i = t.rowmap(u); i < t.rowmap(u + 1); i++) {
+        const lno_t v = t.entries(i);
+        if (v != u && v >= 0 && v < t.numVerts) d++;
+      }
+      t.degrees(u) = d;
+    }
+  };
+
+  // Counts (fill = false) or writes (fill = true) the out-neighbors
+  template <bool fill>
+  struct OrientFunctor {
+    graph_t t;
+
+    KOKKOS_INLINE_FUNCTION void operator()(const lno_t u) const {
+      size_type out = fill ? t.outRowmap(u) : 0;
+      for (size_type i = t.rowmap(u); i < t.rowmap(u + 1); i++) {
+        const lno_t v = t.entries(i);
+        if (v == u || v < 0 || v >= t.numVerts || !t.precedes(u, v)) continue;
+        if (fill) t.outEntries(out) = v;
+        out++;
+      }
+      if (!fill) t.outRowmap(u) = out;
+    }
+  };
+
+  struct MaxOutDegreeFunctor {
+    graph_t t;
+
+    KOKKOS_INLINE_FUNCTION void operator()(const lno_t u, lno_t& lmax) const {
+      const lno_t d = t.outRowmap(u + 1) - t.outRowmap(u);
+      if (d > lmax) lmax = d;
+    }
+  };
+
+  // Power of two table size for a hash set of n keys, at most half full
+  KOKKOS_INLINE_FUNCTION static lno_t hash_size(const lno_t n) {
+    lno_t size = 1;
+    while (size < 2 * n) size *= 2;
+    return size;
+  }
+
+  // Finds the triangles at each vertex u, calling visitor(u,v,w) for each.
+  // counts, when not empty, gets the triangles of every vertex. The pool
+  // holds the hash tables and bitmaps, all -1 when free.
+  template <typename visitor_t, typename counts_t>
+  struct FindFunctor {
+    graph_t t;
+    TriangleIntersection method;
+    pool_t pool;
+    lno_t chunkSize;
+    visitor_t visitor;
+    counts_t counts;
+
+    using count_t = typename counts_t::non_const_value_type;
+
+    KOKKOS_INLINE_FUNCTION void found(const lno_t u, const lno_t v,
+                                      const lno_t w) const {
+      if (counts.extent(0)) {
+        Kokkos::atomic_add(&counts(v), count_t(1));
+        Kokkos::atomic_add(&counts(w), count_t(1));
+      }
+      visitor(u, v, w);
+    }
+
+    KOKKOS_INLINE_FUNCTION size_t merge(const lno_t u) const {
+      size_t local         = 0;
+      const size_type uEnd = t.outRowmap(u + 1);
+      for (size_type i = t.outRowmap(u); i < uEnd; i++) {
+        const lno_t v        = t.outEntries(i);
+        size_type a          = t.outRowmap(u);
+        size_type b          = t.outRowmap(v);
+        const size_type vEnd = t.outRowmap(v + 1);
+        while (a < uEnd && b < vEnd) {
+          const lno_t x = t.outEntries(a);
+          const lno_t y = t.outEntries(b);
+          if (x < y)
+            a++;
+          else if (y < x)
+            b++;
+          else {
+            found(u, v, x);
+            local++;
+            a++;
+            b++;
+          }
+        }
+      }
+      return local;
+    }
+
+    KOKKOS_INLINE_FUNCTION size_t hash(const lno_t u, lno_t* table) const {
+      const size_type uBegin = t.outRowmap(u);
+      const size_type uEnd   = t.outRowmap(u + 1);
+      const size_t mask      = hash_size(uEnd - uBegin) - 1;
+      for (size_type i = uBegin; i < uEnd; i++) {
+        const lno_t w = t.outEntries(i);
+        size_t slot   = (size_t(w) * 2654435761ul) & mask;
+        while (table[slot] != -1) slot = (slot + 1) & mask;
+        table[slot] = w;
+      }
+      size_t local = 0;
+      for (size_type i = uBegin; i < uEnd; i++) {
+        const lno_t v = t.outEntries(i);
+        for (size_type j = t.outRowmap(v); j < t.outRowmap(v + 1); j++) {
+          const lno_t w = t.outEntries(j);
+          size_t slot   = (size_t(w) * 2654435761ul) & mask;
+          while (table[slot] != -1 && table[slot] != w)
+            slot = (slot + 1) & mask;
+          if (table[slot] == w) {
+            found(u, v, w);
+            local++;
+          }
+        }
+      }
+      for (size_t slot = 0; slot <= mask; slot++) table[slot] = -1;
+      return local;
+    }
+
+    // One bit per vertex in [first, last] of N+(u), cleared for the members
+    // so that a free chunk stays all ones
+    KOKKOS_INLINE_FUNCTION size_t bitmap(const lno_t u, lno_t* chunk) const {
+      word_t* bits           = reinterpret_cast<word_t*>(chunk);
+      const size_type uBegin = t.outRowmap(u);
+      const size_type uEnd   = t.outRowmap(u + 1);
+      const lno_t first      = t.outEntries(uBegin);
+      const lno_t last       = t.outEntries(uEnd - 1);
+      for (size_type i = uBegin; i < uEnd; i++) {
+        const lno_t b = t.outEntries(i) - first;
+        bits[b / wordBits] &= ~(word_t(1) << (b % wordBits));
+      }
+      size_t local = 0;
+      for (size_type i = uBegin; i < uEnd; i++) {
+        const lno_t v = t.outEntries(i);
+        for (size_type j = t.outRowmap(v); j < t.outRowmap(v + 1); j++) {
+          const lno_t w = t.outEntries(j);
+          if (w > last) break;
+          if (w < first) continue;
+          const lno_t b = w - first;
+          if (!((bits[b / wordBits] >> (b % wordBits)) & 1)) {
+            found(u, v, w);
+            local++;
+          }
+        }
+      }
+      for (size_type i = uBegin; i < uEnd; i++) {
+        const lno_t b = t.outEntries(i) - first;
+        bits[b / wordBits] = ~word_t(0);
+      }
+      return local;
+    }
+
+    KOKKOS_INLINE_FUNCTION void operator()(const lno_t u,
+                                           size_t& total) const {
+      const size_type uBegin = t.outRowmap(u);
+      const lno_t du         = t.outRowmap(u + 1) - uBegin;
+      size_t local           = 0;
+      if (du >= 2) {
+        TriangleIntersection m = method;
+        const lno_t spanWords =
+            (t.outEntries(uBegin + du - 1) - t.outEntries(uBegin)) / wordBits +
+            1;
+        if (m == TRIANGLE_INTERSECT_AUTO) {
+          // Merging is cheapest for short rows; past that, the bitmap when
+          // N+(u) is dense enough for it to be no larger than the hash table
+          if (du <= mergeMaxDegree)
+            m = TRIANGLE_INTERSECT_MERGE;
+          else if (spanWords <= hash_size(du))
+            m = TRIANGLE_INTERSECT_BITMAP;
+          else
+            m = TRIANGLE_INTERSECT_HASH;
+        }
+        if (m == TRIANGLE_INTERSECT_BITMAP && spanWords > chunkSize)
+          m = TRIANGLE_INTERSECT_HASH;
+        if (m == TRIANGLE_INTERSECT_MERGE) {
+          local = merge(u);
+        } else {
+          lno_t* chunk =
+              KokkosSparse::Impl::spgemm_acquire_chunk<exec_space, lno_t>(pool,
+                                                                          u);
+          if (m == TRIANGLE_INTERSECT_BITMAP)
+            local = bitmap(u, chunk);
+          else
+            local = hash(u, chunk);
+          pool.release_chunk(chunk);
+        }
+      }
+      if (local && counts.extent(0))
+        Kokkos::atomic_add(&counts(u), count_t(local));
+      total += local;
+    }
+  };
+
+  template <typename visitor_t, typename counts_t>
+  size_t find(TriangleIntersection method, const visitor_t& visitor,
+              const counts_t& counts) const {
+    if (counts.extent(0)) Kokkos::deep_copy(counts, 0);
+    // Hash tables are sized for the largest N+(u), and bitmaps take what is
+    // left of the chunk, or cover all the vertices when they are forced
+    lno_t chunkSize = 0;
+    if (method != TRIANGLE_INTERSECT_MERGE)
+      chunkSize = hash_size(maxOutDegree);
+    if (method == TRIANGLE_INTERSECT_BITMAP) {
+      const lno_t allWords = g.numVerts / wordBits + 1;
+      if (allWords > chunkSize) chunkSize = allWords;
+    }
+    pool_t pool;
+    if (chunkSize)
+      pool = KokkosSparse::Impl::spgemm_make_pool<pool_t, lno_t>(chunkSize);
+    FindFunctor<visitor_t, counts_t> f{g,         method,  pool,
+                                       chunkSize, visitor, counts};
+    size_t total = 0;
+    Kokkos::parallel_reduce("KokkosGraph::Triangle::Find",
+                            dynamic_pol(0, g.numVerts), f, total);
+    return total;
+  }
+
+  // 2 T(v) / (d(v) (d(v) - 1)), and 0 when d(v) < 2
+  template <typename counts_t, typename coeffs_t>
+  struct ClusteringFunctor {
+    graph_t t;
+    counts_t counts;
+    coeffs_t coeffs;
+
+    using coeff_t = typename coeffs_t::non_const_value_type;
+
+    KOKKOS_INLINE_FUNCTION void operator()(const lno_t v) const {
+      const lno_t d = t.degrees(v);
+      if (d < 2)
+        coeffs(v) = coeff_t(0);
+      else
+        coeffs(v) = coeff_t(2 * counts(v)) / (coeff_t(d) * coeff_t(d - 1));
+    }
+  };
+
+  template <typename coeffs_t>
+  size_t clustering(TriangleIntersection method,
+                    const coeffs_t& coeffs) const {
+    count_view_t counts("Triangle counts", g.numVerts);
+    const size_t total = find(method, TriangleNoopVisitor(), counts);
+    Kokkos::parallel_for(
+        "KokkosGraph::Triangle::Clustering", range_pol(0, g.numVerts),
+        ClusteringFunctor<count_view_t, coeffs_t>{g, counts, coeffs});
+    return total;
+  }
+
+  graph_t g;
+  lno_t maxOutDegree;
+};
+
+}  // namespace Impl
+}  // namespace KokkosGraph
+
+#endif
@@ -0,0 +1,94 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#ifndef _KOKKOSGRAPH_BFS_HPP
+#define _KOKKOSGRAPH_BFS_HPP
+
+#include <stdexcept>
+#include "KokkosGraph_BFS_impl.hpp"
+
+namespace KokkosGraph {
+namespace Experimental {
+
+// Breadth-first search from source over a symmetric CRS graph, in parallel
+// on device_t's execution space. Each level is expanded top-down from the
+// frontier or bottom-up from the unvisited vertices, whichever is expected
+// to inspect fewer edges.
+//
+// levels (one lno_t per vertex) gets the distance of each vertex from
+// source, -1 if unreachable. parents, unless it is empty, gets the vertex
+// each one was reached from: source for itself and -1 if unreachable.
+// Self loops and column indices >= num_verts are ignored.
+//
+// Returns the number of levels, i.e. the eccentricity of source plus one.
+
+template <typename device_t, typename rowmap_t, typename colinds_t,
+          typename levels_t, typename parents_t>
+typename colinds_t::non_const_value_type graph_bfs(
+    const rowmap_t& rowmap, const colinds_t& colinds,
+    typename colinds_t::non_const_value_type source, const levels_t& levels,
+    const parents_t& parents) {
+  using lno_t    = typename colinds_t::non_const_value_type;
+  lno_t numVerts = rowmap.extent(0) ? lno_t(rowmap.extent(0) - 1) : 0;
+  if (source < 0 || source >= numVerts)
+    throw std::invalid_argument("graph_bfs: source is not a vertex");
+  if (levels.extent(0) != size_t(numVerts) ||
+      (parents.extent(0) && parents.extent(0) != size_t(numVerts)))
+    throw std::invalid_argument(
+        "graph_bfs: levels and parents must have one entry per vertex");
+  Impl::DirectionOptimizingBFS<device_t, rowmap_t, colinds_t, levels_t,
+                               parents_t>
+      bfs(rowmap, colinds, levels, parents);
+  return bfs.run(source);
+}
+
+template <typename device_t, typename rowmap_t, typename colinds_t,
+          typename levels_t>
+typename colinds_t::non_const_value_type graph_bfs(
+    const rowmap_t& rowmap, const colinds_t& colinds,
+    typename colinds_t::non_const_value_type source, const levels_t& levels) {
+  return graph_bfs<device_t>(rowmap, colinds, source, levels, levels_t());
+}
+
+// Breadth-first searches from each vertex of sources (which must all be
+// vertices), run 64 at a time with one bit per source and vertex.
+//
+// levels (num_verts x sources.extent(0)) gets in levels(v, i) the distance
+// of v from sources(i), -1 if unreachable. The largest finite entry of each
+// column is the eccentricity of its source, which gives a lower bound on
+// the diameter.
+//
+// Returns the largest number of levels of any of the searches.
+
+template <typename device_t, typename rowmap_t, typename colinds_t,
+          typename sources_t, typename levels_t>
+typename colinds_t::non_const_value_type graph_multi_source_bfs(
+    const rowmap_t& rowmap, const colinds_t& colinds, const sources_t& sources,
+    const levels_t& levels) {
+  size_t numVerts = rowmap.extent(0) ? rowmap.extent(0) - 1 : 0;
+  if (levels.extent(0) != numVerts || levels.extent(1) != sources.extent(0))
+    throw std::invalid_argument(
+        "graph_multi_source_bfs: levels must be num_verts x num_sources");
+  if (!sources.extent(0)) return 0;
+  Impl::MultiSourceBFS<device_t, rowmap_t, colinds_t, sources_t, levels_t>
+      bfs(rowmap, colinds, sources, levels);
+  return bfs.run();
+}
+
+}  // namespace Experimental
+}  // namespace KokkosGraph
+
+#endif
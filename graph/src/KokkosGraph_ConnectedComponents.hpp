@@ -0,0 +1,48 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#ifndef _KOKKOSGRAPH_CONNECTED_COMPONENTS_HPP
+#define _KOKKOSGRAPH_CONNECTED_COMPONENTS_HPP
+
+#include "KokkosGraph_ConnectedComponents_impl.hpp"
+
+namespace KokkosGraph {
+
+// Compute the connected components of a symmetric CRS graph, in parallel on
+// device_t's execution space (Afforest: union-find with hooking on sampled
+// neighbors and pointer jumping). Returns the component of each vertex,
+// in [0, numComponents). Components are numbered in the order of their
+// lowest vertex, so the labels do not depend on the thread schedule.
+//
+// Self loops and column indices >= num_verts are ignored.
+
+template <typename device_t, typename rowmap_t, typename colinds_t,
+          typename labels_t = typename colinds_t::non_const_type>
+labels_t graph_connected_components(
+    const rowmap_t& rowmap, const colinds_t& colinds,
+    typename colinds_t::non_const_value_type& numComponents) {
+  if (rowmap.extent(0) <= 1) {
+    // there are no vertices to label
+    numComponents = 0;
+    return labels_t();
+  }
+  Impl::Afforest<device_t, rowmap_t, colinds_t, labels_t> cc(rowmap, colinds);
+  return cc.compute(numComponents);
+}
+
+}  // end namespace KokkosGraph
+
+#endif
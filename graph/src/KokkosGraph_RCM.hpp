@@ -25,6 +25,9 @@ namespace Experimental {
 // Compute the reverse Cuthill-McKee ordering of a graph.
 // The graph must be symmetric, but it may have any number of connected
 // components. This function returns a list of vertices in RCM order.
+//
+// The ordering is computed in parallel on device_t's execution space, with a
+// level-synchronous BFS from a pseudo-peripheral vertex of each component.
 
 template <typename device_t, typename rowmap_t, typename colinds_t,
           typename labels_t = typename colinds_t::non_const_type>
@@ -36,7 +39,8 @@ labels_t graph_rcm(const rowmap_t& rowmap, const colinds_t& colinds) {
     if (numVerts) numVerts--;
     return labels_t("RCM Labels", numVerts);
   }
-  Impl::SerialRCM<rowmap_t, colinds_t, labels_t> algo(rowmap, colinds);
+  Impl::ParallelRCM<device_t, rowmap_t, colinds_t, labels_t> algo(rowmap,
+                                                                  colinds);
   return algo.rcm();
 }
 
@@ -0,0 +1,100 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#ifndef _KOKKOSGRAPH_TRIANGLE_COUNT_HPP
+#define _KOKKOSGRAPH_TRIANGLE_COUNT_HPP
+
+#include <stdexcept>
+#include "KokkosGraph_TriangleCount_impl.hpp"
+
+namespace KokkosGraph {
+
+// Triangles of a symmetric CRS graph, without forming a matrix product.
+// Edges are oriented from lower to higher degree, and the out-neighbors of
+// each vertex are intersected with those of its out-neighbors by merging,
+// hashing or a bitmap, chosen per vertex unless algo forces one.
+//
+// Self loops and column indices >= num_verts are ignored. A row must not
+// list the same neighbor twice.
+
+// Returns the number of triangles.
+template <typename device_t, typename rowmap_t, typename colinds_t>
+size_t triangle_count(const rowmap_t& rowmap, const colinds_t& colinds,
+                      TriangleIntersection algo = TRIANGLE_INTERSECT_AUTO) {
+  if (rowmap.extent(0) <= 1) return 0;
+  Impl::OrientedTriangles<device_t, rowmap_t, colinds_t> tri(rowmap, colinds);
+  return tri.find(algo, Impl::TriangleNoopVisitor(),
+                  Kokkos::View<size_t*, typename device_t::memory_space>());
+}
+
+// Returns the number of triangles, and fills counts (one per vertex) with
+// the number of triangles each vertex belongs to.
+template <typename device_t, typename rowmap_t, typename colinds_t,
+          typename counts_t>
+size_t triangle_count_per_vertex(
+    const rowmap_t& rowmap, const colinds_t& colinds, const counts_t& counts,
+    TriangleIntersection algo = TRIANGLE_INTERSECT_AUTO) {
+  if (rowmap.extent(0) <= 1) return 0;
+  if (counts.extent(0) != rowmap.extent(0) - 1)
+    throw std::invalid_argument(
+        "triangle_count_per_vertex: counts must have one entry per vertex");
+  Impl::OrientedTriangles<device_t, rowmap_t, colinds_t> tri(rowmap, colinds);
+  return tri.find(algo, Impl::TriangleNoopVisitor(), counts);
+}
+
+// Calls visitor(u, v, w) once for each triangle, in parallel, and returns
+// the number of triangles. u, v and w are in increasing (degree, id) order.
+// The visitor must be callable on device_t.
+template <typename device_t, typename rowmap_t, typename colinds_t,
+          typename visitor_t>
+size_t triangle_enumerate(
+    const rowmap_t& rowmap, const colinds_t& colinds, const visitor_t& visitor,
+    TriangleIntersection algo = TRIANGLE_INTERSECT_AUTO) {
+  if (rowmap.extent(0) <= 1) return 0;
+  Impl::OrientedTriangles<device_t, rowmap_t, colinds_t> tri(rowmap, colinds);
+  return tri.find(algo, visitor,
+                  Kokkos::View<size_t*, typename device_t::memory_space>());
+}
+
+// Fills coeffs (one per vertex) with the local clustering coefficient
+// 2 T(v) / (d(v) (d(v) - 1)) of each vertex, 0 when d(v) < 2, and returns
+// the number of triangles.
+template <typename device_t, typename rowmap_t, typename colinds_t,
+          typename coeffs_t>
+size_t clustering_coefficients(
+    const rowmap_t& rowmap, const colinds_t& colinds, const coeffs_t& coeffs,
+    TriangleIntersection algo = TRIANGLE_INTERSECT_AUTO) {
+  if (rowmap.extent(0) <= 1) return 0;
+  if (coeffs.extent(0) != rowmap.extent(0) - 1)
+    throw std::invalid_argument(
+        "clustering_coefficients: coeffs must have one entry per vertex");
+  Impl::OrientedTriangles<device_t, rowmap_t, colinds_t> tri(rowmap, colinds);
+  return tri.clustering(algo, coeffs);
+}
+
+inline const char* triangle_intersection_name(TriangleIntersection algo) {
+  switch (algo) {
+    case TRIANGLE_INTERSECT_AUTO: return "TRIANGLE_INTERSECT_AUTO";
+    case TRIANGLE_INTERSECT_MERGE: return "TRIANGLE_INTERSECT_MERGE";
+    case TRIANGLE_INTERSECT_HASH: return "TRIANGLE_INTERSECT_HASH";
+    case TRIANGLE_INTERSECT_BITMAP: return "TRIANGLE_INTERSECT_BITMAP";
+  }
+  return "*** Invalid triangle intersection enum value.\n";
+}
+
+}  // end namespace KokkosGraph
+
+#endif
@@ -24,5 +24,8 @@
 #include "Test_Graph_coarsen.hpp"
 #endif
 #include "Test_Graph_rcm.hpp"
+#include "Test_Graph_bfs.hpp"
+#include "Test_Graph_connected_components.hpp"
+#include "Test_Graph_triangle.hpp"
 
 #endif  // TEST_GRAPH_HPP
@@ -0,0 +1,196 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#include <gtest/gtest.h>
+#include <queue>
+#include <vector>
+#include <Kokkos_Core.hpp>
+
+#include "KokkosGraph_BFS.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosSparse_Utils.hpp"
+#include "KokkosKernels_Utils.hpp"
+#include "KokkosKernels_TestUtils.hpp"
+
+namespace Test {
+
+// Distances from source, by a serial BFS on the host
+template <typename lno_t, typename rowmap_t, typename entries_t>
+std::vector<lno_t> serialBFS(lno_t numVerts, const rowmap_t& rowmap,
+                             const entries_t& entries, lno_t source) {
+  std::vector<lno_t> levels(numVerts, -1);
+  std::queue<lno_t> q;
+  levels[source] = 0;
+  q.push(source);
+  while (!q.empty()) {
+    lno_t v = q.front();
+    q.pop();
+    for (auto j = rowmap(v); j < rowmap(v + 1); j++) {
+      lno_t nei = entries(j);
+      if (nei == v || nei >= numVerts || levels[nei] != -1) continue;
+      levels[nei] = levels[v] + 1;
+      q.push(nei);
+    }
+  }
+  return levels;
+}
+
+}  // namespace Test
+
+template <typename lno_t, typename rowmap_t, typename entries_t,
+          typename device>
+void check_bfs(const rowmap_t& rowmap, const entries_t& entries,
+               lno_t numSources) {
+  using lno_view_t     = Kokkos::View<lno_t*, device>;
+  using lno_2d_t       = Kokkos::View<lno_t**, Kokkos::LayoutLeft, device>;
+  const lno_t numVerts = rowmap.extent(0) - 1;
+  auto rowmapHost =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), rowmap);
+  auto entriesHost =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), entries);
+  lno_view_t sources("Sources", numSources);
+  auto sourcesHost = Kokkos::create_mirror_view(sources);
+  for (lno_t i = 0; i < numSources; i++)
+    sourcesHost(i) = (i * 7919) % numVerts;
+  Kokkos::deep_copy(sources, sourcesHost);
+  lno_2d_t multiLevels("Levels", numVerts, numSources);
+  lno_t multiNumLevels =
+      KokkosGraph::Experimental::graph_multi_source_bfs<device>(
+          rowmap, entries, sources, multiLevels);
+  auto multiLevelsHost =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), multiLevels);
+  lno_t maxLevels = 0;
+  for (lno_t i = 0; i < numSources; i++) {
+    lno_t source = sourcesHost(i);
+    std::vector<lno_t> expected =
+        Test::serialBFS(numVerts, rowmapHost, entriesHost, source);
+    lno_t numLevels = 0;
+    for (lno_t v = 0; v < numVerts; v++) {
+      if (expected[v] + 1 > numLevels) numLevels = expected[v] + 1;
+    }
+    if (numLevels > maxLevels) maxLevels = numLevels;
+    lno_view_t levels("Levels", numVerts);
+    lno_view_t parents("Parents", numVerts);
+    EXPECT_EQ(numLevels, (KokkosGraph::Experimental::graph_bfs<device>(
+                             rowmap, entries, source, levels, parents)));
+    auto levelsHost =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), levels);
+    auto parentsHost =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), parents);
+    for (lno_t v = 0; v < numVerts; v++) {
+      ASSERT_EQ(expected[v], levelsHost(v)) << "source " << source;
+      ASSERT_EQ(expected[v], multiLevelsHost(v, i)) << "source " << source;
+      lno_t p = parentsHost(v);
+      if (expected[v] == -1) {
+        EXPECT_EQ(p, -1);
+      } else if (v == source) {
+        EXPECT_EQ(p, source);
+      } else {
+        // The parent is a neighbor one level closer to the source
+        ASSERT_TRUE(p >= 0 && p < numVerts);
+        EXPECT_EQ(expected[p] + 1, expected[v]);
+        bool adjacent = false;
+        for (auto j = rowmapHost(p); j < rowmapHost(p + 1); j++)
+          adjacent = adjacent || entriesHost(j) == v;
+        EXPECT_TRUE(adjacent);
+      }
+    }
+  }
+  EXPECT_EQ(maxLevels, multiNumLevels);
+}
+
+template <typename scalar_unused, typename lno_t, typename size_type,
+          typename device>
+void test_bfs(lno_t numVerts, size_type nnz, lno_t bandwidth,
+              lno_t row_size_variance, lno_t numSources) {
+  using execution_space = typename device::execution_space;
+  using crsMat =
+      KokkosSparse::CrsMatrix<double, lno_t, device, void, size_type>;
+  using graph_type  = typename crsMat::StaticCrsGraphType;
+  using c_rowmap_t  = typename graph_type::row_map_type;
+  using c_entries_t = typename graph_type::entries_type;
+  using rowmap_t    = typename c_rowmap_t::non_const_type;
+  using entries_t   = typename c_entries_t::non_const_type;
+  crsMat A = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat>(
+      numVerts, numVerts, nnz, row_size_variance, bandwidth);
+  auto G = A.graph;
+  rowmap_t symRowmap;
+  entries_t symEntries;
+  KokkosKernels::Impl::symmetrize_graph_symbolic_hashmap<
+      c_rowmap_t, c_entries_t, rowmap_t, entries_t, execution_space>(
+      numVerts, G.row_map, G.entries, symRowmap, symEntries);
+  check_bfs<lno_t, rowmap_t, entries_t, device>(symRowmap, symEntries,
+                                                numSources);
+}
+
+// Two paths of pathLength vertices: long, thin frontiers that stay top-down,
+// and vertices that the other path never reaches
+template <typename scalar_unused, typename lno_t, typename size_type,
+          typename device>
+void test_bfs_paths(lno_t pathLength) {
+  using rowmap_t       = Kokkos::View<size_type*, device>;
+  using entries_t      = Kokkos::View<lno_t*, device>;
+  const lno_t numVerts = 2 * pathLength;
+  std::vector<std::vector<lno_t>> adj(numVerts);
+  for (lno_t i = 1; i < numVerts; i++) {
+    if (i == pathLength) continue;
+    adj[i].push_back(i - 1);
+    adj[i - 1].push_back(i);
+  }
+  rowmap_t rowmap;
+  entries_t entries;
+  adjacency_to_crs(adj, rowmap, entries);
+  check_bfs<lno_t, rowmap_t, entries_t, device>(rowmap, entries, 3);
+}
+
+#define EXECUTE_TEST(SCALAR, ORDINAL, OFFSET, DEVICE)                                 \
+  TEST_F(TestCategory,                                                                \
+         graph##_##graph_bfs##_##SCALAR##_##ORDINAL##_##OFFSET##_##DEVICE) {          \
+    test_bfs<SCALAR, ORDINAL, OFFSET, DEVICE>(2000, 2000 * 20, 2000, 10, 70);         \
+    test_bfs<SCALAR, ORDINAL, OFFSET, DEVICE>(2000, 2000 * 3, 50, 2, 5);              \
+    test_bfs<SCALAR, ORDINAL, OFFSET, DEVICE>(5, 5 * 3, 5, 0, 2);                     \
+    test_bfs_paths<SCALAR, ORDINAL, OFFSET, DEVICE>(200);                             \
+  }
+
+#if (defined(KOKKOSKERNELS_INST_ORDINAL_INT) && \
+     defined(KOKKOSKERNELS_INST_OFFSET_INT)) || \
+    (!defined(KOKKOSKERNELS_ETI_ONLY) &&        \
+     !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+EXECUTE_TEST(double, int, int, TestExecSpace)
+#endif
+
+#if (defined(KOKKOSKERNELS_INST_ORDINAL_INT64_T) && \
+     defined(KOKKOSKERNELS_INST_OFFSET_INT)) ||     \
+    (!defined(KOKKOSKERNELS_ETI_ONLY) &&            \
+     !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+EXECUTE_TEST(double, int64_t, int, TestExecSpace)
+#endif
+
+#if (defined(KOKKOSKERNELS_INST_ORDINAL_INT) &&    \
+     defined(KOKKOSKERNELS_INST_OFFSET_SIZE_T)) || \
+    (!defined(KOKKOSKERNELS_ETI_ONLY) &&           \
+     !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+EXECUTE_TEST(double, int, size_t, TestExecSpace)
+#endif
+
+#if (defined(KOKKOSKERNELS_INST_ORDINAL_INT64_T) && \
+     defined(KOKKOSKERNELS_INST_OFFSET_SIZE_T)) ||  \
+    (!defined(KOKKOSKERNELS_ETI_ONLY) &&            \
+     !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+EXECUTE_TEST(double, int64_t, size_t, TestExecSpace)
+#endif
+
+#undef EXECUTE_TEST
@@ -0,0 +1,149 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <Kokkos_Core.hpp>
+
+#include "KokkosGraph_ConnectedComponents.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosSparse_Utils.hpp"
+#include "KokkosKernels_Utils.hpp"
+
+namespace Test {
+
+// Components numbered in the order of their lowest vertex, by a serial
+// search from each vertex not labeled yet
+template <typename lno_t, typename rowmap_t, typename entries_t>
+std::vector<lno_t> serialComponents(lno_t numVerts, const rowmap_t& rowmap,
+                                    const entries_t& entries,
+                                    lno_t& numComponents) {
+  std::vector<lno_t> labels(numVerts, -1);
+  std::vector<lno_t> stack;
+  numComponents = 0;
+  for (lno_t root = 0; root < numVerts; root++) {
+    if (labels[root] != -1) continue;
+    labels[root] = numComponents;
+    stack.push_back(root);
+    while (!stack.empty()) {
+      lno_t v = stack.back();
+      stack.pop_back();
+      for (auto j = rowmap(v); j < rowmap(v + 1); j++) {
+        lno_t nei = entries(j);
+        if (nei >= numVerts || labels[nei] != -1) continue;
+        labels[nei] = numComponents;
+        stack.push_back(nei);
+      }
+    }
+    numComponents++;
+  }
+  return labels;
+}
+
+}  // namespace Test
+
+template <typename scalar_unused, typename lno_t, typename size_type,
+          typename device>
+void test_connected_components(lno_t numVerts, size_type nnz, lno_t bandwidth,
+                               lno_t row_size_variance) {
+  using execution_space = typename device::execution_space;
+  using crsMat =
+      KokkosSparse::CrsMatrix<double, lno_t, device, void, size_type>;
+  using graph_type  = typename crsMat::StaticCrsGraphType;
+  using c_rowmap_t  = typename graph_type::row_map_type;
+  using c_entries_t = typename graph_type::entries_type;
+  using rowmap_t    = typename c_rowmap_t::non_const_type;
+  using entries_t   = typename c_entries_t::non_const_type;
+  // Generate a graph with several components
+  crsMat A = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat>(
+      numVerts, numVerts, nnz, row_size_variance, bandwidth);
+  auto G = A.graph;
+  // Symmetrize the graph
+  rowmap_t symRowmap;
+  entries_t symEntries;
+  KokkosKernels::Impl::symmetrize_graph_symbolic_hashmap<
+      c_rowmap_t, c_entries_t, rowmap_t, entries_t, execution_space>(
+      numVerts, G.row_map, G.entries, symRowmap, symEntries);
+  auto rowmapHost =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), symRowmap);
+  auto entriesHost =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), symEntries);
+  lno_t expectedNum = 0;
+  std::vector<lno_t> expected = Test::serialComponents(
+      numVerts, rowmapHost, entriesHost, expectedNum);
+  lno_t numComponents = 0;
+  auto labels =
+      KokkosGraph::graph_connected_components<device, rowmap_t, entries_t>(
+          symRowmap, symEntries, numComponents);
+  EXPECT_EQ(expectedNum, numComponents);
+  auto labelsHost =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), labels);
+  for (lno_t i = 0; i < numVerts; i++)
+    ASSERT_EQ(expected[i], labelsHost(i)) << "vertex " << i;
+}
+
+template <typename scalar_unused, typename lno_t, typename size_type,
+          typename device>
+void test_connected_components_zero_rows() {
+  using rowmap_t      = Kokkos::View<size_type*, device>;
+  using entries_t     = Kokkos::View<lno_t*, device>;
+  lno_t numComponents = -1;
+  auto labels =
+      KokkosGraph::graph_connected_components<device, rowmap_t, entries_t>(
+          rowmap_t(), entries_t(), numComponents);
+  EXPECT_EQ(numComponents, 0);
+  EXPECT_EQ(labels.extent(0), 0);
+}
+
+#define EXECUTE_TEST(SCALAR, ORDINAL, OFFSET, DEVICE)                                         \
+  TEST_F(TestCategory,                                                                        \
+         graph##_##graph_connected_components##_##SCALAR##_##ORDINAL##_##OFFSET##_##DEVICE) { \
+    test_connected_components<SCALAR, ORDINAL, OFFSET, DEVICE>(5000, 5000 * 20, 1000, 10);    \
+    test_connected_components<SCALAR, ORDINAL, OFFSET, DEVICE>(5000, 5000, 100, 1);           \
+    test_connected_components<SCALAR, ORDINAL, OFFSET, DEVICE>(2000, 2000, 2000, 2);          \
+    test_connected_components<SCALAR, ORDINAL, OFFSET, DEVICE>(5, 5 * 3, 5, 0);               \
+    test_connected_components_zero_rows<SCALAR, ORDINAL, OFFSET, DEVICE>();                   \
+  }
+
+#if (defined(KOKKOSKERNELS_INST_ORDINAL_INT) && \
+     defined(KOKKOSKERNELS_INST_OFFSET_INT)) || \
+    (!defined(KOKKOSKERNELS_ETI_ONLY) &&        \
+     !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+EXECUTE_TEST(double, int, int, TestExecSpace)
+#endif
+
+#if (defined(KOKKOSKERNELS_INST_ORDINAL_INT64_T) && \
+     defined(KOKKOSKERNELS_INST_OFFSET_INT)) ||     \
+    (!defined(KOKKOSKERNELS_ETI_ONLY) &&            \
+     !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+EXECUTE_TEST(double, int64_t, int, TestExecSpace)
+#endif
+
+#if (defined(KOKKOSKERNELS_INST_ORDINAL_INT) &&    \
+     defined(KOKKOSKERNELS_INST_OFFSET_SIZE_T)) || \
+    (!defined(KOKKOSKERNELS_ETI_ONLY) &&           \
+     !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+EXECUTE_TEST(double, int, size_t, TestExecSpace)
+#endif
+
+#if (defined(KOKKOSKERNELS_INST_ORDINAL_INT64_T) && \
+     defined(KOKKOSKERNELS_INST_OFFSET_SIZE_T)) ||  \
+    (!defined(KOKKOSKERNELS_ETI_ONLY) &&            \
+     !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+EXECUTE_TEST(double, int64_t, size_t, TestExecSpace)
+#endif
+
+#undef EXECUTE_TEST
@@ -139,12 +139,87 @@ void test_rcm(lno_t gridX, lno_t gridY, lno_t gridZ) {
   EXPECT_LE(rcmBW, origBW);
 }
 
+// Several paths of different lengths, interleaved with vertices that have no
+// neighbors (or only a self-loop). RCM must give every path bandwidth 1, and
+// the same ordering on every run.
+template <typename lno_t, typename size_type, typename device>
+void test_rcm_paths(lno_t numPaths) {
+  typedef
+      typename KokkosSparse::CrsMatrix<double, lno_t, device, void, size_type>
+          crsMat_t;
+  typedef typename crsMat_t::StaticCrsGraphType graph_t;
+  typedef typename graph_t::row_map_type rowmap_t;
+  typedef typename graph_t::entries_type entries_t;
+  std::vector<size_type> rowmap(1, 0);
+  std::vector<lno_t> entries;
+  lno_t numVerts = 0;
+  for (lno_t p = 0; p < numPaths; p++) {
+    // isolated vertex, then a vertex with only a self-loop
+    rowmap.push_back(entries.size());
+    entries.push_back(numVerts + 1);
+    rowmap.push_back(entries.size());
+    numVerts += 2;
+    // path of length p + 2, numbered from its middle
+    lno_t len = p + 2;
+    std::vector<lno_t> pathOrder;
+    for (lno_t i = len / 2; i < len; i++) pathOrder.push_back(i);
+    for (lno_t i = 0; i < len / 2; i++) pathOrder.push_back(i);
+    std::vector<lno_t> vertexOf(len);
+    for (lno_t i = 0; i < len; i++) vertexOf[pathOrder[i]] = numVerts + i;
+    for (lno_t i = 0; i < len; i++) {
+      lno_t pos = pathOrder[i];
+      if (pos > 0) entries.push_back(vertexOf[pos - 1]);
+      if (pos < len - 1) entries.push_back(vertexOf[pos + 1]);
+      rowmap.push_back(entries.size());
+    }
+    numVerts += len;
+  }
+  typename rowmap_t::non_const_type rowmapDev("Rowmap", numVerts + 1);
+  typename entries_t::non_const_type entriesDev("Colinds", entries.size());
+  Kokkos::deep_copy(
+      rowmapDev,
+      Kokkos::View<size_type*, Kokkos::HostSpace,
+                   Kokkos::MemoryTraits<Kokkos::Unmanaged>>(rowmap.data(),
+                                                            rowmap.size()));
+  Kokkos::deep_copy(
+      entriesDev,
+      Kokkos::View<lno_t*, Kokkos::HostSpace,
+                   Kokkos::MemoryTraits<Kokkos::Unmanaged>>(entries.data(),
+                                                            entries.size()));
+  auto rcm = KokkosGraph::Experimental::graph_rcm<device, rowmap_t, entries_t>(
+      rowmapDev, entriesDev);
+  auto rcm2 = KokkosGraph::Experimental::graph_rcm<device, rowmap_t, entries_t>(
+      rowmapDev, entriesDev);
+  auto rcmHost = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), rcm);
+  auto rcm2Host =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), rcm2);
+  decltype(rcmHost) rcmPermHost(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "RCMPerm"), numVerts);
+  std::vector<int> counts(numVerts);
+  for (lno_t i = 0; i < numVerts; i++) {
+    ASSERT_GE(rcmHost(i), 0);
+    ASSERT_LT(rcmHost(i), numVerts);
+    ASSERT_EQ(rcmHost(i), rcm2Host(i));
+    counts[rcmHost(i)]++;
+    rcmPermHost(rcmHost(i)) = i;
+  }
+  for (lno_t i = 0; i < numVerts; i++) ASSERT_EQ(counts[i], 1);
+  Kokkos::View<size_type*, Kokkos::HostSpace,
+               Kokkos::MemoryTraits<Kokkos::Unmanaged>>
+      rowmapHost(rowmap.data(), rowmap.size());
+  Kokkos::View<lno_t*, Kokkos::HostSpace,
+               Kokkos::MemoryTraits<Kokkos::Unmanaged>>
+      entriesHost(entries.data(), entries.size());
+  EXPECT_EQ(maxBandwidth(rowmapHost, entriesHost, rcmHost, rcmPermHost), 1);
+}
+
 #define EXECUTE_TEST(SCALAR, ORDINAL, OFFSET, DEVICE)                  \
   TEST_F(TestCategory,                                                 \
          graph##_##rcm##_##SCALAR##_##ORDINAL##_##OFFSET##_##DEVICE) { \
     test_rcm<ORDINAL, OFFSET, DEVICE>(6, 3, 3);                        \
     test_rcm<ORDINAL, OFFSET, DEVICE>(20, 20, 20);                     \
     test_rcm<ORDINAL, OFFSET, DEVICE>(100, 100, 1);                    \
+    test_rcm_paths<ORDINAL, OFFSET, DEVICE>(30);                       \
   }
 
 #if (defined(KOKKOSKERNELS_INST_ORDINAL_INT) && \
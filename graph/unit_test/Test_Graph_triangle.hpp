@@ -0,0 +1,210 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#include <gtest/gtest.h>
+#include <set>
+#include <vector>
+#include <Kokkos_Core.hpp>
+
+#include "KokkosGraph_TriangleCount.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosSparse_Utils.hpp"
+#include "KokkosKernels_Utils.hpp"
+#include "KokkosKernels_TestUtils.hpp"
+
+namespace Test {
+
+// Counts each triangle it is given into a view
+template <typename count_view_t>
+struct TriangleTally {
+  count_view_t tally;
+
+  template <typename lno_t>
+  KOKKOS_INLINE_FUNCTION void operator()(lno_t u, lno_t v, lno_t w) const {
+    if (u != v && v != w && u != w) Kokkos::atomic_add(&tally(), size_t(1));
+  }
+};
+
+// Triangles of each vertex, by brute force on the host
+template <typename lno_t, typename rowmap_t, typename entries_t>
+std::vector<size_t> bruteForceTriangles(lno_t numVerts,
+                                        const rowmap_t& rowmap,
+                                        const entries_t& entries) {
+  std::vector<std::set<lno_t>> adj(numVerts);
+  for (lno_t i = 0; i < numVerts; i++) {
+    for (auto j = rowmap(i); j < rowmap(i + 1); j++) {
+      lno_t nei = entries(j);
+      if (nei != i && nei < numVerts) adj[i].insert(nei);
+    }
+  }
+  std::vector<size_t> counts(numVerts, 0);
+  for (lno_t u = 0; u < numVerts; u++) {
+    for (lno_t v : adj[u]) {
+      if (v <= u) continue;
+      for (lno_t w : adj[v]) {
+        if (w <= v || !adj[u].count(w)) continue;
+        counts[u]++;
+        counts[v]++;
+        counts[w]++;
+      }
+    }
+  }
+  return counts;
+}
+
+}  // namespace Test
+
+template <typename rowmap_t, typename entries_t, typename device>
+void check_triangles(const rowmap_t& rowmap, const entries_t& entries) {
+  using lno_t          = typename entries_t::non_const_value_type;
+  using count_view_t   = Kokkos::View<size_t*, device>;
+  using coeff_view_t   = Kokkos::View<double*, device>;
+  using tally_t        = Kokkos::View<size_t, device>;
+  const lno_t numVerts = rowmap.extent(0) - 1;
+  auto rowmapHost =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), rowmap);
+  auto entriesHost =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), entries);
+  std::vector<size_t> expected =
+      Test::bruteForceTriangles(numVerts, rowmapHost, entriesHost);
+  size_t expectedTotal = 0;
+  for (size_t c : expected) expectedTotal += c;
+  expectedTotal /= 3;
+  std::vector<KokkosGraph::TriangleIntersection> algos = {
+      KokkosGraph::TRIANGLE_INTERSECT_AUTO,
+      KokkosGraph::TRIANGLE_INTERSECT_MERGE,
+      KokkosGraph::TRIANGLE_INTERSECT_HASH,
+      KokkosGraph::TRIANGLE_INTERSECT_BITMAP};
+  for (auto algo : algos) {
+    const char* name = KokkosGraph::triangle_intersection_name(algo);
+    EXPECT_EQ(expectedTotal, (KokkosGraph::triangle_count<device>(
+                                 rowmap, entries, algo)))
+        << name;
+    count_view_t counts("Counts", numVerts);
+    EXPECT_EQ(expectedTotal, (KokkosGraph::triangle_count_per_vertex<device>(
+                                 rowmap, entries, counts, algo)))
+        << name;
+    auto countsHost =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), counts);
+    for (lno_t i = 0; i < numVerts; i++)
+      EXPECT_EQ(expected[i], countsHost(i)) << name << ", vertex " << i;
+    tally_t tally("Tally");
+    EXPECT_EQ(expectedTotal,
+              (KokkosGraph::triangle_enumerate<device>(
+                  rowmap, entries, Test::TriangleTally<tally_t>{tally}, algo)))
+        << name;
+    auto tallyHost =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), tally);
+    EXPECT_EQ(expectedTotal, tallyHost()) << name;
+  }
+  coeff_view_t coeffs("Coefficients", numVerts);
+  KokkosGraph::clustering_coefficients<device>(rowmap, entries, coeffs);
+  auto coeffsHost =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), coeffs);
+  for (lno_t i = 0; i < numVerts; i++) {
+    size_t d = 0;
+    for (auto j = rowmapHost(i); j < rowmapHost(i + 1); j++) {
+      if (entriesHost(j) != i && entriesHost(j) < numVerts) d++;
+    }
+    double c = d < 2 ? 0.0 : 2.0 * expected[i] / (double(d) * (d - 1));
+    EXPECT_NEAR(c, coeffsHost(i), 1e-12) << "vertex " << i;
+  }
+}
+
+template <typename scalar_unused, typename lno_t, typename size_type,
+          typename device>
+void test_triangle_count(lno_t numVerts, size_type nnz, lno_t bandwidth,
+                         lno_t row_size_variance) {
+  using execution_space = typename device::execution_space;
+  using crsMat =
+      KokkosSparse::CrsMatrix<double, lno_t, device, void, size_type>;
+  using graph_type  = typename crsMat::StaticCrsGraphType;
+  using c_rowmap_t  = typename graph_type::row_map_type;
+  using c_entries_t = typename graph_type::entries_type;
+  using rowmap_t    = typename c_rowmap_t::non_const_type;
+  using entries_t   = typename c_entries_t::non_const_type;
+  crsMat A = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat>(
+      numVerts, numVerts, nnz, row_size_variance, bandwidth);
+  auto G = A.graph;
+  rowmap_t symRowmap;
+  entries_t symEntries;
+  KokkosKernels::Impl::symmetrize_graph_symbolic_hashmap<
+      c_rowmap_t, c_entries_t, rowmap_t, entries_t, execution_space>(
+      numVerts, G.row_map, G.entries, symRowmap, symEntries);
+  check_triangles<rowmap_t, entries_t, device>(symRowmap, symEntries);
+}
+
+// A clique of cliqueSize vertices with a path hanging off it, so that the
+// clique rows are long enough for the hash and bitmap intersections
+template <typename scalar_unused, typename lno_t, typename size_type,
+          typename device>
+void test_triangle_count_clique(lno_t cliqueSize, lno_t pathLength) {
+  using rowmap_t       = Kokkos::View<size_type*, device>;
+  using entries_t      = Kokkos::View<lno_t*, device>;
+  const lno_t numVerts = cliqueSize + pathLength;
+  std::vector<std::vector<lno_t>> adj(numVerts);
+  for (lno_t i = 0; i < cliqueSize; i++) {
+    for (lno_t j = 0; j < cliqueSize; j++) adj[i].push_back(j);
+  }
+  for (lno_t i = cliqueSize; i < numVerts; i++) {
+    adj[i].push_back(i - 1);
+    adj[i - 1].push_back(i);
+  }
+  rowmap_t rowmap;
+  entries_t entries;
+  adjacency_to_crs(adj, rowmap, entries);
+  check_triangles<rowmap_t, entries_t, device>(rowmap, entries);
+}
+
+#define EXECUTE_TEST(SCALAR, ORDINAL, OFFSET, DEVICE)                                 \
+  TEST_F(                                                                             \
+      TestCategory,                                                                   \
+      graph##_##graph_triangle_count##_##SCALAR##_##ORDINAL##_##OFFSET##_##DEVICE) {  \
+    test_triangle_count<SCALAR, ORDINAL, OFFSET, DEVICE>(2000, 2000 * 20, 200, 10);   \
+    test_triangle_count<SCALAR, ORDINAL, OFFSET, DEVICE>(50, 50 * 10, 40, 10);        \
+    test_triangle_count<SCALAR, ORDINAL, OFFSET, DEVICE>(5, 5 * 3, 5, 0);             \
+    test_triangle_count_clique<SCALAR, ORDINAL, OFFSET, DEVICE>(40, 10);              \
+  }
+
+#if (defined(KOKKOSKERNELS_INST_ORDINAL_INT) && \
+     defined(KOKKOSKERNELS_INST_OFFSET_INT)) || \
+    (!defined(KOKKOSKERNELS_ETI_ONLY) &&        \
+     !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+EXECUTE_TEST(double, int, int, TestExecSpace)
+#endif
+
+#if (defined(KOKKOSKERNELS_INST_ORDINAL_INT64_T) && \
+     defined(KOKKOSKERNELS_INST_OFFSET_INT)) ||     \
+    (!defined(KOKKOSKERNELS_ETI_ONLY) &&            \
+     !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+EXECUTE_TEST(double, int64_t, int, TestExecSpace)
+#endif
+
+#if (defined(KOKKOSKERNELS_INST_ORDINAL_INT) &&    \
+     defined(KOKKOSKERNELS_INST_OFFSET_SIZE_T)) || \
+    (!defined(KOKKOSKERNELS_ETI_ONLY) &&           \
+     !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+EXECUTE_TEST(double, int, size_t, TestExecSpace)
+#endif
+
+#if (defined(KOKKOSKERNELS_INST_ORDINAL_INT64_T) && \
+     defined(KOKKOSKERNELS_INST_OFFSET_SIZE_T)) ||  \
+    (!defined(KOKKOSKERNELS_ETI_ONLY) &&            \
+     !defined(KOKKOSKERNELS_IMPL_CHECK_ETI_CALLS))
+EXECUTE_TEST(double, int64_t, size_t, TestExecSpace)
+#endif
+
+#undef EXECUTE_TEST
@@ -231,6 +231,10 @@ crsMat_t3 run_experiment(crsMat_t crsMat, crsMat_t2 crsMat2,
     }
     // do the compression whether in 2 step, or 1 step.
     kh.get_spgemm_handle()->set_compression_steps(!params.compression2step);
+    // numeric phase by bins of row flops
+    kh.get_spgemm_handle()->set_row_binning(params.row_binning);
+    // record the contribution map in the numeric phase
+    kh.get_spgemm_handle()->set_numeric_reuse_map(params.numeric_reuse_map);
     // whether to scale the hash more. default is 1, so no scale.
     kh.get_spgemm_handle()->set_min_hash_size_scale(params.minhashscale);
     // max occupancy in 1-level LP hashes. LL hashes can be 100%
@@ -273,6 +277,16 @@ crsMat_t3 run_experiment(crsMat_t crsMat, crsMat_t2 crsMat2,
     std::cout << "mm_time:" << symbolic_time + numeric_time
               << " symbolic_time:" << symbolic_time
               << " numeric_time:" << numeric_time << std::endl;
+
+    if (params.numeric_reuse_map) {
+      Kokkos::Timer timer4;
+      spgemm_numeric(&kh, m, n, k, crsMat.graph.row_map, crsMat.graph.entries,
+                     crsMat.values, TRANPOSEFIRST, crsMat2.graph.row_map,
+                     crsMat2.graph.entries, crsMat2.values, TRANPOSESECOND,
+                     row_mapC, entriesC, valuesC);
+      ExecSpace().fence();
+      std::cout << "reuse_numeric_time:" << timer4.seconds() << std::endl;
+    }
   }
   if (verbose) {
     std::cout << "row_mapC:" << row_mapC.extent(0) << std::endl;
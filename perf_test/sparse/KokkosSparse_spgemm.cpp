@@ -54,6 +54,13 @@ void print_options() {
          "HBM. A and B will be stored DDR. To use this enable multilevel "
          "memory in Kokkos, check generate_makefile.sh"
       << std::endl;
+  std::cerr << "\t[Optional] '--rowbinning': run the numeric phase by bins "
+               "of rows of similar flop counts, each with its own accumulator"
+            << std::endl;
+  std::cerr << "\t[Optional] '--reusemap': record the position in C of each "
+               "product in the numeric phase, and time a second numeric "
+               "phase that reuses it"
+            << std::endl;
   std::cerr << "\tLoop scheduling: '--dynamic': Use this for dynamic "
                "scheduling of the loops. (Better performance most of the time)"
             << std::endl;
@@ -94,6 +101,10 @@ int parse_inputs(KokkosKernels::Experiment::Parameters& params, int argc,
 
     else if (0 == Test::string_compare_no_case(argv[i], "--compression2step")) {
       params.compression2step = true;
+    } else if (0 == Test::string_compare_no_case(argv[i], "--rowbinning")) {
+      params.row_binning = true;
+    } else if (0 == Test::string_compare_no_case(argv[i], "--reusemap")) {
+      params.numeric_reuse_map = true;
     } else if (0 == Test::string_compare_no_case(argv[i], "--shmem")) {
       params.shmemsize = atoi(getNextArg(i, argc, argv));
     } else if (0 == Test::string_compare_no_case(argv[i], "--memspaces")) {
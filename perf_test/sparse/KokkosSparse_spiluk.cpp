@@ -46,7 +46,13 @@ using namespace KokkosSparse::Experimental;
 using namespace KokkosKernels;
 using namespace KokkosKernels::Experimental;
 
-enum { DEFAULT, CUSPARSE, LVLSCHED_RP, LVLSCHED_TP1 /*, LVLSCHED_TP2*/ };
+enum {
+  DEFAULT,
+  CUSPARSE,
+  LVLSCHED_RP,
+  LVLSCHED_TP1 /*, LVLSCHED_TP2*/,
+  FIXEDPOINT
+};
 
 int test_spiluk_perf(std::vector<int> tests, std::string afilename, int kin,
                      int team_size, int /*vector_length*/,
@@ -157,6 +163,12 @@ int test_spiluk_perf(std::vector<int> tests, std::string afilename, int kin,
           kh.get_spiluk_handle()->print_algorithm();
           kh.get_spiluk_handle()->set_team_size(team_size);
           break;
+        case FIXEDPOINT:
+          kh.create_spiluk_handle(SPILUKAlgorithm::FIXED_POINT, nrows,
+                                  EXPAND_FACT * nnz * (fill_lev + 1),
+                                  EXPAND_FACT * nnz * (fill_lev + 1));
+          kh.get_spiluk_handle()->print_algorithm();
+          break;
         // case LVLSCHED_TP2:
         //  kh.create_spiluk_handle(SPILUKAlgorithm::SEQLVLSCHED_TP2, nrows,
         //  EXPAND_FACT*nnz*(fill_lev+1), EXPAND_FACT*nnz*(fill_lev+1));
@@ -474,7 +486,7 @@ void print_help_spiluk() {
   printf("Options:\n");
   printf("  --test [OPTION] : Use different kernel implementations\n");
   printf("                    Options:\n");
-  printf("                      lvlrp, lvltp1, lvltp2\n\n");
+  printf("                      lvlrp, lvltp1, lvltp2, fixedpoint\n\n");
   printf(
       "  -f [file]       : Read in Matrix Market formatted text file "
       "'file'.\n");
@@ -522,6 +534,9 @@ int main(int argc, char **argv) {
       if ((strcmp(argv[i], "lvltp1") == 0)) {
         tests.push_back(LVLSCHED_TP1);
       }
+      if ((strcmp(argv[i], "fixedpoint") == 0)) {
+        tests.push_back(FIXEDPOINT);
+      }
       /*
             if((strcmp(argv[i],"lvltp2")==0)) {
               tests.push_back( LVLSCHED_TP2 );
@@ -149,8 +149,8 @@ matrix_type generate_unbalanced_matrix(
 void print_help() {
   printf("SPMV merge benchmark code written by Luc Berger-Vergiat.\n");
   printf(
-      "The goal is to test cusSPARSE's merge algorithm on imbalanced "
-      "matrices.");
+      "The goal is to test the merge algorithm (cuSPARSE's on Cuda, the "
+      "native one otherwise) on imbalanced matrices.\n");
   printf("Options:\n");
   printf(
       "  --compare       : Compare the performance of the merge algo with the "
@@ -233,32 +233,53 @@ int main(int argc, char** argv) {
   Kokkos::initialize(argc, argv);
 
   {
-    if (std::is_same<Kokkos::Cuda, Kokkos::DefaultExecutionSpace>::value) {
-      // Note that we template the matrix with entries=lno_t and offsets=lno_t
-      // to make sure it verifies the cusparse requirements
-      using matrix_type =
-          KokkosSparse::CrsMatrix<Scalar, lno_t, Kokkos::DefaultExecutionSpace,
-                                  void, lno_t>;
-      using values_type   = typename matrix_type::values_type::non_const_type;
-      const Scalar SC_ONE = Kokkos::ArithTraits<Scalar>::one();
-      const Scalar alpha  = SC_ONE + SC_ONE;
-      const Scalar beta   = alpha + SC_ONE;
-
-      matrix_type test_matrix = generate_unbalanced_matrix<matrix_type>(
-          numRows, numEntries, numLongRows, numLongEntries);
-
-      values_type y("right hand side", test_matrix.numRows());
-      values_type x("left hand side", test_matrix.numCols());
-      Kokkos::deep_copy(x, SC_ONE);
-      Kokkos::deep_copy(y, SC_ONE);
-
-      KokkosKernels::Experimental::Controls controls;
-      controls.setParameter("algorithm", "merge");
-
-      // Perform a so called "warm-up" run
+    // Note that we template the matrix with entries=lno_t and offsets=lno_t
+    // to make sure it verifies the cusparse requirements
+    using matrix_type =
+        KokkosSparse::CrsMatrix<Scalar, lno_t, Kokkos::DefaultExecutionSpace,
+                                void, lno_t>;
+    using values_type   = typename matrix_type::values_type::non_const_type;
+    const Scalar SC_ONE = Kokkos::ArithTraits<Scalar>::one();
+    const Scalar alpha  = SC_ONE + SC_ONE;
+    const Scalar beta   = alpha + SC_ONE;
+
+    matrix_type test_matrix = generate_unbalanced_matrix<matrix_type>(
+        numRows, numEntries, numLongRows, numLongEntries);
+
+    values_type y("right hand side", test_matrix.numRows());
+    values_type x("left hand side", test_matrix.numCols());
+    Kokkos::deep_copy(x, SC_ONE);
+    Kokkos::deep_copy(y, SC_ONE);
+
+    KokkosKernels::Experimental::Controls controls;
+    controls.setParameter("algorithm", "merge");
+
+    // Perform a so called "warm-up" run
+    KokkosSparse::spmv(controls, "N", alpha, test_matrix, x, beta, y);
+
+    double min_time = 1.0e32, max_time = 0.0, avg_time = 0.0;
+    for (int iterIdx = 0; iterIdx < loop; ++iterIdx) {
+      Kokkos::Timer timer;
       KokkosSparse::spmv(controls, "N", alpha, test_matrix, x, beta, y);
+      Kokkos::fence();
+      double time = timer.seconds();
+      avg_time += time;
+      if (time > max_time) max_time = time;
+      if (time < min_time) min_time = time;
+    }
+
+    std::cout << "Merge alg             ---  min: " << min_time
+              << " max: " << max_time << " avg: " << avg_time / loop
+              << std::endl;
 
-      double min_time = 1.0e32, max_time = 0.0, avg_time = 0.0;
+    // Run the cusparse default algorithm and native kokkos-kernels algorithm
+    // then output timings for comparison
+    if (compare) {
+      controls.setParameter("algorithm", "default");
+
+      min_time = 1.0e32;
+      max_time = 0.0;
+      avg_time = 0.0;
       for (int iterIdx = 0; iterIdx < loop; ++iterIdx) {
         Kokkos::Timer timer;
         KokkosSparse::spmv(controls, "N", alpha, test_matrix, x, beta, y);
@@ -269,56 +290,30 @@ int main(int argc, char** argv) {
         if (time < min_time) min_time = time;
       }
 
-      std::cout << "cuSPARSE Merge alg    ---  min: " << min_time
+      std::cout << "Default alg           ---  min: " << min_time
                 << " max: " << max_time << " avg: " << avg_time / loop
                 << std::endl;
 
-      // Run the cusparse default algorithm and native kokkos-kernels algorithm
-      // then output timings for comparison
-      if (compare) {
-        controls.setParameter("algorithm", "default");
-
-        min_time = 1.0e32;
-        max_time = 0.0;
-        avg_time = 0.0;
-        for (int iterIdx = 0; iterIdx < loop; ++iterIdx) {
-          Kokkos::Timer timer;
-          KokkosSparse::spmv(controls, "N", alpha, test_matrix, x, beta, y);
-          Kokkos::fence();
-          double time = timer.seconds();
-          avg_time += time;
-          if (time > max_time) max_time = time;
-          if (time < min_time) min_time = time;
-        }
-
-        std::cout << "cuSPARSE Default alg  ---  min: " << min_time
-                  << " max: " << max_time << " avg: " << avg_time / loop
-                  << std::endl;
-
-        controls.setParameter("algorithm", "native");
-
-        min_time = 1.0e32;
-        max_time = 0.0;
-        avg_time = 0.0;
-        for (int iterIdx = 0; iterIdx < loop; ++iterIdx) {
-          Kokkos::Timer timer;
-          // KokkosSparse::spmv(controls, "N", alpha, test_matrix, x, beta, y);
-          KokkosSparse::Impl::spmv_beta<matrix_type, values_type, values_type,
-                                        1>(controls, "N", alpha, test_matrix, x,
-                                           beta, y);
-          Kokkos::fence();
-          double time = timer.seconds();
-          avg_time += time;
-          if (time > max_time) max_time = time;
-          if (time < min_time) min_time = time;
-        }
-
-        std::cout << "Kokkos Native alg     ---  min: " << min_time
-                  << " max: " << max_time << " avg: " << avg_time / loop
-                  << std::endl;
+      controls.setParameter("algorithm", "native");
+
+      min_time = 1.0e32;
+      max_time = 0.0;
+      avg_time = 0.0;
+      for (int iterIdx = 0; iterIdx < loop; ++iterIdx) {
+        Kokkos::Timer timer;
+        // KokkosSparse::spmv(controls, "N", alpha, test_matrix, x, beta, y);
+        KokkosSparse::Impl::spmv_beta<matrix_type, values_type, values_type,
+                                      1>(controls, "N", alpha, test_matrix, x,
+                                         beta, y);
+        Kokkos::fence();
+        double time = timer.seconds();
+        avg_time += time;
+        if (time > max_time) max_time = time;
+        if (time < min_time) min_time = time;
       }
-    } else {
-      std::cout << "The default execution space is not Cuda, nothing to do!"
+
+      std::cout << "Kokkos Native alg     ---  min: " << min_time
+                << " max: " << max_time << " avg: " << avg_time / loop
                 << std::endl;
     }
   }
@@ -57,6 +57,8 @@ enum {
   LVLSCHED_RP,
   LVLSCHED_TP1,
   /*LVLSCHED_TP2,*/ LVLSCHED_TP1CHAIN,
+  LVLSCHED_SYNCFREE,
+  JACOBI_SWEEPS,
   CUSPARSE_K
 };
 
@@ -101,7 +103,8 @@ int test_sptrsv_perf(std::vector<int> tests, const std::string &lfilename,
                      const std::string &ufilename, const int team_size,
                      const int vector_length, const int /*idx_offset*/,
                      const int loop, const int chain_threshold = 0,
-                     const float /*dense_row_percent*/ = -1.0) {
+                     const float /*dense_row_percent*/ = -1.0,
+                     const int merge_threshold = -1) {
   typedef default_scalar scalar_t;
   typedef default_lno_t lno_t;
   typedef default_size_type size_type;
@@ -255,6 +258,18 @@ int test_sptrsv_perf(std::vector<int> tests, const std::string &lfilename,
             kh.get_sptrsv_handle()->set_vector_size(vector_length);
           kh.get_sptrsv_handle()->print_algorithm();
           break;
+        case LVLSCHED_SYNCFREE:
+          kh.create_sptrsv_handle(SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE, nrows,
+                                  is_lower_tri);
+          if (merge_threshold != -1)
+            kh.get_sptrsv_handle()->set_merge_threshold(merge_threshold);
+          kh.get_sptrsv_handle()->print_algorithm();
+          break;
+        case JACOBI_SWEEPS:
+          kh.create_sptrsv_handle(SPTRSVAlgorithm::JACOBI, nrows,
+                                  is_lower_tri);
+          kh.get_sptrsv_handle()->print_algorithm();
+          break;
           /*
                 case LVLSCHED_TP2:
                   kh.create_sptrsv_handle(SPTRSVAlgorithm::SEQLVLSCHED_TP2,
@@ -663,6 +678,18 @@ int test_sptrsv_perf(std::vector<int> tests, const std::string &lfilename,
             kh.get_sptrsv_handle()->set_vector_size(vector_length);
           kh.get_sptrsv_handle()->print_algorithm();
           break;
+        case LVLSCHED_SYNCFREE:
+          kh.create_sptrsv_handle(SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE, nrows,
+                                  is_lower_tri);
+          if (merge_threshold != -1)
+            kh.get_sptrsv_handle()->set_merge_threshold(merge_threshold);
+          kh.get_sptrsv_handle()->print_algorithm();
+          break;
+        case JACOBI_SWEEPS:
+          kh.create_sptrsv_handle(SPTRSVAlgorithm::JACOBI, nrows,
+                                  is_lower_tri);
+          kh.get_sptrsv_handle()->print_algorithm();
+          break;
           /*
                 case LVLSCHED_TP2:
                   kh.create_sptrsv_handle(SPTRSVAlgorithm::SEQLVLSCHED_TP2,
@@ -938,8 +965,8 @@ void print_help_sptrsv() {
   printf("  --test [OPTION] : Use different kernel implementations\n");
   printf("                    Options:\n");
   printf(
-      "                      lvlrp, lvltp1, lvltp2, lvltp1chain, lvldensetp1, "
-      "lvldensetp2\n\n");
+      "                      lvlrp, lvltp1, lvltp2, lvltp1chain, lvlsyncfree, "
+      "jacobi, lvldensetp1, lvldensetp2\n\n");
   printf("                      cusparse           (Vendor Libraries)\n\n");
   printf(
       "  -lf [file]      : Read in Matrix Market formatted text file "
@@ -958,6 +985,9 @@ void print_help_sptrsv() {
   printf(
       "  -ct [V]         : Chain threshold: Only has effect of lvltp1chain "
       "algorithm.\n");
+  printf(
+      "  -mt [V]         : Merge threshold: Only has effect of lvlsyncfree "
+      "algorithm.\n");
   printf(
       "  -dr [V]         : Dense row percent (as float): Only has effect of "
       "lvldensetp1 algorithm.\n");
@@ -983,6 +1013,7 @@ int main(int argc, char **argv) {
   int idx_offset          = 0;
   int loop                = 1;
   int chain_threshold     = 0;
+  int merge_threshold     = -1;
   float dense_row_percent = -1.0;
   // int schedule=AUTO;
 
@@ -1003,6 +1034,12 @@ int main(int argc, char **argv) {
       if ((strcmp(argv[i], "lvltp1chain") == 0)) {
         tests.push_back(LVLSCHED_TP1CHAIN);
       }
+      if ((strcmp(argv[i], "lvlsyncfree") == 0)) {
+        tests.push_back(LVLSCHED_SYNCFREE);
+      }
+      if ((strcmp(argv[i], "jacobi") == 0)) {
+        tests.push_back(JACOBI_SWEEPS);
+      }
       /*
       if((strcmp(argv[i],"lvltp2")==0)) {
         tests.push_back( LVLSCHED_TP2 );
@@ -1036,6 +1073,10 @@ int main(int argc, char **argv) {
       chain_threshold = atoi(argv[++i]);
       continue;
     }
+    if ((strcmp(argv[i], "-mt") == 0)) {
+      merge_threshold = atoi(argv[++i]);
+      continue;
+    }
     if ((strcmp(argv[i], "-dr") == 0)) {
       dense_row_percent = atof(argv[++i]);
       continue;
@@ -1082,7 +1123,8 @@ int main(int argc, char **argv) {
   {
     int total_errors =
         test_sptrsv_perf(tests, lfilename, ufilename, team_size, vector_length,
-                         idx_offset, loop, chain_threshold, dense_row_percent);
+                         idx_offset, loop, chain_threshold, dense_row_percent,
+                         merge_threshold);
 
     if (total_errors == 0)
       printf("Kokkos::SPTRSV Test: Passed\n");
@@ -0,0 +1,473 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+*/
+
+#ifndef KOKKOSSPARSE_IMPL_CG_HPP_
+#define KOKKOSSPARSE_IMPL_CG_HPP_
+
+/// \file KokkosSparse_cg_impl.hpp
+/// \brief Implementation of the (preconditioned) conjugate gradient solver.
+
+#include <KokkosKernels_config.h>
+#include <Kokkos_ArithTraits.hpp>
+#include <Kokkos_InnerProductSpaceTraits.hpp>
+#include <KokkosSparse_cg_handle.hpp>
+#include <KokkosBlas.hpp>
+#include <KokkosSparse_spmv.hpp>
+#include <KokkosSparse_spmv_dot.hpp>
+#include <KokkosSparse_Preconditioner.hpp>
+#include "KokkosKernels_Error.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+namespace Experimental {
+
+/// \brief The inner products of a single-reduction or pipelined CG
+///   iteration, computed in one pass: (r, u), (w, u) and (r, r).
+template <class Vector>
+struct CgDotsFunctor {
+  typedef typename Vector::non_const_value_type scalar_t;
+  typedef Kokkos::Details::InnerProductSpaceTraits<scalar_t> IPT;
+  typedef scalar_t value_type[];
+
+  const unsigned value_count;
+  Vector r, u, w;
+
+  CgDotsFunctor(const Vector& r_, const Vector& u_, const Vector& w_)
+      : value_count(3), r(r_), u(u_), w(w_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void init(value_type dst) const {
+    for (unsigned k = 0; k < value_count; k++)
+      dst[k] = Kokkos::ArithTraits<scalar_t>::zero();
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void join(value_type dst, const value_type src) const {
+    for (unsigned k = 0; k < value_count; k++) dst[k] += src[k];
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_t i, value_type sums) const {
+    const scalar_t ui = u(i);
+    sums[0] += IPT::dot(r(i), ui);
+    sums[1] += IPT::dot(w(i), ui);
+    sums[2] += IPT::dot(r(i), r(i));
+  }
+};
+
+/// \brief All the vector updates of a single-reduction CG iteration in one
+///   pass: p = u + beta*p, s = w + beta*s, x += alpha*p, r -= alpha*s.
+///
+/// u may alias r (no preconditioner): it is read before r is updated.
+template <class Vector, class XVector>
+struct CgSingleReductionUpdateFunctor {
+  typedef typename Vector::non_const_value_type scalar_t;
+
+  scalar_t alpha, beta;
+  Vector u, w, p, s, r;
+  XVector x;
+
+  CgSingleReductionUpdateFunctor(const scalar_t alpha_, const scalar_t beta_,
+                                 const Vector& u_, const Vector& w_,
+                                 const Vector& p_, const Vector& s_,
+                                 const Vector& r_, const XVector& x_)
+      : alpha(alpha_),
+        beta(beta_),
+        u(u_),
+        w(w_),
+        p(p_),
+        s(s_),
+        r(r_),
+        x(x_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_t i) const {
+    const scalar_t pi = u(i) + beta * p(i);
+    const scalar_t si = w(i) + beta * s(i);
+    p(i)              = pi;
+    s(i)              = si;
+    x(i) += alpha * pi;
+    r(i) -= alpha * si;
+  }
+};
+
+/// \brief All the vector updates of a pipelined CG iteration in one pass:
+///   z = n + beta*z, q = m + beta*q, s = w + beta*s, p = u + beta*p,
+///   x += alpha*p, r -= alpha*s, u -= alpha*q, w -= alpha*z.
+///
+/// Without preconditioner (\c precond false) u is r, m is w and q is s, so
+/// the updates of q and u are skipped.
+template <class Vector, class XVector, bool precond>
+struct CgPipelinedUpdateFunctor {
+  typedef typename Vector::non_const_value_type scalar_t;
+
+  scalar_t alpha, beta;
+  Vector m, n, z, q, s, p, u, w, r;
+  XVector x;
+
+  CgPipelinedUpdateFunctor(const scalar_t alpha_, const scalar_t beta_,
+                           const Vector& m_, const Vector& n_,
+                           const Vector& z_, const Vector& q_,
+                           const Vector& s_, const Vector& p_,
+                           const Vector& u_, const Vector& w_,
+                           const Vector& r_, const XVector& x_)
+      : alpha(alpha_),
+        beta(beta_),
+        m(m_),
+        n(n_),
+        z(z_),
+        q(q_),
+        s(s_),
+        p(p_),
+        u(u_),
+        w(w_),
+        r(r_),
+        x(x_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_t i) const {
+    const scalar_t wi = w(i);
+    const scalar_t zi = n(i) + beta * z(i);
+    const scalar_t si = wi + beta * s(i);
+    const scalar_t pi = u(i) + beta * p(i);
+    z(i)              = zi;
+    s(i)              = si;
+    p(i)              = pi;
+    x(i) += alpha * pi;
+    r(i) -= alpha * si;
+    w(i) = wi - alpha * zi;
+    if constexpr (precond) {
+      const scalar_t qi = m(i) + beta * q(i);
+      q(i)              = qi;
+      u(i) -= alpha * qi;
+    }
+  }
+};
+
+template <class CGHandle>
+struct CgWrap {
+  //
+  // Useful types
+  //
+  using execution_space       = typename CGHandle::execution_space;
+  using index_t               = typename CGHandle::nnz_lno_t;
+  using size_type             = typename CGHandle::size_type;
+  using scalar_t              = typename CGHandle::nnz_scalar_t;
+  using HandleDeviceValueType = typename CGHandle::nnz_value_view_t;
+  using karith                = typename Kokkos::ArithTraits<scalar_t>;
+  using ST                    = typename karith::val_type;
+  using MT                    = typename karith::mag_type;
+  using range_policy          = Kokkos::RangePolicy<execution_space>;
+  using Flag                  = typename CGHandle::Flag;
+
+  /**
+   * The main cg function. Solves Ax = b for Hermitian positive definite A
+   * (and preconditioner), starting from the initial guess in X.
+   */
+  template <class AMatrix, class BType, class XType>
+  static void cg(
+      CGHandle& thandle, const AMatrix& A, const BType& B, XType& X,
+      KokkosSparse::Experimental::Preconditioner<AMatrix>* precond = nullptr) {
+    Kokkos::Profiling::pushRegion("CG::TotalTime:");
+
+    const auto n        = A.numRows();
+    const auto variant  = thandle.get_variant();
+    const auto maxIters = thandle.get_max_iters();
+    const MT tol        = thandle.get_tol();
+    const bool verbose  = thandle.get_verbose();
+
+    if (verbose) {
+      std::cout << "Starting CG with..." << std::endl;
+      std::cout << "  n:        " << n << std::endl;
+      std::cout << "  maxIters: " << maxIters << std::endl;
+      std::cout << "  tol:      " << tol << std::endl;
+      std::cout << "  variant:  "
+                << (variant == CGHandle::Standard
+                        ? "Standard"
+                        : (variant == CGHandle::SingleReduction
+                               ? "SingleReduction"
+                               : "Pipelined"))
+                << std::endl;
+    }
+
+    // Initial residual r = b - Ax
+    HandleDeviceValueType r(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "r"), n);
+    Kokkos::deep_copy(r, B);
+    const MT nrmB = KokkosBlas::nrm2(B);
+    MT nrmR = KokkosSparse::spmv_nrm2("N", -karith::one(), A, X, karith::one(),
+                                      r);
+    if (verbose) {
+      std::cout << "Initial relative residual is: "
+                << (nrmB != 0 ? nrmR / nrmB : nrmR) << std::endl;
+    }
+
+    int numIters = 0;
+    Flag flag    = Flag::NoConv;
+    if (nrmB == 0) {
+      // The solution is zero
+      Kokkos::deep_copy(X, karith::zero());
+      nrmR = 0;
+      flag = Flag::Conv;
+    } else if (variant == CGHandle::Standard) {
+      flag = standard(maxIters, tol, verbose, A, X, precond, r, nrmB,
+                      numIters);
+    } else if (variant == CGHandle::SingleReduction) {
+      flag = single_reduction(maxIters, tol, verbose, A, X, precond, r, nrmB,
+                              numIters);
+    } else if (precond) {
+      flag = pipelined<true>(maxIters, tol, verbose, A, X, precond, r, nrmB,
+                             numIters);
+    } else {
+      flag = pipelined<false>(maxIters, tol, verbose, A, X, precond, r, nrmB,
+                              numIters);
+    }
+
+    // The recurrences only update r, which drifts away from b - Ax in
+    // finite precision: report the true residual
+    MT relRes = 0;
+    if (nrmB != 0) {
+      Kokkos::deep_copy(r, B);
+      nrmR   = KokkosSparse::spmv_nrm2("N", -karith::one(), A, X,
+                                       karith::one(), r);
+      relRes = nrmR / nrmB;
+      if (flag == Flag::Conv && relRes >= tol) flag = Flag::LOA;
+    }
+
+    if (verbose) {
+      std::cout << "Ending relative residual is: " << relRes << std::endl;
+      if (flag == Flag::Conv) {
+        std::cout << "Solver converged! " << std::endl;
+      } else if (flag == Flag::LOA) {
+        std::cout << "Solver experienced a loss of accuracy." << std::endl;
+      } else {
+        std::cout << "Solver did not converge." << std::endl;
+      }
+      std::cout << "The solver completed " << numIters << " iterations."
+                << std::endl;
+    }
+
+    thandle.set_stats(numIters, relRes, flag);
+
+    Kokkos::Profiling::popRegion();
+  }  // end cg
+
+ private:
+  static void print_residual(bool verbose, int iter, MT relRes) {
+    if (verbose) {
+      std::cout << "Relative residual for iteration " << iter
+                << " is: " << relRes << std::endl;
+    }
+  }
+
+  static bool is_breakdown(const ST& denom) {
+    return !(karith::abs(denom) > 0) || karith::isNan(denom) ||
+           karith::isInf(denom);
+  }
+
+  // Textbook PCG. The product A*p is fused with (p, Ap), the other
+  // reductions are separate kernels.
+  template <class AMatrix, class XType>
+  static Flag standard(
+      const size_type maxIters, const MT tol, const bool verbose,
+      const AMatrix& A, XType& X,
+      KokkosSparse::Experimental::Preconditioner<AMatrix>* precond,
+      const HandleDeviceValueType& r, const MT nrmB, int& numIters) {
+    const ST one = karith::one();
+    const auto n = A.numRows();
+    HandleDeviceValueType p(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "p"), n);
+    HandleDeviceValueType q(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "q"), n);
+    HandleDeviceValueType z = r;
+    if (precond) {
+      z = HandleDeviceValueType(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, "z"), n);
+      precond->apply(r, z);
+    }
+    Kokkos::deep_copy(p, z);
+    ST rz = KokkosBlas::dot(r, z);
+    MT relRes =
+        (precond ? KokkosBlas::nrm2(r) : karith::sqrt(karith::abs(rz))) /
+        nrmB;
+
+    while (relRes >= tol) {
+      if (size_type(numIters) >= maxIters) return Flag::NoConv;
+      // q = Ap and (q, p) in one pass
+      const ST pq = KokkosSparse::spmv_dot("N", one, A, p, karith::zero(), q,
+                                           p);
+      if (is_breakdown(pq)) return Flag::LOA;
+      const ST alpha = rz / pq;
+      KokkosBlas::axpy(alpha, p, X);   // x = x + alpha*p
+      KokkosBlas::axpy(-alpha, q, r);  // r = r - alpha*q
+      numIters++;
+
+      ST rzNew;
+      if (precond) {
+        precond->apply(r, z);
+        rzNew  = KokkosBlas::dot(r, z);
+        relRes = KokkosBlas::nrm2(r) / nrmB;
+      } else {
+        rzNew  = KokkosBlas::dot(r, r);
+        relRes = karith::sqrt(karith::abs(rzNew)) / nrmB;
+      }
+      print_residual(verbose, numIters, relRes);
+      if (is_breakdown(rz)) return Flag::LOA;
+      const ST beta = rzNew / rz;
+      rz            = rzNew;
+      KokkosBlas::axpby(one, z, beta, p);  // p = z + beta*p
+    }
+    return Flag::Conv;
+  }
+
+  // Chronopoulos and Gear, "s-step iterative methods for symmetric linear
+  // systems", 1989: with s = Ap and w = Au kept by recurrences, (r, u) and
+  // (w, u) give both alpha and beta, so they are reduced together with the
+  // residual norm.
+  template <class AMatrix, class XType>
+  static Flag single_reduction(
+      const size_type maxIters, const MT tol, const bool verbose,
+      const AMatrix& A, XType& X,
+      KokkosSparse::Experimental::Preconditioner<AMatrix>* precond,
+      const HandleDeviceValueType& r, const MT nrmB, int& numIters) {
+    const auto n = A.numRows();
+    HandleDeviceValueType u = r;
+    if (precond) {
+      u = HandleDeviceValueType(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, "u"), n);
+    }
+    HandleDeviceValueType w(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "w"), n);
+    HandleDeviceValueType p("p", n), s("s", n);
+    Kokkos::View<ST*, Kokkos::HostSpace> dots("dots", 3);
+
+    ST gammaOld = karith::zero(), alphaOld = karith::zero();
+    for (;;) {
+      if (precond) precond->apply(r, u);
+      KokkosSparse::spmv("N", karith::one(), A, u, karith::zero(), w);
+      Kokkos::parallel_reduce("CG::single_reduction::dots",
+                              range_policy(0, n),
+                              CgDotsFunctor<HandleDeviceValueType>(r, u, w),
+                              dots);
+      const ST gamma  = dots(0);
+      const ST delta  = dots(1);
+      const MT relRes = karith::sqrt(karith::abs(dots(2))) / nrmB;
+      if (numIters) print_residual(verbose, numIters, relRes);
+      if (relRes < tol) return Flag::Conv;
+      if (size_type(numIters) >= maxIters) return Flag::NoConv;
+
+      ST beta  = karith::zero();
+      ST denom = delta;
+      if (numIters) {
+        if (is_breakdown(gammaOld) || is_breakdown(alphaOld))
+          return Flag::LOA;
+        beta  = gamma / gammaOld;
+        denom = delta - beta * gamma / alphaOld;
+      }
+      if (is_breakdown(denom)) return Flag::LOA;
+      const ST alpha = gamma / denom;
+
+      Kokkos::parallel_for(
+          "CG::single_reduction::update", range_policy(0, n),
+          CgSingleReductionUpdateFunctor<HandleDeviceValueType, XType>(
+              alpha, beta, u, w, p, s, r, X));
+      numIters++;
+      gammaOld = gamma;
+      alphaOld = alpha;
+    }
+  }
+
+  // Ghysels and Vanroose, "Hiding global synchronization latency in the
+  // preconditioned conjugate gradient algorithm", 2014. The reduction of
+  // an iteration is launched asynchronously (its result is a device view)
+  // before the preconditioner and spmv of the same iteration, and only
+  // waited for after them.
+  template <bool has_precond, class AMatrix, class XType>
+  static Flag pipelined(
+      const size_type maxIters, const MT tol, const bool verbose,
+      const AMatrix& A, XType& X,
+      KokkosSparse::Experimental::Preconditioner<AMatrix>* precond,
+      const HandleDeviceValueType& r, const MT nrmB, int& numIters) {
+    const ST one  = karith::one();
+    const ST zero = karith::zero();
+    const auto n  = A.numRows();
+    HandleDeviceValueType u = r;
+    HandleDeviceValueType w(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "w"), n);
+    HandleDeviceValueType m = w;
+    HandleDeviceValueType nv(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "n"), n);
+    HandleDeviceValueType z("z", n), s("s", n), p("p", n), q = s;
+    if (has_precond) {
+      u = HandleDeviceValueType(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, "u"), n);
+      m = HandleDeviceValueType(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, "m"), n);
+      q = HandleDeviceValueType("q", n);
+      precond->apply(r, u);
+    }
+    KokkosSparse::spmv("N", one, A, u, zero, w);
+
+    Kokkos::View<ST*, typename HandleDeviceValueType::memory_space> dots(
+        "dots", 3);
+    auto dots_h = Kokkos::create_mirror_view(dots);
+
+    ST gammaOld = zero, alphaOld = zero;
+    for (;;) {
+      // Not waited for until after m = Mw and n = Am
+      Kokkos::parallel_reduce("CG::pipelined::dots", range_policy(0, n),
+                              CgDotsFunctor<HandleDeviceValueType>(r, u, w),
+                              dots);
+      if (has_precond) precond->apply(w, m);
+      KokkosSparse::spmv("N", one, A, m, zero, nv);
+      Kokkos::deep_copy(dots_h, dots);
+
+      const ST gamma  = dots_h(0);
+      const ST delta  = dots_h(1);
+      const MT relRes = karith::sqrt(karith::abs(dots_h(2))) / nrmB;
+      if (numIters) print_residual(verbose, numIters, relRes);
+      if (relRes < tol) return Flag::Conv;
+      if (size_type(numIters) >= maxIters) return Flag::NoConv;
+
+      ST beta  = zero;
+      ST denom = delta;
+      if (numIters) {
+        if (is_breakdown(gammaOld) || is_breakdown(alphaOld))
+          return Flag::LOA;
+        beta  = gamma / gammaOld;
+        denom = delta - beta * gamma / alphaOld;
+      }
+      if (is_breakdown(denom)) return Flag::LOA;
+      const ST alpha = gamma / denom;
+
+      Kokkos::parallel_for(
+          "CG::pipelined::update", range_policy(0, n),
+          CgPipelinedUpdateFunctor<HandleDeviceValueType, XType, has_precond>(
+              alpha, beta, m, nv, z, q, s, p, u, w, r, X));
+      numIters++;
+      gammaOld = gamma;
+      alphaOld = alpha;
+    }
+  }
+};  // struct CgWrap
+
+}  // namespace Experimental
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif
@@ -0,0 +1,82 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+#ifndef KOKKOSSPARSE_CHEBYSHEV_IMPL_HPP_
+#define KOKKOSSPARSE_CHEBYSHEV_IMPL_HPP_
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_ArithTraits.hpp>
+#include "KokkosSparse_OrdinalTraits.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+// Offset of the diagonal entry in each row of A, invalid() if the row has
+// none: the offsets taken by getDiagCopy
+template <typename crs_t, typename offsets_t>
+struct ChebyshevDiagOffsets {
+  using ordinal_t = typename crs_t::non_const_ordinal_type;
+  using offset_t  = typename offsets_t::non_const_value_type;
+
+  crs_t A;
+  offsets_t offsets;
+
+  KOKKOS_INLINE_FUNCTION void operator()(const ordinal_t row) const {
+    offset_t offset = KokkosSparse::OrdinalTraits<offset_t>::invalid();
+    const auto rowView = A.rowConst(row);
+    for (ordinal_t k = 0; k < rowView.length; k++) {
+      if (rowView.colidx(k) == row) {
+        offset = k;
+        break;
+      }
+    }
+    offsets(row) = offset;
+  }
+};
+
+// diag(i) = 1 / diag(i), counting the zero entries, which have no inverse
+template <typename diag_t, typename ordinal_t>
+struct ChebyshevInvertDiag {
+  using scalar_t = typename diag_t::non_const_value_type;
+  using karith   = Kokkos::ArithTraits<scalar_t>;
+
+  diag_t diag;
+
+  KOKKOS_INLINE_FUNCTION void operator()(const ordinal_t i,
+                                         ordinal_t& zeros) const {
+    if (diag(i) == karith::zero())
+      zeros++;
+    else
+      diag(i) = karith::one() / diag(i);
+  }
+};
+
+// Deterministic start vector of the power iteration, far from any
+// particular eigenvector of a stencil
+template <typename vector_t, typename ordinal_t>
+struct ChebyshevStartVector {
+  using scalar_t = typename vector_t::non_const_value_type;
+
+  vector_t x;
+
+  KOKKOS_INLINE_FUNCTION void operator()(const ordinal_t i) const {
+    x(i) = scalar_t(1) + scalar_t((size_t(i) * 7919) % 97) / scalar_t(97);
+  }
+};
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif
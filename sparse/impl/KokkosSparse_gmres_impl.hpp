@@ -28,6 +28,7 @@
 #include <KokkosBlas.hpp>
 #include <KokkosBlas3_trsm_impl.hpp>
 #include <KokkosSparse_spmv.hpp>
+#include <KokkosSparse_spmv_dot.hpp>
 #include <KokkosSparse_Preconditioner.hpp>
 #include "KokkosKernels_Error.hpp"
 
@@ -35,6 +36,94 @@ namespace KokkosSparse {
 namespace Impl {
 namespace Experimental {
 
+/// \brief The scalar type of the inner solves of mixed precision GMRES.
+/// Scalar types without a lower precision are solved in working precision.
+template <class scalar_t>
+struct GmresLowPrecision {
+  using type = scalar_t;
+};
+
+template <>
+struct GmresLowPrecision<double> {
+  using type = float;
+};
+
+template <>
+struct GmresLowPrecision<Kokkos::complex<double>> {
+  using type = Kokkos::complex<float>;
+};
+
+/// \brief y = beta * y + alpha * x, where x and y may have different scalar
+/// types. The arithmetic is done in the scalar type of alpha.
+template <class XView, class YView, class ST>
+struct GmresCastAxpbyFunctor {
+  using y_t = typename YView::non_const_value_type;
+
+  XView x;
+  YView y;
+  ST alpha, beta;
+
+  GmresCastAxpbyFunctor(const XView& x_, const YView& y_, const ST alpha_,
+                        const ST beta_)
+      : x(x_), y(y_), alpha(alpha_), beta(beta_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int64_t i) const {
+    ST v = alpha * ST(x(i));
+    if (beta != Kokkos::ArithTraits<ST>::zero()) v += beta * ST(y(i));
+    y(i) = y_t(v);
+  }
+};
+
+template <class ExecSpace, class XView, class YView, class ST>
+void gmres_cast_axpby(const XView& x, const YView& y, const ST alpha,
+                      const ST beta) {
+  Kokkos::parallel_for(
+      "KokkosSparse::gmres::cast_axpby",
+      Kokkos::RangePolicy<ExecSpace>(0, x.extent(0)),
+      GmresCastAxpbyFunctor<XView, YView, ST>(x, y, alpha, beta));
+}
+
+/// \brief Applies a preconditioner of the working precision matrix in the
+/// low precision inner solves of mixed precision GMRES, converting the
+/// vectors on the way in and out.
+template <class LoMatrix, class AMatrix>
+class GmresLowPrecisionPrec
+    : public KokkosSparse::Experimental::Preconditioner<LoMatrix> {
+  using lo_t      = typename LoMatrix::non_const_value_type;
+  using hi_t      = typename AMatrix::non_const_value_type;
+  using EXSP      = typename LoMatrix::execution_space;
+  using hi_view_t = Kokkos::View<hi_t *, EXSP>;
+
+  KokkosSparse::Experimental::Preconditioner<AMatrix> *prec;
+  hi_view_t xHi, yHi;
+
+ public:
+  GmresLowPrecisionPrec(
+      KokkosSparse::Experimental::Preconditioner<AMatrix> *prec_,
+      const size_t n)
+      : prec(prec_),
+        xHi(Kokkos::view_alloc(Kokkos::WithoutInitializing, "xHi"), n),
+        yHi(Kokkos::view_alloc(Kokkos::WithoutInitializing, "yHi"), n) {}
+
+  void apply(const Kokkos::View<const lo_t *, EXSP> &X,
+             const Kokkos::View<lo_t *, EXSP> &Y, const char transM[] = "N",
+             lo_t alpha = Kokkos::ArithTraits<lo_t>::one(),
+             lo_t beta  = Kokkos::ArithTraits<lo_t>::zero()) const override {
+    gmres_cast_axpby<EXSP>(X, xHi, Kokkos::ArithTraits<hi_t>::one(),
+                           Kokkos::ArithTraits<hi_t>::zero());
+    prec->apply(xHi, yHi, transM);
+    gmres_cast_axpby<EXSP>(yHi, Y, hi_t(alpha), hi_t(beta));
+  }
+
+  void setParameters() override {}
+  void initialize() override {}
+  bool isInitialized() const override { return prec->isInitialized(); }
+  void compute() override {}
+  bool isComputed() const override { return prec->isComputed(); }
+  bool hasTransposeApply() const override { return prec->hasTransposeApply(); }
+};
+
 template <class GmresHandle>
 struct GmresWrap {
   //
@@ -50,6 +139,7 @@ struct GmresWrap {
   using HandleDevice2dValueType = typename GmresHandle::nnz_value_view2d_t;
   using karith                  = typename Kokkos::ArithTraits<scalar_t>;
   using device_t                = typename HandleDeviceEntriesType::device_type;
+  using low_scalar_t            = typename GmresLowPrecision<scalar_t>::type;
 
   /**
    * The main gmres numeric function. Copied with slight modifications from
@@ -64,6 +154,17 @@ struct GmresWrap {
     using MT                  = typename karith::mag_type;
     using HandleHostValueType = typename HandleDeviceValueType::HostMirror;
 
+    if (thandle.get_precision() == GmresHandle::Precision::Mixed) {
+      if constexpr (!std::is_same<low_scalar_t, scalar_t>::value) {
+        gmres_ir(thandle, A, B, X, precond);
+        return;
+      } else {
+        throw std::invalid_argument(
+            "gmres: Mixed precision needs a lower precision scalar type, "
+            "only double and complex double have one.");
+      }
+    }
+
     ST one  = karith::one();
     ST zero = karith::zero();
 
@@ -75,8 +176,14 @@ struct GmresWrap {
     const auto maxRestart = thandle.get_max_restart();
     const auto tol        = thandle.get_tol();
     const auto ortho      = thandle.get_ortho();
+    const int s           = std::min<int>(thandle.get_s_step(), m);
     const auto verbose    = thandle.get_verbose();
 
+    if (ortho == GmresHandle::Ortho::SStep && s <= 0) {
+      throw std::invalid_argument(
+          "gmres: Please choose s_step greater than zero.");
+    }
+
     bool converged     = false;
     size_type cycle    = 0;  // How many times have we restarted?
     size_type numIters = 0;  // Number of iterations within the cycle before
@@ -90,8 +197,14 @@ struct GmresWrap {
       std::cout << "  maxRestart: " << maxRestart << std::endl;
       std::cout << "  tol:        " << tol << std::endl;
       std::cout << "  ortho:      "
-                << ((ortho == GmresHandle::Ortho::CGS2) ? "CGS2" : "MGS")
+                << ((ortho == GmresHandle::Ortho::CGS2)
+                        ? "CGS2"
+                        : ((ortho == GmresHandle::Ortho::MGS) ? "MGS"
+                                                              : "SStep"))
                 << std::endl;
+      if (ortho == GmresHandle::Ortho::SStep) {
+        std::cout << "  s_step:     " << s << std::endl;
+      }
     }
 
     // Make tmp work views
@@ -122,14 +235,19 @@ struct GmresWrap {
 
     auto H_h = Kokkos::create_mirror_view(H);  // Make H into a host view of H.
 
+    // The s-step variant keeps the Hessenberg matrix before the Givens
+    // rotations, as the next block of columns is recovered from it.
+    SStepWork sstep;
+    if (ortho == GmresHandle::Ortho::SStep) sstep = SStepWork(n, m, s);
+    int sstepBlocks = 0, sstepFallbacks = 0;
+
     // Compute initial residuals:
     nrmB = KokkosBlas::nrm2(B);
     Kokkos::deep_copy(Res, B);
 
     // This is initial true residual, so don't need prec here.
-    KokkosSparse::spmv("N", one, A, X, zero, Wj);  // wj = Ax
-    KokkosBlas::axpy(-one, Wj, Res);               // res = res-Wj = b-Ax.
-    trueRes = KokkosBlas::nrm2(Res);
+    // res = b-Ax, and its norm in the same pass.
+    trueRes = KokkosSparse::spmv_nrm2("N", -one, A, X, one, Res);
     if (nrmB != 0) {
       relRes = trueRes / nrmB;
     } else if (trueRes == 0) {
@@ -154,50 +272,85 @@ struct GmresWrap {
       Kokkos::deep_copy(Vj, Res);
       KokkosBlas::scal(Vj, one / trueRes, Vj);  // V0 = V0/norm(V0)
 
+      int blockEnd = 0;  // End of the current s-step block
+      if (ortho == GmresHandle::Ortho::SStep) {
+        Kokkos::deep_copy(sstep.Hraw, zero);
+      }
+
       for (int j = 0; j < m; j++) {
-        if (precond) {                                     // Apply Right prec
-          precond->apply(Vj, Wj2);                         // wj2 = M*Vj
-          KokkosSparse::spmv("N", one, A, Wj2, zero, Wj);  // wj = A*MVj = A*Wj2
-        } else {
-          KokkosSparse::spmv("N", one, A, Vj, zero, Wj);  // wj = A*Vj
-        }
-        Kokkos::Profiling::pushRegion("GMRES::Orthog:");
-        if (ortho == GmresHandle::Ortho::MGS) {
-          for (int i = 0; i <= j; i++) {
-            auto Vi   = Kokkos::subview(V, Kokkos::ALL, i);
-            H_h(i, j) = KokkosBlas::dot(Vi, Wj);   // Vi^* Wj
-            KokkosBlas::axpy(-H_h(i, j), Vi, Wj);  // wj = wj-Hij*Vi
+        if (ortho == GmresHandle::Ortho::SStep && j >= blockEnd) {
+          // Try the next block of columns. If the basis is numerically rank
+          // deficient, column j falls back to a single CGS2 step.
+          const int sk = std::min(s, m - j);
+          Kokkos::Profiling::pushRegion("GMRES::SStep:");
+          if (sstep_arnoldi(A, precond, V, j, sk, Wj2, sstep)) {
+            blockEnd = j + sk;
+            sstepBlocks++;
+          } else {
+            sstepFallbacks++;
           }
-          auto Hj_h = Kokkos::subview(H_h, Kokkos::make_pair(0, j + 1), j);
-        } else if (ortho == GmresHandle::Ortho::CGS2) {
-          auto V0j =
-              Kokkos::subview(V, Kokkos::ALL, Kokkos::make_pair(0, j + 1));
-          auto Hj   = Kokkos::subview(H, Kokkos::make_pair(0, j + 1), j);
-          auto Hj_h = Kokkos::subview(H_h, Kokkos::make_pair(0, j + 1), j);
-          KokkosBlas::gemv("C", one, V0j, Wj, zero, Hj);  // Hj = Vj^T * wj
-          KokkosBlas::gemv("N", -one, V0j, Hj, one, Wj);  // wj = wj - Vj * Hj
-
-          // Re-orthog CGS:
-          auto orthoTmpSub =
-              Kokkos::subview(orthoTmp, Kokkos::make_pair(0, j + 1));
-          KokkosBlas::gemv("C", one, V0j, Wj, zero,
-                           orthoTmpSub);  // tmp (Hj) = Vj^T * wj
-          KokkosBlas::gemv("N", -one, V0j, orthoTmpSub, one,
-                           Wj);                    // wj = wj - Vj * tmp
-          KokkosBlas::axpy(one, orthoTmpSub, Hj);  // Hj = Hj + tmp
-          Kokkos::deep_copy(Hj_h, Hj);
-        } else {
-          throw std::invalid_argument(
-              "Invalid argument for 'ortho'.  Please use 'CGS2' or 'MGS'.");
+          Kokkos::Profiling::popRegion();
         }
 
-        MT tmpNrm     = KokkosBlas::nrm2(Wj);
-        H_h(j + 1, j) = tmpNrm;
-        if (tmpNrm > 1e-14) {
-          Vj = Kokkos::subview(V, Kokkos::ALL, j + 1);
-          KokkosBlas::scal(Vj, one / H_h(j + 1, j), Wj);  // Vj = Wj/H(j+1,j)
+        MT tmpNrm;
+        if (j < blockEnd) {
+          // Column j of H and V(:, j+1) were computed with the block
+          for (int i = 0; i <= j + 1; i++) H_h(i, j) = sstep.Hraw(i, j);
+          tmpNrm = karith::abs(H_h(j + 1, j));
+          Vj     = Kokkos::subview(V, Kokkos::ALL, j + 1);
+        } else {
+          if (precond) {              // Apply Right prec
+            precond->apply(Vj, Wj2);  // wj2 = M*Vj
+            KokkosSparse::spmv("N", one, A, Wj2, zero,
+                               Wj);  // wj = A*MVj = A*Wj2
+          } else {
+            KokkosSparse::spmv("N", one, A, Vj, zero, Wj);  // wj = A*Vj
+          }
+          Kokkos::Profiling::pushRegion("GMRES::Orthog:");
+          if (ortho == GmresHandle::Ortho::MGS) {
+            for (int i = 0; i <= j; i++) {
+              auto Vi   = Kokkos::subview(V, Kokkos::ALL, i);
+              H_h(i, j) = KokkosBlas::dot(Vi, Wj);   // Vi^* Wj
+              KokkosBlas::axpy(-H_h(i, j), Vi, Wj);  // wj = wj-Hij*Vi
+            }
+            auto Hj_h = Kokkos::subview(H_h, Kokkos::make_pair(0, j + 1), j);
+          } else if (ortho == GmresHandle::Ortho::CGS2 ||
+                     ortho == GmresHandle::Ortho::SStep) {
+            auto V0j =
+                Kokkos::subview(V, Kokkos::ALL, Kokkos::make_pair(0, j + 1));
+            auto Hj   = Kokkos::subview(H, Kokkos::make_pair(0, j + 1), j);
+            auto Hj_h = Kokkos::subview(H_h, Kokkos::make_pair(0, j + 1), j);
+            KokkosBlas::gemv("C", one, V0j, Wj, zero, Hj);  // Hj = Vj^T * wj
+            KokkosBlas::gemv("N", -one, V0j, Hj, one,
+                             Wj);  // wj = wj - Vj * Hj
+
+            // Re-orthog CGS:
+            auto orthoTmpSub =
+                Kokkos::subview(orthoTmp, Kokkos::make_pair(0, j + 1));
+            KokkosBlas::gemv("C", one, V0j, Wj, zero,
+                             orthoTmpSub);  // tmp (Hj) = Vj^T * wj
+            KokkosBlas::gemv("N", -one, V0j, orthoTmpSub, one,
+                             Wj);                    // wj = wj - Vj * tmp
+            KokkosBlas::axpy(one, orthoTmpSub, Hj);  // Hj = Hj + tmp
+            Kokkos::deep_copy(Hj_h, Hj);
+          } else {
+            throw std::invalid_argument(
+                "Invalid argument for 'ortho'.  Please use 'CGS2', 'MGS' or "
+                "'SStep'.");
+          }
+
+          tmpNrm        = KokkosBlas::nrm2(Wj);
+          H_h(j + 1, j) = tmpNrm;
+          if (tmpNrm > 1e-14) {
+            Vj = Kokkos::subview(V, Kokkos::ALL, j + 1);
+            KokkosBlas::scal(Vj, one / H_h(j + 1, j),
+                             Wj);  // Vj = Wj/H(j+1,j)
+          }
+          if (ortho == GmresHandle::Ortho::SStep) {
+            for (int i = 0; i <= j + 1; i++) sstep.Hraw(i, j) = H_h(i, j);
+          }
+          Kokkos::Profiling::popRegion();
         }
-        Kokkos::Profiling::popRegion();
 
         // Givens for real and complex (See Alg 3 in "On computing Givens
         // rotations reliably and efficiently" by Demmel, et. al. 2001) Apply
@@ -275,10 +428,9 @@ struct GmresWrap {
             KokkosBlas::gemv("N", one, VSub, GLsSolnSub3, one,
                              Xiter);  // x_iter = x + V(1:j+1)*lsSoln
           }
-          KokkosSparse::spmv("N", one, A, Xiter, zero, Wj);  // wj = Ax
-          Kokkos::deep_copy(Res, B);                         // Reset r=b.
-          KokkosBlas::axpy(-one, Wj, Res);                   // r = b-Ax.
-          trueRes = KokkosBlas::nrm2(Res);
+          Kokkos::deep_copy(Res, B);  // Reset r=b.
+          trueRes = KokkosSparse::spmv_nrm2("N", -one, A, Xiter, one,
+                                            Res);  // r = b-Ax.
           relRes  = trueRes / nrmB;
           if (verbose) {
             std::cout << "True relative residual for iteration "
@@ -350,10 +502,339 @@ struct GmresWrap {
     }
 
     thandle.set_stats(num_iters, end_rel_res, conv_flag_val);
+    thandle.set_sstep_stats(sstepBlocks, sstepFallbacks);
 
     Kokkos::Profiling::popRegion();
   }  // end gmres
 
+ private:
+  using HandleHost2dValueType = typename HandleDevice2dValueType::HostMirror;
+  using mag_t                 = typename karith::mag_type;
+
+  /// \brief Mixed precision GMRES: iterative refinement in the working
+  /// precision, where each correction is one restart cycle of GMRES on a
+  /// low precision copy of A. The Krylov basis, and so most of the memory
+  /// traffic, is in low precision.
+  ///
+  /// The refinement takes up to max_restart + 1 steps, so a mixed solve
+  /// does at most as many Arnoldi iterations as a working precision one.
+  template <class AMatrix, class BType, class XType>
+  static void gmres_ir(
+      GmresHandle& thandle, const AMatrix& A, const BType& B, XType& X,
+      KokkosSparse::Experimental::Preconditioner<AMatrix>* precond) {
+    using ST       = typename karith::val_type;
+    using LoHandle = KokkosSparse::Experimental::GMRESHandle<
+        size_type, index_t, low_scalar_t, execution_space,
+        typename GmresHandle::HandleTempMemorySpace,
+        typename GmresHandle::HandlePersistentMemorySpace>;
+    using LoMatrix = KokkosSparse::CrsMatrix<
+        low_scalar_t, typename AMatrix::ordinal_type,
+        typename AMatrix::device_type, void, typename AMatrix::size_type>;
+    using LoVector = typename LoHandle::nnz_value_view_t;
+    using lo_mag_t = typename Kokkos::ArithTraits<low_scalar_t>::mag_type;
+
+    Kokkos::Profiling::pushRegion("GMRES::TotalTime:");
+
+    const ST one          = karith::one();
+    const auto n          = A.numRows();
+    const int m           = thandle.get_m();
+    const auto maxRestart = thandle.get_max_restart();
+    const auto tol        = thandle.get_tol();
+    const auto verbose    = thandle.get_verbose();
+
+    // The best relative accuracy to ask of a low precision solve
+    const mag_t loTol =
+        100 * static_cast<mag_t>(Kokkos::ArithTraits<lo_mag_t>::epsilon());
+
+    if (verbose) {
+      std::cout << "Starting mixed precision GMRES with..." << std::endl;
+      std::cout << "  n:          " << n << std::endl;
+      std::cout << "  m:          " << m << std::endl;
+      std::cout << "  maxRestart: " << maxRestart << std::endl;
+      std::cout << "  tol:        " << tol << std::endl;
+    }
+
+    // Low precision copy of A, sharing its graph
+    typename LoMatrix::values_type::non_const_type loValues(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "A_lo values"),
+        A.nnz());
+    gmres_cast_axpby<execution_space>(A.values, loValues, one,
+                                      karith::zero());
+    LoMatrix loA("A_lo", A.numRows(), A.numCols(), A.nnz(), loValues,
+                 A.graph.row_map, A.graph.entries);
+    GmresLowPrecisionPrec<LoMatrix, AMatrix> loPrec(precond,
+                                                    precond ? n : 0);
+
+    LoHandle loHandle(m, tol, 0);
+    LoVector loRes(Kokkos::view_alloc(Kokkos::WithoutInitializing, "loRes"),
+                   n),
+        loCorr(Kokkos::view_alloc(Kokkos::WithoutInitializing, "loCorr"), n);
+    HandleDeviceValueType Res(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "Res"), n);
+
+    // Initial residual, in working precision
+    const mag_t nrmB = KokkosBlas::nrm2(B);
+    Kokkos::deep_copy(Res, B);
+    mag_t trueRes = KokkosSparse::spmv_nrm2("N", -one, A, X, one, Res);
+    mag_t relRes;
+    if (nrmB != 0) {
+      relRes = trueRes / nrmB;
+    } else {  // B is zero, so is the solution
+      Kokkos::deep_copy(X, karith::zero());
+      relRes = 0;
+    }
+    if (verbose) {
+      std::cout << "Initial relative residual is: " << relRes << std::endl;
+    }
+
+    int numIters       = 0;
+    int sstepBlocks    = 0;
+    int sstepFallbacks = 0;
+    bool stagnant      = false;
+    for (size_type step = 0; step <= maxRestart && relRes >= tol; step++) {
+      // Solve A d = r / ||r|| in low precision, to the accuracy needed for
+      // the outer tolerance or the best the low precision can do.
+      loHandle.reset_handle(m, std::max(tol / relRes, loTol), 0);
+      loHandle.set_ortho(
+          static_cast<typename LoHandle::Ortho>(thandle.get_ortho()));
+      loHandle.set_s_step(thandle.get_s_step());
+      gmres_cast_axpby<execution_space>(Res, loRes, one / trueRes,
+                                        karith::zero());
+      Kokkos::deep_copy(loCorr, Kokkos::ArithTraits<low_scalar_t>::zero());
+      GmresWrap<LoHandle>::gmres(loHandle, loA, loRes, loCorr,
+                                 precond ? &loPrec : nullptr);
+      numIters       += loHandle.get_num_iters();
+      sstepBlocks    += loHandle.get_num_sstep_blocks();
+      sstepFallbacks += loHandle.get_num_sstep_fallbacks();
+
+      // x = x + ||r|| d, and the new residual, in working precision
+      gmres_cast_axpby<execution_space>(loCorr, X, ST(trueRes), one);
+      Kokkos::deep_copy(Res, B);
+      trueRes             = KokkosSparse::spmv_nrm2("N", -one, A, X, one, Res);
+      const mag_t prevRes = relRes;
+      relRes              = trueRes / nrmB;
+      if (verbose) {
+        std::cout << "True relative residual after refinement step " << step
+                  << " (" << numIters << " iterations) is: " << relRes
+                  << std::endl;
+      }
+      if (!(relRes < prevRes)) {
+        stagnant = true;
+        break;
+      }
+    }
+
+    typename GmresHandle::Flag conv_flag_val;
+    if (relRes < tol) {
+      if (verbose) std::cout << "Solver converged! " << std::endl;
+      conv_flag_val = GmresHandle::Flag::Conv;
+    } else if (stagnant) {
+      if (verbose) {
+        std::cout << "Refinement stagnated: the low precision solves no "
+                     "longer reduce the residual."
+                  << std::endl;
+      }
+      conv_flag_val = GmresHandle::Flag::LOA;
+    } else {
+      if (verbose) std::cout << "Solver did not converge. :( " << std::endl;
+      conv_flag_val = GmresHandle::Flag::NoConv;
+    }
+
+    thandle.set_stats(numIters, relRes, conv_flag_val);
+    thandle.set_sstep_stats(sstepBlocks, sstepFallbacks);
+
+    Kokkos::Profiling::popRegion();
+  }
+
+  /// \brief Work space of the s-step variant, allocated once per solve.
+  struct SStepWork {
+    // n x s, the CholQR passes ping-pong between it and V
+    HandleDevice2dValueType Wtmp;
+    // (m+1) x s projections of the two block CGS passes
+    HandleDeviceValueType RqBuf1, RqBuf2;
+    // s x s Gram matrix and inverse Cholesky factor
+    HandleDeviceValueType GramBuf, RinvBuf;
+    // (m+1) x m, H before the Givens rotations
+    HandleHost2dValueType Hraw;
+    // Scaling of the monomial basis, an estimate of ||A M||
+    mag_t sigma;
+
+    SStepWork() = default;
+    SStepWork(index_t n, int m, int s)
+        : Wtmp(Kokkos::view_alloc(Kokkos::WithoutInitializing, "Wtmp"), n, s),
+          RqBuf1(Kokkos::view_alloc(Kokkos::WithoutInitializing, "Rq1"),
+                 (m + 1) * s),
+          RqBuf2(Kokkos::view_alloc(Kokkos::WithoutInitializing, "Rq2"),
+                 (m + 1) * s),
+          GramBuf(Kokkos::view_alloc(Kokkos::WithoutInitializing, "Gram"),
+                  s * s),
+          RinvBuf(Kokkos::view_alloc(Kokkos::WithoutInitializing, "Rinv"),
+                  s * s),
+          Hraw("Hraw", m + 1, m),
+          sigma(0) {}
+  };
+
+  /// \brief Upper triangular R with R^* R = G, for the leading k x k block
+  /// of G. Returns false if G is not numerically positive definite.
+  static bool cholesky_upper(const HandleHost2dValueType& G,
+                             const HandleHost2dValueType& R, const int k) {
+    const mag_t eps = Kokkos::ArithTraits<mag_t>::epsilon();
+    for (int j = 0; j < k; j++) {
+      for (int i = j + 1; i < k; i++) R(i, j) = karith::zero();
+      mag_t d = karith::real(G(j, j));
+      for (int l = 0; l < j; l++) {
+        d -= karith::abs(R(l, j)) * karith::abs(R(l, j));
+      }
+      if (!(d > 100 * eps * karith::real(G(j, j)))) return false;
+      R(j, j) = Kokkos::sqrt(d);
+      for (int i = j + 1; i < k; i++) {
+        scalar_t v = G(j, i);
+        for (int l = 0; l < j; l++) v -= karith::conj(R(l, j)) * R(l, i);
+        R(j, i) = v / R(j, j);
+      }
+    }
+    return true;
+  }
+
+  /// \brief Rinv = R^{-1} for an upper triangular k x k R.
+  static void invert_upper(const HandleHost2dValueType& R,
+                           const HandleHost2dValueType& Rinv, const int k) {
+    for (int j = 0; j < k; j++) {
+      for (int i = j + 1; i < k; i++) Rinv(i, j) = karith::zero();
+      Rinv(j, j) = karith::one() / R(j, j);
+      for (int i = j - 1; i >= 0; i--) {
+        scalar_t v = karith::zero();
+        for (int l = i + 1; l <= j; l++) v += R(i, l) * Rinv(l, j);
+        Rinv(i, j) = -v / R(i, i);
+      }
+    }
+  }
+
+  /// \brief Extends the Arnoldi relation A M V(:, 0:j0) = V(:, 0:j0+1) H by
+  /// sk columns at once.
+  ///
+  /// A matrix powers kernel generates the monomial basis
+  /// (A M / sigma)^i V(:, j0), i = 1..sk, in V(:, j0+1:j0+sk+1). The block is
+  /// orthogonalized against V(:, 0:j0+1) with block CGS2 and within itself
+  /// with CholQR2, so the sk columns cost four global reductions instead of
+  /// three per column. The columns of H follow from the triangular factors
+  /// of the block and are written to work.Hraw.
+  ///
+  /// Returns false, leaving V(:, 0:j0+1) and work.Hraw untouched, if the
+  /// basis is numerically rank deficient.
+  template <class AMatrix>
+  static bool sstep_arnoldi(
+      const AMatrix& A,
+      KokkosSparse::Experimental::Preconditioner<AMatrix>* precond,
+      const HandleDevice2dValueType& V, const int j0, const int sk,
+      const HandleDeviceValueType& Wj2, SStepWork& work) {
+    const scalar_t one  = karith::one();
+    const scalar_t zero = karith::zero();
+    auto& Hraw          = work.Hraw;
+    mag_t& sigma        = work.sigma;
+
+    auto Q0 = Kokkos::subview(V, Kokkos::ALL, Kokkos::make_pair(0, j0 + 1));
+    auto W  = Kokkos::subview(V, Kokkos::ALL,
+                              Kokkos::make_pair(j0 + 1, j0 + sk + 1));
+    auto Wt = Kokkos::subview(work.Wtmp, Kokkos::ALL,
+                              Kokkos::make_pair(0, sk));
+
+    // Matrix powers kernel. The first block of a solve takes its scaling
+    // from the norm of its first vector, the later ones from the norms of
+    // the columns of H computed so far.
+    for (int i = 0; i < sk; i++) {
+      auto src = Kokkos::subview(V, Kokkos::ALL, j0 + i);
+      auto dst = Kokkos::subview(V, Kokkos::ALL, j0 + i + 1);
+      if (sigma == 0) {
+        mag_t nrm;
+        if (precond) {
+          precond->apply(src, Wj2);
+          nrm = KokkosSparse::spmv_nrm2("N", one, A, Wj2, zero, dst);
+        } else {
+          nrm = KokkosSparse::spmv_nrm2("N", one, A, src, zero, dst);
+        }
+        if (!(nrm > 0)) return false;
+        sigma = nrm;
+        KokkosBlas::scal(dst, one / sigma, dst);
+      } else if (precond) {
+        precond->apply(src, Wj2);
+        KokkosSparse::spmv("N", one / sigma, A, Wj2, zero, dst);
+      } else {
+        KokkosSparse::spmv("N", one / sigma, A, src, zero, dst);
+      }
+    }
+
+    // Block CGS2 against V(:, 0:j0+1)
+    HandleDevice2dValueType Rq1(work.RqBuf1.data(), j0 + 1, sk);
+    HandleDevice2dValueType Rq2(work.RqBuf2.data(), j0 + 1, sk);
+    KokkosBlas::gemm("C", "N", one, Q0, W, zero, Rq1);
+    KokkosBlas::gemm("N", "N", -one, Q0, Rq1, one, W);
+    KokkosBlas::gemm("C", "N", one, Q0, W, zero, Rq2);
+    KokkosBlas::gemm("N", "N", -one, Q0, Rq2, one, W);
+
+    // CholQR2: W = W R1^{-1} R2^{-1}, through Wtmp
+    HandleDevice2dValueType Gram(work.GramBuf.data(), sk, sk);
+    HandleDevice2dValueType Rinv(work.RinvBuf.data(), sk, sk);
+    auto Gram_h = Kokkos::create_mirror_view(Gram);
+    auto Rinv_h = Kokkos::create_mirror_view(Rinv);
+    HandleHost2dValueType R1_h("R1", sk, sk), R2_h("R2", sk, sk);
+    for (int pass = 0; pass < 2; pass++) {
+      auto src = pass == 0 ? W : Wt;
+      auto dst = pass == 0 ? Wt : W;
+      auto R_h = pass == 0 ? R1_h : R2_h;
+      KokkosBlas::gemm("C", "N", one, src, src, zero, Gram);
+      Kokkos::deep_copy(Gram_h, Gram);
+      if (!cholesky_upper(Gram_h, R_h, sk)) return false;
+      invert_upper(R_h, Rinv_h, sk);
+      Kokkos::deep_copy(Rinv, Rinv_h);
+      KokkosBlas::gemm("N", "N", one, src, Rinv, zero, dst);
+    }
+
+    // [V(:, j0), W] = V(:, 0:j0+sk+1) Rb, with Rb upper triangular below
+    // row j0. Column 0 is e_j0, the others stack Rq1 + Rq2 on R2 R1.
+    auto Rq1_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), Rq1);
+    auto Rq2_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), Rq2);
+    HandleHost2dValueType Rb("Rb", j0 + sk + 1, sk + 1);
+    Rb(j0, 0) = one;
+    for (int i = 0; i < sk; i++) {
+      for (int r = 0; r <= j0; r++) Rb(r, i + 1) = Rq1_h(r, i) + Rq2_h(r, i);
+      for (int r = 0; r <= i; r++) {
+        scalar_t v = zero;
+        for (int l = r; l <= i; l++) v += R2_h(r, l) * R1_h(l, i);
+        Rb(j0 + 1 + r, i + 1) = v;
+      }
+    }
+
+    // A M [V(:, j0), W(:, 0:sk-1)] = [V(:, j0), W] sigma E, where E is the
+    // (sk+1) x sk shift. Substituting the factorizations and the columns of
+    // H before j0 gives H(:, j0:j0+sk) Rsq = sigma Rb E - H(:, 0:j0) Rtop,
+    // with Rsq = Rb(j0:j0+sk, 0:sk) and Rtop = Rb(0:j0, 0:sk).
+    const int nr           = j0 + sk + 1;
+    const mag_t blockSigma = sigma;
+    for (int i = 0; i < sk; i++) {
+      const int col = j0 + i;
+      for (int r = 0; r < nr; r++) Hraw(r, col) = blockSigma * Rb(r, i + 1);
+      for (int l = 0; l < j0; l++) {
+        for (int r = 0; r <= l + 1; r++) Hraw(r, col) -= Hraw(r, l) * Rb(l, i);
+      }
+      for (int l = 0; l < i; l++) {
+        for (int r = 0; r <= j0 + l + 1; r++) {
+          Hraw(r, col) -= Hraw(r, j0 + l) * Rb(j0 + l, i);
+        }
+      }
+      mag_t nrm = 0;
+      for (int r = 0; r < nr; r++) {
+        if (r > col + 1) Hraw(r, col) = zero;
+        Hraw(r, col) /= Rb(col, i);
+        nrm += karith::abs(Hraw(r, col)) * karith::abs(Hraw(r, col));
+      }
+      // ||H(:, col)|| = ||A M V(:, col)||, which estimates ||A M||
+      nrm = Kokkos::sqrt(nrm);
+      if (nrm > sigma) sigma = nrm;
+    }
+    return true;
+  }
+
 };  // struct GmresWrap
 
 }  // namespace Experimental
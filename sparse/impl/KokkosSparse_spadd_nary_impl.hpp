@@ -0,0 +1,322 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+#ifndef _KOKKOS_SPADD_NARY_IMPL_HPP
+#define _KOKKOS_SPADD_NARY_IMPL_HPP
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "KokkosKernels_Handle.hpp"
+#include "KokkosSparse_SortCrs.hpp"
+#include "Kokkos_ArithTraits.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+// The n-ary add C = sum_k alpha_k A_k stacks the rows of all inputs into one
+// uncompressed C, sorts it once and merges it, recording where each input
+// entry lands in its C row. The numeric phase then adds each input through
+// those positions, like the unsorted two-matrix add does with Apos/Bpos.
+
+// Adds the row lengths of one input to the row counts of the stacked sum
+template <typename ordinal_type, typename ArowptrsT, typename CrowptrsT>
+struct NaryAddRowCounts {
+  NaryAddRowCounts(const ArowptrsT& Arowptrs_, const CrowptrsT& Crowcounts_)
+      : Arowptrs(Arowptrs_), Crowcounts(Crowcounts_) {}
+
+  KOKKOS_INLINE_FUNCTION void operator()(const ordinal_type i) const {
+    Crowcounts(i) += Arowptrs(i + 1) - Arowptrs(i);
+  }
+
+  const ArowptrsT Arowptrs;
+  CrowptrsT Crowcounts;
+};
+
+// Appends the entries of one input to the stacked rows. ABperm gets the
+// number of each entry among the entries of all inputs.
+template <typename size_type, typename ordinal_type, typename ArowptrsT,
+          typename AcolindsT, typename OffsetView, typename CcolindsT>
+struct NaryAddStackEntries {
+  NaryAddStackEntries(const ArowptrsT& Arowptrs_, const AcolindsT& Acolinds_,
+                      const OffsetView& Crowptrs_, const OffsetView& Cfill_,
+                      const CcolindsT& Ccolinds_, const OffsetView& ABperm_,
+                      const size_type offset_)
+      : Arowptrs(Arowptrs_),
+        Acolinds(Acolinds_),
+        Crowptrs(Crowptrs_),
+        Cfill(Cfill_),
+        Ccolinds(Ccolinds_),
+        ABperm(ABperm_),
+        offset(offset_) {}
+
+  KOKKOS_INLINE_FUNCTION void operator()(const ordinal_type i) const {
+    size_type ArowStart = Arowptrs(i);
+    size_type ArowEnd   = Arowptrs(i + 1);
+    size_type Cit       = Crowptrs(i) + Cfill(i);
+    for (size_type j = ArowStart; j < ArowEnd; j++, Cit++) {
+      Ccolinds(Cit) = Acolinds(j);
+      ABperm(Cit)   = offset + j;
+    }
+    Cfill(i) += ArowEnd - ArowStart;
+  }
+
+  const ArowptrsT Arowptrs;
+  const AcolindsT Acolinds;
+  const OffsetView Crowptrs;
+  OffsetView Cfill;
+  CcolindsT Ccolinds;
+  OffsetView ABperm;
+  const size_type offset;
+};
+
+// Merges the sorted stacked rows: each input entry gets the index of its
+// column in the C row, and Crowcounts the number of distinct columns.
+template <typename size_type, typename ordinal_type, typename OffsetView,
+          typename CrowptrsT, typename CcolindsT>
+struct NaryAddMergeEntries {
+  NaryAddMergeEntries(const OffsetView& Crowptrs_,
+                      const CrowptrsT& Crowcounts_, const CcolindsT& Ccolinds_,
+                      const OffsetView& ABperm_, const CcolindsT& pos_)
+      : Crowptrs(Crowptrs_),
+        Crowcounts(Crowcounts_),
+        Ccolinds(Ccolinds_),
+        ABperm(ABperm_),
+        pos(pos_) {}
+
+  KOKKOS_INLINE_FUNCTION void operator()(const ordinal_type i) const {
+    size_type CrowStart = Crowptrs(i);
+    size_type CrowEnd   = Crowptrs(i + 1);
+    if (CrowEnd == CrowStart) {
+      Crowcounts(i) = 0;
+      return;
+    }
+    ordinal_type CFit = 0;
+    for (size_type Cit = CrowStart; Cit < CrowEnd; Cit++) {
+      if ((Cit > CrowStart) && (Ccolinds(Cit) != Ccolinds(Cit - 1))) CFit++;
+      pos(ABperm(Cit)) = CFit;
+    }
+    Crowcounts(i) = CFit + 1;
+  }
+
+  const OffsetView Crowptrs;
+  CrowptrsT Crowcounts;
+  const CcolindsT Ccolinds;
+  const OffsetView ABperm;
+  CcolindsT pos;
+};
+
+// Adds alpha * A into C through the positions of the entries of A
+template <typename size_type, typename ordinal_type, typename ArowptrsT,
+          typename AcolindsT, typename AvaluesT, typename CrowptrsT,
+          typename CcolindsT, typename CvaluesT, typename PosT,
+          typename AscalarT>
+struct NaryAddNumericFunctor {
+  NaryAddNumericFunctor(const ArowptrsT& Arowptrs_, const AcolindsT& Acolinds_,
+                        const AvaluesT& Avalues_, const CrowptrsT& Crowptrs_,
+                        const CcolindsT& Ccolinds_, const CvaluesT& Cvalues_,
+                        const PosT& pos_, const size_type offset_,
+                        const AscalarT alpha_)
+      : Arowptrs(Arowptrs_),
+        Acolinds(Acolinds_),
+        Avalues(Avalues_),
+        Crowptrs(Crowptrs_),
+        Ccolinds(Ccolinds_),
+        Cvalues(Cvalues_),
+        pos(pos_),
+        offset(offset_),
+        alpha(alpha_) {}
+
+  KOKKOS_INLINE_FUNCTION void operator()(const ordinal_type i) const {
+    size_type CrowStart = Crowptrs(i);
+    for (size_type j = Arowptrs(i); j < Arowptrs(i + 1); j++) {
+      size_type Cit = CrowStart + pos(offset + j);
+      Cvalues(Cit) += alpha * Avalues(j);
+      Ccolinds(Cit) = Acolinds(j);
+    }
+  }
+
+  const ArowptrsT Arowptrs;
+  const AcolindsT Acolinds;
+  const AvaluesT Avalues;
+  const CrowptrsT Crowptrs;
+  CcolindsT Ccolinds;
+  CvaluesT Cvalues;
+  const PosT pos;
+  const size_type offset;
+  const AscalarT alpha;
+};
+
+template <typename AMatrix>
+void check_nary_spadd_inputs(const std::vector<AMatrix>& A) {
+  if (A.empty())
+    throw std::invalid_argument(
+        "KokkosSparse::spadd: the n-ary add needs at least one input matrix");
+  for (const AMatrix& Ak : A) {
+    if (Ak.numRows() != A[0].numRows() || Ak.numCols() != A[0].numCols())
+      throw std::invalid_argument(
+          "KokkosSparse::spadd: the input matrices must all have the same "
+          "dimensions");
+  }
+}
+
+// Symbolic n-ary add: computes c_rowmap, and stores in the handle the
+// position of every input entry in C for the numeric phase. The stacked rows
+// are sorted whether or not the handle says the inputs are, since stacking
+// sorted rows does not give sorted rows: C always has sorted rows.
+template <typename KernelHandle, typename AMatrix, typename clno_row_view_t_>
+void spadd_symbolic_nary_impl(KernelHandle* handle,
+                              const std::vector<AMatrix>& A,
+                              clno_row_view_t_ c_rowmap) {
+  typedef
+      typename KernelHandle::SPADDHandleType::execution_space execution_space;
+  typedef typename KernelHandle::size_type size_type;
+  typedef typename KernelHandle::nnz_lno_t ordinal_type;
+  typedef typename KernelHandle::SPADDHandleType::nnz_lno_view_t ordinal_view_t;
+  typedef typename KernelHandle::SPADDHandleType::nnz_row_view_t offset_view_t;
+  typedef typename AMatrix::row_map_type a_rowmap_t;
+  typedef typename AMatrix::index_type a_entries_t;
+  typedef Kokkos::RangePolicy<execution_space, ordinal_type> range_type;
+
+  check_nary_spadd_inputs(A);
+  auto addHandle = handle->get_spadd_handle();
+  std::vector<size_type> offsets(1, 0);
+  for (const AMatrix& Ak : A) offsets.push_back(offsets.back() + Ak.nnz());
+  ordinal_type nrows = A[0].numRows();
+  if (nrows == 0) {
+    addHandle->set_c_nnz(0);
+    if (c_rowmap.extent(0)) Kokkos::deep_copy(c_rowmap, (size_type)0);
+    addHandle->set_input_pos(ordinal_view_t(), offsets);
+    addHandle->set_call_symbolic();
+    addHandle->set_call_numeric(false);
+    return;
+  }
+  // stack the rows of all inputs
+  offset_view_t c_rowmap_upperbound("C row counts upper bound", nrows + 1);
+  for (const AMatrix& Ak : A) {
+    Kokkos::parallel_for(
+        "KokkosSparse::SpAdd:Symbolic::Nary::CountEntries",
+        range_type(0, nrows),
+        NaryAddRowCounts<ordinal_type, a_rowmap_t, offset_view_t>(
+            Ak.graph.row_map, c_rowmap_upperbound));
+  }
+  KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<offset_view_t,
+                                                        execution_space>(
+      nrows + 1, c_rowmap_upperbound);
+  ordinal_view_t c_entries_uncompressed(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "C entries uncompressed"),
+      offsets.back());
+  offset_view_t ab_perm(Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                                           "input entry indices"),
+                        offsets.back());
+  {
+    offset_view_t c_fill("C row fill", nrows);
+    for (size_t k = 0; k < A.size(); k++) {
+      Kokkos::parallel_for(
+          "KokkosSparse::SpAdd:Symbolic::Nary::StackEntries",
+          range_type(0, nrows),
+          NaryAddStackEntries<size_type, ordinal_type, a_rowmap_t, a_entries_t,
+                              offset_view_t, ordinal_view_t>(
+              A[k].graph.row_map, A[k].graph.entries, c_rowmap_upperbound,
+              c_fill, c_entries_uncompressed, ab_perm, offsets[k]));
+    }
+  }
+  // one sort for all inputs, then merge the repeated columns
+  KokkosSparse::sort_crs_matrix<execution_space, offset_view_t, ordinal_view_t,
+                                offset_view_t>(c_rowmap_upperbound,
+                                               c_entries_uncompressed, ab_perm);
+  ordinal_view_t input_pos(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "input entry positions"),
+      offsets.back());
+  Kokkos::parallel_for(
+      "KokkosSparse::SpAdd:Symbolic::Nary::MergeEntries", range_type(0, nrows),
+      NaryAddMergeEntries<size_type, ordinal_type, offset_view_t,
+                          clno_row_view_t_, ordinal_view_t>(
+          c_rowmap_upperbound, c_rowmap, c_entries_uncompressed, ab_perm,
+          input_pos));
+  KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<clno_row_view_t_,
+                                                        execution_space>(
+      nrows + 1, c_rowmap);
+  addHandle->set_input_pos(input_pos, offsets);
+  size_type cmax;
+  Kokkos::deep_copy(cmax, Kokkos::subview(c_rowmap, nrows));
+  addHandle->set_c_nnz(cmax);
+  addHandle->set_call_symbolic();
+  addHandle->set_call_numeric(false);
+}
+
+// Numeric n-ary add, for inputs with the structure given to the symbolic
+// phase: fills the entries and values of C.
+template <typename KernelHandle, typename AScalar, typename AMatrix,
+          typename clno_row_view_t_, typename clno_nnz_view_t_,
+          typename cscalar_nnz_view_t_>
+void spadd_numeric_nary_impl(KernelHandle* handle,
+                             const std::vector<AScalar>& alpha,
+                             const std::vector<AMatrix>& A,
+                             const clno_row_view_t_ c_rowmap,
+                             clno_nnz_view_t_ c_entries,
+                             cscalar_nnz_view_t_ c_values) {
+  typedef
+      typename KernelHandle::SPADDHandleType::execution_space execution_space;
+  typedef typename KernelHandle::size_type size_type;
+  typedef typename KernelHandle::nnz_lno_t ordinal_type;
+  typedef typename KernelHandle::SPADDHandleType::nnz_lno_view_t ordinal_view_t;
+  typedef typename cscalar_nnz_view_t_::non_const_value_type c_scalar_t;
+  typedef Kokkos::RangePolicy<execution_space, ordinal_type> range_type;
+
+  check_nary_spadd_inputs(A);
+  auto addHandle = handle->get_spadd_handle();
+  if (!addHandle->is_symbolic_called())
+    throw std::runtime_error(
+        "KokkosSparse::spadd_numeric: call the n-ary spadd_symbolic first");
+  const std::vector<size_type>& offsets = addHandle->get_input_offsets();
+  if (alpha.size() != A.size() || offsets.size() != A.size() + 1)
+    throw std::invalid_argument(
+        "KokkosSparse::spadd_numeric: the n-ary add needs one coefficient per "
+        "input, and the inputs of its symbolic phase");
+  for (size_t k = 0; k < A.size(); k++) {
+    if (size_type(A[k].nnz()) != offsets[k + 1] - offsets[k])
+      throw std::invalid_argument(
+          "KokkosSparse::spadd_numeric: input " + std::to_string(k) +
+          " does not have the structure it had in the symbolic phase");
+  }
+  ordinal_type nrows = A[0].numRows();
+  if (nrows == 0) {
+    addHandle->set_call_numeric();
+    return;
+  }
+  Kokkos::deep_copy(c_values, Kokkos::ArithTraits<c_scalar_t>::zero());
+  ordinal_view_t input_pos = addHandle->get_input_pos();
+  // inputs go one after the other, so that no two threads add into the same
+  // entry of C
+  for (size_t k = 0; k < A.size(); k++) {
+    Kokkos::parallel_for(
+        "KokkosSparse::SpAdd:Numeric::Nary", range_type(0, nrows),
+        NaryAddNumericFunctor<size_type, ordinal_type,
+                              typename AMatrix::row_map_type,
+                              typename AMatrix::index_type,
+                              typename AMatrix::values_type, clno_row_view_t_,
+                              clno_nnz_view_t_, cscalar_nnz_view_t_,
+                              ordinal_view_t, AScalar>(
+            A[k].graph.row_map, A[k].graph.entries, A[k].values, c_rowmap,
+            c_entries, c_values, input_pos, offsets[k], alpha[k]));
+  }
+  addHandle->set_call_numeric();
+}
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif
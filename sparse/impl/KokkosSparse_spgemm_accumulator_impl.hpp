@@ -0,0 +1,191 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+#ifndef KOKKOSSPARSE_SPGEMM_ACCUMULATOR_IMPL_HPP_
+#define KOKKOSSPARSE_SPGEMM_ACCUMULATOR_IMPL_HPP_
+
+#include <stdexcept>
+#include <type_traits>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_ArithTraits.hpp>
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosKernels_Uniform_Initialized_MemoryPool.hpp"
+#include "KokkosSparse_spgemm_handle.hpp"
+
+// Row accumulators shared by the row-by-row SpGEMM variants (triple product,
+// masked product). Each thread takes its accumulators from a chunk of a
+// KokkosKernels::Impl::UniformMemoryPool initialized to -1.
+
+namespace KokkosSparse {
+namespace Impl {
+
+// Accumulates the distinct column indices of one row. Each new key gets the
+// next position in keys (and vals, when present). A dense accumulator maps a
+// key to its position through table[key]; a sparse one hashes the key into a
+// power-of-two table with linear probing and remembers the slot of each
+// position in slots. clear() restores the table to all -1, so a pool chunk is
+// returned in the state it was handed out.
+template <typename lno_t, typename scalar_t>
+struct SpgemmRowAccumulator {
+  lno_t *table;
+  lno_t *slots;
+  lno_t *keys;
+  scalar_t *vals;
+  lno_t mask;  // table size - 1 for a sparse accumulator, -1 for a dense one
+  lno_t size;
+
+  // Table size of an accumulator of at most max_keys keys below ncols
+  static lno_t table_size(const bool dense, const lno_t ncols,
+                          const lno_t max_keys) {
+    if (dense) return ncols;
+    // Keep the hash table at most half full
+    lno_t tsize = 1;
+    while (tsize < 2 * max_keys) tsize *= 2;
+    return tsize;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  lno_t slot_of(const lno_t key) const {
+    if (mask < 0) return key;
+    lno_t slot = lno_t((size_t(key) * size_t(2654435761u)) & size_t(mask));
+    while (table[slot] != -1 && keys[table[slot]] != key)
+      slot = (slot + 1) & mask;
+    return slot;
+  }
+
+  // Position of key, or -1 if it was never inserted
+  KOKKOS_INLINE_FUNCTION
+  lno_t find(const lno_t key) const { return table[slot_of(key)]; }
+
+  // Position of key, inserting it if needed
+  KOKKOS_INLINE_FUNCTION
+  lno_t insert(const lno_t key) {
+    const lno_t slot = slot_of(key);
+    lno_t pos        = table[slot];
+    if (pos == -1) {
+      pos         = size++;
+      table[slot] = pos;
+      keys[pos]   = key;
+      if (mask >= 0) slots[pos] = slot;
+      if (vals) vals[pos] = Kokkos::ArithTraits<scalar_t>::zero();
+    }
+    return pos;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void clear() {
+    for (lno_t p = 0; p < size; ++p)
+      table[mask >= 0 ? slots[p] : keys[p]] = -1;
+    size = 0;
+  }
+};
+
+// Takes a chunk of the pool for the thread working on row_index. Host spaces
+// own one chunk per thread; on GPUs chunks are shared, so spin until one is
+// free.
+template <typename MyExecSpace, typename lno_t, typename pool_t>
+KOKKOS_INLINE_FUNCTION lno_t *spgemm_acquire_chunk(const pool_t &pool,
+                                                   const size_t row_index) {
+  size_t tid = row_index;
+#if defined(KOKKOS_ENABLE_SERIAL)
+  if constexpr (std::is_same<MyExecSpace, Kokkos::Serial>::value) tid = 0;
+#endif
+#if defined(KOKKOS_ENABLE_OPENMP)
+  if constexpr (std::is_same<MyExecSpace, Kokkos::OpenMP>::value)
+    tid = Kokkos::OpenMP::impl_hardware_thread_id();
+#endif
+#if defined(KOKKOS_ENABLE_THREADS)
+  if constexpr (std::is_same<MyExecSpace, Kokkos::Threads>::value)
+    tid = Kokkos::Threads::impl_hardware_thread_id();
+#endif
+  volatile lno_t *tmp = nullptr;
+  while (tmp == nullptr) {
+    tmp = (volatile lno_t *)(pool.allocate_chunk(tid));
+  }
+  return (lno_t *)tmp;
+}
+
+// Picks dense or hashed accumulators from the SPGEMMHandle: the dense and
+// speed variants use dense accumulators, the memory variants and LP hashed
+// ones, and the default lets the column counts decide on the host.
+template <typename spgemm_handle_t>
+bool spgemm_use_dense_accumulator(spgemm_handle_t *sh, const size_t ncols1,
+                                  const size_t ncols2) {
+  using exec_space = typename spgemm_handle_t::HandleExecSpace;
+  switch (sh->get_accumulator_type()) {
+    case SPGEMM_ACC_DENSE: return true;
+    case SPGEMM_ACC_SPARSE: return false;
+    default: break;
+  }
+  switch (sh->get_algorithm_type()) {
+    case SPGEMM_KK_DENSE:
+    case SPGEMM_KK_SPEED: return true;
+    case SPGEMM_KK_MEMORY:
+    case SPGEMM_KK_MEMORY_SORTED:
+    case SPGEMM_KK_MEMORY_TEAM:
+    case SPGEMM_KK_MEMORY_BIGTEAM:
+    case SPGEMM_KK_MEMORY_SPREADTEAM:
+    case SPGEMM_KK_MEMORY_BIGSPREADTEAM:
+    case SPGEMM_KK_MEMORY2:
+    case SPGEMM_KK_LP: return false;
+    case SPGEMM_KK:
+    case SPGEMM_KK_MEMSPEED:
+    case SPGEMM_DEFAULT:
+    case SPGEMM_SERIAL:
+    case SPGEMM_DEBUG:
+      return !KokkosKernels::Impl::kk_is_gpu_exec_space<exec_space>() &&
+             std::max(ncols1, ncols2) <= sh->MaxColDenseAcc;
+    default:
+      throw std::runtime_error(
+          "KokkosSparse: the SpGEMM algorithm of the handle is not supported "
+          "by row-accumulator SpGEMM kernels");
+  }
+}
+
+// Number of pool chunks: one per thread, or as many as fit in half of the
+// free memory on a GPU
+template <typename pool_t>
+size_t spgemm_pool_num_chunks(const size_t chunk_bytes) {
+  using exec_space   = typename pool_t::execution_space;
+  using memory_space = typename pool_t::memory_space;
+  size_t num_chunks  = exec_space().concurrency();
+  if (!KokkosKernels::Impl::kk_is_gpu_exec_space<exec_space>())
+    return num_chunks;
+  size_t free_byte, total_byte;
+  KokkosKernels::Impl::kk_get_free_total_memory<memory_space>(free_byte,
+                                                              total_byte);
+  if (num_chunks * chunk_bytes > free_byte / 2)
+    num_chunks = (free_byte / 2) / chunk_bytes;
+  size_t po2_num_chunks = 1;
+  while (po2_num_chunks * 2 < num_chunks) po2_num_chunks *= 2;
+  return po2_num_chunks;
+}
+
+// A pool of chunks of chunk_size lno_t, all -1
+template <typename pool_t, typename lno_t>
+pool_t spgemm_make_pool(const size_t chunk_size) {
+  using exec_space = typename pool_t::execution_space;
+  const size_t num_chunks =
+      spgemm_pool_num_chunks<pool_t>(chunk_size * sizeof(lno_t));
+  return pool_t(num_chunks, chunk_size, -1,
+                KokkosKernels::Impl::kk_is_gpu_exec_space<exec_space>()
+                    ? KokkosKernels::Impl::ManyThread2OneChunk
+                    : KokkosKernels::Impl::OneThread2OneChunk);
+}
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif
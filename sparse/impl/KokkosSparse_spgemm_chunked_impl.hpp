@@ -0,0 +1,188 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+#ifndef KOKKOSSPARSE_SPGEMM_CHUNKED_IMPL_HPP_
+#define KOKKOSSPARSE_SPGEMM_CHUNKED_IMPL_HPP_
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <Kokkos_Core.hpp>
+#include "KokkosSparse_spgemm_symbolic.hpp"
+#include "KokkosSparse_spgemm_numeric.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+// out(i) = in(first + i) - in(first): the row map of rows [first, first + n)
+// of a CRS matrix, or of a block placed at row first when offset is added.
+template <typename in_row_view_t, typename out_row_view_t>
+struct SpgemmShiftRowmap {
+  in_row_view_t in;
+  out_row_view_t out;
+  size_t in_first, out_first;
+  typename out_row_view_t::non_const_value_type base, offset;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_t i) const {
+    out(out_first + i) = in(in_first + i) - base + offset;
+  }
+};
+
+/// Splits the rows of C into consecutive blocks whose storage fits in
+/// budget bytes, given the row map of C on the host. Block b is the rows
+/// [bounds[b], bounds[b + 1]).
+template <typename host_row_view_t>
+std::vector<size_t> spgemm_chunked_row_blocks(const host_row_view_t &rowmapC,
+                                              const size_t nrows,
+                                              const size_t bytes_per_nnz,
+                                              const size_t bytes_per_row,
+                                              const size_t budget) {
+  std::vector<size_t> bounds(1, 0);
+  size_t bytes = bytes_per_row;  // the extra entry of the row map
+  for (size_t i = 0; i < nrows; ++i) {
+    const size_t row_bytes =
+        bytes_per_row + bytes_per_nnz * (rowmapC(i + 1) - rowmapC(i));
+    if (budget && bytes + row_bytes > budget) {
+      if (bounds.back() == i)
+        throw std::runtime_error(
+            "KokkosSparse::spgemm_chunked: row " + std::to_string(i) +
+            " of C does not fit in the memory budget of the SPGEMMHandle");
+      bounds.push_back(i);
+      bytes = bytes_per_row;
+    }
+    bytes += row_bytes;
+  }
+  if (nrows) bounds.push_back(nrows);
+  return bounds;
+}
+
+/// Gives local the SpGEMM settings of kh, so that spgemm_chunked can run its
+/// own symbolic and numeric phases without touching the state of kh.
+template <class KernelHandle>
+void spgemm_chunked_copy_handle(KernelHandle &kh, KernelHandle &local) {
+  auto sh = kh.get_spgemm_handle();
+  local.set_team_work_size(kh.get_set_team_work_size());
+  local.set_dynamic_scheduling(kh.is_dynamic_scheduling());
+  local.set_shmem_size(kh.get_shmem_size());
+  local.set_verbose(kh.get_verbose());
+  local.create_spgemm_handle(sh->get_algorithm_type());
+  auto lsh = local.get_spgemm_handle();
+  lsh->set_accumulator_type(sh->get_accumulator_type());
+  lsh->set_row_binning(sh->get_row_binning());
+  lsh->MaxColDenseAcc = sh->MaxColDenseAcc;
+}
+
+/// Row map of C = A*B, from a symbolic phase over all of A on a handle of
+/// its own.
+template <class row_map_type, class KernelHandle, class AMatrix,
+          class BMatrix>
+row_map_type spgemm_chunked_row_map(KernelHandle &kh, const AMatrix &A,
+                                    const BMatrix &B) {
+  row_map_type row_mapC(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "non_const_lnow_row"),
+      A.numRows() + 1);
+  KernelHandle skh;
+  spgemm_chunked_copy_handle(kh, skh);
+  KokkosSparse::Experimental::spgemm_symbolic(
+      &skh, A.numRows(), B.numRows(), B.numCols(), A.graph.row_map,
+      A.graph.entries, false, B.graph.row_map, B.graph.entries, false,
+      row_mapC);
+  skh.destroy_spgemm_handle();
+  return row_mapC;
+}
+
+/// Multiplies the row blocks of A by B under the memory budget of kh, given
+/// the row map of C on the host. For each block, output(c_begin, c_nnz,
+/// entries, values) provides the storage of its c_nnz entries, which start
+/// at c_begin in C, and sink(first_row, Cblock) receives the product.
+template <class CMatrix, class KernelHandle, class AMatrix, class BMatrix,
+          class HostRowMapC, class Output, class Sink>
+void spgemm_chunked_blocks(KernelHandle &kh, const AMatrix &A,
+                           const BMatrix &B, const HostRowMapC &h_row_mapC,
+                           Output &&output, Sink &&sink) {
+  using row_map_type = typename CMatrix::row_map_type::non_const_type;
+  using entries_type = typename CMatrix::index_type::non_const_type;
+  using values_type  = typename CMatrix::values_type::non_const_type;
+  using size_type    = typename CMatrix::non_const_size_type;
+  using ordinal_type = typename CMatrix::non_const_ordinal_type;
+  using scalar_type  = typename CMatrix::non_const_value_type;
+  using exec_space   = typename KernelHandle::HandleExecSpace;
+  using a_row_map_type =
+      Kokkos::View<size_type *, typename AMatrix::device_type>;
+
+  const size_t nrows = A.numRows();
+  auto h_row_mapA    = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                           A.graph.row_map);
+
+  // A block takes its row map, entries and values in C, and its own row map
+  // of A
+  const std::vector<size_t> bounds = spgemm_chunked_row_blocks(
+      h_row_mapC, nrows, sizeof(ordinal_type) + sizeof(scalar_type),
+      2 * sizeof(size_type), kh.get_spgemm_handle()->get_memory_budget());
+
+  for (size_t b = 0; b + 1 < bounds.size(); ++b) {
+    const size_t first = bounds[b];
+    const size_t rows  = bounds[b + 1] - first;
+    const auto a_begin = h_row_mapA(first);
+    const auto a_end   = h_row_mapA(first + rows);
+
+    // Rows [first, first + rows) of A
+    a_row_map_type row_mapAb(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "A block row map"),
+        rows + 1);
+    Kokkos::parallel_for(
+        "KokkosSparse::spgemm_chunked::RowMapA",
+        Kokkos::RangePolicy<exec_space>(0, rows + 1),
+        SpgemmShiftRowmap<decltype(A.graph.row_map), a_row_map_type>{
+            A.graph.row_map, row_mapAb, first, 0, size_type(a_begin), 0});
+    auto entriesAb =
+        Kokkos::subview(A.graph.entries, Kokkos::make_pair(a_begin, a_end));
+    auto valuesAb =
+        Kokkos::subview(A.values, Kokkos::make_pair(a_begin, a_end));
+
+    KernelHandle bkh;
+    spgemm_chunked_copy_handle(kh, bkh);
+    row_map_type row_mapCb(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "C block row map"),
+        rows + 1);
+    KokkosSparse::Experimental::spgemm_symbolic(
+        &bkh, rows, B.numRows(), B.numCols(), row_mapAb, entriesAb, false,
+        B.graph.row_map, B.graph.entries, false, row_mapCb);
+    const size_t c_begin = h_row_mapC(first);
+    const size_t c_nnz   = bkh.get_spgemm_handle()->get_c_nnz();
+    if (c_nnz != size_t(h_row_mapC(first + rows)) - c_begin)
+      throw std::runtime_error(
+          "KokkosSparse::spgemm_chunked: the symbolic phases of a block and "
+          "of C disagree on its number of entries");
+    entries_type entriesCb;
+    values_type valuesCb;
+    output(c_begin, c_nnz, entriesCb, valuesCb);
+    KokkosSparse::Experimental::spgemm_numeric(
+        &bkh, rows, B.numRows(), B.numCols(), row_mapAb, entriesAb, valuesAb,
+        false, B.graph.row_map, B.graph.entries, B.values, false, row_mapCb,
+        entriesCb, valuesCb);
+    bkh.destroy_spgemm_handle();
+
+    const CMatrix Cblock("C block", rows, B.numCols(), c_nnz, valuesCb,
+                         row_mapCb, entriesCb);
+    sink(first, Cblock);
+  }
+}
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif
@@ -450,6 +450,18 @@ class KokkosSPGEMM {
       c_row_view_t rowmapC_, c_lno_nnz_view_t entriesC_,
       c_scalar_nnz_view_t valuesC_,
       KokkosKernels::Impl::ExecSpaceType my_exec_space);
+
+  //////////////////////////////////////////////////////////////////////////
+  /////BELOW CODE IS for the row-binned numeric phase
+  ////DECL IS AT _binned.hpp
+  //////////////////////////////////////////////////////////////////////////
+  void compute_row_bins();
+
+  template <typename c_row_view_t, typename c_lno_nnz_view_t,
+            typename c_scalar_nnz_view_t>
+  void KokkosSPGEMM_numeric_binned(c_row_view_t rowmapC_,
+                                   c_lno_nnz_view_t entriesC_,
+                                   c_scalar_nnz_view_t valuesC_);
 #if defined(KOKKOS_ENABLE_OPENMP)
 #ifdef KOKKOSKERNELS_HAVE_OUTER
  public:
@@ -836,6 +848,7 @@ class KokkosSPGEMM {
     sh->original_overall_flops = overall_flops;
     sh->row_flops              = flops_per_row;
     sh->set_computed_rowflops();
+    sh->set_computed_row_bins(false);
   }
 };
 
@@ -844,6 +857,7 @@ class KokkosSPGEMM {
 #include "KokkosSparse_spgemm_imp_outer.hpp"
 #include "KokkosSparse_spgemm_impl_memaccess.hpp"
 #include "KokkosSparse_spgemm_impl_kkmem.hpp"
+#include "KokkosSparse_spgemm_impl_binned.hpp"
 #include "KokkosSparse_spgemm_impl_speed.hpp"
 #include "KokkosSparse_spgemm_impl_compression.hpp"
 #include "KokkosSparse_spgemm_impl_def.hpp"
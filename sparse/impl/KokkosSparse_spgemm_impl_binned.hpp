@@ -0,0 +1,340 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#include <algorithm>
+#include "KokkosSparse_spgemm_accumulator_impl.hpp"
+
+namespace KokkosSparse {
+
+namespace Impl {
+
+// Number of bins of the binned numeric phase. Bin b holds the rows with at
+// most 16 * 8^b flops, and the last bin everything above.
+constexpr int spgemm_num_row_bins = 6;
+
+KOKKOS_INLINE_FUNCTION
+int spgemm_row_bin(const size_t flops) {
+  int bin      = 0;
+  size_t bound = 16;
+  while (bin < spgemm_num_row_bins - 1 && flops > bound) {
+    ++bin;
+    bound *= 8;
+  }
+  return bin;
+}
+
+// Bin of each row, with the number of rows and the largest flops of each bin
+template <typename row_flops_view_t, typename row_bin_view_t,
+          typename bin_view_t>
+struct SpgemmRowBinCountFunctor {
+  row_flops_view_t row_flops;
+  row_bin_view_t row_bin;
+  bin_view_t bin_count;
+  bin_view_t bin_max_flops;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_t i) const {
+    const size_t flops = row_flops(i);
+    const int bin      = spgemm_row_bin(flops);
+    row_bin(i)         = bin;
+    Kokkos::atomic_inc(&bin_count(bin));
+    Kokkos::atomic_max(&bin_max_flops(bin), flops);
+  }
+};
+
+// Groups the rows by bin; bin_next starts at the first position of each bin
+template <typename row_bin_view_t, typename bin_view_t,
+          typename bin_rows_view_t>
+struct SpgemmRowBinScatterFunctor {
+  row_bin_view_t row_bin;
+  bin_view_t bin_next;
+  bin_rows_view_t bin_rows;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_t i) const {
+    bin_rows(Kokkos::atomic_fetch_add(&bin_next(row_bin(i)), size_t(1))) = i;
+  }
+};
+
+// Numeric phase of the rows bin_rows(idx) of one bin.
+//   - ListTag: rows of a few flops. The row of C is its own accumulator,
+//     kept sorted by insertion, so no workspace is needed at all.
+//   - AccumulatorTag: a dense or hashed SpgemmRowAccumulator in a pool chunk
+//     sized for the heaviest row of the bin.
+template <typename MyExecSpace, typename lno_t, typename scalar_t,
+          typename a_row_view_t, typename a_nnz_view_t,
+          typename a_scalar_view_t, typename b_row_view_t,
+          typename b_nnz_view_t, typename b_scalar_view_t,
+          typename c_row_view_t, typename c_nnz_view_t,
+          typename c_scalar_view_t, typename bin_rows_view_t,
+          typename pool_t>
+struct SpgemmBinnedNumericFunctor {
+  struct ListTag {};
+  struct AccumulatorTag {};
+
+  using accumulator_t = SpgemmRowAccumulator<lno_t, scalar_t>;
+
+  a_row_view_t rowmapA;
+  a_nnz_view_t entriesA;
+  a_scalar_view_t valuesA;
+  b_row_view_t rowmapB;
+  b_nnz_view_t entriesB;
+  b_scalar_view_t valuesB;
+  c_row_view_t rowmapC;
+  c_nnz_view_t entriesC;
+  c_scalar_view_t valuesC;
+  bin_rows_view_t bin_rows;
+  pool_t pool;
+
+  bool dense;
+  lno_t table, keys;
+  size_t scalar_offset;  // in lno_t units, aligned for scalar_t
+  size_t chunk_size;     // in lno_t units
+
+  SpgemmBinnedNumericFunctor(a_row_view_t rowmapA_, a_nnz_view_t entriesA_,
+                             a_scalar_view_t valuesA_, b_row_view_t rowmapB_,
+                             b_nnz_view_t entriesB_, b_scalar_view_t valuesB_,
+                             c_row_view_t rowmapC_, c_nnz_view_t entriesC_,
+                             c_scalar_view_t valuesC_,
+                             bin_rows_view_t bin_rows_)
+      : rowmapA(rowmapA_),
+        entriesA(entriesA_),
+        valuesA(valuesA_),
+        rowmapB(rowmapB_),
+        entriesB(entriesB_),
+        valuesB(valuesB_),
+        rowmapC(rowmapC_),
+        entriesC(entriesC_),
+        valuesC(valuesC_),
+        bin_rows(bin_rows_),
+        pool(),
+        dense(false),
+        table(0),
+        keys(0),
+        scalar_offset(0),
+        chunk_size(1) {}
+
+  // Sizes the chunk of an accumulator of at most max_keys keys below ncols:
+  // the table, the keys and their slots, then the values.
+  void set_accumulator(const bool dense_, const lno_t ncols,
+                       const lno_t max_keys) {
+    dense = dense_;
+    keys  = max_keys;
+    table = accumulator_t::table_size(dense, ncols, max_keys);
+    const size_t lnos  = size_t(table) + (dense ? 1 : 2) * size_t(keys);
+    const size_t ratio = (sizeof(scalar_t) + sizeof(lno_t) - 1) / sizeof(lno_t);
+    scalar_offset      = ((lnos + ratio - 1) / ratio) * ratio;
+    chunk_size         = scalar_offset + ratio * size_t(keys);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const ListTag &, const size_t idx) const {
+    const lno_t i     = bin_rows(idx);
+    const auto cstart = rowmapC(i);
+    lno_t n           = 0;
+    for (auto pa = rowmapA(i); pa < rowmapA(i + 1); ++pa) {
+      const lno_t k    = entriesA(pa);
+      const scalar_t a = valuesA(pa);
+      for (auto pb = rowmapB(k); pb < rowmapB(k + 1); ++pb) {
+        const lno_t col  = entriesB(pb);
+        const scalar_t v = a * valuesB(pb);
+        lno_t p          = 0;
+        while (p < n && entriesC(cstart + p) < col) ++p;
+        if (p < n && entriesC(cstart + p) == col) {
+          valuesC(cstart + p) += v;
+          continue;
+        }
+        for (lno_t q = n; q > p; --q) {
+          entriesC(cstart + q) = entriesC(cstart + q - 1);
+          valuesC(cstart + q)  = valuesC(cstart + q - 1);
+        }
+        entriesC(cstart + p) = col;
+        valuesC(cstart + p)  = v;
+        ++n;
+      }
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const AccumulatorTag &, const size_t idx) const {
+    const lno_t i = bin_rows(idx);
+    lno_t *chunk  = spgemm_acquire_chunk<MyExecSpace, lno_t>(pool, idx);
+    accumulator_t acc;
+    acc.table = chunk;
+    acc.keys  = acc.table + table;
+    acc.slots = dense ? nullptr : acc.keys + keys;
+    acc.vals  = reinterpret_cast<scalar_t *>(chunk + scalar_offset);
+    acc.mask  = dense ? -1 : table - 1;
+    acc.size  = 0;
+    for (auto pa = rowmapA(i); pa < rowmapA(i + 1); ++pa) {
+      const lno_t k    = entriesA(pa);
+      const scalar_t a = valuesA(pa);
+      for (auto pb = rowmapB(k); pb < rowmapB(k + 1); ++pb)
+        acc.vals[acc.insert(entriesB(pb))] += a * valuesB(pb);
+    }
+    const auto cstart = rowmapC(i);
+    for (lno_t q = 0; q < acc.size; ++q) {
+      entriesC(cstart + q) = acc.keys[q];
+      valuesC(cstart + q)  = acc.vals[q];
+    }
+    acc.clear();
+    pool.release_chunk(chunk);
+  }
+};
+
+template <typename HandleType, typename a_row_view_t_,
+          typename a_lno_nnz_view_t_, typename a_scalar_nnz_view_t_,
+          typename b_lno_row_view_t_, typename b_lno_nnz_view_t_,
+          typename b_scalar_nnz_view_t_>
+void KokkosSPGEMM<HandleType, a_row_view_t_, a_lno_nnz_view_t_,
+                  a_scalar_nnz_view_t_, b_lno_row_view_t_, b_lno_nnz_view_t_,
+                  b_scalar_nnz_view_t_>::compute_row_bins() {
+  typedef Kokkos::View<size_t *, MyTempMemorySpace> bin_view_t;
+
+  auto sh = this->handle->get_spgemm_handle();
+  if (!sh->are_rowflops_computed()) this->compute_row_flops();
+
+  nnz_lno_temp_work_view_t row_bin(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "row bins"), a_row_cnt);
+  bin_view_t bin_count("bin counts", spgemm_num_row_bins);
+  bin_view_t bin_max_flops("bin max flops", spgemm_num_row_bins);
+  Kokkos::parallel_for(
+      "KokkosSparse::spgemm::RowBins", my_exec_space(0, a_row_cnt),
+      SpgemmRowBinCountFunctor<row_lno_persistent_work_view_t,
+                               nnz_lno_temp_work_view_t, bin_view_t>{
+          sh->row_flops, row_bin, bin_count, bin_max_flops});
+
+  auto h_count = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                     bin_count);
+  auto h_max_flops =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), bin_max_flops);
+  sh->row_bin_offsets.assign(spgemm_num_row_bins + 1, 0);
+  sh->row_bin_max_flops.assign(spgemm_num_row_bins, 0);
+  for (int bin = 0; bin < spgemm_num_row_bins; ++bin) {
+    sh->row_bin_offsets[bin + 1] = sh->row_bin_offsets[bin] + h_count(bin);
+    sh->row_bin_max_flops[bin]   = h_max_flops(bin);
+  }
+
+  auto h_next = Kokkos::create_mirror_view(bin_count);
+  for (int bin = 0; bin < spgemm_num_row_bins; ++bin)
+    h_next(bin) = sh->row_bin_offsets[bin];
+  Kokkos::deep_copy(bin_count, h_next);
+  sh->row_bin_rows = nnz_lno_persistent_work_view_t(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "binned rows"),
+      a_row_cnt);
+  Kokkos::parallel_for(
+      "KokkosSparse::spgemm::RowBinScatter", my_exec_space(0, a_row_cnt),
+      SpgemmRowBinScatterFunctor<nnz_lno_temp_work_view_t, bin_view_t,
+                                 nnz_lno_persistent_work_view_t>{
+          row_bin, bin_count, sh->row_bin_rows});
+  sh->set_computed_row_bins();
+
+  if (KOKKOSKERNELS_VERBOSE) {
+    for (int bin = 0; bin < spgemm_num_row_bins; ++bin)
+      std::cout << "\t\tRow bin " << bin << ": "
+                << h_count(bin) << " rows, max flops "
+                << sh->row_bin_max_flops[bin] << std::endl;
+  }
+}
+
+//
+// Row-binned numeric phase (SPGEMMHandle::set_row_binning)
+//
+// The rows of A are grouped by their flop count, as computed in the symbolic
+// phase, and each bin is launched on its own with an accumulator sized for
+// its own heaviest row, so that a few heavy rows no longer size the
+// accumulator of every row:
+//   - bin 0 (at most 16 flops): the row of C itself, kept sorted
+//   - other bins: a hashed accumulator of twice the bin's keys, or a dense
+//     one when that is no larger than the number of columns of B
+// The bins are kept in the handle and reused by later numeric calls.
+template <typename HandleType, typename a_row_view_t_,
+          typename a_lno_nnz_view_t_, typename a_scalar_nnz_view_t_,
+          typename b_lno_row_view_t_, typename b_lno_nnz_view_t_,
+          typename b_scalar_nnz_view_t_>
+template <typename c_row_view_t, typename c_lno_nnz_view_t,
+          typename c_scalar_nnz_view_t>
+void KokkosSPGEMM<HandleType, a_row_view_t_, a_lno_nnz_view_t_,
+                  a_scalar_nnz_view_t_, b_lno_row_view_t_, b_lno_nnz_view_t_,
+                  b_scalar_nnz_view_t_>::
+    KokkosSPGEMM_numeric_binned(c_row_view_t rowmapC_,
+                                c_lno_nnz_view_t entriesC_,
+                                c_scalar_nnz_view_t valuesC_) {
+  typedef KokkosKernels::Impl::UniformMemoryPool<MyTempMemorySpace, nnz_lno_t>
+      pool_memory_space;
+  typedef SpgemmBinnedNumericFunctor<
+      MyExecSpace, nnz_lno_t, scalar_t, const_a_lno_row_view_t,
+      const_a_lno_nnz_view_t, const_a_scalar_nnz_view_t,
+      const_b_lno_row_view_t, const_b_lno_nnz_view_t,
+      const_b_scalar_nnz_view_t, c_row_view_t, c_lno_nnz_view_t,
+      c_scalar_nnz_view_t, nnz_lno_persistent_work_view_t, pool_memory_space>
+      functor_t;
+  typedef Kokkos::RangePolicy<MyExecSpace, typename functor_t::ListTag>
+      list_policy_t;
+  typedef Kokkos::RangePolicy<MyExecSpace, Kokkos::Schedule<Kokkos::Dynamic>,
+                              typename functor_t::AccumulatorTag>
+      accumulator_policy_t;
+
+  if (KOKKOSKERNELS_VERBOSE) {
+    std::cout << "\tBINNED MODE" << std::endl;
+  }
+  auto sh = this->handle->get_spgemm_handle();
+  if (!sh->are_row_bins_computed()) this->compute_row_bins();
+
+  const size_t max_nnz =
+      sh->template get_max_result_nnz<c_row_view_t>(rowmapC_);
+  functor_t f(row_mapA, entriesA, valsA, row_mapB, entriesB, valsB, rowmapC_,
+              entriesC_, valuesC_, sh->row_bin_rows);
+
+  const size_t begin0 = sh->row_bin_offsets[0];
+  const size_t end0   = sh->row_bin_offsets[1];
+  if (end0 > begin0) {
+    Kokkos::parallel_for("KokkosSparse::spgemm::Binned::List",
+                         list_policy_t(begin0, end0), f);
+  }
+
+  for (int bin = 1; bin < spgemm_num_row_bins; ++bin) {
+    const size_t begin = sh->row_bin_offsets[bin];
+    const size_t end   = sh->row_bin_offsets[bin + 1];
+    if (end == begin) continue;
+
+    const nnz_lno_t bin_keys = std::min(
+        {sh->row_bin_max_flops[bin], max_nnz, size_t(this->b_col_cnt)});
+    bool dense;
+    switch (this->spgemm_accumulator) {
+      case SPGEMM_ACC_DENSE: dense = true; break;
+      case SPGEMM_ACC_SPARSE: dense = false; break;
+      default:
+        dense = size_t(this->b_col_cnt) <= sh->MaxColDenseAcc &&
+                this->b_col_cnt <=
+                    SpgemmRowAccumulator<nnz_lno_t, scalar_t>::table_size(
+                        false, this->b_col_cnt, bin_keys);
+    }
+    f.set_accumulator(dense, this->b_col_cnt, bin_keys);
+    f.pool = spgemm_make_pool<pool_memory_space, nnz_lno_t>(f.chunk_size);
+    if (KOKKOSKERNELS_VERBOSE) {
+      std::cout << "\t\tRow bin " << bin << ": " << end - begin << " rows, "
+                << (dense ? "dense" : "hashed") << " accumulator of "
+                << bin_keys << " keys" << std::endl;
+    }
+    Kokkos::parallel_for("KokkosSparse::spgemm::Binned::Accumulator",
+                         accumulator_policy_t(begin, end), f);
+  }
+  MyExecSpace().fence();
+}
+
+}  // namespace Impl
+}  // namespace KokkosSparse
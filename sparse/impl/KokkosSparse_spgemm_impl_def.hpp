@@ -40,8 +40,10 @@ void KokkosSPGEMM<
     std::cout << "Numeric PHASE" << std::endl;
   }
 
-  if (spgemm_algorithm == SPGEMM_KK_SPEED ||
-      spgemm_algorithm == SPGEMM_KK_DENSE) {
+  if (this->handle->get_spgemm_handle()->get_row_binning()) {
+    this->KokkosSPGEMM_numeric_binned(rowmapC_, entriesC_, valuesC_);
+  } else if (spgemm_algorithm == SPGEMM_KK_SPEED ||
+             spgemm_algorithm == SPGEMM_KK_DENSE) {
     this->KokkosSPGEMM_numeric_speed(rowmapC_, entriesC_, valuesC_,
                                      my_exec_space_);
   } else {
@@ -0,0 +1,348 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+#ifndef KOKKOSSPARSE_SPGEMM_MASKED_IMPL_HPP_
+#define KOKKOSSPARSE_SPGEMM_MASKED_IMPL_HPP_
+
+#include <stdexcept>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_ArithTraits.hpp>
+#include "KokkosKernels_SimpleUtils.hpp"
+#include "KokkosSparse_Utils.hpp"
+#include "KokkosSparse_SortCrs.hpp"
+#include "KokkosSparse_spgemm_handle.hpp"
+#include "KokkosSparse_spgemm_accumulator_impl.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+// Layout of a pool chunk of the masked product: one accumulator of at most
+// max_keys keys, its hash slots when sparse, and one flag per key.
+template <typename lno_t, typename scalar_t>
+struct MaskedChunkLayout {
+  lno_t table, keys;
+  bool dense;
+  size_t chunk_size;  // in lno_t units
+
+  MaskedChunkLayout() = default;
+  MaskedChunkLayout(const bool dense_, const lno_t ncols, const lno_t max_keys)
+      : keys(max_keys), dense(dense_) {
+    table = SpgemmRowAccumulator<lno_t, scalar_t>::table_size(dense, ncols,
+                                                              max_keys);
+    chunk_size = size_t(table) + (dense ? 2 : 3) * size_t(keys);
+    if (chunk_size == 0) chunk_size = 1;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void carve(lno_t *chunk, SpgemmRowAccumulator<lno_t, scalar_t> &acc,
+             lno_t *&flags) const {
+    acc.table = chunk;
+    acc.keys  = acc.table + table;
+    flags     = acc.keys + keys;
+    acc.slots = dense ? nullptr : flags + keys;
+    acc.mask  = dense ? -1 : table - 1;
+    acc.vals  = nullptr;
+    acc.size  = 0;
+  }
+};
+
+// Row-by-row masked product C = (A*B) .* M, or (A*B) .* !M with complement.
+// The mask is applied inside the accumulator: with a plain mask, the columns
+// of M(i,:) are the only keys ever inserted and a product only marks its
+// column as hit; with a complemented mask, M(i,:) is inserted first so that
+// the products falling on it are absorbed by existing keys.
+//   - CountTag: rowmapC(i) = number of entries in row i of C
+//   - FillTag:  entriesC of row i, unsorted
+//   - NumericTag: valuesC of row i, for the structure computed before
+template <typename MyExecSpace, typename lno_t, typename scalar_t,
+          typename a_row_view_t, typename a_nnz_view_t,
+          typename a_scalar_view_t, typename b_row_view_t,
+          typename b_nnz_view_t, typename b_scalar_view_t,
+          typename m_row_view_t, typename m_nnz_view_t,
+          typename c_row_view_t, typename c_nnz_view_t,
+          typename c_scalar_view_t, typename pool_t>
+struct SpgemmMaskedFunctor {
+  struct CountTag {};
+  struct FillTag {};
+  struct NumericTag {};
+
+  using accumulator_t = SpgemmRowAccumulator<lno_t, scalar_t>;
+  using layout_t      = MaskedChunkLayout<lno_t, scalar_t>;
+
+  a_row_view_t rowmapA;
+  a_nnz_view_t entriesA;
+  a_scalar_view_t valuesA;
+  b_row_view_t rowmapB;
+  b_nnz_view_t entriesB;
+  b_scalar_view_t valuesB;
+  m_row_view_t rowmapM;
+  m_nnz_view_t entriesM;
+  c_row_view_t rowmapC;
+  c_nnz_view_t entriesC;
+  c_scalar_view_t valuesC;
+  bool complement;
+  pool_t pool;
+  layout_t layout;
+
+  SpgemmMaskedFunctor(a_row_view_t rowmapA_, a_nnz_view_t entriesA_,
+                      a_scalar_view_t valuesA_, b_row_view_t rowmapB_,
+                      b_nnz_view_t entriesB_, b_scalar_view_t valuesB_,
+                      m_row_view_t rowmapM_, m_nnz_view_t entriesM_,
+                      c_row_view_t rowmapC_, c_nnz_view_t entriesC_,
+                      c_scalar_view_t valuesC_, const bool complement_,
+                      const pool_t &pool_, const layout_t &layout_)
+      : rowmapA(rowmapA_),
+        entriesA(entriesA_),
+        valuesA(valuesA_),
+        rowmapB(rowmapB_),
+        entriesB(entriesB_),
+        valuesB(valuesB_),
+        rowmapM(rowmapM_),
+        entriesM(entriesM_),
+        rowmapC(rowmapC_),
+        entriesC(entriesC_),
+        valuesC(valuesC_),
+        complement(complement_),
+        pool(pool_),
+        layout(layout_) {}
+
+  // Accumulates the pattern of row i of C. On return the columns of C are
+  // the keys whose flag is set.
+  KOKKOS_INLINE_FUNCTION
+  void row_pattern(const lno_t i, accumulator_t &acc, lno_t *flags) const {
+    for (auto pm = rowmapM(i); pm < rowmapM(i + 1); ++pm) {
+      const lno_t pos = acc.insert(entriesM(pm));
+      flags[pos]      = 0;
+    }
+    const lno_t nmask = acc.size;
+    for (auto pa = rowmapA(i); pa < rowmapA(i + 1); ++pa) {
+      const lno_t k = entriesA(pa);
+      for (auto pb = rowmapB(k); pb < rowmapB(k + 1); ++pb) {
+        if (complement) {
+          const lno_t pos = acc.insert(entriesB(pb));
+          if (pos >= nmask) flags[pos] = 1;
+        } else {
+          const lno_t pos = acc.find(entriesB(pb));
+          if (pos >= 0) flags[pos] = 1;
+        }
+      }
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const CountTag &, const lno_t i) const {
+    lno_t *chunk = spgemm_acquire_chunk<MyExecSpace, lno_t>(pool, i);
+    accumulator_t acc;
+    lno_t *flags;
+    layout.carve(chunk, acc, flags);
+    row_pattern(i, acc, flags);
+    lno_t count = 0;
+    for (lno_t q = 0; q < acc.size; ++q) count += flags[q];
+    rowmapC(i) = count;
+    acc.clear();
+    pool.release_chunk(chunk);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const FillTag &, const lno_t i) const {
+    lno_t *chunk = spgemm_acquire_chunk<MyExecSpace, lno_t>(pool, i);
+    accumulator_t acc;
+    lno_t *flags;
+    layout.carve(chunk, acc, flags);
+    row_pattern(i, acc, flags);
+    auto pc = rowmapC(i);
+    for (lno_t q = 0; q < acc.size; ++q)
+      if (flags[q]) entriesC(pc++) = acc.keys[q];
+    acc.clear();
+    pool.release_chunk(chunk);
+  }
+
+  // The structure of C already carries the mask: the products that do not
+  // land on a column of C(i,:) are dropped.
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const NumericTag &, const lno_t i) const {
+    lno_t *chunk = spgemm_acquire_chunk<MyExecSpace, lno_t>(pool, i);
+    accumulator_t acc;
+    lno_t *flags;
+    layout.carve(chunk, acc, flags);
+    const auto cstart = rowmapC(i);
+    for (auto pc = cstart; pc < rowmapC(i + 1); ++pc) {
+      acc.insert(entriesC(pc));
+      valuesC(pc) = Kokkos::ArithTraits<scalar_t>::zero();
+    }
+    for (auto pa = rowmapA(i); pa < rowmapA(i + 1); ++pa) {
+      const lno_t k    = entriesA(pa);
+      const scalar_t a = valuesA(pa);
+      for (auto pb = rowmapB(k); pb < rowmapB(k + 1); ++pb) {
+        const lno_t pos = acc.find(entriesB(pb));
+        if (pos >= 0) valuesC(cstart + pos) += a * valuesB(pb);
+      }
+    }
+    acc.clear();
+    pool.release_chunk(chunk);
+  }
+};
+
+// Upper bound on the keys of the accumulator of a complemented product:
+// max_i nnz(M(i,:)) + sum_{k in A(i,:)} nnz(B(k,:))
+template <typename a_row_view_t, typename a_nnz_view_t, typename b_row_view_t,
+          typename m_row_view_t, typename lno_t>
+struct MaskedRowBoundFunctor {
+  a_row_view_t rowmapA;
+  a_nnz_view_t entriesA;
+  b_row_view_t rowmapB;
+  m_row_view_t rowmapM;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const lno_t i, size_t &lmax) const {
+    size_t bound = rowmapM(i + 1) - rowmapM(i);
+    for (auto pa = rowmapA(i); pa < rowmapA(i + 1); ++pa) {
+      const lno_t k = entriesA(pa);
+      bound += rowmapB(k + 1) - rowmapB(k);
+    }
+    if (bound > lmax) lmax = bound;
+  }
+};
+
+/// Symbolic phase of C = (A*B) .* M (or .* !M when complement is true):
+/// computes rowmapC and the sorted entriesC, allocating entriesC.
+template <typename KernelHandle, typename a_row_view_t,
+          typename a_nnz_view_t, typename b_row_view_t,
+          typename b_nnz_view_t, typename m_row_view_t,
+          typename m_nnz_view_t, typename c_row_view_t,
+          typename c_nnz_view_t>
+void spgemm_masked_symbolic(KernelHandle *handle,
+                            typename KernelHandle::nnz_lno_t nrowsA,
+                            typename KernelHandle::nnz_lno_t ncolsB,
+                            a_row_view_t rowmapA, a_nnz_view_t entriesA,
+                            b_row_view_t rowmapB, b_nnz_view_t entriesB,
+                            m_row_view_t rowmapM, m_nnz_view_t entriesM,
+                            const bool complement, c_row_view_t rowmapC,
+                            c_nnz_view_t &entriesC) {
+  using lno_t      = typename KernelHandle::nnz_lno_t;
+  using scalar_t   = typename KernelHandle::nnz_scalar_t;
+  using exec_space = typename KernelHandle::HandleExecSpace;
+  using pool_t = KokkosKernels::Impl::UniformMemoryPool<exec_space, lno_t>;
+  using functor_t =
+      SpgemmMaskedFunctor<exec_space, lno_t, scalar_t, a_row_view_t,
+                          a_nnz_view_t, a_nnz_view_t, b_row_view_t,
+                          b_nnz_view_t, b_nnz_view_t, m_row_view_t,
+                          m_nnz_view_t, c_row_view_t, c_nnz_view_t,
+                          c_nnz_view_t, pool_t>;
+  using layout_t = typename functor_t::layout_t;
+
+  auto sh = handle->get_spgemm_handle();
+
+  // A plain mask bounds the row of C by itself; a complemented one lets
+  // every product in.
+  size_t max_keys = 0;
+  if (complement) {
+    Kokkos::parallel_reduce(
+        "KokkosSparse::spgemm_masked::RowBound",
+        Kokkos::RangePolicy<exec_space>(0, nrowsA),
+        MaskedRowBoundFunctor<a_row_view_t, a_nnz_view_t, b_row_view_t,
+                              m_row_view_t, lno_t>{rowmapA, entriesA,
+                                                   rowmapB, rowmapM},
+        Kokkos::Max<size_t>(max_keys));
+  } else {
+    max_keys =
+        KokkosSparse::Impl::graph_max_degree<exec_space, size_t>(rowmapM);
+  }
+  max_keys = std::min<size_t>(max_keys, ncolsB);
+
+  const bool dense = spgemm_use_dense_accumulator(sh, ncolsB, ncolsB);
+  layout_t layout(dense, ncolsB, max_keys);
+  pool_t pool = spgemm_make_pool<pool_t, lno_t>(layout.chunk_size);
+
+  functor_t f(rowmapA, entriesA, entriesA, rowmapB, entriesB, entriesB,
+              rowmapM, entriesM, rowmapC, entriesC, entriesC, complement,
+              pool, layout);
+  Kokkos::parallel_for(
+      "KokkosSparse::spgemm_masked::Count",
+      Kokkos::RangePolicy<exec_space, typename functor_t::CountTag>(0,
+                                                                    nrowsA),
+      f);
+  typename c_row_view_t::non_const_value_type c_nnz = 0;
+  KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<c_row_view_t,
+                                                        exec_space>(
+      nrowsA + 1, rowmapC, c_nnz);
+  sh->set_c_nnz(c_nnz);
+
+  entriesC = c_nnz_view_t(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "entriesC"), c_nnz);
+  f.entriesC = entriesC;
+  Kokkos::parallel_for(
+      "KokkosSparse::spgemm_masked::Fill",
+      Kokkos::RangePolicy<exec_space, typename functor_t::FillTag>(0, nrowsA),
+      f);
+  KokkosSparse::sort_crs_graph<exec_space>(rowmapC, entriesC);
+  sh->set_max_result_nnz(
+      KokkosSparse::Impl::graph_max_degree<exec_space, lno_t>(rowmapC));
+  sh->set_call_symbolic();
+}
+
+/// Numeric phase of the masked product for the structure of C computed by
+/// spgemm_masked_symbolic. Only the values of A and B may have changed.
+template <typename KernelHandle, typename a_row_view_t,
+          typename a_nnz_view_t, typename a_scalar_view_t,
+          typename b_row_view_t, typename b_nnz_view_t,
+          typename b_scalar_view_t, typename c_row_view_t,
+          typename c_nnz_view_t, typename c_scalar_view_t>
+void spgemm_masked_numeric(KernelHandle *handle,
+                           typename KernelHandle::nnz_lno_t nrowsA,
+                           typename KernelHandle::nnz_lno_t ncolsB,
+                           a_row_view_t rowmapA, a_nnz_view_t entriesA,
+                           a_scalar_view_t valuesA, b_row_view_t rowmapB,
+                           b_nnz_view_t entriesB, b_scalar_view_t valuesB,
+                           c_row_view_t rowmapC, c_nnz_view_t entriesC,
+                           c_scalar_view_t valuesC) {
+  using lno_t      = typename KernelHandle::nnz_lno_t;
+  using scalar_t   = typename KernelHandle::nnz_scalar_t;
+  using exec_space = typename KernelHandle::HandleExecSpace;
+  using pool_t = KokkosKernels::Impl::UniformMemoryPool<exec_space, lno_t>;
+  using functor_t =
+      SpgemmMaskedFunctor<exec_space, lno_t, scalar_t, a_row_view_t,
+                          a_nnz_view_t, a_scalar_view_t, b_row_view_t,
+                          b_nnz_view_t, b_scalar_view_t, c_row_view_t,
+                          c_nnz_view_t, c_row_view_t, c_nnz_view_t,
+                          c_scalar_view_t, pool_t>;
+  using layout_t = typename functor_t::layout_t;
+
+  auto sh = handle->get_spgemm_handle();
+  if (!sh->is_symbolic_called()) {
+    throw std::runtime_error(
+        "KokkosSparse::masked_spgemm_numeric: the symbolic phase must be "
+        "called first");
+  }
+
+  const bool dense = spgemm_use_dense_accumulator(sh, ncolsB, ncolsB);
+  layout_t layout(dense, ncolsB, sh->get_max_result_nnz(rowmapC));
+  pool_t pool = spgemm_make_pool<pool_t, lno_t>(layout.chunk_size);
+
+  functor_t f(rowmapA, entriesA, valuesA, rowmapB, entriesB, valuesB,
+              rowmapC, entriesC, rowmapC, entriesC, valuesC, false, pool,
+              layout);
+  Kokkos::parallel_for(
+      "KokkosSparse::spgemm_masked::Numeric",
+      Kokkos::RangePolicy<exec_space, typename functor_t::NumericTag>(0,
+                                                                      nrowsA),
+      f);
+  sh->set_call_numeric();
+}
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif
@@ -27,6 +27,7 @@
 #include "KokkosSparse_spgemm_impl.hpp"
 #include "KokkosSparse_spgemm_impl_seq.hpp"
 #include "KokkosSparse_SortCrs.hpp"
+#include "KokkosSparse_spgemm_reuse_map_impl.hpp"
 #endif
 
 namespace KokkosSparse {
@@ -147,6 +148,17 @@ struct SPGEMM_NUMERIC<
       sh->set_computed_entries();
       return;
     }
+    const bool reuse_map =
+        sh->get_numeric_reuse_map() && !transposeA && !transposeB;
+    if (reuse_map && sh->is_reuse_map_computed() &&
+        sh->reuse_map_rowmap.extent(0) == size_t(m) + 1) {
+      spgemm_reuse_map_numeric(handle, m, row_mapA, entriesA, valuesA,
+                               row_mapB, entriesB, valuesB, row_mapC,
+                               entriesC, valuesC);
+      sh->set_call_numeric();
+      sh->set_computed_entries();
+      return;
+    }
     switch (sh->get_algorithm_type()) {
       case SPGEMM_SERIAL:
       case SPGEMM_DEBUG:
@@ -168,6 +180,9 @@ struct SPGEMM_NUMERIC<
     // TODO: remove this call when impl sorts
     KokkosSparse::sort_crs_matrix<typename KernelHandle::HandleExecSpace>(
         row_mapC, entriesC, valuesC);
+    if (reuse_map)
+      spgemm_build_reuse_map(handle, m, row_mapA, entriesA, valuesA, row_mapB,
+                             entriesB, valuesB, row_mapC, entriesC, valuesC);
     sh->set_call_numeric();
     sh->set_computed_entries();
   }
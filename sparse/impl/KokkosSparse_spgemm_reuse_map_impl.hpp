@@ -0,0 +1,203 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+#ifndef KOKKOSSPARSE_SPGEMM_REUSE_MAP_IMPL_HPP_
+#define KOKKOSSPARSE_SPGEMM_REUSE_MAP_IMPL_HPP_
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_ArithTraits.hpp>
+#include "KokkosKernels_SimpleUtils.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+// The contribution map of C = A*B: for the f-th product a_ik * b_kj of row i,
+// taken in the order of the entries of A(i,:) and then of B(k,:), the offset
+// of j in the sorted row C(i,:). mapRowmap holds the first product of each
+// row. Once the map is built, a numeric phase is a gather over the products,
+// with no accumulator and no sort.
+template <typename lno_t, typename a_row_view_t, typename a_nnz_view_t,
+          typename a_scalar_view_t, typename b_row_view_t,
+          typename b_nnz_view_t, typename b_scalar_view_t,
+          typename c_row_view_t, typename c_nnz_view_t,
+          typename c_scalar_view_t, typename map_row_view_t,
+          typename map_view_t>
+struct SpgemmReuseMapFunctor {
+  struct FlopCountTag {};
+  struct BuildTag {};
+  struct GatherTag {};
+
+  using scalar_t = typename c_scalar_view_t::non_const_value_type;
+
+  a_row_view_t rowmapA;
+  a_nnz_view_t entriesA;
+  a_scalar_view_t valuesA;
+  b_row_view_t rowmapB;
+  b_nnz_view_t entriesB;
+  b_scalar_view_t valuesB;
+  c_row_view_t rowmapC;
+  c_nnz_view_t entriesC;
+  c_scalar_view_t valuesC;
+  map_row_view_t mapRowmap;
+  map_view_t map;
+
+  // Products of row i, in mapRowmap(i) before the prefix sum
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const FlopCountTag &, const lno_t i) const {
+    typename map_row_view_t::non_const_value_type flops = 0;
+    for (auto pa = rowmapA(i); pa < rowmapA(i + 1); ++pa) {
+      const lno_t k = entriesA(pa);
+      flops += rowmapB(k + 1) - rowmapB(k);
+    }
+    mapRowmap(i) = flops;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const BuildTag &, const lno_t i) const {
+    const auto c_begin = rowmapC(i);
+    const lno_t c_len  = rowmapC(i + 1) - c_begin;
+    auto f             = mapRowmap(i);
+    for (auto pa = rowmapA(i); pa < rowmapA(i + 1); ++pa) {
+      const lno_t k = entriesA(pa);
+      for (auto pb = rowmapB(k); pb < rowmapB(k + 1); ++pb) {
+        const lno_t j = entriesB(pb);
+        lno_t lo = 0, hi = c_len;
+        while (hi - lo > 1) {
+          const lno_t mid = lo + (hi - lo) / 2;
+          if (entriesC(c_begin + mid) <= j)
+            lo = mid;
+          else
+            hi = mid;
+        }
+        // Every product lands on an entry of the structure of C
+        KOKKOS_ASSERT(lo < c_len && entriesC(c_begin + lo) == j);
+        map(f++) = lo;
+      }
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const GatherTag &, const lno_t i) const {
+    const auto c_begin = rowmapC(i);
+    for (auto pc = c_begin; pc < rowmapC(i + 1); ++pc)
+      valuesC(pc) = Kokkos::ArithTraits<scalar_t>::zero();
+    auto f = mapRowmap(i);
+    for (auto pa = rowmapA(i); pa < rowmapA(i + 1); ++pa) {
+      const lno_t k       = entriesA(pa);
+      const scalar_t a_ik = valuesA(pa);
+      for (auto pb = rowmapB(k); pb < rowmapB(k + 1); ++pb)
+        valuesC(c_begin + map(f++)) += a_ik * valuesB(pb);
+    }
+  }
+};
+
+/// Records the contribution map of C = A*B in the SPGEMMHandle, for the
+/// sorted structure of C left by a numeric phase. The values are not read;
+/// they only give the functor the types of the numeric phase.
+template <typename KernelHandle, typename a_row_view_t,
+          typename a_nnz_view_t, typename a_scalar_view_t,
+          typename b_row_view_t, typename b_nnz_view_t,
+          typename b_scalar_view_t, typename c_row_view_t,
+          typename c_nnz_view_t, typename c_scalar_view_t>
+void spgemm_build_reuse_map(KernelHandle *handle,
+                            typename KernelHandle::nnz_lno_t m,
+                            a_row_view_t rowmapA, a_nnz_view_t entriesA,
+                            a_scalar_view_t valuesA, b_row_view_t rowmapB,
+                            b_nnz_view_t entriesB, b_scalar_view_t valuesB,
+                            c_row_view_t rowmapC, c_nnz_view_t entriesC,
+                            c_scalar_view_t valuesC) {
+  using lno_t      = typename KernelHandle::nnz_lno_t;
+  using exec_space = typename KernelHandle::HandleExecSpace;
+  using spgemm_handle_t = typename KernelHandle::SPGEMMHandleType;
+  using map_row_view_t =
+      typename spgemm_handle_t::row_lno_persistent_work_view_t;
+  using map_view_t = typename spgemm_handle_t::nnz_lno_persistent_work_view_t;
+  using functor_t  = SpgemmReuseMapFunctor<
+      lno_t, a_row_view_t, a_nnz_view_t, a_scalar_view_t, b_row_view_t,
+      b_nnz_view_t, b_scalar_view_t, c_row_view_t, c_nnz_view_t,
+      c_scalar_view_t, map_row_view_t, map_view_t>;
+  using sched_t = Kokkos::Schedule<Kokkos::Dynamic>;
+
+  auto sh = handle->get_spgemm_handle();
+  // The flop count fills the first m entries; the exclusive scan reads the
+  // last one as zero, so none of them needs initializing
+  map_row_view_t mapRowmap(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "SpGEMM reuse rowmap"),
+      m + 1);
+  functor_t f{rowmapA, entriesA, valuesA, rowmapB,   entriesB,    valuesB,
+              rowmapC, entriesC, valuesC, mapRowmap, map_view_t()};
+  Kokkos::parallel_for(
+      "KokkosSparse::spgemm_reuse_map::FlopCount",
+      Kokkos::RangePolicy<exec_space, typename functor_t::FlopCountTag>(0, m),
+      f);
+  typename map_row_view_t::non_const_value_type flops = 0;
+  KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<map_row_view_t,
+                                                        exec_space>(
+      m + 1, mapRowmap, flops);
+
+  f.map = map_view_t(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "SpGEMM reuse map"),
+      flops);
+  Kokkos::parallel_for(
+      "KokkosSparse::spgemm_reuse_map::Build",
+      Kokkos::RangePolicy<exec_space, sched_t, typename functor_t::BuildTag>(
+          0, m),
+      f);
+  sh->reuse_map_rowmap = mapRowmap;
+  sh->reuse_map        = f.map;
+  sh->set_computed_reuse_map();
+}
+
+/// Numeric phase of C = A*B through the contribution map of the
+/// SPGEMMHandle: overwrites valuesC, leaving the structure of C as is.
+template <typename KernelHandle, typename a_row_view_t,
+          typename a_nnz_view_t, typename a_scalar_view_t,
+          typename b_row_view_t, typename b_nnz_view_t,
+          typename b_scalar_view_t, typename c_row_view_t,
+          typename c_nnz_view_t, typename c_scalar_view_t>
+void spgemm_reuse_map_numeric(KernelHandle *handle,
+                              typename KernelHandle::nnz_lno_t m,
+                              a_row_view_t rowmapA, a_nnz_view_t entriesA,
+                              a_scalar_view_t valuesA, b_row_view_t rowmapB,
+                              b_nnz_view_t entriesB, b_scalar_view_t valuesB,
+                              c_row_view_t rowmapC, c_nnz_view_t entriesC,
+                              c_scalar_view_t valuesC) {
+  using lno_t      = typename KernelHandle::nnz_lno_t;
+  using exec_space = typename KernelHandle::HandleExecSpace;
+  using spgemm_handle_t = typename KernelHandle::SPGEMMHandleType;
+  using map_row_view_t =
+      typename spgemm_handle_t::row_lno_persistent_work_view_t;
+  using map_view_t = typename spgemm_handle_t::nnz_lno_persistent_work_view_t;
+  using functor_t  = SpgemmReuseMapFunctor<
+      lno_t, a_row_view_t, a_nnz_view_t, a_scalar_view_t, b_row_view_t,
+      b_nnz_view_t, b_scalar_view_t, c_row_view_t, c_nnz_view_t,
+      c_scalar_view_t, map_row_view_t, map_view_t>;
+  using sched_t = Kokkos::Schedule<Kokkos::Dynamic>;
+
+  auto sh = handle->get_spgemm_handle();
+  functor_t f{rowmapA,  entriesA, valuesA, rowmapB,
+              entriesB, valuesB,  rowmapC, entriesC,
+              valuesC,  sh->reuse_map_rowmap, sh->reuse_map};
+  Kokkos::parallel_for(
+      "KokkosSparse::spgemm_reuse_map::Gather",
+      Kokkos::RangePolicy<exec_space, sched_t, typename functor_t::GatherTag>(
+          0, m),
+      f);
+}
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif
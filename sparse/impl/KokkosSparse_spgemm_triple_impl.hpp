@@ -0,0 +1,440 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+#ifndef KOKKOSSPARSE_SPGEMM_TRIPLE_IMPL_HPP_
+#define KOKKOSSPARSE_SPGEMM_TRIPLE_IMPL_HPP_
+
+#include <stdexcept>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_ArithTraits.hpp>
+#include "KokkosKernels_SimpleUtils.hpp"
+#include "KokkosSparse_Utils.hpp"
+#include "KokkosSparse_SortCrs.hpp"
+#include "KokkosSparse_spgemm_handle.hpp"
+#include "KokkosSparse_spgemm_accumulator_impl.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+// Sizes of the two accumulators of spgemm_triple. The first holds a row of
+// R*A, the second a row of C = R*A*P; both live in one memory pool chunk,
+// followed by the values of the first when the numeric phase needs them.
+template <typename lno_t, typename scalar_t>
+struct TripleChunkLayout {
+  lno_t table1, keys1, table2, keys2;
+  bool dense;
+  size_t scalar_offset;  // in lno_t units, aligned for scalar_t
+  size_t chunk_size;     // in lno_t units
+
+  TripleChunkLayout() = default;
+  TripleChunkLayout(const bool dense_, const lno_t ncolsA, const lno_t ncolsP,
+                    const lno_t max_ra, const lno_t max_c,
+                    const bool with_values)
+      : keys1(max_ra), keys2(max_c), dense(dense_) {
+    using accumulator_t = SpgemmRowAccumulator<lno_t, scalar_t>;
+    table1              = accumulator_t::table_size(dense, ncolsA, max_ra);
+    table2              = accumulator_t::table_size(dense, ncolsP, max_c);
+    // tables, keys, and for a sparse accumulator the slots of the keys
+    const size_t keys = size_t(keys1) + size_t(keys2);
+    const size_t lnos = size_t(table1) + table2 + (dense ? 1 : 2) * keys;
+
+    const size_t ratio = (sizeof(scalar_t) + sizeof(lno_t) - 1) / sizeof(lno_t);
+    scalar_offset      = ((lnos + ratio - 1) / ratio) * ratio;
+    chunk_size         = with_values ? scalar_offset + ratio * size_t(keys1)
+                                     : lnos;
+    if (chunk_size == 0) chunk_size = 1;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void carve(lno_t *chunk, const bool with_values,
+             SpgemmRowAccumulator<lno_t, scalar_t> &acc1,
+             SpgemmRowAccumulator<lno_t, scalar_t> &acc2) const {
+    const lno_t nslots1 = dense ? 0 : keys1;
+    acc1.table          = chunk;
+    acc1.keys           = acc1.table + table1;
+    acc2.table          = acc1.keys + keys1;
+    acc2.keys           = acc2.table + table2;
+    acc1.slots          = dense ? nullptr : acc2.keys + keys2;
+    acc2.slots          = dense ? nullptr : acc2.keys + keys2 + nslots1;
+    acc1.mask           = dense ? -1 : table1 - 1;
+    acc2.mask           = dense ? -1 : table2 - 1;
+    acc1.vals =
+        with_values ? reinterpret_cast<scalar_t *>(chunk + scalar_offset)
+                    : nullptr;
+    acc2.vals = nullptr;
+    acc1.size = 0;
+    acc2.size = 0;
+  }
+};
+
+// Row-by-row triple product C = R*A*P. For each row i of R, the row of R*A
+// is accumulated first and then multiplied by P, so neither R*A nor A*P is
+// ever stored: the only temporary memory is one pool chunk per thread.
+// CountTag and FillTag only build the column pattern, counting it into
+// rowmapC(i) and then copying it, unsorted, to entriesC. NumericTag keys
+// acc2 with the existing entries of row i, so that each product of P is
+// added straight to its position in valuesC.
+template <typename MyExecSpace, typename lno_t, typename scalar_t,
+          typename r_row_view_t, typename r_nnz_view_t,
+          typename r_scalar_view_t, typename a_row_view_t,
+          typename a_nnz_view_t, typename a_scalar_view_t,
+          typename p_row_view_t, typename p_nnz_view_t,
+          typename p_scalar_view_t, typename c_row_view_t,
+          typename c_nnz_view_t, typename c_scalar_view_t, typename pool_t>
+struct SpgemmTripleFunctor {
+  struct CountTag {};
+  struct FillTag {};
+  struct NumericTag {};
+
+  using accumulator_t = SpgemmRowAccumulator<lno_t, scalar_t>;
+  using layout_t      = TripleChunkLayout<lno_t, scalar_t>;
+
+  r_row_view_t rowmapR;
+  r_nnz_view_t entriesR;
+  r_scalar_view_t valuesR;
+  a_row_view_t rowmapA;
+  a_nnz_view_t entriesA;
+  a_scalar_view_t valuesA;
+  p_row_view_t rowmapP;
+  p_nnz_view_t entriesP;
+  p_scalar_view_t valuesP;
+  c_row_view_t rowmapC;
+  c_nnz_view_t entriesC;
+  c_scalar_view_t valuesC;
+  pool_t pool;
+  layout_t layout;
+
+  SpgemmTripleFunctor(r_row_view_t rowmapR_, r_nnz_view_t entriesR_,
+                      r_scalar_view_t valuesR_, a_row_view_t rowmapA_,
+                      a_nnz_view_t entriesA_, a_scalar_view_t valuesA_,
+                      p_row_view_t rowmapP_, p_nnz_view_t entriesP_,
+                      p_scalar_view_t valuesP_, c_row_view_t rowmapC_,
+                      c_nnz_view_t entriesC_, c_scalar_view_t valuesC_,
+                      const pool_t &pool_, const layout_t &layout_)
+      : rowmapR(rowmapR_),
+        entriesR(entriesR_),
+        valuesR(valuesR_),
+        rowmapA(rowmapA_),
+        entriesA(entriesA_),
+        valuesA(valuesA_),
+        rowmapP(rowmapP_),
+        entriesP(entriesP_),
+        valuesP(valuesP_),
+        rowmapC(rowmapC_),
+        entriesC(entriesC_),
+        valuesC(valuesC_),
+        pool(pool_),
+        layout(layout_) {}
+
+  // Inserts the column pattern of row i of R*A*P into acc2
+  KOKKOS_INLINE_FUNCTION
+  void row_pattern(const lno_t i, accumulator_t &acc1,
+                   accumulator_t &acc2) const {
+    for (auto pr = rowmapR(i); pr < rowmapR(i + 1); ++pr) {
+      const lno_t k = entriesR(pr);
+      for (auto pa = rowmapA(k); pa < rowmapA(k + 1); ++pa)
+        acc1.insert(entriesA(pa));
+    }
+    for (lno_t q = 0; q < acc1.size; ++q) {
+      const lno_t j = acc1.keys[q];
+      for (auto pp = rowmapP(j); pp < rowmapP(j + 1); ++pp)
+        acc2.insert(entriesP(pp));
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const CountTag &, const lno_t i) const {
+    lno_t *chunk = spgemm_acquire_chunk<MyExecSpace, lno_t>(pool, i);
+    accumulator_t acc1, acc2;
+    layout.carve(chunk, false, acc1, acc2);
+    row_pattern(i, acc1, acc2);
+    rowmapC(i) = acc2.size;
+    acc1.clear();
+    acc2.clear();
+    pool.release_chunk(chunk);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const FillTag &, const lno_t i) const {
+    lno_t *chunk = spgemm_acquire_chunk<MyExecSpace, lno_t>(pool, i);
+    accumulator_t acc1, acc2;
+    layout.carve(chunk, false, acc1, acc2);
+    row_pattern(i, acc1, acc2);
+    const auto cstart = rowmapC(i);
+    for (lno_t q = 0; q < acc2.size; ++q) entriesC(cstart + q) = acc2.keys[q];
+    acc1.clear();
+    acc2.clear();
+    pool.release_chunk(chunk);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const NumericTag &, const lno_t i) const {
+    lno_t *chunk = spgemm_acquire_chunk<MyExecSpace, lno_t>(pool, i);
+    accumulator_t acc1, acc2;
+    layout.carve(chunk, true, acc1, acc2);
+    // Map each column of row i of C to its offset within the row
+    const auto cstart = rowmapC(i);
+    const auto cend   = rowmapC(i + 1);
+    for (auto pc = cstart; pc < cend; ++pc) {
+      acc2.insert(entriesC(pc));
+      valuesC(pc) = Kokkos::ArithTraits<scalar_t>::zero();
+    }
+    // Row i of R*A
+    for (auto pr = rowmapR(i); pr < rowmapR(i + 1); ++pr) {
+      const lno_t k    = entriesR(pr);
+      const scalar_t r = valuesR(pr);
+      for (auto pa = rowmapA(k); pa < rowmapA(k + 1); ++pa)
+        acc1.vals[acc1.insert(entriesA(pa))] += r * valuesA(pa);
+    }
+    // Times P, straight into the values of C
+    for (lno_t q = 0; q < acc1.size; ++q) {
+      const lno_t j    = acc1.keys[q];
+      const scalar_t t = acc1.vals[q];
+      for (auto pp = rowmapP(j); pp < rowmapP(j + 1); ++pp)
+        valuesC(cstart + acc2.insert(entriesP(pp))) += t * valuesP(pp);
+    }
+    acc1.clear();
+    acc2.clear();
+    pool.release_chunk(chunk);
+  }
+};
+
+// Upper bound on the entries of a row of R*A:
+// min(ncolsA, max_i sum_{k in R(i,:)} nnz(A(k,:)))
+template <typename r_row_view_t, typename r_nnz_view_t, typename a_row_view_t,
+          typename lno_t>
+struct TripleRowBoundFunctor {
+  r_row_view_t rowmapR;
+  r_nnz_view_t entriesR;
+  a_row_view_t rowmapA;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const lno_t i, size_t &lmax) const {
+    size_t bound = 0;
+    for (auto pr = rowmapR(i); pr < rowmapR(i + 1); ++pr) {
+      const lno_t k = entriesR(pr);
+      bound += rowmapA(k + 1) - rowmapA(k);
+    }
+    if (bound > lmax) lmax = bound;
+  }
+};
+
+/// Symbolic phase of C = R*A*P: computes rowmapC and the sorted entriesC,
+/// allocating entriesC, and records in the SPGEMMHandle what the numeric
+/// phase reuses.
+template <typename KernelHandle, typename r_row_view_t,
+          typename r_nnz_view_t, typename a_row_view_t,
+          typename a_nnz_view_t, typename p_row_view_t,
+          typename p_nnz_view_t, typename c_row_view_t,
+          typename c_nnz_view_t>
+void spgemm_triple_symbolic(KernelHandle *handle,
+                            typename KernelHandle::nnz_lno_t nrowsR,
+                            typename KernelHandle::nnz_lno_t ncolsA,
+                            typename KernelHandle::nnz_lno_t ncolsP,
+                            r_row_view_t rowmapR, r_nnz_view_t entriesR,
+                            a_row_view_t rowmapA, a_nnz_view_t entriesA,
+                            p_row_view_t rowmapP, p_nnz_view_t entriesP,
+                            c_row_view_t rowmapC, c_nnz_view_t &entriesC) {
+  using lno_t      = typename KernelHandle::nnz_lno_t;
+  using scalar_t   = typename KernelHandle::nnz_scalar_t;
+  using exec_space = typename KernelHandle::HandleExecSpace;
+  using pool_t = KokkosKernels::Impl::UniformMemoryPool<exec_space, lno_t>;
+  using functor_t =
+      SpgemmTripleFunctor<exec_space, lno_t, scalar_t, r_row_view_t,
+                          r_nnz_view_t, r_nnz_view_t, a_row_view_t,
+                          a_nnz_view_t, a_nnz_view_t, p_row_view_t,
+                          p_nnz_view_t, p_nnz_view_t, c_row_view_t,
+                          c_nnz_view_t, c_nnz_view_t, pool_t>;
+  using layout_t = typename functor_t::layout_t;
+
+  auto sh = handle->get_spgemm_handle();
+
+  // Bound the lengths of the rows of R*A and of C
+  size_t max_ra = 0;
+  Kokkos::parallel_reduce(
+      "KokkosSparse::spgemm_triple::RowBound",
+      Kokkos::RangePolicy<exec_space>(0, nrowsR),
+      TripleRowBoundFunctor<r_row_view_t, r_nnz_view_t, a_row_view_t, lno_t>{
+          rowmapR, entriesR, rowmapA},
+      Kokkos::Max<size_t>(max_ra));
+  const size_t max_p =
+      KokkosSparse::Impl::graph_max_degree<exec_space, size_t>(rowmapP);
+  max_ra = std::min<size_t>(max_ra, ncolsA);
+
+  const size_t max_c = std::min<size_t>(max_ra * max_p, ncolsP);
+  const bool dense   = spgemm_use_dense_accumulator(sh, ncolsA, ncolsP);
+  sh->triple_dense   = dense;
+  sh->triple_max_ra  = max_ra;
+  sh->triple_max_c   = max_c;
+  sh->triple_ncolsA  = ncolsA;
+  sh->triple_ncolsP  = ncolsP;
+
+  layout_t layout(dense, ncolsA, ncolsP, max_ra, max_c, false);
+  pool_t pool = spgemm_make_pool<pool_t, lno_t>(layout.chunk_size);
+
+  functor_t f(rowmapR, entriesR, entriesR, rowmapA, entriesA, entriesA,
+              rowmapP, entriesP, entriesP, rowmapC, entriesC, entriesC, pool,
+              layout);
+  Kokkos::parallel_for(
+      "KokkosSparse::spgemm_triple::Count",
+      Kokkos::RangePolicy<exec_space, typename functor_t::CountTag>(0,
+                                                                    nrowsR),
+      f);
+  typename c_row_view_t::non_const_value_type c_nnz = 0;
+  KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<c_row_view_t,
+                                                        exec_space>(
+      nrowsR + 1, rowmapC, c_nnz);
+  sh->set_c_nnz(c_nnz);
+
+  entriesC = c_nnz_view_t(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "entriesC"), c_nnz);
+  f.entriesC = entriesC;
+  Kokkos::parallel_for(
+      "KokkosSparse::spgemm_triple::Fill",
+      Kokkos::RangePolicy<exec_space, typename functor_t::FillTag>(0, nrowsR),
+      f);
+  KokkosSparse::sort_crs_graph<exec_space>(rowmapC, entriesC);
+  sh->triple_symbolic_called = true;
+}
+
+/// Numeric phase of C = R*A*P for the structure of C computed by
+/// spgemm_triple_symbolic. Only the values of R, A and P may have changed.
+template <typename KernelHandle, typename r_row_view_t,
+          typename r_nnz_view_t, typename r_scalar_view_t,
+          typename a_row_view_t, typename a_nnz_view_t,
+          typename a_scalar_view_t, typename p_row_view_t,
+          typename p_nnz_view_t, typename p_scalar_view_t,
+          typename c_row_view_t, typename c_nnz_view_t,
+          typename c_scalar_view_t>
+void spgemm_triple_numeric(KernelHandle *handle,
+                           typename KernelHandle::nnz_lno_t nrowsR,
+                           r_row_view_t rowmapR, r_nnz_view_t entriesR,
+                           r_scalar_view_t valuesR, a_row_view_t rowmapA,
+                           a_nnz_view_t entriesA, a_scalar_view_t valuesA,
+                           p_row_view_t rowmapP, p_nnz_view_t entriesP,
+                           p_scalar_view_t valuesP, c_row_view_t rowmapC,
+                           c_nnz_view_t entriesC, c_scalar_view_t valuesC) {
+  using lno_t      = typename KernelHandle::nnz_lno_t;
+  using scalar_t   = typename KernelHandle::nnz_scalar_t;
+  using exec_space = typename KernelHandle::HandleExecSpace;
+  using pool_t = KokkosKernels::Impl::UniformMemoryPool<exec_space, lno_t>;
+  using functor_t =
+      SpgemmTripleFunctor<exec_space, lno_t, scalar_t, r_row_view_t,
+                          r_nnz_view_t, r_scalar_view_t, a_row_view_t,
+                          a_nnz_view_t, a_scalar_view_t, p_row_view_t,
+                          p_nnz_view_t, p_scalar_view_t, c_row_view_t,
+                          c_nnz_view_t, c_scalar_view_t, pool_t>;
+  using layout_t = typename functor_t::layout_t;
+
+  auto sh = handle->get_spgemm_handle();
+  if (!sh->triple_symbolic_called) {
+    throw std::runtime_error(
+        "KokkosSparse::spgemm_triple_numeric: the symbolic phase must be "
+        "called first");
+  }
+
+  layout_t layout(sh->triple_dense, sh->triple_ncolsA, sh->triple_ncolsP,
+                  sh->triple_max_ra, sh->triple_max_c, true);
+  pool_t pool = spgemm_make_pool<pool_t, lno_t>(layout.chunk_size);
+
+  functor_t f(rowmapR, entriesR, valuesR, rowmapA, entriesA, valuesA,
+              rowmapP, entriesP, valuesP, rowmapC, entriesC, valuesC, pool,
+              layout);
+  Kokkos::parallel_for(
+      "KokkosSparse::spgemm_triple::Numeric",
+      Kokkos::RangePolicy<exec_space, typename functor_t::NumericTag>(0,
+                                                                      nrowsR),
+      f);
+  sh->set_call_numeric();
+}
+
+template <class RMatrix, class AMatrix, class PMatrix>
+void check_spgemm_triple_dims(const RMatrix& R, const AMatrix& A,
+                              const PMatrix& P) {
+  if (R.numCols() != A.numRows() || A.numCols() != P.numRows())
+    throw std::invalid_argument(
+        "KokkosSparse::spgemm_triple: R, A and P have incompatible dimensions "
+        "for multiplication");
+}
+
+// Gathers the values of P into its transpose through the permutation
+// recorded by spgemm_ptap_transpose
+template <typename perm_view_t, typename in_scalar_view_t,
+          typename out_scalar_view_t>
+struct TriplePermuteValues {
+  perm_view_t perm;
+  in_scalar_view_t in;
+  out_scalar_view_t out;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_t i) const { out(i) = in(perm(i)); }
+};
+
+/// Stores the structure of P^T in the SPGEMMHandle, with the entry of P that
+/// each entry of P^T comes from, so that spgemm_ptap_transpose_values can
+/// refresh the values of P^T without transposing again.
+template <typename KernelHandle, typename p_row_view_t,
+          typename p_nnz_view_t>
+void spgemm_ptap_transpose(KernelHandle *handle,
+                           typename KernelHandle::nnz_lno_t nrowsP,
+                           typename KernelHandle::nnz_lno_t ncolsP,
+                           p_row_view_t rowmapP, p_nnz_view_t entriesP) {
+  using exec_space = typename KernelHandle::HandleExecSpace;
+  using sh_t       = typename KernelHandle::SPGEMMHandleType;
+  using row_view_t = typename sh_t::row_lno_persistent_work_view_t;
+  using nnz_view_t = typename sh_t::nnz_lno_persistent_work_view_t;
+  using val_view_t = typename sh_t::scalar_persistent_work_view_t;
+
+  auto sh          = handle->get_spgemm_handle();
+  const size_t nnz = entriesP.extent(0);
+  row_view_t positions(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "P positions"), nnz);
+  KokkosKernels::Impl::sequential_fill(positions);
+
+  sh->triple_pt_rowmap  = row_view_t("Pt rowmap", ncolsP + 1);
+  sh->triple_pt_entries = nnz_view_t(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "Pt entries"), nnz);
+  sh->triple_pt_perm = row_view_t(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "Pt permutation"), nnz);
+  sh->triple_pt_values = val_view_t(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "Pt values"), nnz);
+  KokkosSparse::Impl::transpose_matrix<p_row_view_t, p_nnz_view_t, row_view_t,
+                                       row_view_t, nnz_view_t, row_view_t,
+                                       row_view_t, exec_space>(
+      nrowsP, ncolsP, rowmapP, entriesP, positions, sh->triple_pt_rowmap,
+      sh->triple_pt_entries, sh->triple_pt_perm);
+}
+
+/// Copies the current values of P into the P^T kept by the handle
+template <typename KernelHandle, typename p_scalar_view_t>
+void spgemm_ptap_transpose_values(KernelHandle *handle,
+                                  p_scalar_view_t valuesP) {
+  using exec_space = typename KernelHandle::HandleExecSpace;
+  using sh_t       = typename KernelHandle::SPGEMMHandleType;
+  using row_view_t = typename sh_t::row_lno_persistent_work_view_t;
+  using val_view_t = typename sh_t::scalar_persistent_work_view_t;
+
+  auto sh = handle->get_spgemm_handle();
+  Kokkos::parallel_for(
+      "KokkosSparse::spgemm_ptap::TransposeValues",
+      Kokkos::RangePolicy<exec_space>(0, sh->triple_pt_values.extent(0)),
+      TriplePermuteValues<row_view_t, p_scalar_view_t, val_view_t>{
+          sh->triple_pt_perm, valuesP, sh->triple_pt_values});
+}
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif
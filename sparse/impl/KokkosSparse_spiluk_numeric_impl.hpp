@@ -23,6 +23,9 @@
 #include <KokkosKernels_config.h>
 #include <Kokkos_ArithTraits.hpp>
 #include <KokkosSparse_spiluk_handle.hpp>
+#include "KokkosBatched_LU_Serial_Internal.hpp"
+#include "KokkosBatched_Trsm_Serial_Internal.hpp"
+#include "KokkosBatched_Gemm_Serial_Internal.hpp"
 
 //#define NUMERIC_OUTPUT_INFO
 
@@ -358,6 +361,397 @@ struct ILUKLvlSchedTP1NumericFunctor {
   }
 };
 
+// Block variant of ILUKLvlSchedRPNumericFunctor for BSR values: every entry
+// of the patterns is a dense block_size x block_size block, row-major and
+// contiguous as in BsrMatrix. The elimination is the point one with the
+// scalar operations replaced by serial dense kernels. The diagonal blocks
+// of L are identities and those of U are left holding their LU factors
+// (unit lower and upper, without pivoting).
+template <class ARowMapType, class AEntriesType, class AValuesType,
+          class LRowMapType, class LEntriesType, class LValuesType,
+          class URowMapType, class UEntriesType, class UValuesType,
+          class LevelViewType, class WorkViewType, class nnz_lno_t>
+struct ILUKLvlSchedRPBlockNumericFunctor {
+  using lno_t    = typename AEntriesType::non_const_value_type;
+  using scalar_t = typename AValuesType::non_const_value_type;
+  using mag_t    = typename Kokkos::ArithTraits<scalar_t>::mag_type;
+  ARowMapType A_row_map;
+  AEntriesType A_entries;
+  AValuesType A_values;
+  LRowMapType L_row_map;
+  LEntriesType L_entries;
+  LValuesType L_values;
+  URowMapType U_row_map;
+  UEntriesType U_entries;
+  UValuesType U_values;
+  LevelViewType level_idx;
+  WorkViewType iw;
+  nnz_lno_t lev_start;
+  int block_size;
+  mag_t tiny;
+
+  ILUKLvlSchedRPBlockNumericFunctor(
+      const ARowMapType &A_row_map_, const AEntriesType &A_entries_,
+      const AValuesType &A_values_, const LRowMapType &L_row_map_,
+      const LEntriesType &L_entries_, LValuesType &L_values_,
+      const URowMapType &U_row_map_, const UEntriesType &U_entries_,
+      UValuesType &U_values_, const LevelViewType &level_idx_,
+      WorkViewType &iw_, const nnz_lno_t &lev_start_, const int block_size_,
+      const mag_t tiny_)
+      : A_row_map(A_row_map_),
+        A_entries(A_entries_),
+        A_values(A_values_),
+        L_row_map(L_row_map_),
+        L_entries(L_entries_),
+        L_values(L_values_),
+        U_row_map(U_row_map_),
+        U_entries(U_entries_),
+        U_values(U_values_),
+        level_idx(level_idx_),
+        iw(iw_),
+        lev_start(lev_start_),
+        block_size(block_size_),
+        tiny(tiny_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  scalar_t *L_block(const size_t k) const {
+    return &L_values(k * block_size * block_size);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  scalar_t *U_block(const size_t k) const {
+    return &U_values(k * block_size * block_size);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void set_block(scalar_t *block, const scalar_t diag) const {
+    for (int r = 0; r < block_size; ++r)
+      for (int c = 0; c < block_size; ++c)
+        block[r * block_size + c] = (r == c) ? diag : scalar_t(0.0);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const lno_t i) const {
+    const scalar_t one  = scalar_t(1.0);
+    const int bs        = block_size;
+    const int blk_elems = bs * bs;
+
+    auto rowid = level_idx(i);
+    auto tid   = i - lev_start;
+    auto k1    = L_row_map(rowid);
+    auto k2    = L_row_map(rowid + 1);
+    for (auto k = k1; k < k2 - 1; ++k) {
+      set_block(L_block(k), scalar_t(0.0));
+      iw(tid, L_entries(k)) = k;
+    }
+    set_block(L_block(k2 - 1), one);
+
+    k1 = U_row_map(rowid);
+    k2 = U_row_map(rowid + 1);
+    for (auto k = k1; k < k2; ++k) {
+      set_block(U_block(k), scalar_t(0.0));
+      iw(tid, U_entries(k)) = k;
+    }
+
+    // Unpack the ith block row of A
+    k1 = A_row_map(rowid);
+    k2 = A_row_map(rowid + 1);
+    for (auto k = k1; k < k2; ++k) {
+      auto col       = A_entries(k);
+      auto ipos      = iw(tid, col);
+      scalar_t *dst  = (col < rowid) ? L_block(ipos) : U_block(ipos);
+      const auto src = k * blk_elems;
+      for (int e = 0; e < blk_elems; ++e) dst[e] = A_values(src + e);
+    }
+
+    // Eliminate prev rows
+    k1 = L_row_map(rowid);
+    k2 = L_row_map(rowid + 1);
+    for (auto k = k1; k < k2 - 1; ++k) {
+      auto prev_row        = L_entries(k);
+      scalar_t *fact       = L_block(k);
+      const scalar_t *diag = U_block(U_row_map(prev_row));
+      // fact = fact * diag^{-1}, with diag = LU: as a left solve of the
+      // transposes, U^T L^T fact^T = fact^T, read through swapped strides
+      KokkosBatched::SerialTrsmInternalLeftLower<
+          KokkosBatched::Algo::Trsm::Unblocked>::invoke(false, bs, bs, one,
+                                                        diag, 1, bs, fact, 1,
+                                                        bs);
+      KokkosBatched::SerialTrsmInternalLeftUpper<
+          KokkosBatched::Algo::Trsm::Unblocked>::invoke(true, bs, bs, one,
+                                                        diag, 1, bs, fact, 1,
+                                                        bs);
+      for (auto kk = U_row_map(prev_row) + 1; kk < U_row_map(prev_row + 1);
+           ++kk) {
+        auto col  = U_entries(kk);
+        auto ipos = iw(tid, col);
+        if (ipos == -1) continue;
+        scalar_t *dst = (col < rowid) ? L_block(ipos) : U_block(ipos);
+        KokkosBatched::SerialGemmInternal<
+            KokkosBatched::Algo::Gemm::Unblocked>::invoke(bs, bs, bs, -one,
+                                                          fact, bs, 1,
+                                                          U_block(kk), bs, 1,
+                                                          one, dst, bs, 1);
+      }  // end for kk
+    }    // end for k
+
+    // Factor the pivot block in place, shifting each pivot away from zero by
+    // the tiny of the handle
+    KokkosBatched::SerialLU_Internal<KokkosBatched::Algo::LU::Unblocked>::
+        invoke(bs, bs, U_block(iw(tid, rowid)), bs, 1, tiny);
+
+    // Reset
+    k1 = L_row_map(rowid);
+    k2 = L_row_map(rowid + 1);
+    for (auto k = k1; k < k2 - 1; ++k) iw(tid, L_entries(k)) = -1;
+
+    k1 = U_row_map(rowid);
+    k2 = U_row_map(rowid + 1);
+    for (auto k = k1; k < k2; ++k) iw(tid, U_entries(k)) = -1;
+  }
+};
+
+// Fixed-point ILU(k) (Chow and Patel): every nonzero of L and U is a
+// fixed point of
+//   l_ij = (a_ij - sum_{k<j} l_ik u_kj) / u_jj   (i > j)
+//   u_ij =  a_ij - sum_{k<i} l_ik u_kj           (i <= j)
+// Each sweep updates all the rows in parallel, in place, so rows read
+// values of the same sweep or of the previous one. The rows of L and U
+// are sorted by the symbolic phase, with the diagonal of U first.
+
+// Position of col in the sorted entries [begin, end), end if it is missing
+template <class EntriesType, class size_type>
+KOKKOS_INLINE_FUNCTION size_type
+iluk_find_sorted(const EntriesType &entries, size_type begin,
+                 const size_type end, typename EntriesType::value_type col) {
+  size_type last = end;
+  while (begin < last) {
+    size_type mid = begin + (last - begin) / 2;
+    if (entries(mid) < col)
+      begin = mid + 1;
+    else
+      last = mid;
+  }
+  return (begin < end && entries(begin) == col) ? begin : end;
+}
+
+// Scatters A into the patterns of L and U, into both the factors (the
+// initial guess) and LA_values and UA_values (the a_ij of the sweeps)
+template <class ARowMapType, class AEntriesType, class AValuesType,
+          class LRowMapType, class LEntriesType, class LValuesType,
+          class URowMapType, class UEntriesType, class UValuesType,
+          class WorkValuesType>
+struct ILUKFixedPointInitFunctor {
+  using lno_t     = typename AEntriesType::non_const_value_type;
+  using size_type = typename ARowMapType::non_const_value_type;
+  using scalar_t  = typename AValuesType::non_const_value_type;
+  ARowMapType A_row_map;
+  AEntriesType A_entries;
+  AValuesType A_values;
+  LRowMapType L_row_map;
+  LEntriesType L_entries;
+  LValuesType L_values;
+  URowMapType U_row_map;
+  UEntriesType U_entries;
+  UValuesType U_values;
+  WorkValuesType LA_values;
+  WorkValuesType UA_values;
+
+  ILUKFixedPointInitFunctor(
+      const ARowMapType &A_row_map_, const AEntriesType &A_entries_,
+      const AValuesType &A_values_, const LRowMapType &L_row_map_,
+      const LEntriesType &L_entries_, LValuesType &L_values_,
+      const URowMapType &U_row_map_, const UEntriesType &U_entries_,
+      UValuesType &U_values_, const WorkValuesType &LA_values_,
+      const WorkValuesType &UA_values_)
+      : A_row_map(A_row_map_),
+        A_entries(A_entries_),
+        A_values(A_values_),
+        L_row_map(L_row_map_),
+        L_entries(L_entries_),
+        L_values(L_values_),
+        U_row_map(U_row_map_),
+        U_entries(U_entries_),
+        U_values(U_values_),
+        LA_values(LA_values_),
+        UA_values(UA_values_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const lno_t rowid) const {
+    for (size_type k = L_row_map(rowid); k < L_row_map(rowid + 1); ++k)
+      LA_values(k) = 0.0;
+    for (size_type k = U_row_map(rowid); k < U_row_map(rowid + 1); ++k)
+      UA_values(k) = 0.0;
+    for (size_type k = A_row_map(rowid); k < A_row_map(rowid + 1); ++k) {
+      auto col = A_entries(k);
+      if (col < rowid) {
+        auto end  = L_row_map(rowid + 1);
+        auto ipos = iluk_find_sorted(L_entries, L_row_map(rowid), end, col);
+        if (ipos != end) LA_values(ipos) += A_values(k);
+      } else {
+        auto end  = U_row_map(rowid + 1);
+        auto ipos = iluk_find_sorted(U_entries, U_row_map(rowid), end, col);
+        if (ipos != end) UA_values(ipos) += A_values(k);
+      }
+    }
+    for (size_type k = L_row_map(rowid); k < L_row_map(rowid + 1); ++k)
+      L_values(k) = LA_values(k);
+#ifdef KEEP_DIAG
+    L_values(L_row_map(rowid + 1) - 1) = scalar_t(1.0);
+#endif
+    for (size_type k = U_row_map(rowid); k < U_row_map(rowid + 1); ++k)
+      U_values(k) = UA_values(k);
+  }
+};
+
+// One fixed-point sweep over the row rowid of L and U
+template <class LRowMapType, class LEntriesType, class LValuesType,
+          class URowMapType, class UEntriesType, class UValuesType,
+          class WorkValuesType>
+struct ILUKFixedPointSweepFunctor {
+  using lno_t    = typename LEntriesType::non_const_value_type;
+  using scalar_t = typename LValuesType::non_const_value_type;
+  LRowMapType L_row_map;
+  LEntriesType L_entries;
+  LValuesType L_values;
+  URowMapType U_row_map;
+  UEntriesType U_entries;
+  UValuesType U_values;
+  WorkValuesType LA_values;
+  WorkValuesType UA_values;
+
+  ILUKFixedPointSweepFunctor(const LRowMapType &L_row_map_,
+                             const LEntriesType &L_entries_,
+                             LValuesType &L_values_,
+                             const URowMapType &U_row_map_,
+                             const UEntriesType &U_entries_,
+                             UValuesType &U_values_,
+                             const WorkValuesType &LA_values_,
+                             const WorkValuesType &UA_values_)
+      : L_row_map(L_row_map_),
+        L_entries(L_entries_),
+        L_values(L_values_),
+        U_row_map(U_row_map_),
+        U_entries(U_entries_),
+        U_values(U_values_),
+        LA_values(LA_values_),
+        UA_values(UA_values_) {}
+
+  // u_{row,col}, zero outside of the pattern of U
+  KOKKOS_INLINE_FUNCTION
+  scalar_t u_value(lno_t row, lno_t col) const {
+    auto end  = U_row_map(row + 1);
+    auto ipos = iluk_find_sorted(U_entries, U_row_map(row), end, col);
+    return ipos != end ? scalar_t(U_values(ipos)) : scalar_t(0.0);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const lno_t rowid) const {
+    auto k1 = L_row_map(rowid);
+#ifdef KEEP_DIAG
+    auto k2 = L_row_map(rowid + 1) - 1;
+#else
+    auto k2 = L_row_map(rowid + 1);
+#endif
+    // The row of L is sorted, so the k < j of l_ij are the entries before it
+    for (auto k = k1; k < k2; ++k) {
+      auto col     = L_entries(k);
+      scalar_t sum = LA_values(k);
+      for (auto kk = k1; kk < k; ++kk)
+        sum -= L_values(kk) * u_value(L_entries(kk), col);
+      scalar_t diag = U_values(U_row_map(col));
+      if (diag != 0.0) L_values(k) = sum / diag;
+    }
+    for (auto k = U_row_map(rowid); k < U_row_map(rowid + 1); ++k) {
+      auto col     = U_entries(k);
+      scalar_t sum = UA_values(k);
+      for (auto kk = k1; kk < k2; ++kk)
+        sum -= L_values(kk) * u_value(L_entries(kk), col);
+      U_values(k) = sum;
+    }
+  }
+};
+
+// Replaces the zero pivots like the level scheduled factorization does
+template <class URowMapType, class UValuesType, class nnz_lno_t>
+struct ILUKFixedPointDiagFunctor {
+  URowMapType U_row_map;
+  UValuesType U_values;
+
+  ILUKFixedPointDiagFunctor(const URowMapType &U_row_map_,
+                            UValuesType &U_values_)
+      : U_row_map(U_row_map_), U_values(U_values_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const nnz_lno_t rowid) const {
+    auto ipos = U_row_map(rowid);
+#ifdef KEEP_DIAG
+    if (U_values(ipos) == 0.0) {
+      U_values(ipos) = 1e6;
+    }
+#else
+    if (U_values(ipos) == 0.0) {
+      U_values(ipos) = 1e6;
+    } else {
+      U_values(ipos) = 1.0 / U_values(ipos);
+    }
+#endif
+  }
+};
+
+template <class IlukHandle, class ARowMapType, class AEntriesType,
+          class AValuesType, class LRowMapType, class LEntriesType,
+          class LValuesType, class URowMapType, class UEntriesType,
+          class UValuesType>
+void iluk_numeric_fixed_point(
+    IlukHandle &thandle, const ARowMapType &A_row_map,
+    const AEntriesType &A_entries, const AValuesType &A_values,
+    const LRowMapType &L_row_map, const LEntriesType &L_entries,
+    LValuesType &L_values, const URowMapType &U_row_map,
+    const UEntriesType &U_entries, UValuesType &U_values) {
+  using execution_space = typename IlukHandle::execution_space;
+  using nnz_lno_t       = typename IlukHandle::nnz_lno_t;
+  using scalar_t        = typename LValuesType::non_const_value_type;
+  using WorkValuesType =
+      Kokkos::View<scalar_t *, typename LValuesType::device_type>;
+  // Rows of L and U differ a lot in length, so balance dynamically
+  using policy_type =
+      Kokkos::RangePolicy<execution_space, Kokkos::Schedule<Kokkos::Dynamic>>;
+
+  nnz_lno_t nrows = thandle.get_nrows();
+
+  WorkValuesType LA_values(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "LA_values"),
+      thandle.get_nnzL());
+  WorkValuesType UA_values(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "UA_values"),
+      thandle.get_nnzU());
+
+  Kokkos::parallel_for(
+      "parfor_fixed_point_init", policy_type(0, nrows),
+      ILUKFixedPointInitFunctor<ARowMapType, AEntriesType, AValuesType,
+                                LRowMapType, LEntriesType, LValuesType,
+                                URowMapType, UEntriesType, UValuesType,
+                                WorkValuesType>(
+          A_row_map, A_entries, A_values, L_row_map, L_entries, L_values,
+          U_row_map, U_entries, U_values, LA_values, UA_values));
+
+  ILUKFixedPointSweepFunctor<LRowMapType, LEntriesType, LValuesType,
+                             URowMapType, UEntriesType, UValuesType,
+                             WorkValuesType>
+      sweep(L_row_map, L_entries, L_values, U_row_map, U_entries, U_values,
+            LA_values, UA_values);
+  for (int s = 0; s < thandle.get_num_sweeps(); ++s)
+    Kokkos::parallel_for("parfor_fixed_point_sweep", policy_type(0, nrows),
+                         sweep);
+
+  Kokkos::parallel_for(
+      "parfor_fixed_point_diag",
+      Kokkos::RangePolicy<execution_space>(0, nrows),
+      ILUKFixedPointDiagFunctor<URowMapType, UValuesType, nnz_lno_t>(
+          U_row_map, U_values));
+}
+
 template <class IlukHandle, class ARowMapType, class AEntriesType,
           class AValuesType, class LRowMapType, class LEntriesType,
           class LValuesType, class URowMapType, class UEntriesType,
@@ -376,6 +770,7 @@ void iluk_numeric(IlukHandle &thandle, const ARowMapType &A_row_map,
 
   size_type nlevels = thandle.get_num_levels();
   int team_size     = thandle.get_team_size();
+  int block_size    = thandle.get_block_size();
 
   LevelHostViewType level_ptr_h     = thandle.get_host_level_ptr();
   HandleDeviceEntriesType level_idx = thandle.get_level_idx();
@@ -391,6 +786,18 @@ void iluk_numeric(IlukHandle &thandle, const ARowMapType &A_row_map,
   }
   iw = thandle.get_iw();
 
+  // The fixed-point sweeps factor all the rows at once: no level loop
+  if (thandle.get_algorithm() ==
+      KokkosSparse::Experimental::SPILUKAlgorithm::FIXED_POINT) {
+    if (block_size > 1)
+      throw std::runtime_error(
+          "iluk_numeric: FIXED_POINT does not support block values");
+    iluk_numeric_fixed_point(thandle, A_row_map, A_entries, A_values,
+                             L_row_map, L_entries, L_values, U_row_map,
+                             U_entries, U_values);
+    nlevels = 0;
+  }
+
   // Main loop must be performed sequential. Question: Try out Cuda's graph
   // stuff to reduce kernel launch overhead
   for (size_type lvl = 0; lvl < nlevels; ++lvl) {
@@ -398,8 +805,30 @@ void iluk_numeric(IlukHandle &thandle, const ARowMapType &A_row_map,
     nnz_lno_t lev_end   = level_ptr_h(lvl + 1);
 
     if ((lev_end - lev_start) != 0) {
-      if (thandle.get_algorithm() ==
-          KokkosSparse::Experimental::SPILUKAlgorithm::SEQLVLSCHD_RP) {
+      if (block_size > 1) {
+        // Both level-scheduled algorithms factor a block row per thread.
+        // TP1 sized iw for one chunk of rows, so it goes chunk by chunk.
+        nnz_lno_t chunk_rows = lev_end - lev_start;
+        if (thandle.get_algorithm() ==
+            KokkosSparse::Experimental::SPILUKAlgorithm::SEQLVLSCHD_TP1)
+          chunk_rows = level_nrowsperchunk_h(lvl);
+        for (nnz_lno_t begin = lev_start; begin < lev_end;
+             begin += chunk_rows) {
+          nnz_lno_t end = Kokkos::min(begin + chunk_rows, lev_end);
+          Kokkos::parallel_for(
+              "parfor_fixed_lvl_block",
+              Kokkos::RangePolicy<execution_space>(begin, end),
+              ILUKLvlSchedRPBlockNumericFunctor<
+                  ARowMapType, AEntriesType, AValuesType, LRowMapType,
+                  LEntriesType, LValuesType, URowMapType, UEntriesType,
+                  UValuesType, HandleDeviceEntriesType, WorkViewType,
+                  nnz_lno_t>(A_row_map, A_entries, A_values, L_row_map,
+                             L_entries, L_values, U_row_map, U_entries,
+                             U_values, level_idx, iw, begin, block_size,
+                             thandle.get_block_pivot_tiny()));
+        }
+      } else if (thandle.get_algorithm() ==
+                 KokkosSparse::Experimental::SPILUKAlgorithm::SEQLVLSCHD_RP) {
         Kokkos::parallel_for(
             "parfor_fixed_lvl",
             Kokkos::RangePolicy<execution_space>(lev_start, lev_end),
@@ -229,7 +229,9 @@ void iluk_symbolic(IlukHandle& thandle,
   if (thandle.get_algorithm() ==
           KokkosSparse::Experimental::SPILUKAlgorithm::SEQLVLSCHD_RP ||
       thandle.get_algorithm() ==
-          KokkosSparse::Experimental::SPILUKAlgorithm::SEQLVLSCHD_TP1)
+          KokkosSparse::Experimental::SPILUKAlgorithm::SEQLVLSCHD_TP1 ||
+      thandle.get_algorithm() ==
+          KokkosSparse::Experimental::SPILUKAlgorithm::FIXED_POINT)
   /*   || thandle.get_algorithm() ==
      KokkosSparse::Experimental::SPILUKAlgorithm::SEQLVLSCHED_TP2 )*/
   {
@@ -429,9 +431,13 @@ void iluk_symbolic(IlukHandle& thandle,
                                  decltype(U_row_map), decltype(U_entries)>(
         U_row_map, U_entries);
 
-    // Level scheduling on L
+    // Level scheduling on L. The fixed-point sweeps update all the rows at
+    // once, and need neither the levels nor the dense work view.
     if (thandle.get_algorithm() ==
-        KokkosSparse::Experimental::SPILUKAlgorithm::SEQLVLSCHD_TP1) {
+        KokkosSparse::Experimental::SPILUKAlgorithm::FIXED_POINT) {
+      thandle.set_num_levels(0);
+    } else if (thandle.get_algorithm() ==
+               KokkosSparse::Experimental::SPILUKAlgorithm::SEQLVLSCHD_TP1) {
       level_sched_tp(thandle, L_row_map, L_entries, level_list, level_ptr,
                      level_idx, nlev);
       thandle.alloc_iw(thandle.get_level_maxrowsperchunk(), nrows);
@@ -0,0 +1,300 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#ifndef KOKKOSSPARSE_SPMV_DOT_IMPL_HPP_
+#define KOKKOSSPARSE_SPMV_DOT_IMPL_HPP_
+
+/// \file KokkosSparse_spmv_dot_impl.hpp
+/// \brief Sparse matrix-vector multiply fused with a reduction over the
+///   output vector.
+
+#include "Kokkos_InnerProductSpaceTraits.hpp"
+#include "KokkosKernels_Controls.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosSparse_spmv_impl.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+/// \brief Sum of squares kept as scale^2 * ssq, as in LAPACK's xLASSQ.
+///
+/// scale is the largest magnitude added so far, so the squared terms are
+/// ratios of at most one: the 2-norm of entries near the overflow or
+/// underflow thresholds is still accurate. The identity is scale = 0.
+template <class mag_type>
+struct SpmvScaledSumSquares {
+  mag_type scale;
+  mag_type ssq;
+
+  KOKKOS_INLINE_FUNCTION
+  SpmvScaledSumSquares() : scale(0), ssq(1) {}
+
+  KOKKOS_INLINE_FUNCTION
+  explicit SpmvScaledSumSquares(const mag_type abs_value)
+      : scale(abs_value), ssq(1) {}
+
+  KOKKOS_INLINE_FUNCTION
+  SpmvScaledSumSquares& operator+=(const SpmvScaledSumSquares& src) {
+    if (src.scale == mag_type(0)) return *this;
+    if (scale < src.scale) {
+      const mag_type ratio = scale / src.scale;
+      ssq                  = src.ssq + ssq * ratio * ratio;
+      scale                = src.scale;
+    } else {
+      const mag_type ratio = src.scale / scale;
+      ssq += src.ssq * ratio * ratio;
+    }
+    return *this;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  mag_type norm() const {
+    return scale * Kokkos::ArithTraits<mag_type>::sqrt(ssq);
+  }
+};
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+namespace Kokkos {
+template <class mag_type>
+struct reduction_identity<
+    KokkosSparse::Impl::SpmvScaledSumSquares<mag_type>> {
+  KOKKOS_FORCEINLINE_FUNCTION static KokkosSparse::Impl::SpmvScaledSumSquares<
+      mag_type>
+  sum() {
+    return KokkosSparse::Impl::SpmvScaledSumSquares<mag_type>();
+  }
+};
+}  // namespace Kokkos
+
+namespace KokkosSparse {
+namespace Impl {
+
+/// \brief SPMV_Functor that also reduces over the entries of y it writes:
+///   the inner product conj(y)^T z when \c norm is false, the scaled sum
+///   of squares of y (see SpmvScaledSumSquares) when it is true.
+///
+/// Each entry of y is reduced from the register it was computed in, so y
+/// is read and written once per multiply instead of being read again by
+/// a separate dot or nrm2 kernel.
+template <class AMatrix, class XVector, class YVector, class ZVector,
+          int dobeta, bool conjugate, bool norm>
+struct SPMV_Dot_Functor
+    : public SPMV_Functor<AMatrix, XVector, YVector, dobeta, conjugate> {
+  typedef SPMV_Functor<AMatrix, XVector, YVector, dobeta, conjugate> base_type;
+  typedef typename base_type::ordinal_type ordinal_type;
+  typedef typename base_type::team_member team_member;
+  typedef typename YVector::non_const_value_type y_value_type;
+  typedef Kokkos::Details::InnerProductSpaceTraits<y_value_type> IPT;
+  // The reduction type (this hides the matrix value_type of the base)
+  typedef typename std::conditional<
+      norm, SpmvScaledSumSquares<typename IPT::mag_type>,
+      typename IPT::dot_type>::type value_type;
+
+  ZVector m_z;
+
+  SPMV_Dot_Functor(const typename base_type::value_type alpha_,
+                   const AMatrix m_A_, const XVector m_x_,
+                   const typename base_type::value_type beta_,
+                   const YVector m_y_, const ZVector m_z_,
+                   const int rows_per_team_)
+      : base_type(alpha_, m_A_, m_x_, beta_, m_y_, rows_per_team_),
+        m_z(m_z_) {
+    static_assert(static_cast<int>(ZVector::rank) == 1,
+                  "ZVector must be a rank 1 View.");
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  value_type contribution(const ordinal_type iRow,
+                          const y_value_type& y_new) const {
+    if constexpr (norm) {
+      (void)iRow;
+      return value_type(IPT::norm(y_new));
+    } else {
+      return IPT::dot(y_new, m_z(iRow));
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const ordinal_type iRow, value_type& update) const {
+    if (iRow >= this->m_A.numRows()) {
+      return;
+    }
+    update += contribution(iRow, this->apply_row(iRow));
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const team_member& dev, value_type& update) const {
+    value_type team_sum = value_type();
+    Kokkos::parallel_reduce(
+        Kokkos::TeamThreadRange(dev, 0, this->rows_per_team),
+        [&](const ordinal_type& loop, value_type& lsum) {
+          const ordinal_type iRow =
+              static_cast<ordinal_type>(dev.league_rank()) *
+                  this->rows_per_team +
+              loop;
+          if (iRow >= this->m_A.numRows()) {
+            return;
+          }
+          lsum += contribution(iRow, this->apply_row(dev, iRow));
+        },
+        team_sum);
+    Kokkos::single(Kokkos::PerTeam(dev), [&]() { update += team_sum; });
+  }
+};
+
+/// \brief y = beta*y + alpha*Op(A)*x for Op = identity (\c conjugate
+///   false) or conjugate, returning the reduction of SPMV_Dot_Functor.
+///
+/// Takes the same controls as spmv_beta_no_transpose: "schedule", and on
+/// GPUs "team size", "vector length" and "rows per thread".
+template <class AMatrix, class XVector, class YVector, class ZVector,
+          int dobeta, bool conjugate, bool norm>
+typename SPMV_Dot_Functor<AMatrix, XVector, YVector, ZVector, dobeta,
+                          conjugate, norm>::value_type
+spmv_dot_beta_no_transpose(
+    const KokkosKernels::Experimental::Controls& controls,
+    typename YVector::const_value_type& alpha, const AMatrix& A,
+    const XVector& x, typename YVector::const_value_type& beta,
+    const YVector& y, const ZVector& z) {
+  typedef typename AMatrix::execution_space execution_space;
+  typedef SPMV_Dot_Functor<AMatrix, XVector, YVector, ZVector, dobeta,
+                           conjugate, norm>
+      functor_type;
+  typedef typename functor_type::value_type result_type;
+
+  result_type result = result_type();
+  if (A.numRows() <= 0) {
+    return result;
+  }
+
+  bool use_dynamic_schedule = false;  // Forces the use of a dynamic schedule
+  bool use_static_schedule  = false;  // Forces the use of a static schedule
+  if (controls.isParameter("schedule")) {
+    if (controls.getParameter("schedule") == "dynamic") {
+      use_dynamic_schedule = true;
+    } else if (controls.getParameter("schedule") == "static") {
+      use_static_schedule = true;
+    }
+  }
+  const bool dynamic =
+      ((A.nnz() > 10000000) || use_dynamic_schedule) && !use_static_schedule;
+  const std::string label =
+      std::string(norm ? "KokkosSparse::spmv_nrm2" : "KokkosSparse::spmv_dot") +
+      (dynamic ? "<NoTranspose,Dynamic>" : "<NoTranspose,Static>");
+
+  if constexpr (!KokkosKernels::Impl::kk_is_gpu_exec_space<
+                    execution_space>()) {
+    functor_type func(alpha, A, x, beta, y, z, 1);
+    if (dynamic)
+      Kokkos::parallel_reduce(
+          label,
+          Kokkos::RangePolicy<execution_space,
+                              Kokkos::Schedule<Kokkos::Dynamic>>(
+              0, A.numRows()),
+          func, result);
+    else
+      Kokkos::parallel_reduce(
+          label,
+          Kokkos::RangePolicy<execution_space,
+                              Kokkos::Schedule<Kokkos::Static>>(0,
+                                                                A.numRows()),
+          func, result);
+  } else {
+    int team_size           = -1;
+    int vector_length       = -1;
+    int64_t rows_per_thread = -1;
+    if (controls.isParameter("team size")) {
+      team_size = std::stoi(controls.getParameter("team size"));
+    }
+    if (controls.isParameter("vector length")) {
+      vector_length = std::stoi(controls.getParameter("vector length"));
+    }
+    if (controls.isParameter("rows per thread")) {
+      rows_per_thread = std::stoll(controls.getParameter("rows per thread"));
+    }
+
+    int64_t rows_per_team = spmv_launch_parameters<execution_space>(
+        A.numRows(), A.nnz(), rows_per_thread, team_size, vector_length);
+    int64_t worksets = (y.extent(0) + rows_per_team - 1) / rows_per_team;
+
+    functor_type func(alpha, A, x, beta, y, z, rows_per_team);
+    if (dynamic) {
+      typedef Kokkos::TeamPolicy<execution_space,
+                                 Kokkos::Schedule<Kokkos::Dynamic>>
+          policy_type;
+      policy_type policy =
+          team_size < 0 ? policy_type(worksets, Kokkos::AUTO, vector_length)
+                        : policy_type(worksets, team_size, vector_length);
+      Kokkos::parallel_reduce(label, policy, func, result);
+    } else {
+      typedef Kokkos::TeamPolicy<execution_space,
+                                 Kokkos::Schedule<Kokkos::Static>>
+          policy_type;
+      policy_type policy =
+          team_size < 0 ? policy_type(worksets, Kokkos::AUTO, vector_length)
+                        : policy_type(worksets, team_size, vector_length);
+      Kokkos::parallel_reduce(label, policy, func, result);
+    }
+  }
+  return result;
+}
+
+// Dispatch on mode ("N" or "C") and on the value of beta
+template <class AMatrix, class XVector, class YVector, class ZVector,
+          bool norm>
+typename SPMV_Dot_Functor<AMatrix, XVector, YVector, ZVector, 0, false,
+                          norm>::value_type
+spmv_dot_no_transpose(const KokkosKernels::Experimental::Controls& controls,
+                      const char mode[],
+                      typename YVector::const_value_type& alpha,
+                      const AMatrix& A, const XVector& x,
+                      typename YVector::const_value_type& beta,
+                      const YVector& y, const ZVector& z) {
+  typedef typename YVector::non_const_value_type y_value_type;
+  const bool conjugate = mode[0] == 'C';
+  if (beta == Kokkos::ArithTraits<y_value_type>::zero()) {
+    return conjugate
+               ? spmv_dot_beta_no_transpose<AMatrix, XVector, YVector,
+                                            ZVector, 0, true, norm>(
+                     controls, alpha, A, x, beta, y, z)
+               : spmv_dot_beta_no_transpose<AMatrix, XVector, YVector,
+                                            ZVector, 0, false, norm>(
+                     controls, alpha, A, x, beta, y, z);
+  }
+  if (beta == Kokkos::ArithTraits<y_value_type>::one()) {
+    return conjugate
+               ? spmv_dot_beta_no_transpose<AMatrix, XVector, YVector,
+                                            ZVector, 1, true, norm>(
+                     controls, alpha, A, x, beta, y, z)
+               : spmv_dot_beta_no_transpose<AMatrix, XVector, YVector,
+                                            ZVector, 1, false, norm>(
+                     controls, alpha, A, x, beta, y, z);
+  }
+  return conjugate
+             ? spmv_dot_beta_no_transpose<AMatrix, XVector, YVector, ZVector,
+                                          2, true, norm>(controls, alpha, A,
+                                                         x, beta, y, z)
+             : spmv_dot_beta_no_transpose<AMatrix, XVector, YVector, ZVector,
+                                          2, false, norm>(controls, alpha, A,
+                                                          x, beta, y, z);
+}
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif  // KOKKOSSPARSE_SPMV_DOT_IMPL_HPP_
@@ -0,0 +1,454 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#ifndef KOKKOSSPARSE_SPMV_HANDLE_IMPL_HPP_
+#define KOKKOSSPARSE_SPMV_HANDLE_IMPL_HPP_
+
+/// \file KokkosSparse_spmv_handle_impl.hpp
+/// \brief Inspector/executor SpMV driven by an SPMVHandle
+///
+/// spmv_analysis inspects the graph of A once and stores a launch plan in
+/// the handle; spmv_handle_apply runs that plan without looking at the
+/// sparsity pattern or any Controls string again.
+
+#include <vector>
+
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosKernels_Error.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosSparse_spmv_handle.hpp"
+#include "KokkosSparse_spmv_impl.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+/// \brief Row-length histogram of a CRS graph.
+///
+/// Array reduction: entry b < nbins counts the rows falling in histogram bin
+/// b (see SPMVHandle::num_histogram_bins), entry nbins is the maximum row
+/// length.
+template <class RowMapType, class ordinal_type>
+struct SPMV_RowLengthHistogram_Functor {
+  typedef typename RowMapType::non_const_value_type size_type;
+  typedef size_type value_type[];
+
+  const unsigned value_count;
+  RowMapType row_map;
+
+  SPMV_RowLengthHistogram_Functor(const RowMapType& row_map_, const int nbins)
+      : value_count(nbins + 1), row_map(row_map_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void init(value_type dst) const {
+    for (unsigned i = 0; i < value_count; ++i) dst[i] = 0;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void join(value_type dst, const value_type src) const {
+    const unsigned nbins = value_count - 1;
+    for (unsigned i = 0; i < nbins; ++i) dst[i] += src[i];
+    if (src[nbins] > dst[nbins]) dst[nbins] = src[nbins];
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const ordinal_type i, value_type hist) const {
+    const unsigned nbins = value_count - 1;
+    const size_type len  = row_map(i + 1) - row_map(i);
+    unsigned bin         = 0;
+    for (size_type l = len; l > 0; l >>= 1) ++bin;
+    if (bin >= nbins) bin = nbins - 1;
+    hist[bin] += 1;
+    if (len > hist[nbins]) hist[nbins] = len;
+  }
+};
+
+/// \brief Split the rows into \c nbins contiguous bins holding about the
+/// same number of nonzeros.
+///
+/// offsets(b) is the first row whose first entry is at or after
+/// b * nnz_per_bin, so each bin is closed by the row containing its last
+/// nonzero. offsets must be filled with numRows beforehand and offsets(0)
+/// set to 0.
+template <class RowMapType, class OffsetView>
+struct SPMV_BinOffsets_Functor {
+  typedef typename RowMapType::non_const_value_type size_type;
+  typedef typename OffsetView::non_const_value_type ordinal_type;
+
+  RowMapType row_map;
+  OffsetView offsets;
+  const size_type nnz_per_bin;
+  const size_type nbins;
+
+  SPMV_BinOffsets_Functor(const RowMapType& row_map_,
+                          const OffsetView& offsets_,
+                          const size_type nnz_per_bin_, const size_type nbins_)
+      : row_map(row_map_),
+        offsets(offsets_),
+        nnz_per_bin(nnz_per_bin_),
+        nbins(nbins_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const ordinal_type row) const {
+    const size_type begin = row_map(row);
+    const size_type end   = row_map(row + 1);
+    // Bins whose first nonzero lies in (begin, end] start at row + 1
+    for (size_type b = begin / nnz_per_bin + 1;
+         b < nbins && b * nnz_per_bin <= end; ++b) {
+      offsets(b) = row + 1;
+    }
+  }
+};
+
+/// \brief y = beta*y + alpha*op(A)*x, one team per row bin.
+template <class AMatrix, class XVector, class YVector, class OffsetView,
+          int dobeta, bool conjugate>
+struct SPMV_BinnedRows_Functor {
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename AMatrix::non_const_ordinal_type ordinal_type;
+  typedef typename AMatrix::non_const_value_type value_type;
+  typedef typename Kokkos::TeamPolicy<execution_space> team_policy;
+  typedef typename team_policy::member_type team_member;
+  typedef Kokkos::Details::ArithTraits<value_type> ATV;
+
+  const value_type alpha;
+  AMatrix m_A;
+  XVector m_x;
+  const value_type beta;
+  YVector m_y;
+  OffsetView bin_offsets;
+
+  SPMV_BinnedRows_Functor(const value_type alpha_, const AMatrix m_A_,
+                          const XVector m_x_, const value_type beta_,
+                          const YVector m_y_, const OffsetView& bin_offsets_)
+      : alpha(alpha_),
+        m_A(m_A_),
+        m_x(m_x_),
+        beta(beta_),
+        m_y(m_y_),
+        bin_offsets(bin_offsets_) {
+    static_assert(static_cast<int>(XVector::rank) == 1,
+                  "XVector must be a rank 1 View.");
+    static_assert(static_cast<int>(YVector::rank) == 1,
+                  "YVector must be a rank 1 View.");
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const team_member& dev) const {
+    using y_value_type = typename YVector::non_const_value_type;
+
+    const ordinal_type row_begin = bin_offsets(dev.league_rank());
+    const ordinal_type row_end   = bin_offsets(dev.league_rank() + 1);
+
+    Kokkos::parallel_for(
+        Kokkos::TeamThreadRange(dev, row_begin, row_end),
+        [&](const ordinal_type& iRow) {
+          const KokkosSparse::SparseRowViewConst<AMatrix> row =
+              m_A.rowConst(iRow);
+          const ordinal_type row_length = static_cast<ordinal_type>(row.length);
+          y_value_type sum              = 0;
+
+          Kokkos::parallel_reduce(
+              Kokkos::ThreadVectorRange(dev, row_length),
+              [&](const ordinal_type& iEntry, y_value_type& lsum) {
+                const value_type val = conjugate ? ATV::conj(row.value(iEntry))
+                                                 : row.value(iEntry);
+                lsum += val * m_x(row.colidx(iEntry));
+              },
+              sum);
+
+          Kokkos::single(Kokkos::PerThread(dev), [&]() {
+            sum *= alpha;
+
+            if (dobeta == 0) {
+              m_y(iRow) = sum;
+            } else {
+              m_y(iRow) = beta * m_y(iRow) + sum;
+            }
+          });
+        });
+  }
+};
+
+/// \brief Inspect the graph of A and store the launch plan in the handle.
+template <class Handle, class AMatrix>
+void spmv_analysis(Handle& handle, const AMatrix& A) {
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename AMatrix::non_const_ordinal_type ordinal_type;
+  typedef typename Handle::size_type size_type;
+  typedef typename Handle::nnz_lno_view_t offset_view_t;
+  typedef typename AMatrix::row_map_type row_map_type;
+
+  const ordinal_type numRows = A.numRows();
+  const size_type nnz        = A.nnz();
+  const int nbins            = Handle::num_histogram_bins;
+
+  // Row-length histogram and maximum row length
+  std::vector<size_type> stats(nbins + 1, 0);
+  if (numRows > 0) {
+    Kokkos::View<size_type*, Kokkos::HostSpace,
+                 Kokkos::MemoryTraits<Kokkos::Unmanaged>>
+        stats_view(stats.data(), stats.size());
+    Kokkos::parallel_reduce(
+        "KokkosSparse::spmv_analysis::histogram",
+        Kokkos::RangePolicy<execution_space>(0, numRows),
+        SPMV_RowLengthHistogram_Functor<row_map_type, ordinal_type>(
+            A.graph.row_map, nbins),
+        stats_view);
+  }
+  const size_type max_row_length = stats[nbins];
+  stats.resize(nbins);
+  const double avg_row_length =
+      numRows > 0 ? static_cast<double>(nnz) / numRows : 0.0;
+
+  handle.set_row_length_histogram(stats);
+  handle.set_max_row_length(static_cast<ordinal_type>(max_row_length));
+  handle.set_avg_row_length(avg_row_length);
+
+  // Kernel selection
+  Experimental::SPMVAlgorithm kernel = handle.get_algorithm();
+  if (kernel == Experimental::SPMVAlgorithm::SPMV_DEFAULT) {
+    kernel = Experimental::SPMVAlgorithm::SPMV_NATIVE;
+    if (KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space>()) {
+      // A team stalls on a row much longer than its neighbors
+      if (max_row_length >= 4096 && max_row_length > 32 * avg_row_length)
+        kernel = Experimental::SPMVAlgorithm::SPMV_MERGE_PATH;
+      else if (max_row_length > 8 * avg_row_length)
+        kernel = Experimental::SPMVAlgorithm::SPMV_BINNED_ROWS;
+    } else {
+      // Whole rows cannot be balanced once a single row is larger than the
+      // share of one thread; moderately skewed rows are binned by nnz.
+      const double conc = execution_space().concurrency();
+      if (conc > 1 && max_row_length > nnz / conc)
+        kernel = Experimental::SPMVAlgorithm::SPMV_MERGE_PATH;
+      else if (max_row_length > 8 * avg_row_length)
+        kernel = Experimental::SPMVAlgorithm::SPMV_BINNED_ROWS;
+    }
+  }
+  handle.set_kernel(kernel);
+
+  // Launch parameters, as used by the stateless native kernel
+  int team_size     = handle.get_team_size_request();
+  int vector_length = handle.get_vector_length_request();
+  int64_t rows_per_team =
+      numRows > 0 ? spmv_launch_parameters<execution_space>(
+                        numRows, nnz, handle.get_rows_per_thread_request(),
+                        team_size, vector_length)
+                  : 1;
+  if (rows_per_team < 1) rows_per_team = 1;
+  handle.set_team_size(team_size);
+  handle.set_vector_length(vector_length);
+  handle.set_rows_per_team(rows_per_team);
+  handle.set_dynamic_schedule(nnz > 10000000);
+  handle.set_items_per_thread(spmv_merge_items_per_thread<execution_space>(
+      handle.get_items_per_thread_request(),
+      static_cast<int64_t>(numRows) + nnz));
+
+  // Row bins: as many teams as the row-parallel kernel would launch, each
+  // holding the same number of nonzeros instead of the same number of rows.
+  if (kernel == Experimental::SPMVAlgorithm::SPMV_BINNED_ROWS && numRows > 0) {
+    size_type num_bins = (numRows + rows_per_team - 1) / rows_per_team;
+    if (num_bins > nnz) num_bins = nnz;
+    if (num_bins < 1) num_bins = 1;
+    const size_type nnz_per_bin = (nnz + num_bins - 1) / num_bins;
+
+    offset_view_t bin_offsets(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "spmv bin offsets"),
+        num_bins + 1);
+    Kokkos::deep_copy(bin_offsets, numRows);
+    Kokkos::deep_copy(Kokkos::subview(bin_offsets, 0), 0);
+    if (nnz_per_bin > 0) {
+      Kokkos::parallel_for(
+          "KokkosSparse::spmv_analysis::bin_offsets",
+          Kokkos::RangePolicy<execution_space>(0, numRows),
+          SPMV_BinOffsets_Functor<row_map_type, offset_view_t>(
+              A.graph.row_map, bin_offsets, nnz_per_bin, num_bins));
+    }
+    handle.set_bin_offsets(bin_offsets);
+  } else {
+    handle.set_bin_offsets(offset_view_t());
+  }
+
+  handle.set_analysis_complete(A.graph.row_map.data(), A.graph.entries.data(),
+                               numRows, nnz);
+}
+
+// spmv_plan_native_no_transpose: row-parallel kernel, version for CPU execution
+// spaces (RangePolicy)
+template <class Handle, class AMatrix, class XVector, class YVector,
+          int dobeta, bool conjugate,
+          typename std::enable_if<!KokkosKernels::Impl::kk_is_gpu_exec_space<
+              typename AMatrix::execution_space>()>::type* = nullptr>
+static void spmv_plan_native_no_transpose(
+    const Handle& handle, typename YVector::const_value_type& alpha,
+    const AMatrix& A, const XVector& x,
+    typename YVector::const_value_type& beta, const YVector& y) {
+  typedef typename AMatrix::execution_space execution_space;
+
+  SPMV_Functor<AMatrix, XVector, YVector, dobeta, conjugate> func(alpha, A, x,
+                                                                  beta, y, 1);
+  if (handle.use_dynamic_schedule())
+    Kokkos::parallel_for(
+        "KokkosSparse::spmv<NoTranspose,Handle,Dynamic>",
+        Kokkos::RangePolicy<execution_space, Kokkos::Schedule<Kokkos::Dynamic>>(
+            0, A.numRows()),
+        func);
+  else
+    Kokkos::parallel_for(
+        "KokkosSparse::spmv<NoTranspose,Handle,Static>",
+        Kokkos::RangePolicy<execution_space, Kokkos::Schedule<Kokkos::Static>>(
+            0, A.numRows()),
+        func);
+}
+
+// spmv_plan_native_no_transpose: row-parallel kernel, version for GPU execution
+// spaces (TeamPolicy)
+template <class Handle, class AMatrix, class XVector, class YVector,
+          int dobeta, bool conjugate,
+          typename std::enable_if<KokkosKernels::Impl::kk_is_gpu_exec_space<
+              typename AMatrix::execution_space>()>::type* = nullptr>
+static void spmv_plan_native_no_transpose(
+    const Handle& handle, typename YVector::const_value_type& alpha,
+    const AMatrix& A, const XVector& x,
+    typename YVector::const_value_type& beta, const YVector& y) {
+  typedef typename AMatrix::execution_space execution_space;
+
+  const int64_t rows_per_team = handle.get_rows_per_team();
+  const int64_t worksets = (A.numRows() + rows_per_team - 1) / rows_per_team;
+
+  SPMV_Functor<AMatrix, XVector, YVector, dobeta, conjugate> func(
+      alpha, A, x, beta, y, rows_per_team);
+
+  if (handle.use_dynamic_schedule()) {
+    Kokkos::parallel_for(
+        "KokkosSparse::spmv<NoTranspose,Handle,Dynamic>",
+        Kokkos::TeamPolicy<execution_space, Kokkos::Schedule<Kokkos::Dynamic>>(
+            worksets, handle.get_team_size(), handle.get_vector_length()),
+        func);
+  } else {
+    Kokkos::parallel_for(
+        "KokkosSparse::spmv<NoTranspose,Handle,Static>",
+        Kokkos::TeamPolicy<execution_space, Kokkos::Schedule<Kokkos::Static>>(
+            worksets, handle.get_team_size(), handle.get_vector_length()),
+        func);
+  }
+}
+
+template <class Handle, class AMatrix, class XVector, class YVector,
+          int dobeta, bool conjugate>
+static void spmv_plan_binned_no_transpose(
+    const Handle& handle, typename YVector::const_value_type& alpha,
+    const AMatrix& A, const XVector& x,
+    typename YVector::const_value_type& beta, const YVector& y) {
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename Handle::nnz_lno_view_t offset_view_t;
+
+  const offset_view_t bin_offsets = handle.get_bin_offsets();
+  const int64_t num_bins          = bin_offsets.extent(0) - 1;
+
+  Kokkos::parallel_for(
+      "KokkosSparse::spmv<NoTranspose,Handle,Binned>",
+      Kokkos::TeamPolicy<execution_space>(num_bins, handle.get_team_size(),
+                                          handle.get_vector_length()),
+      SPMV_BinnedRows_Functor<AMatrix, XVector, YVector, offset_view_t, dobeta,
+                              conjugate>(alpha, A, x, beta, y, bin_offsets));
+}
+
+template <class Handle, class AMatrix, class XVector, class YVector,
+          int dobeta, bool conjugate>
+static void spmv_plan_no_transpose(const Handle& handle,
+                                   typename YVector::const_value_type& alpha,
+                                   const AMatrix& A, const XVector& x,
+                                   typename YVector::const_value_type& beta,
+                                   const YVector& y) {
+  switch (handle.get_kernel()) {
+    case Experimental::SPMVAlgorithm::SPMV_MERGE_PATH:
+      spmv_beta_merge_no_transpose<AMatrix, XVector, YVector, dobeta,
+                                   conjugate>(handle.get_items_per_thread(),
+                                              alpha, A, x, beta, y);
+      break;
+    case Experimental::SPMVAlgorithm::SPMV_BINNED_ROWS:
+      spmv_plan_binned_no_transpose<Handle, AMatrix, XVector, YVector, dobeta,
+                                    conjugate>(handle, alpha, A, x, beta, y);
+      break;
+    default:
+      spmv_plan_native_no_transpose<Handle, AMatrix, XVector, YVector, dobeta,
+                                    conjugate>(handle, alpha, A, x, beta, y);
+  }
+}
+
+template <class Handle, class AMatrix, class XVector, class YVector,
+          int dobeta>
+static void spmv_plan_beta(const Handle& handle, const char mode[],
+                           typename YVector::const_value_type& alpha,
+                           const AMatrix& A, const XVector& x,
+                           typename YVector::const_value_type& beta,
+                           const YVector& y) {
+  const bool merge =
+      handle.get_kernel() == Experimental::SPMVAlgorithm::SPMV_MERGE_PATH;
+  if (mode[0] == NoTranspose[0]) {
+    spmv_plan_no_transpose<Handle, AMatrix, XVector, YVector, dobeta, false>(
+        handle, alpha, A, x, beta, y);
+  } else if (mode[0] == Conjugate[0]) {
+    spmv_plan_no_transpose<Handle, AMatrix, XVector, YVector, dobeta, true>(
+        handle, alpha, A, x, beta, y);
+  } else if (mode[0] == Transpose[0]) {
+    if (merge)
+      spmv_merge_transpose<AMatrix, XVector, YVector, false>(
+          handle.get_items_per_thread(), alpha, A, x, beta, y);
+    else
+      spmv_beta_transpose<AMatrix, XVector, YVector, dobeta, false>(alpha, A, x,
+                                                                    beta, y);
+  } else if (mode[0] == ConjugateTranspose[0]) {
+    if (merge)
+      spmv_merge_transpose<AMatrix, XVector, YVector, true>(
+          handle.get_items_per_thread(), alpha, A, x, beta, y);
+    else
+      spmv_beta_transpose<AMatrix, XVector, YVector, dobeta, true>(alpha, A, x,
+                                                                   beta, y);
+  } else {
+    KokkosKernels::Impl::throw_runtime_exception(
+        "Invalid Transpose Mode for KokkosSparse::spmv()");
+  }
+}
+
+/// \brief Single vector SpMV using the plan stored in an analyzed handle.
+template <class Handle, class AMatrix, class XVector, class YVector>
+void spmv_handle_apply(const Handle& handle, const char mode[],
+                       typename YVector::const_value_type& alpha,
+                       const AMatrix& A, const XVector& x,
+                       typename YVector::const_value_type& beta,
+                       const YVector& y) {
+  typedef typename YVector::non_const_value_type coefficient_type;
+  typedef Kokkos::Details::ArithTraits<coefficient_type> KAT;
+
+  if (A.numRows() <= 0) return;
+
+  if (beta == KAT::zero()) {
+    spmv_plan_beta<Handle, AMatrix, XVector, YVector, 0>(handle, mode, alpha, A,
+                                                         x, beta, y);
+  } else if (beta == KAT::one()) {
+    spmv_plan_beta<Handle, AMatrix, XVector, YVector, 1>(handle, mode, alpha, A,
+                                                         x, beta, y);
+  } else {
+    spmv_plan_beta<Handle, AMatrix, XVector, YVector, 2>(handle, mode, alpha, A,
+                                                         x, beta, y);
+  }
+}
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif  // KOKKOSSPARSE_SPMV_HANDLE_IMPL_HPP_
@@ -23,6 +23,7 @@
 #include "KokkosKernels_ExecSpaceUtils.hpp"
 #include "KokkosSparse_CrsMatrix.hpp"
 #include "KokkosSparse_spmv_impl_omp.hpp"
+#include "KokkosSparse_spmv_impl_merge.hpp"
 #include "KokkosKernels_Error.hpp"
 
 namespace KokkosSparse {
@@ -143,12 +144,11 @@ struct SPMV_Functor {
                   "YVector must be a rank 1 View.");
   }
 
+  // Compute entry iRow of y, store it and return it
   KOKKOS_INLINE_FUNCTION
-  void operator()(const ordinal_type iRow) const {
+  typename YVector::non_const_value_type apply_row(
+      const ordinal_type iRow) const {
     using y_value_type = typename YVector::non_const_value_type;
-    if (iRow >= m_A.numRows()) {
-      return;
-    }
     const KokkosSparse::SparseRowViewConst<AMatrix> row = m_A.rowConst(iRow);
     const ordinal_type row_length = static_cast<ordinal_type>(row.length);
     y_value_type sum              = 0;
@@ -161,17 +161,57 @@ struct SPMV_Functor {
 
     sum *= alpha;
 
-    if (dobeta == 0) {
-      m_y(iRow) = sum;
-    } else {
-      m_y(iRow) = beta * m_y(iRow) + sum;
-    }
+    const y_value_type y_new = (dobeta == 0) ? sum : beta * m_y(iRow) + sum;
+    m_y(iRow)                = y_new;
+    return y_new;
   }
 
+  // Same as above for the vector lanes of a team thread; the new entry is
+  // returned on every lane
   KOKKOS_INLINE_FUNCTION
-  void operator()(const team_member& dev) const {
+  typename YVector::non_const_value_type apply_row(
+      const team_member& dev, const ordinal_type iRow) const {
     using y_value_type = typename YVector::non_const_value_type;
+    const KokkosSparse::SparseRowViewConst<AMatrix> row = m_A.rowConst(iRow);
+    const ordinal_type row_length = static_cast<ordinal_type>(row.length);
+    y_value_type sum              = 0;
+
+    Kokkos::parallel_reduce(
+        Kokkos::ThreadVectorRange(dev, row_length),
+        [&](const ordinal_type& iEntry, y_value_type& lsum) {
+          const value_type val =
+              conjugate ? ATV::conj(row.value(iEntry)) : row.value(iEntry);
+          lsum += val * m_x(row.colidx(iEntry));
+        },
+        sum);
 
+    y_value_type y_new = 0;
+    Kokkos::single(
+        Kokkos::PerThread(dev),
+        [&](y_value_type& y_single) {
+          sum *= alpha;
+
+          if (dobeta == 0) {
+            y_single = sum;
+          } else {
+            y_single = beta * m_y(iRow) + sum;
+          }
+          m_y(iRow) = y_single;
+        },
+        y_new);
+    return y_new;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const ordinal_type iRow) const {
+    if (iRow >= m_A.numRows()) {
+      return;
+    }
+    apply_row(iRow);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const team_member& dev) const {
     Kokkos::parallel_for(
         Kokkos::TeamThreadRange(dev, 0, rows_per_team),
         [&](const ordinal_type& loop) {
@@ -181,29 +221,7 @@ struct SPMV_Functor {
           if (iRow >= m_A.numRows()) {
             return;
           }
-          const KokkosSparse::SparseRowViewConst<AMatrix> row =
-              m_A.rowConst(iRow);
-          const ordinal_type row_length = static_cast<ordinal_type>(row.length);
-          y_value_type sum              = 0;
-
-          Kokkos::parallel_reduce(
-              Kokkos::ThreadVectorRange(dev, row_length),
-              [&](const ordinal_type& iEntry, y_value_type& lsum) {
-                const value_type val = conjugate ? ATV::conj(row.value(iEntry))
-                                                 : row.value(iEntry);
-                lsum += val * m_x(row.colidx(iEntry));
-              },
-              sum);
-
-          Kokkos::single(Kokkos::PerThread(dev), [&]() {
-            sum *= alpha;
-
-            if (dobeta == 0) {
-              m_y(iRow) = sum;
-            } else {
-              m_y(iRow) = beta * m_y(iRow) + sum;
-            }
-          });
+          apply_row(dev, iRow);
         });
   }
 };
@@ -658,6 +676,13 @@ static void spmv_beta(const KokkosKernels::Experimental::Controls& controls,
                       const AMatrix& A, const XVector& x,
                       typename YVector::const_value_type& beta,
                       const YVector& y) {
+  if (controls.isParameter("algorithm") &&
+      controls.getParameter("algorithm") == "merge") {
+    spmv_beta_merge<AMatrix, XVector, YVector, dobeta>(controls, mode, alpha, A,
+                                                       x, beta, y);
+    return;
+  }
+
   if (mode[0] == NoTranspose[0]) {
     spmv_beta_no_transpose<AMatrix, XVector, YVector, dobeta, false>(
         controls, alpha, A, x, beta, y);
@@ -0,0 +1,629 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#ifndef KOKKOSSPARSE_SPMV_IMPL_MERGE_HPP_
+#define KOKKOSSPARSE_SPMV_IMPL_MERGE_HPP_
+
+/// \file KokkosSparse_spmv_impl_merge.hpp
+/// \brief Merge-path (nnz-balanced) sparse matrix-vector multiply
+///
+/// The merge-path decomposition (Merrill and Garland, SC'16) views the
+/// row offsets and the nonzeros of a CRS matrix as two sorted lists and
+/// splits their merge into chunks of equal length.  Every chunk therefore
+/// performs the same amount of work no matter how skewed the row lengths
+/// are.  A row split between several chunks is finished by the chunk that
+/// consumes its end; the partial sums of the other chunks are "carried out"
+/// and added in a short fix-up pass.
+
+#include "KokkosKernels_Controls.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosKernels_Error.hpp"
+#include "KokkosBlas1_scal.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+/// \brief Find the coordinates at which diagonal \c diag of the merge grid
+/// intersects the merge path.
+///
+/// On return, \c row is the number of row ends consumed before the diagonal
+/// and \c entry is the number of nonzeros consumed, \c row + \c entry ==
+/// \c diag.
+template <class RowMapType, class ordinal_type, class size_type>
+KOKKOS_INLINE_FUNCTION void spmv_merge_path_search(const RowMapType& row_map,
+                                                   const ordinal_type numRows,
+                                                   const size_type nnz,
+                                                   const size_type diag,
+                                                   ordinal_type& row,
+                                                   size_type& entry) {
+  ordinal_type lo =
+      (diag > nnz) ? static_cast<ordinal_type>(diag - nnz) : ordinal_type(0);
+  ordinal_type hi = (diag < static_cast<size_type>(numRows))
+                        ? static_cast<ordinal_type>(diag)
+                        : numRows;
+  while (lo < hi) {
+    const ordinal_type mid = lo + (hi - lo) / 2;
+    // Row end mid is merged before nonzero (diag - mid - 1)
+    if (static_cast<size_type>(row_map(mid + 1)) <=
+        diag - static_cast<size_type>(mid) - 1)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  row   = lo;
+  entry = diag - static_cast<size_type>(lo);
+}
+
+/// \brief Number of merge items (row ends + nonzeros) processed by a single
+/// thread of the merge-path kernels.
+///
+/// A positive \c items_per_thread is returned unchanged, otherwise a default
+/// is picked for the execution space.
+template <class execution_space>
+int64_t spmv_merge_items_per_thread(int64_t items_per_thread,
+                                    const int64_t path_length) {
+  if (items_per_thread < 1) {
+    if (KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space>()) {
+      // A handful of items per thread keeps every lane busy while the
+      // carry-out array stays small.
+      items_per_thread = 16;
+    } else {
+      // One equal share per hardware thread, rounded up to a cache line
+      // worth of work so that tiny matrices do not over-decompose.
+      const int64_t conc = execution_space().concurrency();
+      items_per_thread   = (path_length + conc - 1) / conc;
+      if (items_per_thread < 256) items_per_thread = 256;
+    }
+  }
+  return items_per_thread;
+}
+
+/// \brief Controls version: \c "items per thread" overrides the default.
+template <class execution_space>
+int64_t spmv_merge_items_per_thread(
+    const KokkosKernels::Experimental::Controls& controls,
+    const int64_t path_length) {
+  int64_t items_per_thread = -1;
+  if (controls.isParameter("items per thread")) {
+    items_per_thread = std::stoll(controls.getParameter("items per thread"));
+  }
+  return spmv_merge_items_per_thread<execution_space>(items_per_thread,
+                                                      path_length);
+}
+
+/// \brief y = beta*y + alpha*op(A)*x for op(A) = A or conj(A), with the
+/// merge path split into chunks of \c items_per_thread.
+template <class AMatrix, class XVector, class YVector, int dobeta,
+          bool conjugate>
+struct SPMV_MergePath_Functor {
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename AMatrix::non_const_ordinal_type ordinal_type;
+  typedef typename AMatrix::non_const_size_type size_type;
+  typedef typename AMatrix::non_const_value_type value_type;
+  typedef typename YVector::non_const_value_type y_value_type;
+  typedef Kokkos::Details::ArithTraits<value_type> ATV;
+  typedef Kokkos::View<ordinal_type*, typename YVector::device_type>
+      carry_row_view;
+  typedef Kokkos::View<y_value_type*, typename YVector::device_type>
+      carry_val_view;
+
+  const y_value_type alpha;
+  AMatrix m_A;
+  XVector m_x;
+  const y_value_type beta;
+  YVector m_y;
+
+  const size_type items_per_thread;
+  const size_type path_length;
+  carry_row_view carry_rows;
+  carry_val_view carry_vals;
+
+  SPMV_MergePath_Functor(const y_value_type& alpha_, const AMatrix& m_A_,
+                         const XVector& m_x_, const y_value_type& beta_,
+                         const YVector& m_y_, const size_type items_per_thread_,
+                         const carry_row_view& carry_rows_,
+                         const carry_val_view& carry_vals_)
+      : alpha(alpha_),
+        m_A(m_A_),
+        m_x(m_x_),
+        beta(beta_),
+        m_y(m_y_),
+        items_per_thread(items_per_thread_),
+        path_length(static_cast<size_type>(m_A_.numRows()) + m_A_.nnz()),
+        carry_rows(carry_rows_),
+        carry_vals(carry_vals_) {
+    static_assert(static_cast<int>(XVector::rank) == 1,
+                  "XVector must be a rank 1 View.");
+    static_assert(static_cast<int>(YVector::rank) == 1,
+                  "YVector must be a rank 1 View.");
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_type chunk) const {
+    const ordinal_type numRows = m_A.numRows();
+    const size_type nnz        = m_A.nnz();
+    const size_type diag_begin = chunk * items_per_thread;
+    const size_type diag_end   = (diag_begin + items_per_thread < path_length)
+                                   ? diag_begin + items_per_thread
+                                   : path_length;
+
+    ordinal_type row, row_end;
+    size_type entry, entry_end;
+    spmv_merge_path_search(m_A.graph.row_map, numRows, nnz, diag_begin, row,
+                           entry);
+    spmv_merge_path_search(m_A.graph.row_map, numRows, nnz, diag_end, row_end,
+                           entry_end);
+
+    // Rows whose end lies in this chunk: the first one may have been started
+    // by previous chunks, whose carry-outs get added by the fix-up pass.
+    y_value_type sum = Kokkos::ArithTraits<y_value_type>::zero();
+    for (; row < row_end; ++row) {
+      const size_type row_stop = m_A.graph.row_map(row + 1);
+      for (; entry < row_stop; ++entry) {
+        const value_type val =
+            conjugate ? ATV::conj(m_A.values(entry)) : m_A.values(entry);
+        sum += val * m_x(m_A.graph.entries(entry));
+      }
+      if (dobeta == 0) {
+        m_y(row) = alpha * sum;
+      } else if (dobeta == 1) {
+        m_y(row) += alpha * sum;
+      } else {
+        m_y(row) = beta * m_y(row) + alpha * sum;
+      }
+      sum = Kokkos::ArithTraits<y_value_type>::zero();
+    }
+
+    // Partial sum of the row this chunk could not finish
+    for (; entry < entry_end; ++entry) {
+      const value_type val =
+          conjugate ? ATV::conj(m_A.values(entry)) : m_A.values(entry);
+      sum += val * m_x(m_A.graph.entries(entry));
+    }
+    carry_rows(chunk) = row_end;
+    carry_vals(chunk) = sum;
+  }
+};
+
+/// \brief Add the carry-outs of the merge-path chunks to the rows they
+/// belong to.
+template <class YVector, class CarryRowView, class CarryValView>
+struct SPMV_MergePath_Fixup_Functor {
+  typedef typename CarryRowView::non_const_value_type ordinal_type;
+  typedef typename YVector::non_const_value_type y_value_type;
+
+  const y_value_type alpha;
+  YVector m_y;
+  CarryRowView carry_rows;
+  CarryValView carry_vals;
+  const ordinal_type numRows;
+
+  SPMV_MergePath_Fixup_Functor(const y_value_type& alpha_, const YVector& m_y_,
+                               const CarryRowView& carry_rows_,
+                               const CarryValView& carry_vals_,
+                               const ordinal_type numRows_)
+      : alpha(alpha_),
+        m_y(m_y_),
+        carry_rows(carry_rows_),
+        carry_vals(carry_vals_),
+        numRows(numRows_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_t chunk) const {
+    const ordinal_type row = carry_rows(chunk);
+    if (row >= numRows) return;
+    if (YVector::rank == 1) {
+      Kokkos::atomic_add(&m_y.access(row),
+                         static_cast<y_value_type>(alpha * carry_vals(chunk)));
+    } else {
+      for (size_t k = 0; k < m_y.extent(1); ++k) {
+        Kokkos::atomic_add(
+            &m_y.access(row, k),
+            static_cast<y_value_type>(alpha * carry_vals.access(chunk, k)));
+      }
+    }
+  }
+};
+
+/// \brief y = beta*y + alpha*op(A)*x for op(A) = A^T or A^H.
+///
+/// Each chunk scatters its share of the nonzeros into y with atomics, so the
+/// nonzeros (and not the rows) are balanced across threads.
+template <class AMatrix, class XVector, class YVector, bool conjugate>
+struct SPMV_MergePath_Transpose_Functor {
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename AMatrix::non_const_ordinal_type ordinal_type;
+  typedef typename AMatrix::non_const_size_type size_type;
+  typedef typename AMatrix::non_const_value_type value_type;
+  typedef typename YVector::non_const_value_type y_value_type;
+  typedef Kokkos::Details::ArithTraits<value_type> ATV;
+
+  const y_value_type alpha;
+  AMatrix m_A;
+  XVector m_x;
+  YVector m_y;
+
+  const size_type items_per_thread;
+  const size_type path_length;
+
+  SPMV_MergePath_Transpose_Functor(const y_value_type& alpha_,
+                                   const AMatrix& m_A_, const XVector& m_x_,
+                                   const YVector& m_y_,
+                                   const size_type items_per_thread_)
+      : alpha(alpha_),
+        m_A(m_A_),
+        m_x(m_x_),
+        m_y(m_y_),
+        items_per_thread(items_per_thread_),
+        path_length(static_cast<size_type>(m_A_.numRows()) + m_A_.nnz()) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void scatter(const ordinal_type row, const size_type entry) const {
+    const value_type val =
+        conjugate ? ATV::conj(m_A.values(entry)) : m_A.values(entry);
+    const ordinal_type col = m_A.graph.entries(entry);
+    if (XVector::rank == 1) {
+      Kokkos::atomic_add(&m_y.access(col), static_cast<y_value_type>(
+                                               alpha * val * m_x.access(row)));
+    } else {
+      for (size_t k = 0; k < m_y.extent(1); ++k) {
+        Kokkos::atomic_add(
+            &m_y.access(col, k),
+            static_cast<y_value_type>(alpha * val * m_x.access(row, k)));
+      }
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_type chunk) const {
+    const ordinal_type numRows = m_A.numRows();
+    const size_type nnz        = m_A.nnz();
+    const size_type diag_begin = chunk * items_per_thread;
+    const size_type diag_end   = (diag_begin + items_per_thread < path_length)
+                                   ? diag_begin + items_per_thread
+                                   : path_length;
+
+    ordinal_type row, row_end;
+    size_type entry, entry_end;
+    spmv_merge_path_search(m_A.graph.row_map, numRows, nnz, diag_begin, row,
+                           entry);
+    spmv_merge_path_search(m_A.graph.row_map, numRows, nnz, diag_end, row_end,
+                           entry_end);
+
+    for (; row < row_end; ++row) {
+      const size_type row_stop = m_A.graph.row_map(row + 1);
+      for (; entry < row_stop; ++entry) scatter(row, entry);
+    }
+    for (; entry < entry_end; ++entry) scatter(row, entry);
+  }
+};
+
+/// \brief Multivector version of SPMV_MergePath_Functor.
+///
+/// Rows finished inside a chunk are owned by that chunk for the duration of
+/// the kernel, so they are accumulated straight into y column by column; the
+/// unfinished row goes to a (chunk x column) carry-out array.
+template <class AMatrix, class XVector, class YVector, int dobeta,
+          bool conjugate>
+struct SPMV_MV_MergePath_Functor {
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename AMatrix::non_const_ordinal_type ordinal_type;
+  typedef typename AMatrix::non_const_size_type size_type;
+  typedef typename AMatrix::non_const_value_type value_type;
+  typedef typename YVector::non_const_value_type y_value_type;
+  typedef Kokkos::Details::ArithTraits<value_type> ATV;
+  typedef Kokkos::View<ordinal_type*, typename YVector::device_type>
+      carry_row_view;
+  typedef Kokkos::View<y_value_type**, Kokkos::LayoutRight,
+                       typename YVector::device_type>
+      carry_val_view;
+
+  const y_value_type alpha;
+  AMatrix m_A;
+  XVector m_x;
+  const y_value_type beta;
+  YVector m_y;
+
+  const size_type items_per_thread;
+  const size_type path_length;
+  carry_row_view carry_rows;
+  carry_val_view carry_vals;
+
+  SPMV_MV_MergePath_Functor(const y_value_type& alpha_, const AMatrix& m_A_,
+                            const XVector& m_x_, const y_value_type& beta_,
+                            const YVector& m_y_,
+                            const size_type items_per_thread_,
+                            const carry_row_view& carry_rows_,
+                            const carry_val_view& carry_vals_)
+      : alpha(alpha_),
+        m_A(m_A_),
+        m_x(m_x_),
+        beta(beta_),
+        m_y(m_y_),
+        items_per_thread(items_per_thread_),
+        path_length(static_cast<size_type>(m_A_.numRows()) + m_A_.nnz()),
+        carry_rows(carry_rows_),
+        carry_vals(carry_vals_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_type chunk) const {
+    const ordinal_type numRows = m_A.numRows();
+    const size_type nnz        = m_A.nnz();
+    const size_type numVecs    = m_x.extent(1);
+    const size_type diag_begin = chunk * items_per_thread;
+    const size_type diag_end   = (diag_begin + items_per_thread < path_length)
+                                   ? diag_begin + items_per_thread
+                                   : path_length;
+
+    ordinal_type row_begin, row_end;
+    size_type entry_begin, entry_end;
+    spmv_merge_path_search(m_A.graph.row_map, numRows, nnz, diag_begin,
+                           row_begin, entry_begin);
+    spmv_merge_path_search(m_A.graph.row_map, numRows, nnz, diag_end, row_end,
+                           entry_end);
+
+    for (size_type k = 0; k < numVecs; ++k) {
+      size_type entry = entry_begin;
+      for (ordinal_type row = row_begin; row < row_end; ++row) {
+        const size_type row_stop = m_A.graph.row_map(row + 1);
+        y_value_type sum         = Kokkos::ArithTraits<y_value_type>::zero();
+        for (; entry < row_stop; ++entry) {
+          const value_type val =
+              conjugate ? ATV::conj(m_A.values(entry)) : m_A.values(entry);
+          sum += val * m_x(m_A.graph.entries(entry), k);
+        }
+        if (dobeta == 0) {
+          m_y(row, k) = alpha * sum;
+        } else if (dobeta == 1) {
+          m_y(row, k) += alpha * sum;
+        } else {
+          m_y(row, k) = beta * m_y(row, k) + alpha * sum;
+        }
+      }
+      y_value_type sum = Kokkos::ArithTraits<y_value_type>::zero();
+      for (; entry < entry_end; ++entry) {
+        const value_type val =
+            conjugate ? ATV::conj(m_A.values(entry)) : m_A.values(entry);
+        sum += val * m_x(m_A.graph.entries(entry), k);
+      }
+      carry_vals(chunk, k) = sum;
+    }
+    carry_rows(chunk) = row_end;
+  }
+};
+
+template <class AMatrix, class XVector, class YVector, int dobeta,
+          bool conjugate>
+static void spmv_beta_merge_no_transpose(
+    const int64_t items_per_thread, typename YVector::const_value_type& alpha,
+    const AMatrix& A, const XVector& x,
+    typename YVector::const_value_type& beta, const YVector& y) {
+  typedef typename AMatrix::non_const_ordinal_type ordinal_type;
+  typedef typename AMatrix::non_const_size_type size_type;
+  typedef typename AMatrix::execution_space execution_space;
+  typedef SPMV_MergePath_Functor<AMatrix, XVector, YVector, dobeta, conjugate>
+      functor_type;
+
+  if (A.numRows() <= static_cast<ordinal_type>(0)) {
+    return;
+  }
+
+  const int64_t path_length = static_cast<int64_t>(A.numRows()) + A.nnz();
+  const size_type num_chunks =
+      (path_length + items_per_thread - 1) / items_per_thread;
+
+  typename functor_type::carry_row_view carry_rows(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "merge carry rows"),
+      num_chunks);
+  typename functor_type::carry_val_view carry_vals(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "merge carry values"),
+      num_chunks);
+
+  Kokkos::parallel_for(
+      "KokkosSparse::spmv<NoTranspose,Merge>",
+      Kokkos::RangePolicy<execution_space>(0, num_chunks),
+      functor_type(alpha, A, x, beta, y, items_per_thread, carry_rows,
+                   carry_vals));
+  Kokkos::parallel_for(
+      "KokkosSparse::spmv<NoTranspose,Merge,Fixup>",
+      Kokkos::RangePolicy<execution_space>(0, num_chunks),
+      SPMV_MergePath_Fixup_Functor<YVector,
+                                   typename functor_type::carry_row_view,
+                                   typename functor_type::carry_val_view>(
+          alpha, y, carry_rows, carry_vals, A.numRows()));
+}
+
+template <class AMatrix, class XVector, class YVector, bool conjugate>
+static void spmv_merge_transpose(
+    const int64_t items_per_thread, typename YVector::const_value_type& alpha,
+    const AMatrix& A, const XVector& x,
+    typename YVector::const_value_type& beta, const YVector& y) {
+  typedef typename AMatrix::non_const_ordinal_type ordinal_type;
+  typedef typename AMatrix::non_const_size_type size_type;
+  typedef typename AMatrix::execution_space execution_space;
+  typedef typename YVector::non_const_value_type y_value_type;
+
+  // We need to scale y first ("scaling" by zero just means filling
+  // with zeros), since the functor works by atomic-adding into y.
+  if (beta != Kokkos::ArithTraits<y_value_type>::one()) {
+    KokkosBlas::scal(y, beta, y);
+  }
+  if (A.numRows() <= static_cast<ordinal_type>(0)) {
+    return;
+  }
+
+  const int64_t path_length = static_cast<int64_t>(A.numRows()) + A.nnz();
+  const size_type num_chunks =
+      (path_length + items_per_thread - 1) / items_per_thread;
+
+  Kokkos::parallel_for(
+      "KokkosSparse::spmv<Transpose,Merge>",
+      Kokkos::RangePolicy<execution_space>(0, num_chunks),
+      SPMV_MergePath_Transpose_Functor<AMatrix, XVector, YVector, conjugate>(
+          alpha, A, x, y, items_per_thread));
+}
+
+/// \brief Merge-path single vector SpMV with a fixed number of merge items
+/// per thread.
+template <class AMatrix, class XVector, class YVector, int dobeta>
+static void spmv_beta_merge(const int64_t items_per_thread, const char mode[],
+                            typename YVector::const_value_type& alpha,
+                            const AMatrix& A, const XVector& x,
+                            typename YVector::const_value_type& beta,
+                            const YVector& y) {
+  if (mode[0] == NoTranspose[0]) {
+    spmv_beta_merge_no_transpose<AMatrix, XVector, YVector, dobeta, false>(
+        items_per_thread, alpha, A, x, beta, y);
+  } else if (mode[0] == Conjugate[0]) {
+    spmv_beta_merge_no_transpose<AMatrix, XVector, YVector, dobeta, true>(
+        items_per_thread, alpha, A, x, beta, y);
+  } else if (mode[0] == Transpose[0]) {
+    spmv_merge_transpose<AMatrix, XVector, YVector, false>(
+        items_per_thread, alpha, A, x, beta, y);
+  } else if (mode[0] == ConjugateTranspose[0]) {
+    spmv_merge_transpose<AMatrix, XVector, YVector, true>(
+        items_per_thread, alpha, A, x, beta, y);
+  } else {
+    KokkosKernels::Impl::throw_runtime_exception(
+        "Invalid Transpose Mode for KokkosSparse::spmv()");
+  }
+}
+
+/// \brief Merge-path single vector SpMV, selected by setting the Controls
+/// parameter \c "algorithm" to \c "merge".
+template <class AMatrix, class XVector, class YVector, int dobeta>
+static void spmv_beta_merge(
+    const KokkosKernels::Experimental::Controls& controls, const char mode[],
+    typename YVector::const_value_type& alpha, const AMatrix& A,
+    const XVector& x, typename YVector::const_value_type& beta,
+    const YVector& y) {
+  const int64_t items_per_thread =
+      spmv_merge_items_per_thread<typename AMatrix::execution_space>(
+          controls, static_cast<int64_t>(A.numRows()) + A.nnz());
+  spmv_beta_merge<AMatrix, XVector, YVector, dobeta>(items_per_thread, mode,
+                                                     alpha, A, x, beta, y);
+}
+
+template <class AMatrix, class XVector, class YVector, int dobeta,
+          bool conjugate>
+static void spmv_beta_mv_merge_no_transpose(
+    const int64_t items_per_thread,
+    const typename YVector::non_const_value_type& alpha, const AMatrix& A,
+    const XVector& x, const typename YVector::non_const_value_type& beta,
+    const YVector& y) {
+  typedef typename AMatrix::non_const_ordinal_type ordinal_type;
+  typedef typename AMatrix::non_const_size_type size_type;
+  typedef typename AMatrix::execution_space execution_space;
+  typedef SPMV_MV_MergePath_Functor<AMatrix, XVector, YVector, dobeta,
+                                    conjugate>
+      functor_type;
+
+  if (A.numRows() <= static_cast<ordinal_type>(0)) {
+    return;
+  }
+
+  const int64_t path_length = static_cast<int64_t>(A.numRows()) + A.nnz();
+  const size_type num_chunks =
+      (path_length + items_per_thread - 1) / items_per_thread;
+
+  typename functor_type::carry_row_view carry_rows(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "merge carry rows"),
+      num_chunks);
+  typename functor_type::carry_val_view carry_vals(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "merge carry values"),
+      num_chunks, x.extent(1));
+
+  Kokkos::parallel_for(
+      "KokkosSparse::spmv<MV,NoTranspose,Merge>",
+      Kokkos::RangePolicy<execution_space>(0, num_chunks),
+      functor_type(alpha, A, x, beta, y, items_per_thread, carry_rows,
+                   carry_vals));
+  Kokkos::parallel_for(
+      "KokkosSparse::spmv<MV,NoTranspose,Merge,Fixup>",
+      Kokkos::RangePolicy<execution_space>(0, num_chunks),
+      SPMV_MergePath_Fixup_Functor<YVector,
+                                   typename functor_type::carry_row_view,
+                                   typename functor_type::carry_val_view>(
+          alpha, y, carry_rows, carry_vals, A.numRows()));
+}
+
+template <class AMatrix, class XVector, class YVector, int dobeta>
+static void spmv_beta_mv_merge(
+    const int64_t items_per_thread, const char mode[],
+    const typename YVector::non_const_value_type& alpha, const AMatrix& A,
+    const XVector& x, const typename YVector::non_const_value_type& beta,
+    const YVector& y) {
+  if (mode[0] == NoTranspose[0]) {
+    spmv_beta_mv_merge_no_transpose<AMatrix, XVector, YVector, dobeta, false>(
+        items_per_thread, alpha, A, x, beta, y);
+  } else if (mode[0] == Conjugate[0]) {
+    spmv_beta_mv_merge_no_transpose<AMatrix, XVector, YVector, dobeta, true>(
+        items_per_thread, alpha, A, x, beta, y);
+  } else if (mode[0] == Transpose[0]) {
+    spmv_merge_transpose<AMatrix, XVector, YVector, false>(
+        items_per_thread, alpha, A, x, beta, y);
+  } else if (mode[0] == ConjugateTranspose[0]) {
+    spmv_merge_transpose<AMatrix, XVector, YVector, true>(
+        items_per_thread, alpha, A, x, beta, y);
+  } else {
+    KokkosKernels::Impl::throw_runtime_exception(
+        "Invalid Transpose Mode for KokkosSparse::spmv()");
+  }
+}
+
+/// \brief Merge-path multivector SpMV with a fixed number of merge items per
+/// thread.
+template <class AMatrix, class XVector, class YVector>
+static void spmv_mv_merge(const int64_t items_per_thread, const char mode[],
+                          const typename YVector::non_const_value_type& alpha,
+                          const AMatrix& A, const XVector& x,
+                          const typename YVector::non_const_value_type& beta,
+                          const YVector& y) {
+  typedef typename YVector::non_const_value_type coefficient_type;
+  typedef Kokkos::Details::ArithTraits<coefficient_type> KAT;
+
+  if (beta == KAT::zero()) {
+    spmv_beta_mv_merge<AMatrix, XVector, YVector, 0>(items_per_thread, mode,
+                                                     alpha, A, x, beta, y);
+  } else if (beta == KAT::one()) {
+    spmv_beta_mv_merge<AMatrix, XVector, YVector, 1>(items_per_thread, mode,
+                                                     alpha, A, x, beta, y);
+  } else {
+    spmv_beta_mv_merge<AMatrix, XVector, YVector, 2>(items_per_thread, mode,
+                                                     alpha, A, x, beta, y);
+  }
+}
+
+/// \brief Merge-path multivector SpMV, selected by setting the Controls
+/// parameter \c "algorithm" to \c "merge".
+template <class AMatrix, class XVector, class YVector>
+static void spmv_mv_merge(
+    const KokkosKernels::Experimental::Controls& controls, const char mode[],
+    const typename YVector::non_const_value_type& alpha, const AMatrix& A,
+    const XVector& x, const typename YVector::non_const_value_type& beta,
+    const YVector& y) {
+  const int64_t items_per_thread =
+      spmv_merge_items_per_thread<typename AMatrix::execution_space>(
+          controls, static_cast<int64_t>(A.numRows()) + A.nnz());
+  spmv_mv_merge<AMatrix, XVector, YVector>(items_per_thread, mode, alpha, A, x,
+                                           beta, y);
+}
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif  // KOKKOSSPARSE_SPMV_IMPL_MERGE_HPP_
@@ -0,0 +1,367 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#ifndef KOKKOSSPARSE_SPMV_SELLMATRIX_IMPL_HPP_
+#define KOKKOSSPARSE_SPMV_SELLMATRIX_IMPL_HPP_
+
+/// \file KokkosSparse_spmv_sellmatrix_impl.hpp
+/// \brief Sparse matrix-vector multiply for SELL-C-sigma matrices
+///
+/// On CPUs one thread handles a whole chunk of C rows: every step of the
+/// inner loop loads C contiguous values and column indices and updates C
+/// independent sums, which the compiler keeps in vector registers (C is a
+/// template parameter so the accumulator array has a fixed size).  On GPUs
+/// one thread handles one row of a chunk, and the C threads of a chunk read
+/// contiguous memory.
+
+#include <sstream>
+
+#include "Kokkos_Core.hpp"
+#include "Kokkos_ArithTraits.hpp"
+#include "KokkosKernels_Error.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosBlas1_scal.hpp"
+#include "KokkosSparse_SellMatrix.hpp"
+
+namespace KokkosSparse {
+namespace Impl {
+
+// Uniform access to rank-1 and rank-2 views; k is ignored for rank 1.
+template <class ViewType>
+KOKKOS_INLINE_FUNCTION typename ViewType::reference_type sell_vector_entry(
+    const ViewType& v, const typename ViewType::size_type i,
+    const typename ViewType::size_type k) {
+  if constexpr (ViewType::rank == 1) {
+    (void)k;
+    return v(i);
+  } else {
+    return v(i, k);
+  }
+}
+
+template <class ViewType>
+inline typename ViewType::size_type sell_num_vectors(const ViewType& v) {
+  if constexpr (ViewType::rank == 1) {
+    (void)v;
+    return 1;
+  } else {
+    return v.extent(1);
+  }
+}
+
+/// \brief y = beta*y + alpha*op(A)*x, one chunk of C rows per thread (CPU).
+template <int C, class AMatrix, class XVector, class YVector, bool conjugate>
+struct SellSpmvHost_Functor {
+  typedef typename AMatrix::ordinal_type ordinal_type;
+  typedef typename AMatrix::size_type size_type;
+  typedef typename AMatrix::non_const_value_type A_value_type;
+  typedef typename YVector::non_const_value_type y_value_type;
+  typedef Kokkos::ArithTraits<A_value_type> ATV;
+
+  const y_value_type alpha;
+  AMatrix m_A;
+  XVector m_x;
+  const y_value_type beta;
+  YVector m_y;
+  const size_t numVecs;
+
+  SellSpmvHost_Functor(const y_value_type alpha_, const AMatrix& A_,
+                       const XVector& x_, const y_value_type beta_,
+                       const YVector& y_)
+      : alpha(alpha_),
+        m_A(A_),
+        m_x(x_),
+        beta(beta_),
+        m_y(y_),
+        numVecs(sell_num_vectors(y_)) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const ordinal_type chunk) const {
+    const size_type base    = m_A.chunk_map(chunk);
+    const size_type width   = (m_A.chunk_map(chunk + 1) - base) / C;
+    const ordinal_type row0 = chunk * C;
+    const ordinal_type nlanes =
+        (m_A.numRows() - row0 < C) ? m_A.numRows() - row0 : C;
+
+    for (size_t k = 0; k < numVecs; ++k) {
+      y_value_type sum[C];
+#ifdef KOKKOS_ENABLE_PRAGMA_UNROLL
+#pragma unroll
+#endif
+      for (int lane = 0; lane < C; ++lane) {
+        sum[lane] = Kokkos::ArithTraits<y_value_type>::zero();
+      }
+
+      for (size_type j = 0; j < width; ++j) {
+        const size_type offset = base + j * C;
+#ifdef KOKKOS_ENABLE_PRAGMA_IVDEP
+#pragma ivdep
+#endif
+#ifdef KOKKOS_ENABLE_PRAGMA_UNROLL
+#pragma unroll
+#endif
+        for (int lane = 0; lane < C; ++lane) {
+          // Padding (column -1) is masked out, so that Inf or NaN in x do
+          // not reach the padded rows
+          const ordinal_type col = m_A.entries(offset + lane);
+          const A_value_type val = conjugate
+                                       ? ATV::conj(m_A.values(offset + lane))
+                                       : m_A.values(offset + lane);
+          if (col >= 0) sum[lane] += val * sell_vector_entry(m_x, col, k);
+        }
+      }
+
+      for (ordinal_type lane = 0; lane < nlanes; ++lane) {
+        auto& y_i = sell_vector_entry(m_y, m_A.row_perm(row0 + lane), k);
+        if (beta == Kokkos::ArithTraits<y_value_type>::zero())
+          y_i = alpha * sum[lane];
+        else
+          y_i = beta * y_i + alpha * sum[lane];
+      }
+    }
+  }
+};
+
+/// \brief y = beta*y + alpha*op(A)*x, one row per thread (GPU).
+///
+/// Thread p handles lane p % C of chunk p / C, so consecutive threads read
+/// consecutive values and column indices.
+template <class AMatrix, class XVector, class YVector, bool conjugate>
+struct SellSpmvDevice_Functor {
+  typedef typename AMatrix::ordinal_type ordinal_type;
+  typedef typename AMatrix::size_type size_type;
+  typedef typename AMatrix::non_const_value_type A_value_type;
+  typedef typename YVector::non_const_value_type y_value_type;
+  typedef Kokkos::ArithTraits<A_value_type> ATV;
+
+  const y_value_type alpha;
+  AMatrix m_A;
+  XVector m_x;
+  const y_value_type beta;
+  YVector m_y;
+  const size_t numVecs;
+  const ordinal_type chunkSize;
+
+  SellSpmvDevice_Functor(const y_value_type alpha_, const AMatrix& A_,
+                         const XVector& x_, const y_value_type beta_,
+                         const YVector& y_)
+      : alpha(alpha_),
+        m_A(A_),
+        m_x(x_),
+        beta(beta_),
+        m_y(y_),
+        numVecs(sell_num_vectors(y_)),
+        chunkSize(A_.chunkSize()) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const ordinal_type p) const {
+    const ordinal_type chunk = p / chunkSize;
+    const ordinal_type lane  = p % chunkSize;
+    const size_type base     = m_A.chunk_map(chunk) + lane;
+    const size_type width =
+        (m_A.chunk_map(chunk + 1) - m_A.chunk_map(chunk)) / chunkSize;
+    const ordinal_type row = m_A.row_perm(p);
+
+    for (size_t k = 0; k < numVecs; ++k) {
+      y_value_type sum = Kokkos::ArithTraits<y_value_type>::zero();
+      for (size_type j = 0; j < width; ++j) {
+        const size_type offset = base + j * chunkSize;
+        const ordinal_type col = m_A.entries(offset);
+        // Padding is at the end of the row
+        if (col < 0) break;
+        const A_value_type val =
+            conjugate ? ATV::conj(m_A.values(offset)) : m_A.values(offset);
+        sum += val * sell_vector_entry(m_x, col, k);
+      }
+      auto& y_i = sell_vector_entry(m_y, row, k);
+      if (beta == Kokkos::ArithTraits<y_value_type>::zero())
+        y_i = alpha * sum;
+      else
+        y_i = beta * y_i + alpha * sum;
+    }
+  }
+};
+
+/// \brief y += alpha*op(A)^T*x, scattered with atomics, one row per thread.
+template <class AMatrix, class XVector, class YVector, bool conjugate>
+struct SellSpmvTranspose_Functor {
+  typedef typename AMatrix::ordinal_type ordinal_type;
+  typedef typename AMatrix::size_type size_type;
+  typedef typename AMatrix::non_const_value_type A_value_type;
+  typedef typename YVector::non_const_value_type y_value_type;
+  typedef Kokkos::ArithTraits<A_value_type> ATV;
+
+  const y_value_type alpha;
+  AMatrix m_A;
+  XVector m_x;
+  YVector m_y;
+  const size_t numVecs;
+  const ordinal_type chunkSize;
+
+  SellSpmvTranspose_Functor(const y_value_type alpha_, const AMatrix& A_,
+                            const XVector& x_, const YVector& y_)
+      : alpha(alpha_),
+        m_A(A_),
+        m_x(x_),
+        m_y(y_),
+        numVecs(sell_num_vectors(y_)),
+        chunkSize(A_.chunkSize()) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const ordinal_type p) const {
+    const ordinal_type chunk = p / chunkSize;
+    const ordinal_type lane  = p % chunkSize;
+    const size_type base     = m_A.chunk_map(chunk) + lane;
+    const size_type width =
+        (m_A.chunk_map(chunk + 1) - m_A.chunk_map(chunk)) / chunkSize;
+    const ordinal_type row = m_A.row_perm(p);
+
+    for (size_t k = 0; k < numVecs; ++k) {
+      const y_value_type alpha_x = alpha * sell_vector_entry(m_x, row, k);
+      for (size_type j = 0; j < width; ++j) {
+        const size_type offset = base + j * chunkSize;
+        const ordinal_type col = m_A.entries(offset);
+        // Padding is at the end of the row
+        if (col < 0) break;
+        const A_value_type val =
+            conjugate ? ATV::conj(m_A.values(offset)) : m_A.values(offset);
+        Kokkos::atomic_add(&sell_vector_entry(m_y, col, k),
+                           static_cast<y_value_type>(val * alpha_x));
+      }
+    }
+  }
+};
+
+template <int C, bool conjugate, class execution_space, class AMatrix,
+          class XVector, class YVector>
+void spmv_sellmatrix_host(
+    const typename YVector::non_const_value_type& alpha, const AMatrix& A,
+    const XVector& x, const typename YVector::non_const_value_type& beta,
+    const YVector& y) {
+  Kokkos::parallel_for(
+      "KokkosSparse::spmv<SellMatrix,Host>",
+      Kokkos::RangePolicy<execution_space, Kokkos::Schedule<Kokkos::Static>>(
+          0, A.numChunks()),
+      SellSpmvHost_Functor<C, AMatrix, XVector, YVector, conjugate>(
+          alpha, A, x, beta, y));
+}
+
+template <bool conjugate, class execution_space, class AMatrix, class XVector,
+          class YVector>
+void spmv_sellmatrix_no_transpose(
+    const typename YVector::non_const_value_type& alpha, const AMatrix& A,
+    const XVector& x, const typename YVector::non_const_value_type& beta,
+    const YVector& y) {
+  if (KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space>()) {
+    Kokkos::parallel_for(
+        "KokkosSparse::spmv<SellMatrix,Device>",
+        Kokkos::RangePolicy<execution_space>(0, A.numRows()),
+        SellSpmvDevice_Functor<AMatrix, XVector, YVector, conjugate>(
+            alpha, A, x, beta, y));
+    return;
+  }
+  switch (A.chunkSize()) {
+    case 1:
+      spmv_sellmatrix_host<1, conjugate, execution_space>(alpha, A, x, beta,
+                                                          y);
+      break;
+    case 2:
+      spmv_sellmatrix_host<2, conjugate, execution_space>(alpha, A, x, beta,
+                                                          y);
+      break;
+    case 4:
+      spmv_sellmatrix_host<4, conjugate, execution_space>(alpha, A, x, beta,
+                                                          y);
+      break;
+    case 8:
+      spmv_sellmatrix_host<8, conjugate, execution_space>(alpha, A, x, beta,
+                                                          y);
+      break;
+    case 16:
+      spmv_sellmatrix_host<16, conjugate, execution_space>(alpha, A, x, beta,
+                                                           y);
+      break;
+    case 32:
+      spmv_sellmatrix_host<32, conjugate, execution_space>(alpha, A, x, beta,
+                                                           y);
+      break;
+    case 64:
+      spmv_sellmatrix_host<64, conjugate, execution_space>(alpha, A, x, beta,
+                                                           y);
+      break;
+    default: {
+      std::ostringstream os;
+      os << "KokkosSparse::spmv: invalid SellMatrix chunk size "
+         << A.chunkSize();
+      KokkosKernels::Impl::throw_runtime_exception(os.str());
+    }
+  }
+}
+
+/// \brief y = beta*y + alpha*op(A)*x for a SellMatrix A.
+///
+/// x and y are either both rank 1 or both rank 2. Dimensions are checked by
+/// the caller.
+template <class execution_space, class AMatrix, class XVector, class YVector>
+void spmv_sellmatrix(const char mode[],
+                     const typename YVector::non_const_value_type& alpha,
+                     const AMatrix& A, const XVector& x,
+                     const typename YVector::non_const_value_type& beta,
+                     const YVector& y) {
+  static_assert(KokkosSparse::Experimental::is_sell_matrix<AMatrix>::value,
+                "spmv_sellmatrix: AMatrix must be a SellMatrix");
+
+  switch (mode[0]) {
+    case 'N':
+      if (A.numRows() == 0) return;
+      spmv_sellmatrix_no_transpose<false, execution_space>(alpha, A, x, beta,
+                                                           y);
+      return;
+    case 'C':
+      if (A.numRows() == 0) return;
+      spmv_sellmatrix_no_transpose<true, execution_space>(alpha, A, x, beta,
+                                                          y);
+      return;
+    case 'T':
+    case 'H': {
+      // y has numCols rows, which are scaled even when A has no rows
+      KokkosBlas::scal(y, beta, y);
+      if (A.numRows() == 0) return;
+      Kokkos::RangePolicy<execution_space> policy(0, A.numRows());
+      if (mode[0] == 'T')
+        Kokkos::parallel_for(
+            "KokkosSparse::spmv<SellMatrix,Transpose>", policy,
+            SellSpmvTranspose_Functor<AMatrix, XVector, YVector, false>(
+                alpha, A, x, y));
+      else
+        Kokkos::parallel_for(
+            "KokkosSparse::spmv<SellMatrix,ConjugateTranspose>", policy,
+            SellSpmvTranspose_Functor<AMatrix, XVector, YVector, true>(
+                alpha, A, x, y));
+      return;
+    }
+    default: {
+      std::ostringstream os;
+      os << "KokkosSparse::spmv: Invalid mode \"" << mode << "\"";
+      KokkosKernels::Impl::throw_runtime_exception(os.str());
+    }
+  }
+}
+
+}  // namespace Impl
+}  // namespace KokkosSparse
+
+#endif  // KOKKOSSPARSE_SPMV_SELLMATRIX_IMPL_HPP_
@@ -22,9 +22,11 @@
 
 #include "KokkosSparse_CrsMatrix.hpp"
 #include "KokkosKernels_Controls.hpp"
+#include "KokkosSparse_spmv_handle.hpp"
 // Include the actual functors
 #if !defined(KOKKOSKERNELS_ETI_ONLY) || KOKKOSKERNELS_IMPL_COMPILE_LIBRARY
 #include <KokkosSparse_spmv_impl.hpp>
+#include <KokkosSparse_spmv_handle_impl.hpp>
 #endif
 
 namespace KokkosSparse {
@@ -119,11 +121,22 @@ struct SPMV {
   typedef Kokkos::View<YT, YL, YD, YM> YVector;
 
   typedef typename YVector::non_const_value_type coefficient_type;
+  typedef KokkosSparse::Experimental::SPMVHandle<
+      typename AMatrix::non_const_size_type,
+      typename AMatrix::non_const_ordinal_type,
+      typename AMatrix::execution_space, typename AMatrix::memory_space>
+      handle_type;
 
   static void spmv(const KokkosKernels::Experimental::Controls& controls,
                    const char mode[], const coefficient_type& alpha,
                    const AMatrix& A, const XVector& x,
                    const coefficient_type& beta, const YVector& y);
+
+  //! Native kernels only: runs the launch plan of an analyzed handle
+  static void spmv(const handle_type& handle, const char mode[],
+                   const coefficient_type& alpha, const AMatrix& A,
+                   const XVector& x, const coefficient_type& beta,
+                   const YVector& y);
 };
 
 // Unification layer
@@ -177,11 +190,22 @@ struct SPMV_MV {
   typedef Kokkos::View<XT, XL, XD, XM> XVector;
   typedef Kokkos::View<YT, YL, YD, YM> YVector;
   typedef typename YVector::non_const_value_type coefficient_type;
+  typedef KokkosSparse::Experimental::SPMVHandle<
+      typename AMatrix::non_const_size_type,
+      typename AMatrix::non_const_ordinal_type,
+      typename AMatrix::execution_space, typename AMatrix::memory_space>
+      handle_type;
 
   static void spmv_mv(const KokkosKernels::Experimental::Controls& controls,
                       const char mode[], const coefficient_type& alpha,
                       const AMatrix& A, const XVector& x,
                       const coefficient_type& beta, const YVector& y);
+
+  //! Native kernels only: runs the launch plan of an analyzed handle
+  static void spmv_mv(const handle_type& handle, const char mode[],
+                      const coefficient_type& alpha, const AMatrix& A,
+                      const XVector& x, const coefficient_type& beta,
+                      const YVector& y);
 };
 
 #if !defined(KOKKOSKERNELS_ETI_ONLY) || KOKKOSKERNELS_IMPL_COMPILE_LIBRARY
@@ -195,6 +219,18 @@ struct SPMV<AT, AO, AD, AM, AS, XT, XL, XD, XM, YT, YL, YD, YM, false,
   typedef Kokkos::View<XT, XL, XD, XM> XVector;
   typedef Kokkos::View<YT, YL, YD, YM> YVector;
   typedef typename YVector::non_const_value_type coefficient_type;
+  typedef KokkosSparse::Experimental::SPMVHandle<
+      typename AMatrix::non_const_size_type,
+      typename AMatrix::non_const_ordinal_type,
+      typename AMatrix::execution_space, typename AMatrix::memory_space>
+      handle_type;
+
+  static void spmv(const handle_type& handle, const char mode[],
+                   const coefficient_type& alpha, const AMatrix& A,
+                   const XVector& x, const coefficient_type& beta,
+                   const YVector& y) {
+    spmv_handle_apply(handle, mode, alpha, A, x, beta, y);
+  }
 
   static void spmv(const KokkosKernels::Experimental::Controls& controls,
                    const char mode[], const coefficient_type& alpha,
@@ -235,13 +271,49 @@ struct SPMV_MV<AT, AO, AD, AM, AS, XT, XL, XD, XM, YT, YL, YD, YM, false, false,
   typedef Kokkos::View<XT, XL, XD, XM> XVector;
   typedef Kokkos::View<YT, YL, YD, YM> YVector;
   typedef typename YVector::non_const_value_type coefficient_type;
+  typedef KokkosSparse::Experimental::SPMVHandle<
+      typename AMatrix::non_const_size_type,
+      typename AMatrix::non_const_ordinal_type,
+      typename AMatrix::execution_space, typename AMatrix::memory_space>
+      handle_type;
 
-  static void spmv_mv(const KokkosKernels::Experimental::Controls& /*controls*/,
+  static void spmv_mv(const handle_type& handle, const char mode[],
+                      const coefficient_type& alpha, const AMatrix& A,
+                      const XVector& x, const coefficient_type& beta,
+                      const YVector& y) {
+    typedef Kokkos::Details::ArithTraits<coefficient_type> KAT;
+
+    if (alpha != KAT::zero() &&
+        handle.get_kernel() ==
+            KokkosSparse::Experimental::SPMVAlgorithm::SPMV_MERGE_PATH) {
+      spmv_mv_merge<AMatrix, XVector, YVector>(handle.get_items_per_thread(),
+                                               mode, alpha, A, x, beta, y);
+      return;
+    }
+    spmv_mv_native(mode, alpha, A, x, beta, y);
+  }
+
+  static void spmv_mv(const KokkosKernels::Experimental::Controls& controls,
                       const char mode[], const coefficient_type& alpha,
                       const AMatrix& A, const XVector& x,
                       const coefficient_type& beta, const YVector& y) {
     typedef Kokkos::Details::ArithTraits<coefficient_type> KAT;
 
+    if (alpha != KAT::zero() && controls.isParameter("algorithm") &&
+        controls.getParameter("algorithm") == "merge") {
+      spmv_mv_merge<AMatrix, XVector, YVector>(controls, mode, alpha, A, x,
+                                               beta, y);
+      return;
+    }
+    spmv_mv_native(mode, alpha, A, x, beta, y);
+  }
+
+ private:
+  static void spmv_mv_native(const char mode[], const coefficient_type& alpha,
+                             const AMatrix& A, const XVector& x,
+                             const coefficient_type& beta, const YVector& y) {
+    typedef Kokkos::Details::ArithTraits<coefficient_type> KAT;
+
     if (alpha == KAT::zero()) {
       spmv_alpha_mv<AMatrix, XVector, YVector, 0>(mode, alpha, A, x, beta, y);
     } else if (alpha == KAT::one()) {
@@ -262,6 +334,25 @@ struct SPMV_MV<AT, AO, AD, AM, AS, XT, XL, XD, XM, YT, YL, YD, YM, true, false,
   typedef Kokkos::View<XT, XL, XD, XM> XVector;
   typedef Kokkos::View<YT, YL, YD, YM> YVector;
   typedef typename YVector::non_const_value_type coefficient_type;
+  typedef KokkosSparse::Experimental::SPMVHandle<
+      typename AMatrix::non_const_size_type,
+      typename AMatrix::non_const_ordinal_type,
+      typename AMatrix::execution_space, typename AMatrix::memory_space>
+      handle_type;
+
+  static void spmv_mv(const handle_type& handle, const char mode[],
+                      const coefficient_type& alpha, const AMatrix& A,
+                      const XVector& x, const coefficient_type& beta,
+                      const YVector& y) {
+    typedef SPMV<AT, AO, AD, AM, AS, typename XVector::value_type*, XL, XD, XM,
+                 typename YVector::value_type*, YL, YD, YM>
+        impl_type;
+    for (typename AMatrix::non_const_size_type j = 0; j < x.extent(1); ++j) {
+      auto x_j = Kokkos::subview(x, Kokkos::ALL(), j);
+      auto y_j = Kokkos::subview(y, Kokkos::ALL(), j);
+      impl_type::spmv(handle, mode, alpha, A, x_j, beta, y_j);
+    }
+  }
 
   static void spmv_mv(const KokkosKernels::Experimental::Controls& /*controls*/,
                       const char mode[], const coefficient_type& alpha,
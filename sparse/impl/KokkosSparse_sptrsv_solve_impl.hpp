@@ -25,6 +25,8 @@
 #include <KokkosSparse_sptrsv_handle.hpp>
 #include <KokkosSparse_spmv.hpp>
 #include <KokkosSparse_CrsMatrix.hpp>
+#include <KokkosBlas1_mult.hpp>
+#include "KokkosBatched_Trsv_Serial_Internal.hpp"
 
 #ifdef KOKKOSKERNELS_ENABLE_SUPERNODAL_SPTRSV
 
@@ -2633,6 +2635,96 @@ struct TriLvlSchedTP1SingleBlockFunctorDiagValues {
   }    // end tagged operator
 };
 
+// Execution spaces on which all threads of a RangePolicy run concurrently and
+// each works through its iterations in increasing order. A row may then spin
+// on rows of earlier levels, which always sit at smaller iteration indices:
+// the smallest unfinished index never waits, so the solve cannot deadlock.
+template <class ExecSpace>
+struct SptrsvSyncFreeSafe {
+  static constexpr bool value = false;
+};
+#ifdef KOKKOS_ENABLE_SERIAL
+template <>
+struct SptrsvSyncFreeSafe<Kokkos::Serial> {
+  static constexpr bool value = true;
+};
+#endif
+#ifdef KOKKOS_ENABLE_OPENMP
+template <>
+struct SptrsvSyncFreeSafe<Kokkos::OpenMP> {
+  static constexpr bool value = true;
+};
+#endif
+#ifdef KOKKOS_ENABLE_THREADS
+template <>
+struct SptrsvSyncFreeSafe<Kokkos::Threads> {
+  static constexpr bool value = true;
+};
+#endif
+
+// Solves the rows of one merged region of levels. With wait set, every
+// off-diagonal entry waits for its column to be flagged with the epoch of
+// the current solve; the row then publishes its own flag. Diagonal entries
+// are found by column, so the row entries need not be sorted.
+template <class RowMapType, class EntriesType, class ValuesType, class LHSType,
+          class RHSType, class NGBLType, class DoneType>
+struct TriLvlSchedSyncFreeFunctor {
+  typedef typename EntriesType::non_const_value_type lno_t;
+  typedef typename LHSType::non_const_value_type scalar_t;
+  RowMapType row_map;
+  EntriesType entries;
+  ValuesType values;
+  LHSType lhs;
+  RHSType rhs;
+  NGBLType nodes_grouped_by_level;
+  DoneType done;
+  bool wait;
+  int epoch;
+
+  TriLvlSchedSyncFreeFunctor(const RowMapType &row_map_,
+                             const EntriesType &entries_,
+                             const ValuesType &values_, LHSType &lhs_,
+                             const RHSType &rhs_,
+                             const NGBLType &nodes_grouped_by_level_,
+                             const DoneType &done_, const bool wait_,
+                             const int epoch_)
+      : row_map(row_map_),
+        entries(entries_),
+        values(values_),
+        lhs(lhs_),
+        rhs(rhs_),
+        nodes_grouped_by_level(nodes_grouped_by_level_),
+        done(done_),
+        wait(wait_),
+        epoch(epoch_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const lno_t i) const {
+    auto rowid         = nodes_grouped_by_level(i);
+    auto soffset       = row_map(rowid);
+    auto eoffset       = row_map(rowid + 1);
+    scalar_t rhs_rowid = rhs(rowid);
+    scalar_t diag      = Kokkos::ArithTraits<scalar_t>::one();
+
+    for (auto ptr = soffset; ptr < eoffset; ++ptr) {
+      auto colid = entries(ptr);
+      if (colid != rowid) {
+        if (wait) {
+          while (Kokkos::atomic_load(&done(colid)) != epoch) {
+          }
+          Kokkos::memory_fence();
+        }
+        rhs_rowid -= values(ptr) * lhs(colid);
+      } else {
+        diag = values(ptr);
+      }
+    }  // end for ptr
+    lhs(rowid) = rhs_rowid / diag;
+    Kokkos::memory_fence();
+    Kokkos::atomic_store(&done(rowid), epoch);
+  }
+};
+
 #ifdef KOKKOSKERNELS_SPTRSV_CUDAGRAPHSUPPORT
 template <class SpaceType>
 struct ReturnTeamPolicyType;
@@ -4019,6 +4111,375 @@ void tri_solve_chain(TriSolveHandle &thandle, const RowMapType row_map,
 
 }  // end tri_solve_chain
 
+// Level-scheduled solve over the regions built by symbolic_merge_phase.
+// Where SptrsvSyncFreeSafe holds, a region of several small levels is one
+// parallel_for whose rows wait on their dependencies individually, replacing
+// a barrier per level by point-to-point synchronization. Elsewhere, each
+// level is still launched on its own.
+template <class TriSolveHandle, class RowMapType, class EntriesType,
+          class ValuesType, class RHSType, class LHSType>
+void tri_solve_syncfree(TriSolveHandle &thandle, const RowMapType row_map,
+                        const EntriesType entries, const ValuesType values,
+                        const RHSType &rhs, LHSType &lhs) {
+  typedef typename TriSolveHandle::execution_space execution_space;
+  typedef typename TriSolveHandle::size_type size_type;
+  typedef typename TriSolveHandle::nnz_lno_view_t NGBLType;
+  typedef typename TriSolveHandle::int_row_view_t DoneType;
+  typedef Kokkos::RangePolicy<execution_space,
+                              Kokkos::Schedule<Kokkos::Static>>
+      range_policy;
+
+  constexpr bool merge = SptrsvSyncFreeSafe<execution_space>::value;
+
+  auto h_merged_level_ptr     = thandle.get_host_merged_level_ptr();
+  size_type num_regions       = thandle.get_num_merged_regions();
+  auto hnodes_per_level       = thandle.get_host_nodes_per_level();
+  auto nodes_grouped_by_level = thandle.get_nodes_grouped_by_level();
+  auto done                   = thandle.get_syncfree_done();
+  const int epoch             = thandle.next_syncfree_epoch();
+
+  using functor_t =
+      TriLvlSchedSyncFreeFunctor<RowMapType, EntriesType, ValuesType, LHSType,
+                                 RHSType, NGBLType, DoneType>;
+
+  size_type node_count = 0;
+  for (size_type r = 0; r < num_regions; ++r) {
+    const size_type slvl = h_merged_level_ptr(r);
+    const size_type elvl = h_merged_level_ptr(r + 1);
+    if (merge) {
+      size_type region_nodes = 0;
+      for (size_type lvl = slvl; lvl < elvl; ++lvl)
+        region_nodes += hnodes_per_level(lvl);
+      functor_t tstf(row_map, entries, values, lhs, rhs,
+                     nodes_grouped_by_level, done, elvl - slvl > 1, epoch);
+      Kokkos::parallel_for(
+          "parfor_syncfree_region",
+          range_policy(node_count, node_count + region_nodes), tstf);
+      node_count += region_nodes;
+    } else {
+      for (size_type lvl = slvl; lvl < elvl; ++lvl) {
+        const size_type lvl_nodes = hnodes_per_level(lvl);
+        functor_t tstf(row_map, entries, values, lhs, rhs,
+                       nodes_grouped_by_level, done, false, epoch);
+        Kokkos::parallel_for("parfor_syncfree_level",
+                             range_policy(node_count, node_count + lvl_nodes),
+                             tstf);
+        node_count += lvl_nodes;
+      }
+    }
+  }
+}  // end tri_solve_syncfree
+
+// Inverse of the diagonal of a triangle, one if the row has no diagonal
+// entry (like the level scheduled solves, which divide by it only if found)
+template <class RowMapType, class EntriesType, class ValuesType,
+          class InvDiagType>
+struct TriJacobiInvDiagFunctor {
+  typedef typename EntriesType::non_const_value_type lno_t;
+  typedef typename InvDiagType::non_const_value_type scalar_t;
+  RowMapType row_map;
+  EntriesType entries;
+  ValuesType values;
+  InvDiagType inv_diag;
+
+  TriJacobiInvDiagFunctor(const RowMapType &row_map_,
+                          const EntriesType &entries_,
+                          const ValuesType &values_,
+                          const InvDiagType &inv_diag_)
+      : row_map(row_map_),
+        entries(entries_),
+        values(values_),
+        inv_diag(inv_diag_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const lno_t rowid) const {
+    scalar_t diag = Kokkos::ArithTraits<scalar_t>::one();
+    for (auto ptr = row_map(rowid); ptr < row_map(rowid + 1); ++ptr) {
+      if (entries(ptr) == rowid) diag = values(ptr);
+    }
+    inv_diag(rowid) = Kokkos::ArithTraits<scalar_t>::one() / diag;
+  }
+};
+
+// Approximate solve of T x = b by Jacobi sweeps from x = D^{-1} b:
+//   x += D^{-1} (b - T x)
+// The iteration matrix I - D^{-1} T is nilpotent, so the error vanishes
+// after as many sweeps as T has levels; a few sweeps usually suffice for
+// applying incomplete factors. Every step is an SpMV or a vector update,
+// the same inner Jacobi-Richardson recurrence as the two-stage
+// Gauss-Seidel, so the solve needs no level schedule and has full
+// parallelism.
+template <class TriSolveHandle, class RowMapType, class EntriesType,
+          class ValuesType, class RHSType, class LHSType>
+void tri_solve_jacobi(TriSolveHandle &thandle, const RowMapType row_map,
+                      const EntriesType entries, const ValuesType values,
+                      const RHSType &rhs, LHSType &lhs) {
+  typedef typename TriSolveHandle::execution_space execution_space;
+  typedef typename TriSolveHandle::nnz_lno_t lno_t;
+  typedef typename TriSolveHandle::nnz_scalar_view_t InvDiagType;
+  typedef typename LHSType::non_const_value_type scalar_t;
+  typedef Kokkos::Device<typename RowMapType::execution_space,
+                         typename RowMapType::memory_space>
+      device_t;
+  typedef KokkosSparse::CrsMatrix<
+      typename ValuesType::value_type, typename EntriesType::value_type,
+      device_t, typename ValuesType::memory_traits,
+      typename RowMapType::value_type>
+      crsmat_t;
+
+  const lno_t nrows   = thandle.get_nrows();
+  const scalar_t one  = Kokkos::ArithTraits<scalar_t>::one();
+  const scalar_t zero = Kokkos::ArithTraits<scalar_t>::zero();
+
+  InvDiagType inv_diag = thandle.get_jacobi_inv_diag();
+  Kokkos::parallel_for(
+      "parfor_jacobi_inv_diag",
+      Kokkos::RangePolicy<execution_space>(0, nrows),
+      TriJacobiInvDiagFunctor<RowMapType, EntriesType, ValuesType,
+                              InvDiagType>(row_map, entries, values,
+                                           inv_diag));
+
+  crsmat_t T("T", nrows, nrows, values.extent(0), values, row_map, entries);
+
+  // With several right-hand sides (rank 2), each sweep is one SpMV on all
+  // the columns
+  auto sweeps = [&](const auto &r) {
+    // x = D^{-1} b
+    KokkosBlas::mult(zero, lhs, one, inv_diag, rhs);
+    for (int sweep = 0; sweep < thandle.get_num_jacobi_sweeps(); ++sweep) {
+      // r = b - T x
+      Kokkos::deep_copy(r, rhs);
+      KokkosSparse::spmv("N", scalar_t(-one), T, lhs, one, r);
+      // x = x + D^{-1} r
+      KokkosBlas::mult(one, lhs, one, inv_diag, r);
+    }
+  };
+  if constexpr (static_cast<int>(LHSType::rank) == 2) {
+    Kokkos::View<scalar_t **, typename LHSType::array_layout, device_t> r(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "jacobi_work_mv"),
+        lhs.extent(0), lhs.extent(1));
+    sweeps(r);
+  } else {
+    sweeps(thandle.get_jacobi_work());
+  }
+}  // end tri_solve_jacobi
+
+// Level-scheduled solve of several right-hand sides at once. One team
+// solves one row for all the columns: every lane of its vector owns a
+// column of X and walks the row, so the factor is traversed once per solve
+// rather than once per column.
+template <class RowMapType, class EntriesType, class ValuesType, class LHSType,
+          class RHSType, class NGBLType>
+struct TriLvlSchedMultiRHSFunctor {
+  typedef typename RowMapType::execution_space execution_space;
+  typedef Kokkos::TeamPolicy<execution_space> policy_type;
+  typedef typename policy_type::member_type member_type;
+  typedef typename EntriesType::non_const_value_type lno_t;
+  typedef typename LHSType::non_const_value_type scalar_t;
+  RowMapType row_map;
+  EntriesType entries;
+  ValuesType values;
+  LHSType lhs;
+  RHSType rhs;
+  NGBLType nodes_grouped_by_level;
+  long node_count;
+
+  TriLvlSchedMultiRHSFunctor(const RowMapType &row_map_,
+                             const EntriesType &entries_,
+                             const ValuesType &values_, LHSType &lhs_,
+                             const RHSType &rhs_,
+                             const NGBLType &nodes_grouped_by_level_,
+                             const long node_count_)
+      : row_map(row_map_),
+        entries(entries_),
+        values(values_),
+        lhs(lhs_),
+        rhs(rhs_),
+        nodes_grouped_by_level(nodes_grouped_by_level_),
+        node_count(node_count_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const member_type &team) const {
+    auto rowid   = nodes_grouped_by_level(node_count + team.league_rank());
+    auto soffset = row_map(rowid);
+    auto eoffset = row_map(rowid + 1);
+    Kokkos::parallel_for(
+        Kokkos::ThreadVectorRange(team, lhs.extent(1)), [&](const int j) {
+          scalar_t rhs_rowid = rhs(rowid, j);
+          scalar_t diag      = Kokkos::ArithTraits<scalar_t>::one();
+          for (auto ptr = soffset; ptr < eoffset; ++ptr) {
+            auto colid = entries(ptr);
+            if (colid != rowid)
+              rhs_rowid -= values(ptr) * lhs(colid, j);
+            else
+              diag = values(ptr);
+          }
+          lhs(rowid, j) = rhs_rowid / diag;
+        });
+  }
+};
+
+// Solves with the level schedule of the symbolic phase, whichever of the
+// level-scheduled algorithms computed it, for all the columns of rhs.
+template <class TriSolveHandle, class RowMapType, class EntriesType,
+          class ValuesType, class RHSType, class LHSType>
+void tri_solve_multi_rhs(TriSolveHandle &thandle, const RowMapType row_map,
+                         const EntriesType entries, const ValuesType values,
+                         const RHSType &rhs, LHSType &lhs) {
+  typedef typename TriSolveHandle::size_type size_type;
+  typedef typename TriSolveHandle::nnz_lno_view_t NGBLType;
+  typedef TriLvlSchedMultiRHSFunctor<RowMapType, EntriesType, ValuesType,
+                                     LHSType, RHSType, NGBLType>
+      functor_t;
+  typedef typename functor_t::policy_type policy_type;
+
+  // A power of two vector length covering the columns, unless set
+  int vector_size = thandle.get_vector_size();
+  if (vector_size == -1) {
+    const int max_size = policy_type::vector_length_max();
+    vector_size        = 1;
+    while (vector_size < int(lhs.extent(1)) && vector_size < max_size)
+      vector_size *= 2;
+  }
+
+  size_type nlevels           = thandle.get_num_levels();
+  auto hnodes_per_level       = thandle.get_host_nodes_per_level();
+  auto nodes_grouped_by_level = thandle.get_nodes_grouped_by_level();
+
+  size_type node_count = 0;
+  for (size_type lvl = 0; lvl < nlevels; ++lvl) {
+    const size_type lvl_nodes = hnodes_per_level(lvl);
+    if (lvl_nodes != 0) {
+      functor_t tstf(row_map, entries, values, lhs, rhs,
+                     nodes_grouped_by_level, node_count);
+      Kokkos::parallel_for("parfor_multi_rhs",
+                           policy_type(lvl_nodes, 1, vector_size), tstf);
+      node_count += lvl_nodes;
+    }
+  }
+}  // end tri_solve_multi_rhs
+
+// Level-scheduled solve with BSR values, one block row per thread:
+// x_i = D_i^{-1} (b_i - sum_{j != i} T_ij x_j), where the diagonal block D_i
+// holds its LU factors (unit lower and upper), as left by the block
+// spiluk_numeric. The same functor solves lower and upper triangles, whose
+// order is in the level schedule.
+template <class RowMapType, class EntriesType, class ValuesType, class LHSType,
+          class RHSType, class NGBLType>
+struct TriLvlSchedBlockFunctor {
+  typedef typename EntriesType::non_const_value_type lno_t;
+  typedef typename LHSType::non_const_value_type scalar_t;
+  RowMapType row_map;
+  EntriesType entries;
+  ValuesType values;
+  LHSType lhs;
+  RHSType rhs;
+  NGBLType nodes_grouped_by_level;
+  int block_size;
+
+  TriLvlSchedBlockFunctor(const RowMapType &row_map_,
+                          const EntriesType &entries_,
+                          const ValuesType &values_, LHSType &lhs_,
+                          const RHSType &rhs_,
+                          const NGBLType &nodes_grouped_by_level_,
+                          const int block_size_)
+      : row_map(row_map_),
+        entries(entries_),
+        values(values_),
+        lhs(lhs_),
+        rhs(rhs_),
+        nodes_grouped_by_level(nodes_grouped_by_level_),
+        block_size(block_size_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const lno_t i) const {
+    const int bs        = block_size;
+    const int blk_elems = bs * bs;
+    auto rowid          = nodes_grouped_by_level(i);
+    const size_t xrow   = size_t(rowid) * bs;
+
+    for (int r = 0; r < bs; ++r) lhs(xrow + r) = rhs(xrow + r);
+
+    auto diag    = row_map(rowid + 1);
+    auto soffset = row_map(rowid);
+    auto eoffset = row_map(rowid + 1);
+    for (auto ptr = soffset; ptr < eoffset; ++ptr) {
+      auto colid = entries(ptr);
+      if (colid == rowid) {
+        diag = ptr;
+        continue;
+      }
+      const size_t xcol = size_t(colid) * bs;
+      const size_t vblk = size_t(ptr) * blk_elems;
+      for (int r = 0; r < bs; ++r) {
+        scalar_t sum = 0;
+        for (int c = 0; c < bs; ++c)
+          sum += values(vblk + r * bs + c) * lhs(xcol + c);
+        lhs(xrow + r) -= sum;
+      }
+    }
+
+    if (diag != eoffset) {
+      // The blocks of the BSR values are contiguous
+      const scalar_t one  = scalar_t(1.0);
+      const auto *d_block = values.data() + size_t(diag) * blk_elems;
+      scalar_t *x_block   = &lhs(xrow);
+      const int x_stride  = lhs.stride_0();
+      KokkosBatched::SerialTrsvInternalLower<
+          KokkosBatched::Algo::Trsv::Unblocked>::invoke(true, bs, one,
+                                                        d_block, bs, 1,
+                                                        x_block, x_stride);
+      KokkosBatched::SerialTrsvInternalUpper<
+          KokkosBatched::Algo::Trsv::Unblocked>::invoke(false, bs, one,
+                                                        d_block, bs, 1,
+                                                        x_block, x_stride);
+    }
+  }
+};
+
+// Solves with BSR values of thandle.get_block_size() blocks, for the
+// algorithms that schedule the rows by levels
+template <class TriSolveHandle, class RowMapType, class EntriesType,
+          class ValuesType, class RHSType, class LHSType>
+void tri_solve_block(TriSolveHandle &thandle, const RowMapType row_map,
+                     const EntriesType entries, const ValuesType values,
+                     const RHSType &rhs, LHSType &lhs) {
+  using namespace KokkosSparse::Experimental;
+  typedef typename TriSolveHandle::execution_space execution_space;
+  typedef typename TriSolveHandle::size_type size_type;
+  typedef typename TriSolveHandle::nnz_lno_view_t NGBLType;
+
+  auto algm = thandle.get_algorithm();
+  if (algm != SPTRSVAlgorithm::SEQLVLSCHD_RP &&
+      algm != SPTRSVAlgorithm::SEQLVLSCHD_TP1 &&
+      algm != SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN &&
+      algm != SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE)
+    throw std::runtime_error(
+        "sptrsv_solve: block values need a level-scheduled algorithm");
+
+  size_type nlevels           = thandle.get_num_levels();
+  auto hnodes_per_level       = thandle.get_host_nodes_per_level();
+  auto nodes_grouped_by_level = thandle.get_nodes_grouped_by_level();
+
+  TriLvlSchedBlockFunctor<RowMapType, EntriesType, ValuesType, LHSType,
+                          RHSType, NGBLType>
+      tstf(row_map, entries, values, lhs, rhs, nodes_grouped_by_level,
+           thandle.get_block_size());
+
+  size_type node_count = 0;
+  for (size_type lvl = 0; lvl < nlevels; ++lvl) {
+    const size_type lvl_nodes = hnodes_per_level(lvl);
+    if (lvl_nodes != 0) {
+      Kokkos::parallel_for(
+          "parfor_block",
+          Kokkos::RangePolicy<execution_space>(node_count,
+                                               node_count + lvl_nodes),
+          tstf);
+      node_count += lvl_nodes;
+    }
+  }
+}  // end tri_solve_block
+
 }  // namespace Experimental
 }  // namespace Impl
 }  // namespace KokkosSparse
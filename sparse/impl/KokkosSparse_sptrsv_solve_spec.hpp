@@ -68,6 +68,32 @@ struct sptrsv_solve_eti_spec_avail {
                    Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,         \
                    Kokkos::MemoryTraits<Kokkos::Unmanaged> > > {            \
     enum : bool { value = true };                                           \
+  };                                                                        \
+  template <>                                                               \
+  struct sptrsv_solve_eti_spec_avail<                                       \
+      KokkosKernels::Experimental::KokkosKernelsHandle<                     \
+          const OFFSET_TYPE, const ORDINAL_TYPE, const SCALAR_TYPE,         \
+          EXEC_SPACE_TYPE, MEM_SPACE_TYPE, MEM_SPACE_TYPE>,                 \
+      Kokkos::View<                                                         \
+          const OFFSET_TYPE *, LAYOUT_TYPE,                                 \
+          Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,                  \
+          Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >, \
+      Kokkos::View<                                                         \
+          const ORDINAL_TYPE *, LAYOUT_TYPE,                                \
+          Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,                  \
+          Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >, \
+      Kokkos::View<                                                         \
+          const SCALAR_TYPE *, LAYOUT_TYPE,                                 \
+          Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,                  \
+          Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >, \
+      Kokkos::View<                                                         \
+          const SCALAR_TYPE **, LAYOUT_TYPE,                                \
+          Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,                  \
+          Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >, \
+      Kokkos::View<SCALAR_TYPE **, LAYOUT_TYPE,                             \
+                   Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,         \
+                   Kokkos::MemoryTraits<Kokkos::Unmanaged> > > {            \
+    enum : bool { value = true };                                           \
   };
 
 // Include the actual specialization declarations
@@ -111,46 +137,96 @@ struct SPTRSV_SOLVE<KernelHandle, RowMapType, EntriesType, ValuesType, BType,
                            BType b, XType x) {
     // Call specific algorithm type
     auto sptrsv_handle = handle->get_sptrsv_handle();
-    Kokkos::Profiling::pushRegion(sptrsv_handle->is_lower_tri()
-                                      ? "KokkosSparse_sptrsv[lower]"
-                                      : "KokkosSparse_sptrsv[upper]");
-    if (sptrsv_handle->is_lower_tri()) {
+    if constexpr (static_cast<int>(BType::rank) == 2) {
+      // Multiple right-hand sides: one pass over the level schedule, or one
+      // SpMV per Jacobi sweep, solves all the columns. Only these algorithms
+      // without block values get here, the caller handles the others.
+      Kokkos::Profiling::pushRegion(sptrsv_handle->is_lower_tri()
+                                        ? "KokkosSparse_sptrsv_mv[lower]"
+                                        : "KokkosSparse_sptrsv_mv[upper]");
       if (sptrsv_handle->is_symbolic_complete() == false) {
-        Experimental::lower_tri_symbolic(*sptrsv_handle, row_map, entries);
+        if (sptrsv_handle->is_lower_tri())
+          Experimental::lower_tri_symbolic(*sptrsv_handle, row_map, entries);
+        else
+          Experimental::upper_tri_symbolic(*sptrsv_handle, row_map, entries);
       }
       if (sptrsv_handle->get_algorithm() ==
-          KokkosSparse::Experimental::SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN) {
-        Experimental::tri_solve_chain(*sptrsv_handle, row_map, entries, values,
-                                      b, x, true);
-      } else {
-#ifdef KOKKOSKERNELS_SPTRSV_CUDAGRAPHSUPPORT
-        using ExecSpace = typename RowMapType::memory_space::execution_space;
-        if (std::is_same<ExecSpace, Kokkos::Cuda>::value)
-          Experimental::lower_tri_solve_cg(*sptrsv_handle, row_map, entries,
+          KokkosSparse::Experimental::SPTRSVAlgorithm::JACOBI)
+        Experimental::tri_solve_jacobi(*sptrsv_handle, row_map, entries,
+                                       values, b, x);
+      else
+        Experimental::tri_solve_multi_rhs(*sptrsv_handle, row_map, entries,
+                                          values, b, x);
+    } else {
+      Kokkos::Profiling::pushRegion(sptrsv_handle->is_lower_tri()
+                                        ? "KokkosSparse_sptrsv[lower]"
+                                        : "KokkosSparse_sptrsv[upper]");
+      if (sptrsv_handle->is_lower_tri()) {
+        if (sptrsv_handle->is_symbolic_complete() == false) {
+          Experimental::lower_tri_symbolic(*sptrsv_handle, row_map, entries);
+        }
+        if (sptrsv_handle->get_block_size() > 1) {
+          Experimental::tri_solve_block(*sptrsv_handle, row_map, entries,
+                                        values, b, x);
+        } else if (sptrsv_handle->get_algorithm() ==
+                   KokkosSparse::Experimental::SPTRSVAlgorithm::
+                       SEQLVLSCHD_TP1CHAIN) {
+          Experimental::tri_solve_chain(*sptrsv_handle, row_map, entries,
+                                        values, b, x, true);
+        } else if (sptrsv_handle->get_algorithm() ==
+                   KokkosSparse::Experimental::SPTRSVAlgorithm::
+                       SEQLVLSCHD_SYNCFREE) {
+          Experimental::tri_solve_syncfree(*sptrsv_handle, row_map, entries,
                                            values, b, x);
-        else
+        } else if (sptrsv_handle->get_algorithm() ==
+                   KokkosSparse::Experimental::SPTRSVAlgorithm::JACOBI) {
+          Experimental::tri_solve_jacobi(*sptrsv_handle, row_map, entries,
+                                         values, b, x);
+        } else {
+#ifdef KOKKOSKERNELS_SPTRSV_CUDAGRAPHSUPPORT
+          using ExecSpace =
+              typename RowMapType::memory_space::execution_space;
+          if (std::is_same<ExecSpace, Kokkos::Cuda>::value)
+            Experimental::lower_tri_solve_cg(*sptrsv_handle, row_map, entries,
+                                             values, b, x);
+          else
 #endif
-          Experimental::lower_tri_solve(*sptrsv_handle, row_map, entries,
-                                        values, b, x);
-      }
-    } else {
-      if (sptrsv_handle->is_symbolic_complete() == false) {
-        Experimental::upper_tri_symbolic(*sptrsv_handle, row_map, entries);
-      }
-      if (sptrsv_handle->get_algorithm() ==
-          KokkosSparse::Experimental::SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN) {
-        Experimental::tri_solve_chain(*sptrsv_handle, row_map, entries, values,
-                                      b, x, false);
+            Experimental::lower_tri_solve(*sptrsv_handle, row_map, entries,
+                                          values, b, x);
+        }
       } else {
-#ifdef KOKKOSKERNELS_SPTRSV_CUDAGRAPHSUPPORT
-        using ExecSpace = typename RowMapType::memory_space::execution_space;
-        if (std::is_same<ExecSpace, Kokkos::Cuda>::value)
-          Experimental::upper_tri_solve_cg(*sptrsv_handle, row_map, entries,
+        if (sptrsv_handle->is_symbolic_complete() == false) {
+          Experimental::upper_tri_symbolic(*sptrsv_handle, row_map, entries);
+        }
+        if (sptrsv_handle->get_block_size() > 1) {
+          Experimental::tri_solve_block(*sptrsv_handle, row_map, entries,
+                                        values, b, x);
+        } else if (sptrsv_handle->get_algorithm() ==
+                   KokkosSparse::Experimental::SPTRSVAlgorithm::
+                       SEQLVLSCHD_TP1CHAIN) {
+          Experimental::tri_solve_chain(*sptrsv_handle, row_map, entries,
+                                        values, b, x, false);
+        } else if (sptrsv_handle->get_algorithm() ==
+                   KokkosSparse::Experimental::SPTRSVAlgorithm::
+                       SEQLVLSCHD_SYNCFREE) {
+          Experimental::tri_solve_syncfree(*sptrsv_handle, row_map, entries,
                                            values, b, x);
-        else
+        } else if (sptrsv_handle->get_algorithm() ==
+                   KokkosSparse::Experimental::SPTRSVAlgorithm::JACOBI) {
+          Experimental::tri_solve_jacobi(*sptrsv_handle, row_map, entries,
+                                         values, b, x);
+        } else {
+#ifdef KOKKOSKERNELS_SPTRSV_CUDAGRAPHSUPPORT
+          using ExecSpace =
+              typename RowMapType::memory_space::execution_space;
+          if (std::is_same<ExecSpace, Kokkos::Cuda>::value)
+            Experimental::upper_tri_solve_cg(*sptrsv_handle, row_map, entries,
+                                             values, b, x);
+          else
 #endif
-          Experimental::upper_tri_solve(*sptrsv_handle, row_map, entries,
-                                        values, b, x);
+            Experimental::upper_tri_solve(*sptrsv_handle, row_map, entries,
+                                          values, b, x);
+        }
       }
     }
     Kokkos::Profiling::popRegion();
@@ -194,6 +270,30 @@ struct SPTRSV_SOLVE<KernelHandle, RowMapType, EntriesType, ValuesType, BType,
       Kokkos::View<SCALAR_TYPE *, LAYOUT_TYPE,                              \
                    Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,         \
                    Kokkos::MemoryTraits<Kokkos::Unmanaged> >,               \
+      false, true>;                                                         \
+  extern template struct SPTRSV_SOLVE<                                      \
+      KokkosKernels::Experimental::KokkosKernelsHandle<                     \
+          const OFFSET_TYPE, const ORDINAL_TYPE, const SCALAR_TYPE,         \
+          EXEC_SPACE_TYPE, MEM_SPACE_TYPE, MEM_SPACE_TYPE>,                 \
+      Kokkos::View<                                                         \
+          const OFFSET_TYPE *, LAYOUT_TYPE,                                 \
+          Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,                  \
+          Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >, \
+      Kokkos::View<                                                         \
+          const ORDINAL_TYPE *, LAYOUT_TYPE,                                \
+          Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,                  \
+          Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >, \
+      Kokkos::View<                                                         \
+          const SCALAR_TYPE *, LAYOUT_TYPE,                                 \
+          Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,                  \
+          Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >, \
+      Kokkos::View<                                                         \
+          const SCALAR_TYPE **, LAYOUT_TYPE,                                \
+          Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,                  \
+          Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >, \
+      Kokkos::View<SCALAR_TYPE **, LAYOUT_TYPE,                             \
+                   Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,         \
+                   Kokkos::MemoryTraits<Kokkos::Unmanaged> >,               \
       false, true>;
 
 #define KOKKOSSPARSE_SPTRSV_SOLVE_ETI_SPEC_INST(                            \
@@ -222,6 +322,30 @@ struct SPTRSV_SOLVE<KernelHandle, RowMapType, EntriesType, ValuesType, BType,
       Kokkos::View<SCALAR_TYPE *, LAYOUT_TYPE,                              \
                    Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,         \
                    Kokkos::MemoryTraits<Kokkos::Unmanaged> >,               \
+      false, true>;                                                         \
+  template struct SPTRSV_SOLVE<                                             \
+      KokkosKernels::Experimental::KokkosKernelsHandle<                     \
+          const OFFSET_TYPE, const ORDINAL_TYPE, const SCALAR_TYPE,         \
+          EXEC_SPACE_TYPE, MEM_SPACE_TYPE, MEM_SPACE_TYPE>,                 \
+      Kokkos::View<                                                         \
+          const OFFSET_TYPE *, LAYOUT_TYPE,                                 \
+          Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,                  \
+          Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >, \
+      Kokkos::View<                                                         \
+          const ORDINAL_TYPE *, LAYOUT_TYPE,                                \
+          Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,                  \
+          Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >, \
+      Kokkos::View<                                                         \
+          const SCALAR_TYPE *, LAYOUT_TYPE,                                 \
+          Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,                  \
+          Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >, \
+      Kokkos::View<                                                         \
+          const SCALAR_TYPE **, LAYOUT_TYPE,                                \
+          Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,                  \
+          Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >, \
+      Kokkos::View<SCALAR_TYPE **, LAYOUT_TYPE,                             \
+                   Kokkos::Device<EXEC_SPACE_TYPE, MEM_SPACE_TYPE>,         \
+                   Kokkos::MemoryTraits<Kokkos::Unmanaged> >,               \
       false, true>;
 
 #include <KokkosSparse_sptrsv_solve_tpl_spec_decl.hpp>
@@ -147,6 +147,49 @@ void symbolic_chain_phase(TriSolveHandle& thandle,
 #endif
 }  // end symbolic_chain_phase
 
+// Usage:
+// for r in [0, num_merged_regions)
+//   s = h_merged_level_ptr(r); e = h_merged_level_ptr(r+1);
+//   solve levels [s, e) in a single parallel region, each row waiting on the
+//   rows it depends on; a region of one level needs no waiting at all
+
+template <class TriSolveHandle, class NPLViewType>
+void symbolic_merge_phase(TriSolveHandle& thandle,
+                          const NPLViewType& nodes_per_level) {
+  typedef typename TriSolveHandle::size_type size_type;
+  typedef typename TriSolveHandle::execution_space execution_space;
+
+  size_type nlevels = thandle.get_num_levels();
+
+  // A level with few rows cannot keep all threads busy, so paying a barrier
+  // (kernel launch) for it is what dominates; such levels are merged with
+  // their small neighbors. Large levels stay on their own.
+  long cutoff = thandle.get_merge_threshold();
+  if (cutoff < 0) cutoff = 32 * long(execution_space().concurrency());
+
+  auto h_merged_level_ptr = thandle.get_host_merged_level_ptr();
+  h_merged_level_ptr(0)   = 0;
+  size_type nregions      = 0;
+  size_type lvl           = 0;
+  while (lvl < nlevels) {
+    size_type end = lvl + 1;
+    if (long(nodes_per_level(lvl)) <= cutoff) {
+      while (end < nlevels && long(nodes_per_level(end)) <= cutoff) ++end;
+    }
+    h_merged_level_ptr(++nregions) = end;
+    lvl                            = end;
+  }
+  thandle.set_num_merged_regions(nregions);
+
+#ifdef CHAIN_LVL_OUTPUT_INFO
+  std::cout << "  num_merged_regions = " << nregions << std::endl;
+  for (size_type i = 0; i < nregions + 1; ++i) {
+    std::cout << "merged_level_ptr(" << i << "): " << h_merged_level_ptr(i)
+              << std::endl;
+  }
+#endif
+}  // end symbolic_merge_phase
+
 template <class TriSolveHandle, class RowMapType, class EntriesType>
 void lower_tri_symbolic(TriSolveHandle& thandle, const RowMapType drow_map,
                         const EntriesType dentries) {
@@ -159,7 +202,8 @@ void lower_tri_symbolic(TriSolveHandle& thandle, const RowMapType drow_map,
   if (thandle.get_algorithm() == SPTRSVAlgorithm::SEQLVLSCHD_RP ||
       thandle.get_algorithm() == SPTRSVAlgorithm::SEQLVLSCHD_TP1 ||
       /*thandle.get_algorithm () == SPTRSVAlgorithm::SEQLVLSCHED_TP2*/
-      thandle.get_algorithm() == SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN) {
+      thandle.get_algorithm() == SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN ||
+      thandle.get_algorithm() == SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE) {
     // Scheduling currently computes on host - need host copy of all views
 
     typedef typename TriSolveHandle::size_type size_type;
@@ -230,6 +274,11 @@ void lower_tri_symbolic(TriSolveHandle& thandle, const RowMapType drow_map,
       symbolic_chain_phase(thandle, nodes_per_level);
     }
 
+    // Merge runs of small levels for the sync-free solve
+    if (thandle.get_algorithm() == SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE) {
+      symbolic_merge_phase(thandle, nodes_per_level);
+    }
+
     thandle.set_symbolic_complete();
 
     // Output check
@@ -291,6 +340,9 @@ void lower_tri_symbolic(TriSolveHandle& thandle, const RowMapType drow_map,
       std::cout << "  devicecheck_count= " << check_count << std::endl;
     }
 #endif
+  } else if (thandle.get_algorithm() == SPTRSVAlgorithm::JACOBI) {
+    // The sweeps update all rows at once: there is nothing to schedule
+    thandle.set_symbolic_complete();
   }
 #ifdef KOKKOSKERNELS_ENABLE_SUPERNODAL_SPTRSV
   else if (thandle.get_algorithm() == SPTRSVAlgorithm::SUPERNODAL_NAIVE ||
@@ -610,7 +662,8 @@ void upper_tri_symbolic(TriSolveHandle& thandle, const RowMapType drow_map,
   if (thandle.get_algorithm() == SPTRSVAlgorithm::SEQLVLSCHD_RP ||
       thandle.get_algorithm() == SPTRSVAlgorithm::SEQLVLSCHD_TP1 ||
       /*thandle.get_algorithm () == SPTRSVAlgorithm::SEQLVLSCHED_TP2*/
-      thandle.get_algorithm() == SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN) {
+      thandle.get_algorithm() == SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN ||
+      thandle.get_algorithm() == SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE) {
     // Scheduling currently compute on host - need host copy of all views
 
     typedef typename TriSolveHandle::size_type size_type;
@@ -681,6 +734,11 @@ void upper_tri_symbolic(TriSolveHandle& thandle, const RowMapType drow_map,
       symbolic_chain_phase(thandle, nodes_per_level);
     }
 
+    // Merge runs of small levels for the sync-free solve
+    if (thandle.get_algorithm() == SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE) {
+      symbolic_merge_phase(thandle, nodes_per_level);
+    }
+
     thandle.set_symbolic_complete();
 
     // Output check
@@ -742,6 +800,9 @@ void upper_tri_symbolic(TriSolveHandle& thandle, const RowMapType drow_map,
       std::cout << "  devicecheck_count= " << check_count << std::endl;
     }
 #endif
+  } else if (thandle.get_algorithm() == SPTRSVAlgorithm::JACOBI) {
+    // The sweeps update all rows at once: there is nothing to schedule
+    thandle.set_symbolic_complete();
   }
 #ifdef KOKKOSKERNELS_ENABLE_SUPERNODAL_SPTRSV
   else if (thandle.get_algorithm() == SPTRSVAlgorithm::SUPERNODAL_NAIVE ||
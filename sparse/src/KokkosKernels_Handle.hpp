@@ -23,6 +23,7 @@
 #include "KokkosSparse_spiluk_handle.hpp"
 #include "KokkosSparse_par_ilut_handle.hpp"
 #include "KokkosSparse_gmres_handle.hpp"
+#include "KokkosSparse_cg_handle.hpp"
 #include "KokkosKernels_default_types.hpp"
 
 #ifndef _KOKKOSKERNELHANDLE_HPP
@@ -161,6 +162,7 @@ class KokkosKernelsHandle {
     this->spilukHandle   = right_side_handle.get_spiluk_handle();
     this->par_ilutHandle = right_side_handle.get_par_ilut_handle();
     this->gmresHandle    = right_side_handle.get_gmres_handle();
+    this->cgHandle       = right_side_handle.get_cg_handle();
 
     this->team_work_size      = right_side_handle.get_set_team_work_size();
     this->shared_memory_size  = right_side_handle.get_shmem_size();
@@ -185,6 +187,7 @@ class KokkosKernelsHandle {
     is_owner_of_the_spiluk_handle   = false;
     is_owner_of_the_par_ilut_handle = false;
     is_owner_of_the_gmres_handle    = false;
+    is_owner_of_the_cg_handle       = false;
     // return *this;
   }
 
@@ -289,6 +292,11 @@ class KokkosKernelsHandle {
       HandleTempMemorySpace, HandlePersistentMemorySpace>
       GMRESHandleType;
 
+  typedef typename KokkosSparse::Experimental::CGHandle<
+      const_size_type, const_nnz_lno_t, const_nnz_scalar_t, HandleExecSpace,
+      HandleTempMemorySpace, HandlePersistentMemorySpace>
+      CGHandleType;
+
  private:
   GraphColoringHandleType *gcHandle;
   GraphColorDistance2HandleType *gcHandle_d2;
@@ -306,6 +314,7 @@ class KokkosKernelsHandle {
   SPILUKHandleType *spilukHandle;
   PAR_ILUTHandleType *par_ilutHandle;
   GMRESHandleType *gmresHandle;
+  CGHandleType *cgHandle;
 
   int team_work_size;
   size_t shared_memory_size;
@@ -330,6 +339,7 @@ class KokkosKernelsHandle {
   bool is_owner_of_the_spiluk_handle;
   bool is_owner_of_the_par_ilut_handle;
   bool is_owner_of_the_gmres_handle;
+  bool is_owner_of_the_cg_handle;
 
  public:
   KokkosKernelsHandle()
@@ -348,6 +358,7 @@ class KokkosKernelsHandle {
         spilukHandle(NULL),
         par_ilutHandle(NULL),
         gmresHandle(NULL),
+        cgHandle(NULL),
         team_work_size(-1),
         shared_memory_size(16128),
         suggested_team_size(-1),
@@ -370,7 +381,8 @@ class KokkosKernelsHandle {
         is_owner_of_the_sptrsv_handle(true),
         is_owner_of_the_spiluk_handle(true),
         is_owner_of_the_par_ilut_handle(true),
-        is_owner_of_the_gmres_handle(true) {}
+        is_owner_of_the_gmres_handle(true),
+        is_owner_of_the_cg_handle(true) {}
 
   ~KokkosKernelsHandle() {
     this->destroy_gs_handle();
@@ -387,6 +399,7 @@ class KokkosKernelsHandle {
     this->destroy_spiluk_handle();
     this->destroy_par_ilut_handle();
     this->destroy_gmres_handle();
+    this->destroy_cg_handle();
   }
 
   void set_verbose(bool verbose_) { this->KKVERBOSE = verbose_; }
@@ -902,6 +915,20 @@ class KokkosKernelsHandle {
     }
   }
 
+  CGHandleType *get_cg_handle() { return this->cgHandle; }
+  void create_cg_handle(const size_type max_iters                = 500,
+                        const typename CGHandleType::float_t tol = 1e-8) {
+    this->destroy_cg_handle();
+    this->is_owner_of_the_cg_handle = true;
+    this->cgHandle                  = new CGHandleType(max_iters, tol);
+  }
+  void destroy_cg_handle() {
+    if (is_owner_of_the_cg_handle && this->cgHandle != nullptr) {
+      delete this->cgHandle;
+      this->cgHandle = nullptr;
+    }
+  }
+
 };  // end class KokkosKernelsHandle
 
 }  // namespace Experimental
@@ -0,0 +1,277 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+/// @file KokkosSparse_ChebyshevPrec.hpp
+
+#ifndef KK_CHEBYSHEV_PREC_HPP
+#define KK_CHEBYSHEV_PREC_HPP
+
+#include <stdexcept>
+#include <KokkosSparse_Preconditioner.hpp>
+#include <Kokkos_Core.hpp>
+#include <KokkosBlas.hpp>
+#include <KokkosSparse_spmv.hpp>
+#include <KokkosSparse_getDiagCopy.hpp>
+#include "KokkosSparse_chebyshev_impl.hpp"
+
+namespace KokkosSparse {
+
+namespace Experimental {
+
+/// \class ChebyshevPrec
+/// \brief Chebyshev polynomial smoother, used as a preconditioner.
+///        Applying it runs degree Chebyshev iterations on A Z = X,
+///        from Z = 0, with the diagonal of A as inner preconditioner.
+///        The iteration targets the eigenvalues of D^{-1} A in
+///        [lambdaMax / eigRatio, lambdaMax], where lambdaMax is
+///        estimated by power iteration in compute().
+/// \tparam CRS Type of the matrix A, a KokkosSparse::CrsMatrix
+///
+/// Unlike a triangular solve, every step is an SpMV or a vector
+/// update, so the apply is fully parallel. The polynomial is only a
+/// good preconditioner for matrices with a positive spectrum, e.g.
+/// symmetric positive definite ones.
+///
+/// Preconditioner provides the following methods
+///   - initialize() Finds the diagonal entry of each row of A.
+///   - isInitialized() returns true once initialize() has been called
+///   - compute() Inverts the diagonal and estimates lambdaMax.
+///     Throws std::runtime_error if a diagonal entry is missing or zero.
+///   - isComputed() returns true once compute() has been called
+///
+template <class CRS>
+class ChebyshevPrec : public KokkosSparse::Experimental::Preconditioner<CRS> {
+ public:
+  using ScalarType = typename std::remove_const<typename CRS::value_type>::type;
+  using EXSP       = typename CRS::execution_space;
+  using karith     = typename Kokkos::ArithTraits<ScalarType>;
+  using MagType    = typename karith::mag_type;
+  using OrdinalType =
+      typename std::remove_const<typename CRS::ordinal_type>::type;
+  using VectorType  = Kokkos::View<ScalarType *, EXSP>;
+  using OffsetsType = Kokkos::View<size_t *, typename CRS::device_type>;
+
+ private:
+  CRS A;
+
+  int degree_;
+  MagType eigRatio_;
+  int powerIters_;
+  // Estimate of the largest eigenvalue of D^{-1} A, unless given by the user
+  MagType lambdaMax_  = 0;
+  MagType lambdaMin_  = 0;
+  bool userLambdaMax_ = false;
+
+  OffsetsType diagOffsets;
+  VectorType invDiag;
+  // Workspace of apply(): residual, update and result
+  VectorType R, D, Z;
+
+  bool isInitialized_ = false;
+  bool isComputed_    = false;
+
+ public:
+  //! Factor by which the power iteration estimate of lambdaMax is raised,
+  //! since it converges from below.
+  static constexpr double boostFactor = 1.1;
+
+  //! Constructor:
+  /// \param degree [in] Number of Chebyshev iterations per apply. The first
+  ///   one starts from Z = 0 and needs no SpMV, so an apply does degree - 1
+  ///   SpMVs.
+  /// \param eigRatio [in] Ratio lambdaMax / lambdaMin of the interval the
+  ///   polynomial damps
+  /// \param powerIters [in] Power iterations used to estimate lambdaMax
+  template <class CRSArg>
+  ChebyshevPrec(const CRSArg &mat, int degree = 3, MagType eigRatio = 30,
+                int powerIters = 10)
+      : A(mat) {
+    setDegree(degree);
+    setEigenvalueRatio(eigRatio);
+    setPowerIterations(powerIters);
+  }
+
+  //! Destructor.
+  virtual ~ChebyshevPrec() {}
+
+  ///// \brief Apply the preconditioner to X, putting the result in Y.
+  /////
+  ///// \param transM [in] "N" for non-transpose. Only supported if
+  /////   hasTransposeApply(), which is not the case in general.
+  ///// \param alpha [in] Input coefficient of M*x
+  ///// \param beta [in] Input coefficient of Y
+  /////
+  ///// If the result of applying this preconditioner to a vector X is
+  ///// \f$M \cdot X\f$, then this method computes \f$Y = \beta Y + \alpha M
+  ///\cdot X\f$.
+  ///// The typical case is \f$\beta = 0\f$ and \f$\alpha = 1\f$.
+  //
+  virtual void apply(const Kokkos::View<const ScalarType *, EXSP> &X,
+                     const Kokkos::View<ScalarType *, EXSP> &Y,
+                     const char transM[] = "N",
+                     ScalarType alpha    = karith::one(),
+                     ScalarType beta     = karith::zero()) const {
+    if (transM[0] != 'N' && transM[0] != 'n')
+      throw std::invalid_argument(
+          "ChebyshevPrec::apply: only the non-transpose apply is supported");
+    if (!isComputed_)
+      throw std::runtime_error(
+          "ChebyshevPrec::apply: compute() must be called first");
+    const ScalarType one = karith::one();
+    const MagType theta  = (lambdaMax_ + lambdaMin_) / 2;
+    const MagType delta  = (lambdaMax_ - lambdaMin_) / 2;
+    const MagType sigma  = theta / delta;
+    MagType rho          = 1 / sigma;
+    // First step from Z = 0: Z = D^{-1} X / theta
+    KokkosBlas::mult(karith::zero(), D, ScalarType(1 / theta), invDiag, X);
+    Kokkos::deep_copy(Z, D);
+    for (int k = 1; k < degree_; k++) {
+      // R = X - A Z
+      Kokkos::deep_copy(R, X);
+      KokkosSparse::spmv("N", -one, A, Z, one, R);
+      MagType rhoNew = 1 / (2 * sigma - rho);
+      // D = rhoNew rho D + 2 rhoNew / delta D^{-1} R
+      KokkosBlas::mult(ScalarType(rhoNew * rho), D,
+                       ScalarType(2 * rhoNew / delta), invDiag, R);
+      KokkosBlas::axpy(one, D, Z);
+      rho = rhoNew;
+    }
+    KokkosBlas::axpby(alpha, Z, beta, Y);
+  }
+  //@}
+
+  //! Set this preconditioner's parameters.
+  void setParameters() {}
+
+  //! Set the degree of the polynomial, at least 1.
+  void setDegree(int degree) {
+    if (degree < 1)
+      throw std::invalid_argument("ChebyshevPrec: degree must be at least 1");
+    degree_ = degree;
+  }
+
+  //! Set lambdaMax / lambdaMin, greater than 1.
+  void setEigenvalueRatio(MagType eigRatio) {
+    if (!(eigRatio > 1))
+      throw std::invalid_argument(
+          "ChebyshevPrec: the eigenvalue ratio must be greater than 1");
+    eigRatio_ = eigRatio;
+    if (isComputed_) lambdaMin_ = lambdaMax_ / eigRatio_;
+  }
+
+  //! Set the number of power iterations used to estimate lambdaMax.
+  void setPowerIterations(int powerIters) {
+    if (powerIters < 1)
+      throw std::invalid_argument(
+          "ChebyshevPrec: at least one power iteration is needed");
+    powerIters_ = powerIters;
+  }
+
+  //! Use lambdaMax as the largest eigenvalue of D^{-1} A, as is, instead
+  //! of estimating it in compute().
+  void setLambdaMax(MagType lambdaMax) {
+    if (!(lambdaMax > 0))
+      throw std::invalid_argument("ChebyshevPrec: lambdaMax must be positive");
+    lambdaMax_     = lambdaMax;
+    lambdaMin_     = lambdaMax / eigRatio_;
+    userLambdaMax_ = true;
+  }
+
+  //! Largest and smallest eigenvalues targeted by the polynomial.
+  MagType getLambdaMax() const { return lambdaMax_; }
+  MagType getLambdaMin() const { return lambdaMin_; }
+
+  void initialize() {
+    OrdinalType n = A.numRows();
+    diagOffsets   = OffsetsType(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "diagOffsets"), n);
+    Kokkos::parallel_for(
+        "KokkosSparse::ChebyshevPrec::DiagOffsets",
+        Kokkos::RangePolicy<EXSP>(0, n),
+        KokkosSparse::Impl::ChebyshevDiagOffsets<CRS, OffsetsType>{
+            A, diagOffsets});
+    R = VectorType(Kokkos::view_alloc(Kokkos::WithoutInitializing, "R"), n);
+    D = VectorType(Kokkos::view_alloc(Kokkos::WithoutInitializing, "D"), n);
+    Z = VectorType(Kokkos::view_alloc(Kokkos::WithoutInitializing, "Z"), n);
+    invDiag =
+        VectorType(Kokkos::view_alloc(Kokkos::WithoutInitializing, "invDiag"),
+                   n);
+    isInitialized_ = true;
+    isComputed_    = false;
+  }
+
+  //! True if the preconditioner has been successfully initialized, else false.
+  bool isInitialized() const { return isInitialized_; }
+
+  void compute() {
+    if (!isInitialized_) initialize();
+    OrdinalType n = A.numRows();
+    // A missing diagonal entry is copied as a zero
+    KokkosSparse::getDiagCopy(invDiag, diagOffsets, A);
+    OrdinalType zeros = 0;
+    Kokkos::parallel_reduce(
+        "KokkosSparse::ChebyshevPrec::InvertDiag",
+        Kokkos::RangePolicy<EXSP>(0, n),
+        KokkosSparse::Impl::ChebyshevInvertDiag<VectorType, OrdinalType>{
+            invDiag},
+        zeros);
+    if (zeros)
+      throw std::runtime_error(
+          "ChebyshevPrec::compute: A has a missing or zero diagonal entry");
+    if (!userLambdaMax_) {
+      lambdaMax_ = boostFactor * powerMethod();
+      lambdaMin_ = lambdaMax_ / eigRatio_;
+    }
+    isComputed_ = true;
+  }
+
+  //! True if the preconditioner has been successfully computed, else false.
+  bool isComputed() const { return isComputed_; }
+
+  //! True if the preconditioner implements a transpose operator apply.
+  bool hasTransposeApply() const { return false; }
+
+ private:
+  // Rayleigh quotient estimate of the largest eigenvalue of D^{-1} A, by
+  // power iteration (uses R and D as workspace)
+  MagType powerMethod() {
+    OrdinalType n = A.numRows();
+    if (n == 0) return karith::one();
+    Kokkos::parallel_for(
+        "KokkosSparse::ChebyshevPrec::StartVector",
+        Kokkos::RangePolicy<EXSP>(0, n),
+        KokkosSparse::Impl::ChebyshevStartVector<VectorType, OrdinalType>{R});
+    KokkosBlas::scal(R, ScalarType(1 / KokkosBlas::nrm2(R)), R);
+    MagType lambda = 0;
+    for (int iter = 0; iter < powerIters_; iter++) {
+      // D = D^{-1} A R
+      KokkosSparse::spmv("N", karith::one(), A, R, karith::zero(), D);
+      KokkosBlas::mult(karith::zero(), D, karith::one(), invDiag, D);
+      // R has unit norm
+      lambda       = karith::real(KokkosBlas::dot(R, D));
+      MagType norm = KokkosBlas::nrm2(D);
+      if (norm == 0) break;
+      KokkosBlas::scal(R, ScalarType(1 / norm), D);
+    }
+    if (!(lambda > 0))
+      throw std::runtime_error(
+          "ChebyshevPrec::compute: the estimate of lambdaMax is not positive");
+    return lambda;
+  }
+};
+}  // namespace Experimental
+}  // End namespace KokkosSparse
+
+#endif
@@ -16,6 +16,10 @@
 #ifndef _KOKKOSSPARSE_IOUTILS_HPP
 #define _KOKKOSSPARSE_IOUTILS_HPP
 
+#include <cstring>
+#include <limits>
+#include <memory>
+
 #include "KokkosKernels_IOUtils.hpp"
 #include "KokkosSparse_CrsMatrix.hpp"
 
@@ -636,6 +640,112 @@ inline Kokkos::complex<double> symmetryFlip(Kokkos::complex<double> val,
     return -val;
   return val;
 }
+
+// Attributes of a MatrixMarket file, from its first line
+struct MtxHeader {
+  MtxObject object;
+  MtxFormat format;
+  MtxField field;
+  MtxSym sym;
+};
+
+// Parse and validate the first line of a MatrixMarket file for reading it
+// into a matrix of scalar_t
+template <typename scalar_t>
+MtxHeader parseMtxHeader(const std::string &fline) {
+  // make sure every required field is in the file, by initializing them to
+  // UNDEFINED_*
+  MtxObject mtx_object = UNDEFINED_OBJECT;
+  MtxFormat mtx_format = UNDEFINED_FORMAT;
+  MtxField mtx_field   = UNDEFINED_FIELD;
+  MtxSym mtx_sym       = UNDEFINED_SYMMETRY;
+
+  if (fline.find("matrix") != std::string::npos) {
+    mtx_object = MATRIX;
+  } else if (fline.find("vector") != std::string::npos) {
+    mtx_object = VECTOR;
+    throw std::runtime_error(
+        "MatrixMarket \"vector\" is not supported by KokkosKernels read_mtx()");
+  }
+
+  if (fline.find("coordinate") != std::string::npos) {
+    // sparse
+    mtx_format = COORDINATE;
+  } else if (fline.find("array") != std::string::npos) {
+    // dense
+    mtx_format = ARRAY;
+  }
+
+  if (fline.find("real") != std::string::npos ||
+      fline.find("double") != std::string::npos) {
+    if (std::is_same<scalar_t, Kokkos::Experimental::half_t>::value ||
+        std::is_same<scalar_t, Kokkos::Experimental::bhalf_t>::value)
+      mtx_field = REAL;
+    else {
+      if (!std::is_floating_point<scalar_t>::value)
+        throw std::runtime_error(
+            "scalar_t in read_mtx() incompatible with float or double typed "
+            "MatrixMarket file.");
+      else
+        mtx_field = REAL;
+    }
+  } else if (fline.find("complex") != std::string::npos) {
+    if (!(std::is_same<scalar_t, Kokkos::complex<float>>::value ||
+          std::is_same<scalar_t, Kokkos::complex<double>>::value))
+      throw std::runtime_error(
+          "scalar_t in read_mtx() incompatible with complex-typed MatrixMarket "
+          "file.");
+    else
+      mtx_field = COMPLEX;
+  } else if (fline.find("integer") != std::string::npos) {
+    if (std::is_integral<scalar_t>::value ||
+        std::is_floating_point<scalar_t>::value ||
+        std::is_same<scalar_t, Kokkos::Experimental::half_t>::value ||
+        std::is_same<scalar_t, Kokkos::Experimental::bhalf_t>::value)
+      mtx_field = INTEGER;
+    else
+      throw std::runtime_error(
+          "scalar_t in read_mtx() incompatible with integer-typed MatrixMarket "
+          "file.");
+  } else if (fline.find("pattern") != std::string::npos) {
+    mtx_field = PATTERN;
+    // any reasonable choice for scalar_t can represent "1" or "1.0 + 0i", so
+    // nothing to check here
+  }
+
+  if (fline.find("general") != std::string::npos) {
+    mtx_sym = GENERAL;
+  } else if (fline.find("skew-symmetric") != std::string::npos) {
+    mtx_sym = SKEW_SYMMETRIC;
+  } else if (fline.find("symmetric") != std::string::npos) {
+    // checking for "symmetric" after "skew-symmetric" because it's a substring
+    mtx_sym = SYMMETRIC;
+  } else if (fline.find("hermitian") != std::string::npos ||
+             fline.find("Hermitian") != std::string::npos) {
+    mtx_sym = HERMITIAN;
+  }
+  // Validate the matrix attributes
+  if (mtx_format == ARRAY) {
+    if (mtx_sym == UNDEFINED_SYMMETRY) mtx_sym = GENERAL;
+    if (mtx_sym != GENERAL)
+      throw std::runtime_error(
+          "array format MatrixMarket file must have general symmetry (optional "
+          "to include \"general\")");
+  }
+  if (mtx_object == UNDEFINED_OBJECT)
+    throw std::runtime_error(
+        "MatrixMarket file header is missing the object type.");
+  if (mtx_format == UNDEFINED_FORMAT)
+    throw std::runtime_error("MatrixMarket file header is missing the format.");
+  if (mtx_field == UNDEFINED_FIELD)
+    throw std::runtime_error(
+        "MatrixMarket file header is missing the field type.");
+  if (mtx_sym == UNDEFINED_SYMMETRY)
+    throw std::runtime_error(
+        "MatrixMarket file header is missing the symmetry type.");
+
+  return MtxHeader{mtx_object, mtx_format, mtx_field, mtx_sym};
+}
 }  // namespace MM
 
 template <typename lno_t, typename size_type, typename scalar_t>
@@ -753,6 +863,256 @@ void read_graph_crs(lno_t *nv, size_type *ne, size_type **xadj, lno_t **adj,
   myFile.close();
 }
 
+/// \brief Header of the binary CRS files written by write_crs_binary.
+///
+/// Version 1 layout: this header, then the row map, the column indices and
+/// the values, each at a 64-byte aligned offset from the start of the file.
+/// Files are only read back on machines with the same byte order and the
+/// same offset, ordinal and scalar types.
+struct CrsBinaryHeader {
+  static constexpr uint32_t currentVersion = 1;
+  static constexpr uint32_t byteOrderMark  = 0x01020304;
+  static constexpr size_t alignment        = 64;
+
+  enum ScalarKind : uint32_t { FLOATING = 1, COMPLEX, SIGNED, UNSIGNED };
+
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint32_t offsetBytes;
+  uint32_t ordinalBytes;
+  uint32_t scalarBytes;
+  uint32_t scalarKind;
+  int64_t numRows;
+  int64_t numCols;
+  int64_t nnz;
+  uint64_t rowmapOffset;
+  uint64_t entriesOffset;
+  uint64_t valuesOffset;
+  uint64_t fileSize;
+
+  static bool magicMatches(const char *m) {
+    return std::memcmp(m, "KKCRSBIN", 8) == 0;
+  }
+
+  template <typename scalar_t>
+  static uint32_t kindOf() {
+    if (Kokkos::ArithTraits<scalar_t>::is_complex) return COMPLEX;
+    if (std::is_integral<scalar_t>::value)
+      return std::is_signed<scalar_t>::value ? SIGNED : UNSIGNED;
+    return FLOATING;
+  }
+
+  static uint64_t align(uint64_t offset) {
+    return (offset + alignment - 1) / alignment * alignment;
+  }
+
+  template <typename lno_t, typename size_type, typename scalar_t>
+  static CrsBinaryHeader make(int64_t nrows, int64_t ncols, int64_t nnz) {
+    CrsBinaryHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, "KKCRSBIN", 8);
+    h.version       = currentVersion;
+    h.byteOrder     = byteOrderMark;
+    h.offsetBytes   = sizeof(size_type);
+    h.ordinalBytes  = sizeof(lno_t);
+    h.scalarBytes   = sizeof(scalar_t);
+    h.scalarKind    = kindOf<scalar_t>();
+    h.numRows       = nrows;
+    h.numCols       = ncols;
+    h.nnz           = nnz;
+    h.rowmapOffset  = align(sizeof(CrsBinaryHeader));
+    h.entriesOffset = align(h.rowmapOffset + (nrows + 1) * sizeof(size_type));
+    h.valuesOffset  = align(h.entriesOffset + nnz * sizeof(lno_t));
+    h.fileSize      = h.valuesOffset + nnz * sizeof(scalar_t);
+    return h;
+  }
+
+  // Empty string if a file with this header can be read as a matrix with
+  // these types, otherwise the reason why it cannot
+  template <typename lno_t, typename size_type, typename scalar_t>
+  std::string incompatibility(size_t actualFileSize) const {
+    if (!magicMatches(magic)) return "not a KokkosKernels binary CRS file";
+    if (version != currentVersion) return "unsupported format version";
+    if (byteOrder != byteOrderMark) return "written with another byte order";
+    if (offsetBytes != sizeof(size_type) || ordinalBytes != sizeof(lno_t) ||
+        scalarBytes != sizeof(scalar_t) || scalarKind != kindOf<scalar_t>())
+      return "written for other offset, ordinal or scalar types";
+    if (fileSize != actualFileSize) return "truncated file";
+    // Every row and nonzero takes at least a byte of the file, which bounds
+    // the counts before the layout is recomputed from them
+    if (numRows < 0 || numCols < 0 || nnz < 0 ||
+        uint64_t(numRows) >= actualFileSize ||
+        uint64_t(nnz) >= actualFileSize ||
+        numRows > int64_t(std::numeric_limits<lno_t>::max()) ||
+        numCols > int64_t(std::numeric_limits<lno_t>::max()))
+      return "invalid dimensions";
+    CrsBinaryHeader expected =
+        make<lno_t, size_type, scalar_t>(numRows, numCols, nnz);
+    if (rowmapOffset != expected.rowmapOffset ||
+        entriesOffset != expected.entriesOffset ||
+        valuesOffset != expected.valuesOffset ||
+        fileSize != expected.fileSize)
+      return "inconsistent layout";
+    return "";
+  }
+};
+
+// Read and check the header of a binary CRS file, throw if the file can not
+// be read as a matrix with these types
+template <typename lno_t, typename size_type, typename scalar_t>
+CrsBinaryHeader read_crs_binary_header(const char *data, size_t size,
+                                       const char *filename) {
+  CrsBinaryHeader header;
+  std::string problem = "file too small";
+  if (size >= sizeof(CrsBinaryHeader)) {
+    std::memcpy(&header, data, sizeof(CrsBinaryHeader));
+    problem = header.incompatibility<lno_t, size_type, scalar_t>(size);
+  }
+  if (!problem.empty())
+    throw std::runtime_error(std::string("Cannot read ") + filename + ": " +
+                             problem);
+  return header;
+}
+
+/// \brief Write a CrsMatrix in the binary format described by
+/// CrsBinaryHeader.
+///
+/// The file is written under a temporary name and then renamed, so readers
+/// never see a partial file.
+template <typename crs_matrix_t>
+void write_crs_binary(const crs_matrix_t &A, const char *filename) {
+  using lno_t     = typename crs_matrix_t::non_const_ordinal_type;
+  using size_type = typename crs_matrix_t::non_const_size_type;
+  using scalar_t  = typename crs_matrix_t::non_const_value_type;
+
+  auto rowmap = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                    A.graph.row_map);
+  auto entries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                     A.graph.entries);
+  auto values =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), A.values);
+  CrsBinaryHeader header = CrsBinaryHeader::make<lno_t, size_type, scalar_t>(
+      A.numRows(), A.numCols(), A.nnz());
+
+  std::string tmpName = std::string(filename) + ".tmp";
+  {
+    std::ofstream os(tmpName, std::ios::out | std::ios::binary);
+    if (!os.is_open())
+      throw std::runtime_error(std::string("Cannot write ") + filename);
+    auto writeAt = [&](uint64_t offset, const void *src, size_t bytes) {
+      static const char zeros[CrsBinaryHeader::alignment] = {};
+      uint64_t pos = uint64_t(os.tellp());
+      os.write(zeros, offset - pos);
+      os.write(static_cast<const char *>(src), bytes);
+    };
+    writeAt(0, &header, sizeof(header));
+    // A default-constructed matrix has an empty row map: write its offset
+    if (rowmap.extent(0) == 0) {
+      const size_type zero = 0;
+      writeAt(header.rowmapOffset, &zero, sizeof(size_type));
+    } else {
+      writeAt(header.rowmapOffset, rowmap.data(),
+              (A.numRows() + 1) * sizeof(size_type));
+    }
+    writeAt(header.entriesOffset, entries.data(), A.nnz() * sizeof(lno_t));
+    writeAt(header.valuesOffset, values.data(), A.nnz() * sizeof(scalar_t));
+    if (!os.good())
+      throw std::runtime_error(std::string("Cannot write ") + filename);
+  }
+  if (std::rename(tmpName.c_str(), filename) != 0) {
+    std::remove(tmpName.c_str());
+    throw std::runtime_error(std::string("Cannot write ") + filename);
+  }
+}
+
+/// \brief Read a CrsMatrix written by write_crs_binary.
+///
+/// The file is memory-mapped and copied straight into the views of the
+/// matrix, with no parsing.
+template <typename crs_matrix_t>
+crs_matrix_t read_crs_binary(const char *filename) {
+  using lno_t     = typename crs_matrix_t::non_const_ordinal_type;
+  using size_type = typename crs_matrix_t::non_const_size_type;
+  using scalar_t  = typename crs_matrix_t::non_const_value_type;
+  using graph_t   = typename crs_matrix_t::StaticCrsGraphType;
+  using rowmap_t  = typename graph_t::row_map_type::non_const_type;
+  using entries_t = typename graph_t::entries_type::non_const_type;
+  using values_t  = typename crs_matrix_t::values_type::non_const_type;
+  using Unmanaged = Kokkos::MemoryTraits<Kokkos::Unmanaged>;
+
+  KokkosKernels::Impl::MappedFile file(filename);
+  CrsBinaryHeader header = read_crs_binary_header<lno_t, size_type, scalar_t>(
+      file.data(), file.size(), filename);
+
+  rowmap_t rowmap(Kokkos::view_alloc(Kokkos::WithoutInitializing, "rowmap"),
+                  header.numRows + 1);
+  entries_t entries(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "entries"), header.nnz);
+  values_t values(Kokkos::view_alloc(Kokkos::WithoutInitializing, "values"),
+                  header.nnz);
+  Kokkos::deep_copy(
+      rowmap, Kokkos::View<size_type *, Kokkos::HostSpace, Unmanaged>(
+                  reinterpret_cast<size_type *>(file.data() +
+                                                header.rowmapOffset),
+                  header.numRows + 1));
+  Kokkos::deep_copy(
+      entries,
+      Kokkos::View<lno_t *, Kokkos::HostSpace, Unmanaged>(
+          reinterpret_cast<lno_t *>(file.data() + header.entriesOffset),
+          header.nnz));
+  Kokkos::deep_copy(
+      values,
+      Kokkos::View<scalar_t *, Kokkos::HostSpace, Unmanaged>(
+          reinterpret_cast<scalar_t *>(file.data() + header.valuesOffset),
+          header.nnz));
+  return crs_matrix_t("CrsMatrix", header.numRows, header.numCols,
+                      header.nnz, values, rowmap, entries);
+}
+
+/// \class MappedCrsMatrix
+/// \brief Host CrsMatrix whose views point directly into a memory-mapped
+/// binary CRS file (see write_crs_binary).
+///
+/// Nothing is read until the matrix is accessed, and pages are shared with
+/// the OS file cache. The mapping is copy-on-write: the values may be
+/// modified, but the file never changes. The matrix views are unmanaged,
+/// so the MappedCrsMatrix must outlive every use of matrix().
+template <typename scalar_t, typename lno_t, typename size_type>
+class MappedCrsMatrix {
+ public:
+  using device_type =
+      Kokkos::Device<Kokkos::DefaultHostExecutionSpace, Kokkos::HostSpace>;
+  using matrix_type =
+      KokkosSparse::CrsMatrix<scalar_t, lno_t, device_type,
+                              Kokkos::MemoryTraits<Kokkos::Unmanaged>,
+                              size_type>;
+
+  explicit MappedCrsMatrix(const std::string &filename)
+      : file(std::make_shared<KokkosKernels::Impl::MappedFile>(filename,
+                                                               true)) {
+    CrsBinaryHeader header = read_crs_binary_header<lno_t, size_type, scalar_t>(
+        file->data(), file->size(), filename.c_str());
+    typename matrix_type::row_map_type::non_const_type rowmap(
+        reinterpret_cast<size_type *>(file->data() + header.rowmapOffset),
+        header.numRows + 1);
+    typename matrix_type::index_type::non_const_type entries(
+        reinterpret_cast<lno_t *>(file->data() + header.entriesOffset),
+        header.nnz);
+    typename matrix_type::values_type::non_const_type values(
+        reinterpret_cast<scalar_t *>(file->data() + header.valuesOffset),
+        header.nnz);
+    A = matrix_type(filename, header.numRows, header.numCols, header.nnz,
+                    values, rowmap, entries);
+  }
+
+  const matrix_type &matrix() const { return A; }
+
+ private:
+  std::shared_ptr<KokkosKernels::Impl::MappedFile> file;
+  matrix_type A;
+};
+
 template <typename crs_matrix_t>
 void write_kokkos_crst_matrix(crs_matrix_t a_crsmat, const char *filename) {
   typedef typename crs_matrix_t::StaticCrsGraphType graph_t;
@@ -784,6 +1144,9 @@ void write_kokkos_crst_matrix(crs_matrix_t a_crsmat, const char *filename) {
         a_crsmat.numRows(), a_crsmat.numCols(), a_crsmat.nnz(), a_rowmap,
         a_entries, a_values, filename);
     return;
+  } else if (KokkosKernels::Impl::endswith(strfilename, ".kkcrs")) {
+    write_crs_binary(a_crsmat, filename);
+    return;
   } else if (a_crsmat.numRows() != a_crsmat.numCols()) {
     throw std::runtime_error(
         "For formats other than MatrixMarket (suffix .mm or .mtx),\n"
@@ -824,96 +1187,10 @@ int read_mtx(const char *fileName, lno_t *nrows, lno_t *ncols, size_type *ne,
     throw std::runtime_error("Invalid MM file. Line-1\n");
   }
 
-  // make sure every required field is in the file, by initializing them to
-  // UNDEFINED_*
-  MtxObject mtx_object = UNDEFINED_OBJECT;
-  MtxFormat mtx_format = UNDEFINED_FORMAT;
-  MtxField mtx_field   = UNDEFINED_FIELD;
-  MtxSym mtx_sym       = UNDEFINED_SYMMETRY;
-
-  if (fline.find("matrix") != std::string::npos) {
-    mtx_object = MATRIX;
-  } else if (fline.find("vector") != std::string::npos) {
-    mtx_object = VECTOR;
-    throw std::runtime_error(
-        "MatrixMarket \"vector\" is not supported by KokkosKernels read_mtx()");
-  }
-
-  if (fline.find("coordinate") != std::string::npos) {
-    // sparse
-    mtx_format = COORDINATE;
-  } else if (fline.find("array") != std::string::npos) {
-    // dense
-    mtx_format = ARRAY;
-  }
-
-  if (fline.find("real") != std::string::npos ||
-      fline.find("double") != std::string::npos) {
-    if (std::is_same<scalar_t, Kokkos::Experimental::half_t>::value ||
-        std::is_same<scalar_t, Kokkos::Experimental::bhalf_t>::value)
-      mtx_field = REAL;
-    else {
-      if (!std::is_floating_point<scalar_t>::value)
-        throw std::runtime_error(
-            "scalar_t in read_mtx() incompatible with float or double typed "
-            "MatrixMarket file.");
-      else
-        mtx_field = REAL;
-    }
-  } else if (fline.find("complex") != std::string::npos) {
-    if (!(std::is_same<scalar_t, Kokkos::complex<float>>::value ||
-          std::is_same<scalar_t, Kokkos::complex<double>>::value))
-      throw std::runtime_error(
-          "scalar_t in read_mtx() incompatible with complex-typed MatrixMarket "
-          "file.");
-    else
-      mtx_field = COMPLEX;
-  } else if (fline.find("integer") != std::string::npos) {
-    if (std::is_integral<scalar_t>::value ||
-        std::is_floating_point<scalar_t>::value ||
-        std::is_same<scalar_t, Kokkos::Experimental::half_t>::value ||
-        std::is_same<scalar_t, Kokkos::Experimental::bhalf_t>::value)
-      mtx_field = INTEGER;
-    else
-      throw std::runtime_error(
-          "scalar_t in read_mtx() incompatible with integer-typed MatrixMarket "
-          "file.");
-  } else if (fline.find("pattern") != std::string::npos) {
-    mtx_field = PATTERN;
-    // any reasonable choice for scalar_t can represent "1" or "1.0 + 0i", so
-    // nothing to check here
-  }
-
-  if (fline.find("general") != std::string::npos) {
-    mtx_sym = GENERAL;
-  } else if (fline.find("skew-symmetric") != std::string::npos) {
-    mtx_sym = SKEW_SYMMETRIC;
-  } else if (fline.find("symmetric") != std::string::npos) {
-    // checking for "symmetric" after "skew-symmetric" because it's a substring
-    mtx_sym = SYMMETRIC;
-  } else if (fline.find("hermitian") != std::string::npos ||
-             fline.find("Hermitian") != std::string::npos) {
-    mtx_sym = HERMITIAN;
-  }
-  // Validate the matrix attributes
-  if (mtx_format == ARRAY) {
-    if (mtx_sym == UNDEFINED_SYMMETRY) mtx_sym = GENERAL;
-    if (mtx_sym != GENERAL)
-      throw std::runtime_error(
-          "array format MatrixMarket file must have general symmetry (optional "
-          "to include \"general\")");
-  }
-  if (mtx_object == UNDEFINED_OBJECT)
-    throw std::runtime_error(
-        "MatrixMarket file header is missing the object type.");
-  if (mtx_format == UNDEFINED_FORMAT)
-    throw std::runtime_error("MatrixMarket file header is missing the format.");
-  if (mtx_field == UNDEFINED_FIELD)
-    throw std::runtime_error(
-        "MatrixMarket file header is missing the field type.");
-  if (mtx_sym == UNDEFINED_SYMMETRY)
-    throw std::runtime_error(
-        "MatrixMarket file header is missing the symmetry type.");
+  MtxHeader header     = parseMtxHeader<scalar_t>(fline);
+  MtxFormat mtx_format = header.format;
+  MtxField mtx_field   = header.field;
+  MtxSym mtx_sym       = header.sym;
 
   while (1) {
     getline(mmf, fline);
@@ -1047,13 +1324,338 @@ int read_mtx(const char *fileName, lno_t *nv, size_type *ne, size_type **xadj,
                                               remove_diagonal, transpose);
 }
 
+namespace MM {
+
+// Tokenizers for read_mtx_parallel. They work on [p, end) without requiring
+// a terminating NUL, advance p past the token and return false if the line
+// (ending at '\n') has no valid token left.
+inline bool skipBlanks(const char *&p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+  return p < end && *p != '\n';
+}
+
+template <typename int_t>
+bool parseInteger(const char *&p, const char *end, int_t &val) {
+  if (!skipBlanks(p, end)) return false;
+  bool negative = false;
+  if (*p == '-' || *p == '+') negative = *p++ == '-';
+  if (p == end || *p < '0' || *p > '9') return false;
+  int64_t v = 0;
+  while (p < end && *p >= '0' && *p <= '9') v = 10 * v + (*p++ - '0');
+  val = static_cast<int_t>(negative ? -v : v);
+  return true;
+}
+
+template <typename real_t>
+bool parseReal(const char *&p, const char *end, real_t &val) {
+  if (!skipBlanks(p, end)) return false;
+  // strtod needs a NUL-terminated string, and the file is not
+  char token[64];
+  size_t len = 0;
+  while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+    if (len == sizeof(token) - 1) return false;
+    token[len++] = *p++;
+  }
+  token[len] = '\0';
+  char *tokenEnd;
+  // Convert straight to the precision of val, like the >> of read_mtx: going
+  // through double would round twice
+  if constexpr (std::is_same<real_t, float>::value)
+    val = std::strtof(token, &tokenEnd);
+  else if constexpr (std::is_same<real_t, long double>::value)
+    val = std::strtold(token, &tokenEnd);
+  else
+    val = static_cast<real_t>(std::strtod(token, &tokenEnd));
+  return len && tokenEnd == token + len;
+}
+
+template <typename scalar_t>
+bool parseValue(const char *&p, const char *end, MtxField field,
+                scalar_t &val) {
+  using KAT = Kokkos::ArithTraits<scalar_t>;
+  if constexpr (KAT::is_complex) {
+    using mag_t = typename KAT::mag_type;
+    mag_t re = 0, im = 0;
+    if (!parseReal(p, end, re)) return false;
+    if (field == COMPLEX && !parseReal(p, end, im)) return false;
+    val = scalar_t(re, im);
+  } else if constexpr (std::is_integral<scalar_t>::value) {
+    if (!parseInteger(p, end, val)) return false;
+  } else {
+    (void)field;
+    if (!parseReal(p, end, val)) return false;
+  }
+  return true;
+}
+
+// Whether the line starting at p holds an entry (is not blank or a comment)
+inline bool isEntryLine(const char *p, const char *end) {
+  return skipBlanks(p, end) && *p != '%';
+}
+
+inline const char *nextLine(const char *p, const char *end) {
+  const void *eol = std::memchr(p, '\n', end - p);
+  return eol ? static_cast<const char *>(eol) + 1 : end;
+}
+
+}  // namespace MM
+
+/// \brief Multi-threaded version of read_mtx.
+///
+/// Same arguments and result as read_mtx, computed with the threads of
+/// Kokkos::DefaultHostExecutionSpace:
+///   - the file is memory-mapped and cut into chunks at line boundaries,
+///     each thread tokenizes its chunks (entries are counted first, so every
+///     chunk knows where its entries go),
+///   - the coordinate list is bucketed by row with a counting sort, then each
+///     row is sorted by column.
+/// Blank lines and comment lines among the entries are skipped.
+template <typename lno_t, typename size_type, typename scalar_t>
+int read_mtx_parallel(const char *fileName, lno_t *nrows, lno_t *ncols,
+                      size_type *ne, size_type **xadj, lno_t **adj,
+                      scalar_t **ew, bool symmetrize = false,
+                      bool remove_diagonal = true, bool transpose = false) {
+  using namespace MM;
+  using host_exec  = Kokkos::DefaultHostExecutionSpace;
+  using range_pol  = Kokkos::RangePolicy<host_exec>;
+  using key_view_t = Kokkos::View<size_t *, Kokkos::HostSpace>;
+  using offsets_t  = Kokkos::View<size_type *, Kokkos::HostSpace>;
+
+  KokkosKernels::Impl::MappedFile file(fileName);
+  const char *fileBegin = file.data();
+  const char *fileEnd   = fileBegin + file.size();
+
+  const char *p = fileBegin;
+  std::string fline(p, nextLine(p, fileEnd));
+  if (fline.size() < 2 || fline[0] != '%' || fline[1] != '%') {
+    throw std::runtime_error("Invalid MM file. Line-1\n");
+  }
+  MtxHeader header     = parseMtxHeader<scalar_t>(fline);
+  MtxFormat mtx_format = header.format;
+  MtxField mtx_field   = header.field;
+  MtxSym mtx_sym       = header.sym;
+
+  p = nextLine(p, fileEnd);
+  while (p < fileEnd && *p == '%') p = nextLine(p, fileEnd);
+  const char *dataBegin = nextLine(p, fileEnd);
+  lno_t nr = 0, nc = 0;
+  size_type nnz = 0;
+  if (!parseInteger(p, dataBegin, nr) || !parseInteger(p, dataBegin, nc) ||
+      (mtx_format == COORDINATE && !parseInteger(p, dataBegin, nnz)))
+    throw std::runtime_error("Invalid MM file. Size line is incomplete\n");
+  if (mtx_format != COORDINATE) nnz = nr * nc;
+  symmetrize = symmetrize || mtx_sym != GENERAL;
+  if (symmetrize && nr != nc) {
+    throw std::runtime_error("A non-square matrix cannot be symmetrized.");
+  }
+  if (mtx_format == ARRAY) {
+    // Array format only supports general symmetry and non-pattern
+    if (symmetrize)
+      throw std::runtime_error(
+          "array format MatrixMarket file cannot be symmetrized.");
+    if (mtx_field == PATTERN)
+      throw std::runtime_error(
+          "array format MatrixMarket file can't have \"pattern\" field type.");
+  }
+
+  // Cut the entries into chunks of whole lines
+  const size_t dataBytes    = fileEnd - dataBegin;
+  const size_t maxChunks    = 8 * size_t(host_exec().concurrency());
+  const size_t minChunkSize = size_t(1) << 16;
+  size_t numChunks          = dataBytes / minChunkSize;
+  if (numChunks > maxChunks) numChunks = maxChunks;
+  if (numChunks == 0) numChunks = 1;
+  std::vector<const char *> chunkBegin(numChunks + 1);
+  chunkBegin[0]         = dataBegin;
+  chunkBegin[numChunks] = fileEnd;
+  for (size_t c = 1; c < numChunks; c++) {
+    const char *q = dataBegin + dataBytes * c / numChunks;
+    if (q[-1] != '\n') q = nextLine(q, fileEnd);
+    chunkBegin[c] = std::max(q, chunkBegin[c - 1]);
+  }
+
+  // Entries in each chunk, then the index of the first entry of each chunk
+  std::vector<size_type> chunkOffset(numChunks + 1, 0);
+  Kokkos::parallel_for(
+      "KokkosSparse::read_mtx_parallel::count", range_pol(0, numChunks),
+      [&](size_t c) {
+        size_type count = 0;
+        for (const char *q = chunkBegin[c]; q < chunkBegin[c + 1];
+             q         = nextLine(q, fileEnd)) {
+          if (isEntryLine(q, fileEnd)) count++;
+        }
+        chunkOffset[c + 1] = count;
+      });
+  for (size_t c = 0; c < numChunks; c++)
+    chunkOffset[c + 1] += chunkOffset[c];
+  if (chunkOffset[numChunks] != nnz) {
+    std::ostringstream os;
+    os << "Invalid MM file. The header announces " << nnz << " entries, the"
+       << " file has " << chunkOffset[numChunks] << "\n";
+    throw std::runtime_error(os.str());
+  }
+
+  // Tokenize: coordinate list in the (possibly transposed) output orientation
+  Kokkos::View<lno_t *, Kokkos::HostSpace> src(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "src"), nnz);
+  Kokkos::View<lno_t *, Kokkos::HostSpace> dst(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "dst"), nnz);
+  Kokkos::View<scalar_t *, Kokkos::HostSpace> val(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "val"), nnz);
+  // First malformed entry of each chunk, nnz if none
+  std::vector<size_type> badEntry(numChunks, nnz);
+  Kokkos::parallel_for(
+      "KokkosSparse::read_mtx_parallel::parse", range_pol(0, numChunks),
+      [&](size_t c) {
+        size_type i = chunkOffset[c];
+        for (const char *q = chunkBegin[c]; q < chunkBegin[c + 1];
+             q         = nextLine(q, fileEnd)) {
+          if (!isEntryLine(q, fileEnd)) continue;
+          const char *t = q;
+          lno_t s, d;
+          scalar_t w = Kokkos::ArithTraits<scalar_t>::one();
+          bool ok    = true;
+          if (mtx_format == ARRAY) {
+            // column major, 1-based like coordinate indices
+            s = i % nr + 1;
+            d = i / nr + 1;
+          } else {
+            ok = parseInteger(t, fileEnd, s) && parseInteger(t, fileEnd, d) &&
+                 s >= 1 && s <= nr && d >= 1 && d <= nc;
+          }
+          if (ok && mtx_field != PATTERN)
+            ok = parseValue(t, fileEnd, mtx_field, w);
+          if (!ok) {
+            badEntry[c] = i;
+            return;
+          }
+          src(i) = transpose ? d - 1 : s - 1;
+          dst(i) = transpose ? s - 1 : d - 1;
+          val(i) = w;
+          i++;
+        }
+      });
+  for (size_t c = 0; c < numChunks; c++) {
+    if (badEntry[c] != nnz) {
+      std::ostringstream os;
+      os << "Invalid MM file. Cannot parse entry " << badEntry[c] + 1 << "\n";
+      throw std::runtime_error(os.str());
+    }
+  }
+  if (transpose) std::swap(nr, nc);
+
+  // Entry e produces up to two edges, identified by the keys 2e (A(s, d))
+  // and 2e + 1 (its symmetric counterpart A(d, s))
+  auto numEdges = [&](size_type e) -> int {
+    if (src(e) == dst(e)) return remove_diagonal ? 0 : 1;
+    return symmetrize ? 2 : 1;
+  };
+  auto keyColumn = [&](size_t key) -> lno_t {
+    return (key & 1) ? src(key >> 1) : dst(key >> 1);
+  };
+
+  // Bucket the edges by row
+  offsets_t rowBegin("rowBegin", nr + 1);
+  Kokkos::parallel_for(
+      "KokkosSparse::read_mtx_parallel::row_counts", range_pol(0, nnz),
+      [&](size_type e) {
+        int n = numEdges(e);
+        if (n > 0) Kokkos::atomic_inc(&rowBegin(src(e)));
+        if (n > 1) Kokkos::atomic_inc(&rowBegin(dst(e)));
+      });
+  size_type numKeys = 0;
+  KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<offsets_t, host_exec>(
+      nr + 1, rowBegin, numKeys);
+  offsets_t rowCursor(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "rowCursor"), nr + 1);
+  Kokkos::deep_copy(rowCursor, rowBegin);
+  key_view_t keys(Kokkos::view_alloc(Kokkos::WithoutInitializing, "keys"),
+                  numKeys);
+  Kokkos::parallel_for(
+      "KokkosSparse::read_mtx_parallel::bucket", range_pol(0, nnz),
+      [&](size_type e) {
+        int n = numEdges(e);
+        if (n > 0) {
+          size_type k = Kokkos::atomic_fetch_add(&rowCursor(src(e)),
+                                                 size_type(1));
+          keys(k)     = 2 * size_t(e);
+        }
+        if (n > 1) {
+          size_type k = Kokkos::atomic_fetch_add(&rowCursor(dst(e)),
+                                                 size_type(1));
+          keys(k)     = 2 * size_t(e) + 1;
+        }
+      });
+
+  // Sort each row by column (ties by position in the file, so the result
+  // does not depend on the thread schedule). Like read_mtx, a symmetrized
+  // matrix keeps only the first entry of each column.
+  offsets_t rowmap("rowmap", nr + 1);
+  Kokkos::parallel_for(
+      "KokkosSparse::read_mtx_parallel::sort_rows", range_pol(0, nr),
+      [&](lno_t row) {
+        size_t *first = keys.data() + rowBegin(row);
+        size_t *last  = keys.data() + rowBegin(row + 1);
+        std::sort(first, last, [&](size_t a, size_t b) {
+          lno_t ca = keyColumn(a), cb = keyColumn(b);
+          return ca < cb || (ca == cb && a < b);
+        });
+        size_type count = last - first;
+        if (symmetrize) {
+          count = 0;
+          for (size_t *k = first; k < last; k++)
+            if (k == first || keyColumn(k[-1]) != keyColumn(*k)) count++;
+        }
+        rowmap(row) = count;
+      });
+  size_type nE = 0;
+  KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<offsets_t, host_exec>(
+      nr + 1, rowmap, nE);
+
+  *nrows = nr;
+  *ncols = nc;
+  *ne    = nE;
+  KokkosKernels::Impl::md_malloc<size_type>(xadj, nr + 1);
+  KokkosKernels::Impl::md_malloc<lno_t>(adj, nE);
+  KokkosKernels::Impl::md_malloc<scalar_t>(ew, nE);
+  size_type *xadjOut = *xadj;
+  lno_t *adjOut      = *adj;
+  scalar_t *ewOut    = *ew;
+  Kokkos::parallel_for(
+      "KokkosSparse::read_mtx_parallel::fill", range_pol(0, nr + 1),
+      [&](lno_t row) {
+        xadjOut[row] = rowmap(row);
+        if (row == nr) return;
+        size_type pos = rowmap(row);
+        for (size_type k = rowBegin(row); k < rowBegin(row + 1); k++) {
+          size_t key = keys(k);
+          if (symmetrize && k > rowBegin(row) &&
+              keyColumn(keys(k - 1)) == keyColumn(key))
+            continue;
+          scalar_t w  = val(key >> 1);
+          adjOut[pos] = keyColumn(key);
+          ewOut[pos]  = (key & 1) ? symmetryFlip<scalar_t>(w, mtx_sym) : w;
+          pos++;
+        }
+      });
+  return 0;
+}
+
+/// MatrixMarket files are read with read_mtx, or with read_mtx_parallel if
+/// \c parallel is true.
 template <typename lno_t, typename size_type, typename scalar_t>
 void read_matrix(lno_t *nv, size_type *ne, size_type **xadj, lno_t **adj,
-                 scalar_t **ew, const char *filename) {
+                 scalar_t **ew, const char *filename, bool parallel = false) {
   std::string strfilename(filename);
   if (KokkosKernels::Impl::endswith(strfilename, ".mtx") ||
       KokkosKernels::Impl::endswith(strfilename, ".mm")) {
-    read_mtx(filename, nv, ne, xadj, adj, ew, false, false, false);
+    if (parallel) {
+      lno_t ncols;
+      read_mtx_parallel(filename, nv, &ncols, ne, xadj, adj, ew, false, false,
+                        false);
+    } else {
+      read_mtx(filename, nv, ne, xadj, adj, ew, false, false, false);
+    }
   }
 
   else if (KokkosKernels::Impl::endswith(strfilename, ".bin")) {
@@ -1069,8 +1671,10 @@ void read_matrix(lno_t *nv, size_type *ne, size_type **xadj, lno_t **adj,
   }
 }
 
+/// MatrixMarket files are read with read_mtx, or with read_mtx_parallel if
+/// \c parallel is true.
 template <typename crsMat_t>
-crsMat_t read_kokkos_crst_matrix(const char *filename_) {
+crsMat_t read_kokkos_crst_matrix(const char *filename_, bool parallel = false) {
   std::string strfilename(filename_);
   bool isMatrixMarket = KokkosKernels::Impl::endswith(strfilename, ".mtx") ||
                         KokkosKernels::Impl::endswith(strfilename, ".mm");
@@ -1084,14 +1688,22 @@ crsMat_t read_kokkos_crst_matrix(const char *filename_) {
   typedef typename cols_view_t::value_type lno_t;
   typedef typename values_view_t::value_type scalar_t;
 
+  if (KokkosKernels::Impl::endswith(strfilename, ".kkcrs"))
+    return read_crs_binary<crsMat_t>(filename_);
+
   lno_t nr, nc, *adj;
   size_type *xadj, nnzA;
   scalar_t *values;
 
   if (isMatrixMarket) {
     // MatrixMarket file contains the exact number of columns
-    read_mtx<lno_t, size_type, scalar_t>(filename_, &nr, &nc, &nnzA, &xadj,
-                                         &adj, &values, false, false, false);
+    if (parallel)
+      read_mtx_parallel<lno_t, size_type, scalar_t>(filename_, &nr, &nc, &nnzA,
+                                                    &xadj, &adj, &values, false,
+                                                    false, false);
+    else
+      read_mtx<lno_t, size_type, scalar_t>(filename_, &nr, &nc, &nnzA, &xadj,
+                                           &adj, &values, false, false, false);
   } else {
     //.crs and .bin files don't contain #cols, so will compute it later based on
     // the entries
@@ -1133,6 +1745,37 @@ crsMat_t read_kokkos_crst_matrix(const char *filename_) {
   return crsmat;
 }
 
+/// \brief Read a MatrixMarket file through a binary CRS cache.
+///
+/// If \c cacheFile is a valid binary CRS file (see write_crs_binary) at
+/// least as new as \c mtxFile, the matrix is read from it. Otherwise
+/// \c mtxFile is parsed and the cache is (re)written for the next call;
+/// failing to write the cache, e.g. in a read-only directory, is not an
+/// error. \c parallel selects the MatrixMarket reader as for
+/// read_kokkos_crst_matrix.
+template <typename crsMat_t>
+crsMat_t read_kokkos_crst_matrix_cached(const char *mtxFile,
+                                        const char *cacheFile = nullptr,
+                                        bool parallel = false) {
+  std::string cacheName =
+      cacheFile ? std::string(cacheFile) : std::string(mtxFile) + ".kkcrs";
+  int64_t mtxTime   = KokkosKernels::Impl::kk_get_file_mtime(mtxFile);
+  int64_t cacheTime = KokkosKernels::Impl::kk_get_file_mtime(cacheName.c_str());
+  if (cacheTime > 0 && cacheTime >= mtxTime) {
+    try {
+      return read_crs_binary<crsMat_t>(cacheName.c_str());
+    } catch (std::runtime_error &) {
+      // stale or incompatible cache, fall back to parsing the file
+    }
+  }
+  crsMat_t A = read_kokkos_crst_matrix<crsMat_t>(mtxFile, parallel);
+  try {
+    write_crs_binary(A, cacheName.c_str());
+  } catch (std::runtime_error &) {
+  }
+  return A;
+}
+
 template <typename crsGraph_t>
 crsGraph_t read_kokkos_crst_graph(const char *filename_) {
   typedef typename crsGraph_t::row_map_type::non_const_type row_map_view_t;
@@ -0,0 +1,505 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+/// \file KokkosSparse_SellMatrix.hpp
+/// \brief Local sparse matrix interface
+///
+/// This file provides KokkosSparse::Experimental::SellMatrix.  This
+/// implements a local (no MPI) sparse matrix stored in sliced ELLPACK
+/// ("SELL-C-sigma") format.
+
+#ifndef KOKKOS_SPARSE_SELLMATRIX_HPP_
+#define KOKKOS_SPARSE_SELLMATRIX_HPP_
+
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include "Kokkos_Core.hpp"
+#include "Kokkos_ArithTraits.hpp"
+#include "KokkosKernels_Error.hpp"
+#include "KokkosKernels_ExecSpaceUtils.hpp"
+#include "KokkosKernels_SimpleUtils.hpp"
+#include "KokkosKernels_Sorting.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+
+namespace KokkosSparse {
+namespace Experimental {
+
+namespace Impl {
+
+/// \brief Sort the rows of each window of sigma rows by decreasing length.
+///
+/// The sort is stable, so rows of equal length keep their original order.
+template <class RowMapType, class PermType, class KeyType>
+struct SellSortWindows_Functor {
+  typedef typename PermType::non_const_value_type ordinal_type;
+  typedef typename KeyType::non_const_value_type key_type;
+
+  RowMapType row_map;
+  PermType perm;
+  PermType perm_aux;
+  KeyType keys;
+  KeyType keys_aux;
+  const ordinal_type numRows;
+  const ordinal_type sigma;
+
+  SellSortWindows_Functor(const RowMapType& row_map_, const PermType& perm_,
+                          const PermType& perm_aux_, const KeyType& keys_,
+                          const KeyType& keys_aux_,
+                          const ordinal_type numRows_,
+                          const ordinal_type sigma_)
+      : row_map(row_map_),
+        perm(perm_),
+        perm_aux(perm_aux_),
+        keys(keys_),
+        keys_aux(keys_aux_),
+        numRows(numRows_),
+        sigma(sigma_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const ordinal_type window) const {
+    const ordinal_type begin = window * sigma;
+    const ordinal_type end =
+        (numRows - begin < sigma) ? numRows : begin + sigma;
+
+    key_type max_len = 0;
+    for (ordinal_type i = begin; i < end; ++i) {
+      const key_type len = row_map(i + 1) - row_map(i);
+      if (len > max_len) max_len = len;
+    }
+    // Ascending keys give descending lengths
+    for (ordinal_type i = begin; i < end; ++i) {
+      perm(i) = i;
+      keys(i) = max_len - static_cast<key_type>(row_map(i + 1) - row_map(i));
+    }
+    KokkosKernels::SerialRadixSort2<ordinal_type, key_type, ordinal_type>(
+        &keys(begin), &keys_aux(begin), &perm(begin), &perm_aux(begin),
+        end - begin);
+  }
+};
+
+/// \brief chunk_map(k + 1) = C * (longest row of chunk k)
+template <class RowMapType, class PermType, class ChunkMapType>
+struct SellChunkWidth_Functor {
+  typedef typename PermType::non_const_value_type ordinal_type;
+  typedef typename ChunkMapType::non_const_value_type size_type;
+
+  RowMapType row_map;
+  PermType perm;
+  ChunkMapType chunk_map;
+  const ordinal_type numRows;
+  const ordinal_type chunkSize;
+
+  SellChunkWidth_Functor(const RowMapType& row_map_, const PermType& perm_,
+                         const ChunkMapType& chunk_map_,
+                         const ordinal_type numRows_,
+                         const ordinal_type chunkSize_)
+      : row_map(row_map_),
+        perm(perm_),
+        chunk_map(chunk_map_),
+        numRows(numRows_),
+        chunkSize(chunkSize_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const ordinal_type chunk) const {
+    size_type width = 0;
+    for (ordinal_type c = 0; c < chunkSize; ++c) {
+      const ordinal_type p = chunk * chunkSize + c;
+      if (p >= numRows) break;
+      const ordinal_type row = perm(p);
+      const size_type len    = row_map(row + 1) - row_map(row);
+      if (len > width) width = len;
+    }
+    chunk_map(chunk + 1) = width * chunkSize;
+    if (chunk == 0) chunk_map(0) = 0;
+  }
+};
+
+/// \brief Copy the rows of a CRS matrix into the column-major chunks of a
+/// SELL matrix.
+///
+/// Padding entries have a zero value and the column index -1, which the
+/// kernels mask out of the sums.
+template <class CrsMatrixType, class PermType, class ChunkMapType,
+          class EntriesType, class ValuesType>
+struct SellFill_Functor {
+  typedef typename PermType::non_const_value_type ordinal_type;
+  typedef typename ChunkMapType::non_const_value_type size_type;
+  typedef typename ValuesType::non_const_value_type value_type;
+
+  CrsMatrixType A;
+  PermType perm;
+  ChunkMapType chunk_map;
+  EntriesType entries;
+  ValuesType values;
+  const ordinal_type chunkSize;
+
+  SellFill_Functor(const CrsMatrixType& A_, const PermType& perm_,
+                   const ChunkMapType& chunk_map_, const EntriesType& entries_,
+                   const ValuesType& values_, const ordinal_type chunkSize_)
+      : A(A_),
+        perm(perm_),
+        chunk_map(chunk_map_),
+        entries(entries_),
+        values(values_),
+        chunkSize(chunkSize_) {}
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const ordinal_type p) const {
+    const ordinal_type chunk = p / chunkSize;
+    const ordinal_type lane  = p % chunkSize;
+    const size_type base     = chunk_map(chunk);
+    const size_type width    = (chunk_map(chunk + 1) - base) / chunkSize;
+
+    size_type len = 0, row_begin = 0;
+    if (p < A.numRows()) {
+      const ordinal_type row = perm(p);
+      row_begin              = A.graph.row_map(row);
+      len                    = A.graph.row_map(row + 1) - row_begin;
+    }
+    for (size_type j = 0; j < len; ++j) {
+      entries(base + j * chunkSize + lane) = A.graph.entries(row_begin + j);
+      values(base + j * chunkSize + lane)  = A.values(row_begin + j);
+    }
+    for (size_type j = len; j < width; ++j) {
+      entries(base + j * chunkSize + lane) = ordinal_type(-1);
+      values(base + j * chunkSize + lane) =
+          Kokkos::ArithTraits<value_type>::zero();
+    }
+  }
+};
+
+}  // namespace Impl
+
+/// \class SellMatrix
+/// \brief Sliced ELLPACK (SELL-C-sigma) implementation of a sparse matrix.
+///
+/// The rows are cut into chunks of C consecutive rows. Each chunk is padded
+/// to its longest row and stored column by column, so entry j of the C rows
+/// of a chunk are contiguous in memory: the SpMV kernels load C values and
+/// column indices at once and keep C running sums in vector registers (on
+/// GPUs, C threads read coalesced memory). To limit the padding, the rows
+/// inside each window of sigma rows are sorted by decreasing length before
+/// being chunked; \c row_perm maps the stored row positions back to rows of
+/// the original matrix, and the SpMV writes y in the original row order.
+///
+/// \tparam ScalarType The type of entries in the sparse matrix.
+/// \tparam OrdinalType The type of column indices in the sparse matrix.
+/// \tparam Device The Kokkos Device type.
+/// \tparam MemoryTraits Traits describing how Kokkos manages and
+///   accesses data.  The default parameter suffices for most users.
+/// \tparam SizeType The type of the chunk offsets.
+template <class ScalarType, class OrdinalType, class Device,
+          class MemoryTraits = void,
+          class SizeType     = typename Kokkos::ViewTraits<OrdinalType*, Device,
+                                                       void, void>::size_type>
+class SellMatrix {
+  static_assert(
+      std::is_signed<OrdinalType>::value,
+      "SellMatrix requires that OrdinalType is a signed integer type.");
+
+ public:
+  //! Type of the matrix's execution space.
+  typedef typename Device::execution_space execution_space;
+  //! Type of the matrix's memory space.
+  typedef typename Device::memory_space memory_space;
+  //! Canonical device type
+  typedef Kokkos::Device<execution_space, memory_space> device_type;
+  typedef MemoryTraits memory_traits;
+
+  //! Type of each entry of the chunk map.
+  typedef SizeType size_type;
+  //! Type of each value in the matrix.
+  typedef ScalarType value_type;
+  //! Type of each value in the const version of the matrix.
+  typedef typename std::add_const<ScalarType>::type const_value_type;
+  //! Type of each value in the non-const version of the matrix.
+  typedef typename std::remove_const<ScalarType>::type non_const_value_type;
+  //! Type of each (column) index in the matrix.
+  typedef OrdinalType ordinal_type;
+  typedef typename std::add_const<OrdinalType>::type const_ordinal_type;
+  typedef typename std::remove_const<OrdinalType>::type non_const_ordinal_type;
+  typedef typename std::add_const<SizeType>::type const_size_type;
+  typedef typename std::remove_const<SizeType>::type non_const_size_type;
+
+  //! Offset of the first entry of each chunk, plus the total at the end.
+  typedef Kokkos::View<const size_type*, device_type, memory_traits>
+      chunk_map_type;
+  //! Column indices, column-major within each chunk.
+  typedef Kokkos::View<ordinal_type*, device_type, memory_traits> index_type;
+  //! Values, column-major within each chunk.
+  typedef Kokkos::View<value_type*, device_type, memory_traits> values_type;
+  //! Original row of each stored row position.
+  typedef Kokkos::View<ordinal_type*, device_type, memory_traits> perm_type;
+
+  /// \name Storage of the actual sparsity structure and values.
+  //@{
+  chunk_map_type chunk_map;
+  index_type entries;
+  values_type values;
+  perm_type row_perm;
+  //@}
+
+ private:
+  ordinal_type numRows_;
+  ordinal_type numCols_;
+  size_type nnz_;
+  ordinal_type chunkSize_;
+  ordinal_type sigma_;
+
+ public:
+  /// \brief Default chunk size C for this execution space and scalar type.
+  ///
+  /// A warp on NVIDIA GPUs, one 64-byte vector register (AVX-512) of values
+  /// on CPUs.
+  static ordinal_type default_chunk_size() {
+    if (KokkosKernels::Impl::kk_is_gpu_exec_space<execution_space>())
+      return 32;
+    ordinal_type c = 1;
+    while (c < 64 && 2 * c * sizeof(non_const_value_type) <= 64) c *= 2;
+    return c;
+  }
+
+  /// \brief Default sorting window: 32 chunks.
+  static ordinal_type default_sigma(const ordinal_type chunkSize) {
+    return 32 * chunkSize;
+  }
+
+  /// \brief Default constructor; constructs an empty sparse matrix.
+  KOKKOS_INLINE_FUNCTION
+  SellMatrix()
+      : numRows_(0), numCols_(0), nnz_(0), chunkSize_(1), sigma_(1) {}
+
+  //! Copy constructor (shallow copy).
+  template <typename SType, typename OType, class DType, class MTType,
+            typename IType>
+  KOKKOS_INLINE_FUNCTION SellMatrix(
+      const SellMatrix<SType, OType, DType, MTType, IType>& B)
+      : chunk_map(B.chunk_map),
+        entries(B.entries),
+        values(B.values),
+        row_perm(B.row_perm),
+        numRows_(B.numRows()),
+        numCols_(B.numCols()),
+        nnz_(B.nnz()),
+        chunkSize_(B.chunkSize()),
+        sigma_(B.sigma()) {}
+
+  /// \brief Constructor that accepts the chunk map, indices, values and row
+  ///   permutation of a SELL-C-sigma matrix.
+  ///
+  /// The matrix will store and use the arrays directly (by view, not by
+  /// deep copy).
+  ///
+  /// \param label [in] The sparse matrix's label (unused).
+  /// \param nrows [in] The number of rows.
+  /// \param ncols [in] The number of columns.
+  /// \param annz [in] The number of nonzeros, not counting the padding.
+  /// \param chunkSize [in] The chunk size C, a power of two no larger
+  ///   than 64.
+  /// \param sigma [in] The sorting window, 1 or a multiple of C.
+  /// \param chunkmap [in] The chunk offsets, of length ceil(nrows/C)+1.
+  /// \param cols [in] The column indices, -1 for the padding.
+  /// \param vals [in] The values (including the padding).
+  /// \param perm [in] The original row of each stored row position.
+  SellMatrix(const std::string& /* label */, const OrdinalType nrows,
+             const OrdinalType ncols, const size_type annz,
+             const OrdinalType chunkSize, const OrdinalType sigma,
+             const chunk_map_type& chunkmap, const index_type& cols,
+             const values_type& vals, const perm_type& perm)
+      : chunk_map(chunkmap),
+        entries(cols),
+        values(vals),
+        row_perm(perm),
+        numRows_(nrows),
+        numCols_(ncols),
+        nnz_(annz),
+        chunkSize_(chunkSize),
+        sigma_(sigma) {
+    check_chunk_parameters(chunkSize_, sigma_);
+    const size_type nchunks = (nrows + chunkSize - 1) / chunkSize;
+    if (static_cast<size_type>(chunk_map.extent(0)) != nchunks + 1 ||
+        static_cast<ordinal_type>(row_perm.extent(0)) != nrows ||
+        entries.extent(0) != values.extent(0)) {
+      std::ostringstream os;
+      os << "KokkosSparse::SellMatrix: inconsistent array lengths: "
+         << "chunk_map " << chunk_map.extent(0) << " (expected "
+         << nchunks + 1 << "), row_perm " << row_perm.extent(0)
+         << " (expected " << nrows << "), entries " << entries.extent(0)
+         << ", values " << values.extent(0);
+      KokkosKernels::Impl::throw_runtime_exception(os.str());
+    }
+  }
+
+  /// \brief Convert a CrsMatrix to SELL-C-sigma.
+  ///
+  /// \param crs_mtx [in] The matrix to convert.
+  /// \param chunkSize [in] The chunk size C, a power of two no larger than
+  ///   64, or -1 for default_chunk_size().
+  /// \param sigma [in] The sorting window, 1 (no sorting) or a multiple of
+  ///   C, or -1 for default_sigma(C).
+  template <typename SType, typename OType, class DType, class MTType,
+            typename IType>
+  SellMatrix(
+      const KokkosSparse::CrsMatrix<SType, OType, DType, MTType, IType>&
+          crs_mtx,
+      const OrdinalType chunkSize = -1, const OrdinalType sigma = -1)
+      : numRows_(crs_mtx.numRows()),
+        numCols_(crs_mtx.numCols()),
+        nnz_(crs_mtx.nnz()),
+        chunkSize_(chunkSize < 0 ? default_chunk_size() : chunkSize),
+        sigma_(sigma < 0 ? default_sigma(chunkSize_) : sigma) {
+    typedef
+        typename KokkosSparse::CrsMatrix<SType, OType, DType, MTType, IType>
+            crs_matrix_type;
+    typedef typename crs_matrix_type::row_map_type crs_row_map_type;
+    typedef typename chunk_map_type::non_const_type non_const_chunk_map_type;
+    typedef Kokkos::View<typename std::make_unsigned<ordinal_type>::type*,
+                         device_type>
+        key_view_type;
+    typedef Kokkos::RangePolicy<execution_space> range_policy;
+
+    check_chunk_parameters(chunkSize_, sigma_);
+
+    const ordinal_type nchunks = numChunks();
+    perm_type perm(Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                                      "SellMatrix::row_perm"),
+                   numRows_);
+    if (sigma_ > 1 && numRows_ > 0) {
+      perm_type perm_aux(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, "perm_aux"),
+          numRows_);
+      key_view_type keys(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, "keys"), numRows_);
+      key_view_type keys_aux(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, "keys_aux"),
+          numRows_);
+      Kokkos::parallel_for(
+          "KokkosSparse::SellMatrix::sort_windows",
+          range_policy(0, (numRows_ + sigma_ - 1) / sigma_),
+          Impl::SellSortWindows_Functor<crs_row_map_type, perm_type,
+                                        key_view_type>(
+              crs_mtx.graph.row_map, perm, perm_aux, keys, keys_aux, numRows_,
+              sigma_));
+    } else {
+      KokkosKernels::Impl::sequential_fill(perm);
+    }
+
+    non_const_chunk_map_type chunkmap(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                           "SellMatrix::chunk_map"),
+        nchunks + 1);
+    size_type nstored = 0;
+    if (nchunks > 0) {
+      Kokkos::parallel_for(
+          "KokkosSparse::SellMatrix::chunk_widths", range_policy(0, nchunks),
+          Impl::SellChunkWidth_Functor<crs_row_map_type, perm_type,
+                                       non_const_chunk_map_type>(
+              crs_mtx.graph.row_map, perm, chunkmap, numRows_, chunkSize_));
+      KokkosKernels::Impl::kk_inclusive_parallel_prefix_sum<
+          non_const_chunk_map_type, execution_space>(nchunks + 1, chunkmap);
+      Kokkos::deep_copy(nstored, Kokkos::subview(chunkmap, nchunks));
+    } else {
+      Kokkos::deep_copy(chunkmap, 0);
+    }
+
+    index_type cols(Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                                       "SellMatrix::entries"),
+                    nstored);
+    values_type vals(Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                                        "SellMatrix::values"),
+                     nstored);
+    if (nchunks > 0) {
+      Kokkos::parallel_for(
+          "KokkosSparse::SellMatrix::fill",
+          range_policy(0, static_cast<ordinal_type>(nchunks * chunkSize_)),
+          Impl::SellFill_Functor<crs_matrix_type, perm_type,
+                                 non_const_chunk_map_type, index_type,
+                                 values_type>(crs_mtx, perm, chunkmap, cols,
+                                              vals, chunkSize_));
+    }
+
+    chunk_map = chunkmap;
+    entries   = cols;
+    values    = vals;
+    row_perm  = perm;
+  }
+
+  //! The number of rows in the sparse matrix.
+  KOKKOS_INLINE_FUNCTION ordinal_type numRows() const { return numRows_; }
+
+  //! The number of columns in the sparse matrix.
+  KOKKOS_INLINE_FUNCTION ordinal_type numCols() const { return numCols_; }
+
+  //! The number of "point" (non-block) rows in the matrix.
+  KOKKOS_INLINE_FUNCTION ordinal_type numPointRows() const { return numRows(); }
+
+  //! The number of "point" (non-block) columns in the matrix.
+  KOKKOS_INLINE_FUNCTION ordinal_type numPointCols() const { return numCols(); }
+
+  //! The number of nonzeros in the sparse matrix, not counting the padding.
+  KOKKOS_INLINE_FUNCTION size_type nnz() const { return nnz_; }
+
+  //! The number of stored entries, including the padding.
+  KOKKOS_INLINE_FUNCTION size_type numStoredEntries() const {
+    return values.extent(0);
+  }
+
+  //! The chunk size C.
+  KOKKOS_INLINE_FUNCTION ordinal_type chunkSize() const { return chunkSize_; }
+
+  //! The sorting window sigma.
+  KOKKOS_INLINE_FUNCTION ordinal_type sigma() const { return sigma_; }
+
+  //! The number of chunks, ceil(numRows / C).
+  KOKKOS_INLINE_FUNCTION ordinal_type numChunks() const {
+    return (numRows_ + chunkSize_ - 1) / chunkSize_;
+  }
+
+ private:
+  static void check_chunk_parameters(const ordinal_type chunkSize,
+                                     const ordinal_type sigma) {
+    if (chunkSize < 1 || chunkSize > 64 || (chunkSize & (chunkSize - 1))) {
+      std::ostringstream os;
+      os << "KokkosSparse::SellMatrix: chunk size must be a power of two "
+            "between 1 and 64, got "
+         << chunkSize;
+      KokkosKernels::Impl::throw_runtime_exception(os.str());
+    }
+    if (sigma < 1 || (sigma > 1 && sigma % chunkSize)) {
+      std::ostringstream os;
+      os << "KokkosSparse::SellMatrix: sigma must be 1 or a multiple of the "
+            "chunk size "
+         << chunkSize << ", got " << sigma;
+      KokkosKernels::Impl::throw_runtime_exception(os.str());
+    }
+  }
+};
+
+/// \class is_sell_matrix
+/// \brief is_sell_matrix<T>::value is true if T is a SellMatrix<...>, false
+/// otherwise
+template <typename>
+struct is_sell_matrix : public std::false_type {};
+template <typename... P>
+struct is_sell_matrix<SellMatrix<P...>> : public std::true_type {};
+template <typename... P>
+struct is_sell_matrix<const SellMatrix<P...>> : public std::true_type {};
+
+}  // namespace Experimental
+}  // namespace KokkosSparse
+#endif
@@ -15,6 +15,7 @@
 //@HEADER
 #ifndef _KOKKOSKERNELS_SPARSEUTILS_HPP
 #define _KOKKOSKERNELS_SPARSEUTILS_HPP
+#include <algorithm>
 #include <vector>
 
 #include "Kokkos_Core.hpp"
@@ -367,6 +368,165 @@ struct TransposeMatrix {
   }
 };
 
+// Atomic-free transpose for host execution spaces. The rows of the input are
+// cut into blocks of about the same number of entries, and each block counts
+// its columns in its own histogram. A scan down each column over the blocks
+// gives every block its own range of each output row, so the blocks fill
+// without atomics, and the output rows come out sorted since the blocks (and
+// the rows within a block) are taken in order. t_perm, when not empty, gets
+// the input entry of each output entry.
+template <typename in_row_view_t, typename in_nnz_view_t,
+          typename in_scalar_view_t, typename out_row_view_t,
+          typename out_nnz_view_t, typename out_scalar_view_t,
+          typename perm_view_t, typename MyExecSpace>
+struct TransposeHistogram {
+  struct BlockTag {};
+  struct CountTag {};
+  struct ScanTag {};
+  struct FillTag {};
+
+  using nnz_lno_t  = typename in_nnz_view_t::non_const_value_type;
+  using size_type  = typename in_row_view_t::non_const_value_type;
+  using out_size_t = typename out_row_view_t::non_const_value_type;
+  using hist_view_t =
+      Kokkos::View<out_size_t **, Kokkos::LayoutRight, MyExecSpace>;
+  using block_view_t = Kokkos::View<nnz_lno_t *, MyExecSpace>;
+
+  nnz_lno_t num_rows;
+  nnz_lno_t num_cols;
+  nnz_lno_t num_blocks;
+  in_row_view_t xadj;
+  in_nnz_view_t adj;
+  in_scalar_view_t vals;
+  out_row_view_t t_xadj;
+  out_nnz_view_t t_adj;
+  out_scalar_view_t t_vals;
+  perm_view_t t_perm;
+  bool transpose_values;
+  block_view_t block_rows;
+  hist_view_t hist;
+
+  // First row of each block, splitting the entries evenly
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const BlockTag &, const nnz_lno_t b) const {
+    const size_type target =
+        xadj(0) + ((xadj(num_rows) - xadj(0)) * size_type(b)) / num_blocks;
+    nnz_lno_t lo = 0, hi = num_rows;
+    while (lo < hi) {
+      const nnz_lno_t mid = lo + (hi - lo) / 2;
+      if (xadj(mid) < target)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    block_rows(b) = (b == num_blocks) ? num_rows : lo;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const CountTag &, const nnz_lno_t b) const {
+    for (nnz_lno_t row = block_rows(b); row < block_rows(b + 1); ++row) {
+      for (size_type k = xadj(row); k < xadj(row + 1); ++k) {
+        hist(b, adj(k))++;
+      }
+    }
+  }
+
+  // Start of each block within column c, and the length of output row c
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const ScanTag &, const nnz_lno_t c) const {
+    out_size_t sum = 0;
+    for (nnz_lno_t b = 0; b < num_blocks; ++b) {
+      const out_size_t count = hist(b, c);
+      hist(b, c)             = sum;
+      sum += count;
+    }
+    t_xadj(c) = sum;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const FillTag &, const nnz_lno_t b) const {
+    for (nnz_lno_t row = block_rows(b); row < block_rows(b + 1); ++row) {
+      for (size_type k = xadj(row); k < xadj(row + 1); ++k) {
+        const nnz_lno_t col  = adj(k);
+        const out_size_t pos = t_xadj(col) + hist(b, col)++;
+        t_adj(pos)           = row;
+        if (transpose_values) t_vals(pos) = vals(k);
+        if (t_perm.extent(0)) t_perm(pos) = k;
+      }
+    }
+  }
+};
+
+template <typename in_row_view_t, typename in_nnz_view_t,
+          typename in_scalar_view_t, typename out_row_view_t,
+          typename out_nnz_view_t, typename out_scalar_view_t,
+          typename perm_view_t, typename MyExecSpace>
+void transpose_histogram(
+    typename in_nnz_view_t::non_const_value_type num_rows,
+    typename in_nnz_view_t::non_const_value_type num_cols, in_row_view_t xadj,
+    in_nnz_view_t adj, in_scalar_view_t vals, out_row_view_t t_xadj,
+    out_nnz_view_t t_adj, out_scalar_view_t t_vals, perm_view_t t_perm,
+    bool transpose_values) {
+  using functor_t =
+      TransposeHistogram<in_row_view_t, in_nnz_view_t, in_scalar_view_t,
+                         out_row_view_t, out_nnz_view_t, out_scalar_view_t,
+                         perm_view_t, MyExecSpace>;
+  using nnz_lno_t = typename functor_t::nnz_lno_t;
+  const size_t nnz = adj.extent(0);
+
+  // One histogram per thread at most, and no more histogram entries than a
+  // few times the entries of the matrix
+  size_t num_blocks = MyExecSpace().concurrency();
+  if (num_cols) num_blocks = std::min(num_blocks, 4 * nnz / num_cols);
+  num_blocks = std::max<size_t>(1, std::min<size_t>(num_blocks, num_rows));
+
+  functor_t tm{num_rows,
+               num_cols,
+               nnz_lno_t(num_blocks),
+               xadj,
+               adj,
+               vals,
+               t_xadj,
+               t_adj,
+               t_vals,
+               t_perm,
+               transpose_values,
+               typename functor_t::block_view_t(
+                   Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                                      "transpose block rows"),
+                   num_blocks + 1),
+               typename functor_t::hist_view_t("transpose histograms",
+                                               num_blocks, num_cols)};
+  if (num_rows) {
+    Kokkos::parallel_for(
+        "KokkosSparse::Impl::transpose_histogram::Blocks",
+        Kokkos::RangePolicy<MyExecSpace, typename functor_t::BlockTag>(
+            0, num_blocks + 1),
+        tm);
+    Kokkos::parallel_for(
+        "KokkosSparse::Impl::transpose_histogram::Count",
+        Kokkos::RangePolicy<MyExecSpace, typename functor_t::CountTag>(
+            0, num_blocks),
+        tm);
+  }
+  Kokkos::parallel_for(
+      "KokkosSparse::Impl::transpose_histogram::Scan",
+      Kokkos::RangePolicy<MyExecSpace, typename functor_t::ScanTag>(0,
+                                                                    num_cols),
+      tm);
+  KokkosKernels::Impl::kk_exclusive_parallel_prefix_sum<out_row_view_t,
+                                                        MyExecSpace>(
+      num_cols + 1, t_xadj);
+  if (num_rows) {
+    Kokkos::parallel_for(
+        "KokkosSparse::Impl::transpose_histogram::Fill",
+        Kokkos::RangePolicy<MyExecSpace, typename functor_t::FillTag>(
+            0, num_blocks),
+        tm);
+  }
+  MyExecSpace().fence();
+}
+
 template <typename in_row_view_t, typename in_nnz_view_t,
           typename in_scalar_view_t, typename out_row_view_t,
           typename out_nnz_view_t, typename out_scalar_view_t,
@@ -379,6 +539,16 @@ void transpose_matrix(
     out_nnz_view_t t_adj,     // pre-allocated -- no need for initialize
     out_scalar_view_t t_vals  // pre-allocated -- no need for initialize
 ) {
+  // on hosts, the atomic-free version, which also sorts the output rows
+  if (!KokkosKernels::Impl::kk_is_gpu_exec_space<MyExecSpace>()) {
+    transpose_histogram<in_row_view_t, in_nnz_view_t, in_scalar_view_t,
+                        out_row_view_t, out_nnz_view_t, out_scalar_view_t,
+                        out_row_view_t, MyExecSpace>(
+        num_rows, num_cols, xadj, adj, vals, t_xadj, t_adj, t_vals,
+        out_row_view_t(), true);
+    return;
+  }
+
   // allocate some memory for work for row pointers
   tempwork_row_view_t tmp_row_view(
       Kokkos::view_alloc(Kokkos::WithoutInitializing, "tmp_row_view"),
@@ -461,6 +631,16 @@ void transpose_graph(
     out_row_view_t t_xadj,  // pre-allocated -- initialized with 0
     out_nnz_view_t t_adj    // pre-allocated -- no need for initialize
 ) {
+  // on hosts, the atomic-free version, which also sorts the output rows
+  if (!KokkosKernels::Impl::kk_is_gpu_exec_space<MyExecSpace>()) {
+    transpose_histogram<in_row_view_t, in_nnz_view_t, in_nnz_view_t,
+                        out_row_view_t, out_nnz_view_t, out_nnz_view_t,
+                        out_row_view_t, MyExecSpace>(
+        num_rows, num_cols, xadj, adj, in_nnz_view_t(), t_xadj, t_adj,
+        out_nnz_view_t(), out_row_view_t(), false);
+    return;
+  }
+
   // allocate some memory for work for row pointers
   tempwork_row_view_t tmp_row_view(
       Kokkos::view_alloc(Kokkos::WithoutInitializing, "tmp_row_view"),
@@ -565,6 +745,29 @@ struct TransposeBsrMatrix {
   }
 };  // TransposeBsrMatrix
 
+// Transposes the blocks of a BSR matrix once the input entry of each output
+// entry is known
+template <typename in_scalar_view_t, typename out_scalar_view_t,
+          typename perm_view_t>
+struct TransposeBsrValues {
+  int block_size;
+  in_scalar_view_t Avalues;
+  out_scalar_view_t tAvalues;
+  perm_view_t perm;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_t tAentryIdx) const {
+    const size_t bs2       = block_size * block_size;
+    const size_t AentryIdx = perm(tAentryIdx);
+    for (int i = 0; i < block_size; ++i) {
+      for (int j = 0; j < block_size; ++j) {
+        tAvalues(tAentryIdx * bs2 + i * block_size + j) =
+            Avalues(AentryIdx * bs2 + j * block_size + i);
+      }
+    }
+  }
+};
+
 template <typename in_row_view_t, typename in_nnz_view_t,
           typename in_scalar_view_t, typename out_row_view_t,
           typename out_nnz_view_t, typename out_scalar_view_t,
@@ -581,6 +784,29 @@ void transpose_bsr_matrix(
       TransposeBsrMatrix<in_row_view_t, in_nnz_view_t, in_scalar_view_t,
                          out_row_view_t, out_nnz_view_t, out_scalar_view_t>;
 
+  // on hosts, the atomic-free graph transpose gives the block of A behind
+  // each block of the transpose, so there is no search in the rows of A
+  if (!KokkosKernels::Impl::kk_is_gpu_exec_space<MyExecSpace>()) {
+    using perm_view_t =
+        Kokkos::View<typename in_row_view_t::non_const_value_type *,
+                     MyExecSpace>;
+    perm_view_t perm(
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "Transpose perm"),
+        adj.extent(0));
+    transpose_histogram<in_row_view_t, in_nnz_view_t, in_nnz_view_t,
+                        out_row_view_t, out_nnz_view_t, out_nnz_view_t,
+                        perm_view_t, MyExecSpace>(
+        num_rows, num_cols, xadj, adj, in_nnz_view_t(), t_xadj, t_adj,
+        out_nnz_view_t(), perm, false);
+    Kokkos::parallel_for(
+        "KokkosSparse::Impl::transpose_bsr_matrix::Values",
+        Kokkos::RangePolicy<MyExecSpace>(0, adj.extent(0)),
+        TransposeBsrValues<in_scalar_view_t, out_scalar_view_t, perm_view_t>{
+            block_size, vals, t_vals, perm});
+    MyExecSpace().fence();
+    return;
+  }
+
   // Step 1: call transpose_graph of bsr matrix
   transpose_graph<in_row_view_t, in_nnz_view_t, out_row_view_t, out_nnz_view_t,
                   out_row_view_t, MyExecSpace>(num_rows, num_cols, xadj, adj,
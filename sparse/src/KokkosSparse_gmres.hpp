@@ -27,6 +27,14 @@
 /// GMRES - A Generalized Minimal Residual Algorithm for Solving Nonsymmetric
 /// Linear Systems - Saad, Schultz
 ///
+/// With GMRESHandle::set_precision(GMRESHandle::Precision::Mixed), double
+/// (and complex double) systems are solved by iterative refinement: the
+/// residual is computed in double and each correction comes from one restart
+/// cycle of GMRES in float on a float copy of A, so the Krylov basis takes
+/// half the memory and bandwidth. The preconditioner keeps the scalar type of
+/// A and is applied to converted vectors. Other scalar types have no lower
+/// precision, and gmres throws std::invalid_argument for them.
+///
 /// For more info, see example/gmres/README.md
 
 #ifndef KOKKOSSPARSE_GMRES_HPP_
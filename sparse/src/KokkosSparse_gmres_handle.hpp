@@ -78,8 +78,20 @@ class GMRESHandle {
    */
   enum Ortho {
     CGS2,  // Two iterations of Classical Gram-Schmidt
-    MGS
-  };  // One iteration of Modified Gram-Schmidt
+    MGS,   // One iteration of Modified Gram-Schmidt
+    SStep  // s-step: blocks of s Krylov vectors from a matrix powers
+           // kernel, orthogonalized with block CGS2 and CholQR2
+  };
+
+  /**
+   * The precision of the Krylov basis
+   */
+  enum Precision {
+    Working,  // Everything in the scalar type of the handle
+    Mixed     // Iterative refinement in the scalar type of the handle, with
+              // inner solves in the next lower precision. gmres throws
+              // std::invalid_argument for types without one (e.g. float)
+  };
 
   /**
    * The result of the run
@@ -98,25 +110,33 @@ class GMRESHandle {
   float_t tol;            /// Relative residual convergence tolerance
   size_type max_restart;  /// Maximum number of times to restart the solver
   Ortho ortho;            /// The orthogonalization type
+  size_type s_step;       /// Krylov vectors per block when ortho is SStep
+  Precision precision;    /// The precision of the Krylov basis
   bool verbose;           /// Print extra info to stdout
 
   // Outputs
-  int num_iters;        /// Number of iterations the sovler took
-  float_t end_rel_res;  /// Residual from solver
-  Flag conv_flag_val;   /// Denotes end result of the run
+  int num_iters;            /// Number of iterations the sovler took
+  float_t end_rel_res;      /// Residual from solver
+  Flag conv_flag_val;       /// Denotes end result of the run
+  int num_sstep_blocks;     /// s-step blocks orthogonalized with CholQR2
+  int num_sstep_fallbacks;  /// s-step blocks that fell back to CGS2
 
  public:
-  // Use set methods to control ortho, and verbose
+  // Use set methods to control ortho, s_step, precision and verbose
   GMRESHandle(const size_type m_ = 50, const float_t tol_ = 1e-8,
               const size_type max_restart_ = 50)
       : m(m_),
         tol(tol_),
         max_restart(max_restart_),
         ortho(CGS2),
+        s_step(4),
+        precision(Working),
         verbose(false),
         num_iters(-1),
         end_rel_res(-1),
-        conv_flag_val(NotRun) {
+        conv_flag_val(NotRun),
+        num_sstep_blocks(0),
+        num_sstep_fallbacks(0) {
     if (m <= 0) {
       throw std::invalid_argument(
           "gmres: Please choose restart size m greater than zero.");
@@ -129,10 +149,14 @@ class GMRESHandle {
     set_tol(tol_);
     set_max_restart(max_restart_);
     set_ortho(CGS2);
+    set_s_step(4);
+    set_precision(Working);
     set_verbose(false);
-    num_iters     = -1;
-    end_rel_res   = -1;
-    conv_flag_val = NotRun;
+    num_iters           = -1;
+    end_rel_res         = -1;
+    conv_flag_val       = NotRun;
+    num_sstep_blocks    = 0;
+    num_sstep_fallbacks = 0;
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -164,6 +188,20 @@ class GMRESHandle {
   KOKKOS_INLINE_FUNCTION
   void set_ortho(const Ortho ortho_) { this->ortho = ortho_; }
 
+  KOKKOS_INLINE_FUNCTION
+  size_type get_s_step() const { return s_step; }
+
+  KOKKOS_INLINE_FUNCTION
+  void set_s_step(const size_type s_step_) { this->s_step = s_step_; }
+
+  KOKKOS_INLINE_FUNCTION
+  Precision get_precision() const { return precision; }
+
+  KOKKOS_INLINE_FUNCTION
+  void set_precision(const Precision precision_) {
+    this->precision = precision_;
+  }
+
   KOKKOS_INLINE_FUNCTION
   bool get_verbose() const { return verbose; }
 
@@ -180,12 +218,30 @@ class GMRESHandle {
   }
   Flag get_conv_flag_val() const { return conv_flag_val; }
 
+  /// Number of blocks of s Krylov vectors the last SStep run built with the
+  /// matrix powers kernel and CholQR2
+  int get_num_sstep_blocks() const {
+    assert(get_conv_flag_val() != NotRun);
+    return num_sstep_blocks;
+  }
+  /// Number of times the last SStep run found a numerically rank deficient
+  /// basis and computed the next column with CGS2 instead
+  int get_num_sstep_fallbacks() const {
+    assert(get_conv_flag_val() != NotRun);
+    return num_sstep_fallbacks;
+  }
+
   void set_stats(int num_iters_, float_t end_rel_res_, Flag conv_flag_val_) {
     assert(conv_flag_val_ != NotRun);
     num_iters     = num_iters_;
     end_rel_res   = end_rel_res_;
     conv_flag_val = conv_flag_val_;
   }
+
+  void set_sstep_stats(int num_sstep_blocks_, int num_sstep_fallbacks_) {
+    num_sstep_blocks    = num_sstep_blocks_;
+    num_sstep_fallbacks = num_sstep_fallbacks_;
+  }
 };
 
 }  // namespace Experimental
@@ -21,6 +21,7 @@
 #include "KokkosKernels_helpers.hpp"
 #include "KokkosSparse_spadd_symbolic_spec.hpp"
 #include "KokkosSparse_spadd_numeric_spec.hpp"
+#include "KokkosSparse_spadd_nary_impl.hpp"
 
 namespace KokkosSparse {
 namespace Experimental {
@@ -225,6 +226,56 @@ void spadd_numeric(KernelHandle* handle, const AScalar alpha, const AMatrix& A,
       C.graph.entries, C.values);
 }
 
+/// \brief Symbolic phase of C = sum_k alpha_k A[k], for any number of inputs
+/// of the same dimensions.
+///
+/// The rows of all inputs are merged in a single pass, instead of a chain of
+/// two-matrix adds with an intermediate matrix for each. The position in C
+/// of every input entry is kept in the SPADDHandle, so that each numeric
+/// phase is a gather, whether the inputs are sorted or not. The stacked rows
+/// are always sorted, so the input-sorted setting of the SPADDHandle is not
+/// used and C always has sorted rows.
+///
+/// \param handle [in/out] The kernel handle, with an SPADDHandle
+/// \param A [in] The inputs
+/// \param C [out] C, allocated with the structure of the sum
+template <typename KernelHandle, typename AMatrix, typename CMatrix>
+void spadd_symbolic(KernelHandle* handle, const std::vector<AMatrix>& A,
+                    CMatrix& C) {
+  using row_map_type = typename CMatrix::row_map_type::non_const_type;
+  using entries_type = typename CMatrix::index_type::non_const_type;
+  using values_type  = typename CMatrix::values_type::non_const_type;
+
+  KokkosSparse::Impl::check_nary_spadd_inputs(A);
+  row_map_type row_mapC(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "row map"),
+      A[0].numRows() + 1);
+  KokkosSparse::Impl::spadd_symbolic_nary_impl(handle, A, row_mapC);
+
+  auto addHandle = handle->get_spadd_handle();
+  entries_type entriesC(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "entries"),
+      addHandle->get_c_nnz());
+  values_type valuesC(Kokkos::view_alloc(Kokkos::WithoutInitializing, "values"),
+                      addHandle->get_c_nnz());
+  C = CMatrix("matrix", A[0].numRows(), A[0].numCols(), addHandle->get_c_nnz(),
+              valuesC, row_mapC, entriesC);
+}
+
+/// \brief Numeric phase of C = sum_k alpha[k] A[k], after the n-ary
+/// spadd_symbolic() with the same handle.
+///
+/// The inputs must have the structure they had in the symbolic phase; their
+/// values and the coefficients may change between numeric calls.
+template <typename KernelHandle, typename AScalar, typename AMatrix,
+          typename CMatrix>
+void spadd_numeric(KernelHandle* handle, const std::vector<AScalar>& alpha,
+                   const std::vector<AMatrix>& A, CMatrix& C) {
+  KokkosSparse::Impl::spadd_numeric_nary_impl(handle, alpha, A,
+                                              C.graph.row_map, C.graph.entries,
+                                              C.values);
+}
+
 }  // namespace KokkosSparse
 
 #undef SAME_TYPE
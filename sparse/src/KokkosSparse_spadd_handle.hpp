@@ -17,6 +17,7 @@
 #include <Kokkos_Core.hpp>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #ifndef _SPADDHANDLE_HPP
 #define _SPADDHANDLE_HPP
@@ -47,6 +48,12 @@ class SPADDHandle {
   nnz_lno_view_t a_pos;
   nnz_lno_view_t b_pos;
 
+  // input_pos is used by the n-ary add: the inputs' entries are numbered one
+  // input after the other, input k starting at input_offsets[k], and each
+  // gets the index in its C row where it is added
+  nnz_lno_view_t input_pos;
+  std::vector<size_type> input_offsets;
+
  public:
   /**
    * \brief sets the result nnz size.
@@ -63,6 +70,16 @@ class SPADDHandle {
 
   nnz_lno_view_t get_b_pos() { return b_pos; }
 
+  void set_input_pos(const nnz_lno_view_t& input_pos_in,
+                     const std::vector<size_type>& input_offsets_in) {
+    input_pos     = input_pos_in;
+    input_offsets = input_offsets_in;
+  }
+
+  nnz_lno_view_t get_input_pos() { return input_pos; }
+
+  const std::vector<size_type>& get_input_offsets() { return input_offsets; }
+
   /**
    * \brief sets the result nnz size.
    * \param result_nnz_size: size of the output matrix.
@@ -0,0 +1,124 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+#ifndef _KOKKOSSPARSE_SPGEMM_CHUNKED_HPP
+#define _KOKKOSSPARSE_SPGEMM_CHUNKED_HPP
+
+#include <stdexcept>
+#include "KokkosKernels_Handle.hpp"
+#include "KokkosSparse_spgemm_chunked_impl.hpp"
+
+namespace KokkosSparse {
+
+/// \brief C = A*B computed in blocks of rows of A, each handed to \c sink
+/// as soon as it is done.
+///
+/// A symbolic phase over all of A first gives the length of each row of C.
+/// The rows are then cut into consecutive blocks whose row map, entries and
+/// values fit in the memory budget of the SPGEMMHandle of \c kh
+/// (SPGEMMHandle::set_memory_budget; 0 means a single block). Each block is
+/// multiplied with its own symbolic and numeric phases, using the algorithm
+/// and accumulator of that handle, and is released once \c sink returns, so
+/// at most one block of C is alive at a time. All phases run on handles of
+/// their own with the settings of \c kh, whose state is left untouched.
+///
+/// \param kh [in] The kernel handle, with an SPGEMMHandle
+/// \param A [in] The left factor
+/// \param B [in] The right factor
+/// \param sink [in] Called as sink(first_row, Cblock) for each block, in
+///   order, where Cblock (a CMatrix) holds the rows [first_row, first_row +
+///   Cblock.numRows()) of C, sorted
+///
+/// Throws std::runtime_error when a single row of C exceeds the budget.
+template <class CMatrix, class KernelHandle, class AMatrix, class BMatrix,
+          class Sink>
+void spgemm_chunked(KernelHandle& kh, const AMatrix& A, const BMatrix& B,
+                    Sink&& sink) {
+  using row_map_type = typename CMatrix::row_map_type::non_const_type;
+  using entries_type = typename CMatrix::index_type::non_const_type;
+  using values_type  = typename CMatrix::values_type::non_const_type;
+
+  if (A.numCols() != B.numRows())
+    throw std::invalid_argument(
+        "KokkosSparse::spgemm_chunked: A and B have incompatible dimensions "
+        "for multiplication");
+  if (!kh.get_spgemm_handle())
+    throw std::runtime_error(
+        "KokkosSparse::spgemm_chunked: the kernel handle has no SPGEMMHandle");
+
+  // Row lengths of C, without its entries
+  auto h_row_mapC = Kokkos::create_mirror_view_and_copy(
+      Kokkos::HostSpace(),
+      Impl::spgemm_chunked_row_map<row_map_type>(kh, A, B));
+
+  Impl::spgemm_chunked_blocks<CMatrix>(
+      kh, A, B, h_row_mapC,
+      [](const size_t, const size_t c_nnz, entries_type& entriesCb,
+         values_type& valuesCb) {
+        entriesCb = entries_type(
+            Kokkos::view_alloc(Kokkos::WithoutInitializing, "C block entries"),
+            c_nnz);
+        valuesCb = values_type(
+            Kokkos::view_alloc(Kokkos::WithoutInitializing, "C block values"),
+            c_nnz);
+      },
+      sink);
+}
+
+/// \brief C = A*B computed in row blocks under the memory budget of the
+/// SPGEMMHandle, directly into one matrix.
+///
+/// C is sized from a symbolic phase over all of A and each block is written
+/// in place, so the budget bounds the workspace of each product, not the
+/// size of C: use the version with a sink to keep C itself out of memory.
+template <class CMatrix, class KernelHandle, class AMatrix, class BMatrix>
+CMatrix spgemm_chunked(KernelHandle& kh, const AMatrix& A, const BMatrix& B) {
+  using row_map_type = typename CMatrix::row_map_type::non_const_type;
+  using entries_type = typename CMatrix::index_type::non_const_type;
+  using values_type  = typename CMatrix::values_type::non_const_type;
+
+  if (A.numCols() != B.numRows())
+    throw std::invalid_argument(
+        "KokkosSparse::spgemm_chunked: A and B have incompatible dimensions "
+        "for multiplication");
+  if (!kh.get_spgemm_handle())
+    throw std::runtime_error(
+        "KokkosSparse::spgemm_chunked: the kernel handle has no SPGEMMHandle");
+
+  row_map_type row_mapC = Impl::spgemm_chunked_row_map<row_map_type>(kh, A, B);
+  auto h_row_mapC =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), row_mapC);
+  const size_t c_nnz = h_row_mapC(A.numRows());
+
+  entries_type entriesC(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "entriesC"), c_nnz);
+  values_type valuesC(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "valuesC"), c_nnz);
+  Impl::spgemm_chunked_blocks<CMatrix>(
+      kh, A, B, h_row_mapC,
+      [&](const size_t c_begin, const size_t block_nnz,
+          entries_type& entriesCb, values_type& valuesCb) {
+        const auto range = Kokkos::make_pair(c_begin, c_begin + block_nnz);
+        entriesCb        = Kokkos::subview(entriesC, range);
+        valuesCb         = Kokkos::subview(valuesC, range);
+      },
+      [](const size_t, const CMatrix&) {});
+  return CMatrix("C=AB", A.numRows(), B.numCols(), c_nnz, valuesC, row_mapC,
+                 entriesC);
+}
+
+}  // namespace KokkosSparse
+
+#endif
@@ -22,6 +22,7 @@
 #include <Kokkos_Core.hpp>
 #include <iostream>
 #include <string>
+#include <vector>
 //#define VERBOSE
 
 #ifdef KOKKOSKERNELS_ENABLE_TPL_ROCSPARSE
@@ -255,6 +256,11 @@ class SPGEMMHandle {
   bool computed_rowflops;
   bool computed_entries;
   bool called_numeric;
+  bool row_binning;
+  bool computed_row_bins;
+  size_t memory_budget;
+  bool numeric_reuse_map;
+  bool computed_reuse_map;
 
   int suggested_vector_size;
   int suggested_team_size;
@@ -337,6 +343,25 @@ class SPGEMMHandle {
   bool mkl_convert_to_1base;
   bool is_compression_single_step;
 
+  // spgemm_triple: what the symbolic phase leaves for the numeric phase
+  bool triple_symbolic_called;
+  bool triple_dense;
+  nnz_lno_t triple_max_ra, triple_max_c, triple_ncolsA, triple_ncolsP;
+  // spgemm_ptap: P^T, and the entry of P behind each entry of P^T
+  row_lno_persistent_work_view_t triple_pt_rowmap, triple_pt_perm;
+  nnz_lno_persistent_work_view_t triple_pt_entries;
+  scalar_persistent_work_view_t triple_pt_values;
+
+  // Row binning of the KK numeric phase: the rows of A grouped by bin of row
+  // flops, with the first row and the largest row flops of each bin
+  nnz_lno_persistent_work_view_t row_bin_rows;
+  std::vector<size_t> row_bin_offsets, row_bin_max_flops;
+
+  // Contribution map of the numeric phase: the first product of each row of
+  // A*B, and for each product the offset of its column in the sorted row
+  row_lno_persistent_work_view_t reuse_map_rowmap;
+  nnz_lno_persistent_work_view_t reuse_map;
+
   void set_mkl_sort_option(int mkl_sort_option_) {
     this->mkl_sort_option = mkl_sort_option_;
   }
@@ -488,6 +513,11 @@ class SPGEMMHandle {
         computed_rowflops(false),
         computed_entries(false),
         called_numeric(false),
+        row_binning(false),
+        computed_row_bins(false),
+        memory_budget(0),
+        numeric_reuse_map(false),
+        computed_reuse_map(false),
         suggested_vector_size(0),
         suggested_team_size(0),
         max_nnz_inresult(0),
@@ -536,7 +566,22 @@ class SPGEMMHandle {
         MaxColDenseAcc(250001),
         mkl_keep_output(true),
         mkl_convert_to_1base(true),
-        is_compression_single_step(false)
+        is_compression_single_step(false),
+        triple_symbolic_called(false),
+        triple_dense(false),
+        triple_max_ra(0),
+        triple_max_c(0),
+        triple_ncolsA(0),
+        triple_ncolsP(0),
+        triple_pt_rowmap(),
+        triple_pt_perm(),
+        triple_pt_entries(),
+        triple_pt_values(),
+        row_bin_rows(),
+        row_bin_offsets(),
+        row_bin_max_flops(),
+        reuse_map_rowmap(),
+        reuse_map()
 #ifdef KOKKOSKERNELS_ENABLE_TPL_ROCSPARSE
         ,
         rocsparse_spgemm_handle(nullptr)
@@ -724,12 +769,48 @@ class SPGEMMHandle {
   void set_algorithm_type(const SPGEMMAlgorithm &sgs_algo) {
     this->algorithm_type = sgs_algo;
   }
-  void set_call_symbolic(bool call = true) { this->called_symbolic = call; }
+  void set_call_symbolic(bool call = true) {
+    this->called_symbolic = call;
+    // A new structure of C invalidates the contribution map
+    if (call) this->computed_reuse_map = false;
+  }
   void set_computed_rowptrs() { this->computed_rowptrs = true; }
   void set_computed_rowflops() { this->computed_rowflops = true; }
   void set_computed_entries() { this->computed_entries = true; }
   void set_call_numeric(bool call = true) { this->called_numeric = call; }
 
+  /// \brief Runs the numeric phase of the KK algorithms by bins of rows of
+  /// similar flop counts, each bin with an accumulator sized for its own
+  /// rows, instead of one accumulator sized for the heaviest row.
+  void set_row_binning(bool binning) { this->row_binning = binning; }
+  bool get_row_binning() const { return this->row_binning; }
+  void set_computed_row_bins(bool computed = true) {
+    this->computed_row_bins = computed;
+  }
+  bool are_row_bins_computed() const { return this->computed_row_bins; }
+
+  /// \brief Bytes that spgemm_chunked may use for one row block of C (its
+  /// row map, entries and values). 0, the default, means no limit: C is
+  /// computed in a single block.
+  void set_memory_budget(size_t bytes) { this->memory_budget = bytes; }
+  size_t get_memory_budget() const { return this->memory_budget; }
+
+  /// \brief Records, in the first numeric phase after a symbolic phase, the
+  /// position in C of each product a_ik * b_kj. The following numeric
+  /// phases, where only the values of A and B change, are then a gather
+  /// over the products without accumulators or sorting. The map takes one
+  /// ordinal per product (the flops of A*B). It is only used by the native
+  /// algorithms: the numeric phases that call a TPL ignore it.
+  void set_numeric_reuse_map(bool reuse) {
+    this->numeric_reuse_map = reuse;
+    if (!reuse) this->computed_reuse_map = false;
+  }
+  bool get_numeric_reuse_map() const { return this->numeric_reuse_map; }
+  void set_computed_reuse_map(bool computed = true) {
+    this->computed_reuse_map = computed;
+  }
+  bool is_reuse_map_computed() const { return this->computed_reuse_map; }
+
   void set_max_result_nnz(nnz_lno_t nz) {
     this->max_nnz_inresult          = nz;
     this->computed_max_nnz_inresult = true;
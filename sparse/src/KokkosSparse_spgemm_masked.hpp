@@ -0,0 +1,121 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+#ifndef _KOKKOSSPARSE_SPGEMM_MASKED_HPP
+#define _KOKKOSSPARSE_SPGEMM_MASKED_HPP
+
+#include <stdexcept>
+#include "KokkosKernels_Handle.hpp"
+#include "KokkosSparse_spgemm_masked_impl.hpp"
+
+namespace KokkosSparse {
+
+namespace Impl {
+template <class AMatrix, class BMatrix>
+void check_masked_spgemm_dims(const AMatrix& A, const BMatrix& B) {
+  if (A.numCols() != B.numRows())
+    throw std::invalid_argument(
+        "KokkosSparse::masked_spgemm: A and B have incompatible dimensions "
+        "for multiplication");
+}
+}  // namespace Impl
+
+/// \brief Symbolic phase of the masked product C = (A*B) .* M.
+///
+/// Only the structure of the mask M is used. With \c complement false, C
+/// keeps the entries of A*B that are in the pattern of M; with \c complement
+/// true, those that are not. The mask is applied inside the row
+/// accumulators, so a product outside the output pattern never takes an
+/// accumulator slot: a plain mask bounds the workspace of a row by the
+/// length of the row of M, whatever the length of the row of A*B.
+///
+/// The accumulator (dense or hashed) follows the algorithm and accumulator
+/// type of the SPGEMMHandle of \c kh. C is allocated with sorted rows.
+///
+/// \param kh [in/out] The kernel handle, with an SPGEMMHandle
+/// \param A [in] The left factor
+/// \param B [in] The right factor
+/// \param M [in] The mask, with the dimensions of A*B
+/// \param complement [in] Whether C is restricted to the complement of M
+/// \param C [out] The product's structure
+template <class KernelHandle, class AMatrix, class BMatrix, class MMatrix,
+          class CMatrix>
+void masked_spgemm_symbolic(KernelHandle& kh, const AMatrix& A,
+                            const BMatrix& B, const MMatrix& M,
+                            const bool complement, CMatrix& C) {
+  using row_map_type = typename CMatrix::row_map_type::non_const_type;
+  using entries_type = typename CMatrix::index_type::non_const_type;
+  using values_type  = typename CMatrix::values_type::non_const_type;
+
+  Impl::check_masked_spgemm_dims(A, B);
+  if (M.numRows() != A.numRows() || M.numCols() != B.numCols())
+    throw std::invalid_argument(
+        "KokkosSparse::masked_spgemm: the mask must have the dimensions of "
+        "A*B");
+
+  row_map_type row_mapC("non_const_lnow_row", A.numRows() + 1);
+  entries_type entriesC;
+  KokkosSparse::Impl::spgemm_masked_symbolic(
+      &kh, A.numRows(), B.numCols(), A.graph.row_map, A.graph.entries,
+      B.graph.row_map, B.graph.entries, M.graph.row_map, M.graph.entries,
+      complement, row_mapC, entriesC);
+
+  const size_t c_nnz_size = kh.get_spgemm_handle()->get_c_nnz();
+  values_type valuesC(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "valuesC"), c_nnz_size);
+  C = CMatrix("C=(AB).*M", A.numRows(), B.numCols(), c_nnz_size, valuesC,
+              row_mapC, entriesC);
+}
+
+/// \brief Numeric phase of the masked product, after
+/// masked_spgemm_symbolic() with the same handle.
+///
+/// The mask is not needed again: it is carried by the structure of C. A and
+/// B must have the structure they had in the symbolic phase; only their
+/// values may change between numeric calls.
+template <class KernelHandle, class AMatrix, class BMatrix, class CMatrix>
+void masked_spgemm_numeric(KernelHandle& kh, const AMatrix& A,
+                           const BMatrix& B, CMatrix& C) {
+  Impl::check_masked_spgemm_dims(A, B);
+
+  KokkosSparse::Impl::spgemm_masked_numeric(
+      &kh, A.numRows(), B.numCols(), A.graph.row_map, A.graph.entries,
+      A.values, B.graph.row_map, B.graph.entries, B.values, C.graph.row_map,
+      C.graph.entries, C.values);
+}
+
+/// \brief C = (A*B) .* M (or .* !M) in one call, without reuse. A new
+/// SPGEMMHandle with the default algorithm is used for the product.
+template <class CMatrix, class AMatrix, class BMatrix, class MMatrix>
+CMatrix masked_spgemm(const AMatrix& A, const BMatrix& B, const MMatrix& M,
+                      const bool complement = false) {
+  using KernelHandle = KokkosKernels::Experimental::KokkosKernelsHandle<
+      typename CMatrix::non_const_size_type,
+      typename CMatrix::non_const_ordinal_type,
+      typename CMatrix::non_const_value_type,
+      typename CMatrix::execution_space, typename CMatrix::memory_space,
+      typename CMatrix::memory_space>;
+  KernelHandle kh;
+  kh.create_spgemm_handle();
+  CMatrix C;
+  masked_spgemm_symbolic(kh, A, B, M, complement, C);
+  masked_spgemm_numeric(kh, A, B, C);
+  kh.destroy_spgemm_handle();
+  return C;
+}
+
+}  // namespace KokkosSparse
+
+#endif
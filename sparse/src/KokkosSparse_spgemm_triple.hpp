@@ -0,0 +1,173 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+#ifndef _KOKKOSSPARSE_SPGEMM_TRIPLE_HPP
+#define _KOKKOSSPARSE_SPGEMM_TRIPLE_HPP
+
+#include <stdexcept>
+#include "KokkosKernels_Handle.hpp"
+#include "KokkosSparse_spgemm_triple_impl.hpp"
+
+namespace KokkosSparse {
+
+/// \brief Symbolic phase of the sparse triple product C = R*A*P.
+///
+/// The product is formed row by row: each row of R*A is accumulated in
+/// per-thread workspace and multiplied by P right away, so neither R*A nor
+/// A*P is ever stored. The accumulator follows the algorithm and
+/// accumulator type of the SPGEMMHandle of \c kh, which must have been
+/// created with create_spgemm_handle(). C is allocated with sorted rows.
+///
+/// \param kh [in/out] The kernel handle; keeps what the numeric phase reuses
+/// \param R [in] The left factor (the restriction in AMG)
+/// \param A [in] The middle factor
+/// \param P [in] The right factor (the prolongation in AMG)
+/// \param C [out] The product's structure
+template <class KernelHandle, class RMatrix, class AMatrix, class PMatrix,
+          class CMatrix>
+void spgemm_triple_symbolic(KernelHandle& kh, const RMatrix& R,
+                            const AMatrix& A, const PMatrix& P, CMatrix& C) {
+  using row_map_type = typename CMatrix::row_map_type::non_const_type;
+  using entries_type = typename CMatrix::index_type::non_const_type;
+  using values_type  = typename CMatrix::values_type::non_const_type;
+
+  Impl::check_spgemm_triple_dims(R, A, P);
+
+  row_map_type row_mapC("non_const_lnow_row", R.numRows() + 1);
+  entries_type entriesC;
+  KokkosSparse::Impl::spgemm_triple_symbolic(
+      &kh, R.numRows(), A.numCols(), P.numCols(), R.graph.row_map,
+      R.graph.entries, A.graph.row_map, A.graph.entries, P.graph.row_map,
+      P.graph.entries, row_mapC, entriesC);
+
+  const size_t c_nnz_size = kh.get_spgemm_handle()->get_c_nnz();
+  values_type valuesC(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "valuesC"), c_nnz_size);
+  C = CMatrix("C=RAP", R.numRows(), P.numCols(), c_nnz_size, valuesC, row_mapC,
+              entriesC);
+}
+
+/// \brief Numeric phase of C = R*A*P.
+///
+/// Recomputes the values of C after spgemm_triple_symbolic() with the same
+/// handle. R, A and P must have the structure they had in the symbolic
+/// phase; only their values may change between numeric calls.
+template <class KernelHandle, class RMatrix, class AMatrix, class PMatrix,
+          class CMatrix>
+void spgemm_triple_numeric(KernelHandle& kh, const RMatrix& R,
+                           const AMatrix& A, const PMatrix& P, CMatrix& C) {
+  Impl::check_spgemm_triple_dims(R, A, P);
+
+  KokkosSparse::Impl::spgemm_triple_numeric(
+      &kh, R.numRows(), R.graph.row_map, R.graph.entries, R.values,
+      A.graph.row_map, A.graph.entries, A.values, P.graph.row_map,
+      P.graph.entries, P.values, C.graph.row_map, C.graph.entries, C.values);
+}
+
+/// \brief Symbolic phase of the Galerkin product C = P^T*A*P.
+///
+/// Same as spgemm_triple_symbolic() with R = P^T. The transpose of P is
+/// formed once and kept in the handle, together with the position in P of
+/// each of its entries, so that spgemm_ptap_numeric() only gathers the
+/// current values of P.
+template <class KernelHandle, class AMatrix, class PMatrix, class CMatrix>
+void spgemm_ptap_symbolic(KernelHandle& kh, const AMatrix& A, const PMatrix& P,
+                          CMatrix& C) {
+  using row_map_type = typename CMatrix::row_map_type::non_const_type;
+  using entries_type = typename CMatrix::index_type::non_const_type;
+  using values_type  = typename CMatrix::values_type::non_const_type;
+
+  if (A.numRows() != A.numCols() || A.numCols() != P.numRows())
+    throw std::invalid_argument(
+        "KokkosSparse::spgemm_ptap: A must be square with as many rows as P");
+
+  KokkosSparse::Impl::spgemm_ptap_transpose(
+      &kh, P.numRows(), P.numCols(), P.graph.row_map, P.graph.entries);
+  auto sh = kh.get_spgemm_handle();
+
+  row_map_type row_mapC("non_const_lnow_row", P.numCols() + 1);
+  entries_type entriesC;
+  KokkosSparse::Impl::spgemm_triple_symbolic(
+      &kh, P.numCols(), A.numCols(), P.numCols(), sh->triple_pt_rowmap,
+      sh->triple_pt_entries, A.graph.row_map, A.graph.entries,
+      P.graph.row_map, P.graph.entries, row_mapC, entriesC);
+
+  const size_t c_nnz_size = sh->get_c_nnz();
+  values_type valuesC(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "valuesC"), c_nnz_size);
+  C = CMatrix("C=PtAP", P.numCols(), P.numCols(), c_nnz_size, valuesC,
+              row_mapC, entriesC);
+}
+
+/// \brief Numeric phase of C = P^T*A*P, after spgemm_ptap_symbolic() with
+/// the same handle. Only the values of A and P may have changed.
+template <class KernelHandle, class AMatrix, class PMatrix, class CMatrix>
+void spgemm_ptap_numeric(KernelHandle& kh, const AMatrix& A, const PMatrix& P,
+                         CMatrix& C) {
+  auto sh = kh.get_spgemm_handle();
+  if (!sh->triple_symbolic_called ||
+      sh->triple_pt_rowmap.extent(0) != size_t(P.numCols()) + 1)
+    throw std::runtime_error(
+        "KokkosSparse::spgemm_ptap_numeric: spgemm_ptap_symbolic must be "
+        "called first");
+
+  KokkosSparse::Impl::spgemm_ptap_transpose_values(&kh, P.values);
+  KokkosSparse::Impl::spgemm_triple_numeric(
+      &kh, P.numCols(), sh->triple_pt_rowmap, sh->triple_pt_entries,
+      sh->triple_pt_values, A.graph.row_map, A.graph.entries, A.values,
+      P.graph.row_map, P.graph.entries, P.values, C.graph.row_map,
+      C.graph.entries, C.values);
+}
+
+/// \brief C = R*A*P in one call, without reuse. A new SPGEMMHandle with
+/// the default algorithm is used for the product.
+template <class CMatrix, class RMatrix, class AMatrix, class PMatrix>
+CMatrix spgemm_triple(const RMatrix& R, const AMatrix& A, const PMatrix& P) {
+  using KernelHandle = KokkosKernels::Experimental::KokkosKernelsHandle<
+      typename CMatrix::non_const_size_type,
+      typename CMatrix::non_const_ordinal_type,
+      typename CMatrix::non_const_value_type,
+      typename CMatrix::execution_space, typename CMatrix::memory_space,
+      typename CMatrix::memory_space>;
+  KernelHandle kh;
+  kh.create_spgemm_handle();
+  CMatrix C;
+  spgemm_triple_symbolic(kh, R, A, P, C);
+  spgemm_triple_numeric(kh, R, A, P, C);
+  kh.destroy_spgemm_handle();
+  return C;
+}
+
+/// \brief C = P^T*A*P in one call, without reuse.
+template <class CMatrix, class AMatrix, class PMatrix>
+CMatrix spgemm_ptap(const AMatrix& A, const PMatrix& P) {
+  using KernelHandle = KokkosKernels::Experimental::KokkosKernelsHandle<
+      typename CMatrix::non_const_size_type,
+      typename CMatrix::non_const_ordinal_type,
+      typename CMatrix::non_const_value_type,
+      typename CMatrix::execution_space, typename CMatrix::memory_space,
+      typename CMatrix::memory_space>;
+  KernelHandle kh;
+  kh.create_spgemm_handle();
+  CMatrix C;
+  spgemm_ptap_symbolic(kh, A, P, C);
+  spgemm_ptap_numeric(kh, A, P, C);
+  kh.destroy_spgemm_handle();
+  return C;
+}
+
+}  // namespace KokkosSparse
+
+#endif
@@ -244,6 +244,13 @@ void spiluk_symbolic(KernelHandle* handle,
 
 }  // spiluk_symbolic
 
+/// \brief Numeric phase of ILU(k), on the patterns of spiluk_symbolic.
+///
+/// Block matrices (BsrMatrix) are factored by blocks when the SPILUK handle
+/// was given their block size (set_block_size). The symbolic phase then
+/// takes the block graph, and the values are the BSR values: a dense
+/// row-major block per entry. The diagonal blocks of U hold their LU
+/// factors, so U can be solved with sptrsv_solve and the same block size.
 template <typename KernelHandle, typename ARowMapType, typename AEntriesType,
           typename AValuesType, typename LRowMapType, typename LEntriesType,
           typename LValuesType, typename URowMapType, typename UEntriesType,
@@ -432,6 +439,19 @@ void spiluk_numeric(KernelHandle* handle,
     KokkosKernels::Impl::throw_runtime_exception(os.str());
   }
 
+  // With a block size, the values hold a dense block per entry
+  auto spiluk_handle = handle->get_spiluk_handle();
+  size_type block_items =
+      spiluk_handle->get_block_size() * spiluk_handle->get_block_size();
+  if (A_values.extent(0) < A_entries.extent(0) * block_items ||
+      L_values.extent(0) < spiluk_handle->get_nnzL() * block_items ||
+      U_values.extent(0) < spiluk_handle->get_nnzU() * block_items) {
+    std::ostringstream os;
+    os << "KokkosSparse::Experimental::spiluk_numeric: values must hold "
+       << block_items << " entries per nonzero of the (block) patterns.";
+    KokkosKernels::Impl::throw_runtime_exception(os.str());
+  }
+
   typedef typename KernelHandle::const_size_type c_size_t;
   typedef typename KernelHandle::const_nnz_lno_t c_lno_t;
   typedef typename KernelHandle::const_nnz_scalar_t c_scalar_t;
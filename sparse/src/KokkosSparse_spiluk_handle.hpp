@@ -15,6 +15,7 @@
 //@HEADER
 
 #include <Kokkos_Core.hpp>
+#include <Kokkos_ArithTraits.hpp>
 #include <iostream>
 #include <string>
 #include <KokkosKernels_HashmapAccumulator.hpp>
@@ -29,9 +30,13 @@ namespace KokkosSparse {
 namespace Experimental {
 
 // TP2 algorithm has issues with some offset-ordinal combo to be addressed
+// FIXED_POINT computes the factors by asynchronous fixed-point sweeps over
+// all the nonzeros of L and U (Chow and Patel) instead of level by level.
+// It needs no level schedule, but only approximates the factorization.
 enum class SPILUKAlgorithm {
   SEQLVLSCHD_RP,
-  SEQLVLSCHD_TP1 /*, SEQLVLSCHED_TP2*/
+  SEQLVLSCHD_TP1 /*, SEQLVLSCHED_TP2*/,
+  FIXED_POINT
 };
 
 template <class size_type_, class lno_t_, class scalar_t_, class ExecutionSpace,
@@ -53,6 +58,7 @@ class SPILUKHandle {
 
   typedef typename std::remove_const<scalar_t_>::type nnz_scalar_t;
   typedef const nnz_scalar_t const_nnz_scalar_t;
+  typedef typename Kokkos::ArithTraits<nnz_scalar_t>::mag_type nnz_mag_t;
 
   typedef typename Kokkos::View<size_type *, HandlePersistentMemorySpace>
       nnz_row_view_t;
@@ -106,6 +112,15 @@ class SPILUKHandle {
   int team_size;
   int vector_size;
 
+  int num_sweeps;  // sweeps of the FIXED_POINT numeric phase
+
+  // Size of the dense blocks of BSR values (1 for point CRS): the row map and
+  // entries are then the block graph and nrows the number of block rows
+  size_type block_size;
+  // Shift added to the pivots when factoring the diagonal blocks of BSR
+  // values, so that a zero pivot does not divide by zero
+  nnz_mag_t block_pivot_tiny;
+
  public:
   SPILUKHandle(SPILUKAlgorithm choice, const size_type nrows_,
                const size_type nnzL_, const size_type nnzU_,
@@ -126,7 +141,10 @@ class SPILUKHandle {
         symbolic_complete(symbolic_complete_),
         algm(choice),
         team_size(-1),
-        vector_size(-1) {}
+        vector_size(-1),
+        num_sweeps(3),
+        block_size(1),
+        block_pivot_tiny(Kokkos::ArithTraits<nnz_mag_t>::epsilon()) {}
 
   void reset_handle(const size_type nrows_, const size_type nnzL_,
                     const size_type nnzU_) {
@@ -235,6 +253,28 @@ class SPILUKHandle {
   void set_vector_size(const int vs) { this->vector_size = vs; }
   int get_vector_size() const { return this->vector_size; }
 
+  void set_num_sweeps(const int ns) {
+    if (ns < 1)
+      throw std::runtime_error("SPILUKHandle: at least one sweep is needed");
+    this->num_sweeps = ns;
+  }
+  int get_num_sweeps() const { return this->num_sweeps; }
+
+  void set_block_size(const size_type bs) {
+    if (bs < 1)
+      throw std::runtime_error("SPILUKHandle: block size must be at least 1");
+    this->block_size = bs;
+  }
+  size_type get_block_size() const { return this->block_size; }
+
+  void set_block_pivot_tiny(const nnz_mag_t tiny) {
+    if (!(tiny > 0))
+      throw std::runtime_error(
+          "SPILUKHandle: the block pivot shift must be positive");
+    this->block_pivot_tiny = tiny;
+  }
+  nnz_mag_t get_block_pivot_tiny() const { return this->block_pivot_tiny; }
+
   void print_algorithm() {
     if (algm == SPILUKAlgorithm::SEQLVLSCHD_RP)
       std::cout << "SEQLVLSCHD_RP" << std::endl;
@@ -242,6 +282,9 @@ class SPILUKHandle {
     if (algm == SPILUKAlgorithm::SEQLVLSCHD_TP1)
       std::cout << "SEQLVLSCHD_TP1" << std::endl;
 
+    if (algm == SPILUKAlgorithm::FIXED_POINT)
+      std::cout << "FIXED_POINT" << std::endl;
+
     /*if ( algm == SPILUKAlgorithm::SEQLVLSCHED_TP2 ) {
       std::cout << "SEQLVLSCHED_TP2" << std::endl;;
       std::cout << "WARNING: With CUDA this is currently only reliable with
@@ -257,6 +300,8 @@ class SPILUKHandle {
       return SPILUKAlgorithm::SEQLVLSCHD_RP;
     else if (name == "SPILUK_TEAMPOLICY1")
       return SPILUKAlgorithm::SEQLVLSCHD_TP1;
+    else if (name == "SPILUK_FIXEDPOINT")
+      return SPILUKAlgorithm::FIXED_POINT;
     /*else if(name=="SPILUK_TEAMPOLICY2")    return
      * SPILUKAlgorithm::SEQLVLSCHED_TP2;*/
     else
@@ -26,9 +26,13 @@
 #include "KokkosSparse_spmv_spec.hpp"
 #include "KokkosSparse_spmv_struct_spec.hpp"
 #include "KokkosSparse_spmv_bsrmatrix_spec.hpp"
+#include "KokkosSparse_spmv_handle.hpp"
+#include "KokkosSparse_spmv_handle_impl.hpp"
 #include <type_traits>
 #include "KokkosSparse_BsrMatrix.hpp"
 #include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosSparse_SellMatrix.hpp"
+#include "KokkosSparse_spmv_sellmatrix_impl.hpp"
 #include "KokkosBlas1_scal.hpp"
 #include "KokkosKernels_Utils.hpp"
 #include "KokkosKernels_Error.hpp"
@@ -173,6 +177,10 @@ void spmv(KokkosKernels::Experimental::Controls controls, const char mode[],
   if (std::is_same<typename AMatrix_Internal::memory_space,
                    Kokkos::HostSpace>::value) {
     useFallback = useFallback || (mode[0] == Conjugate[0]);
+    // MKL has no merge-path kernel, use the native one
+    useFallback =
+        useFallback || (controls.isParameter("algorithm") &&
+                        controls.getParameter("algorithm") == "merge");
   }
 #endif
 
@@ -564,8 +572,11 @@ void spmv(KokkosKernels::Experimental::Controls controls, const char mode[],
 
   AMatrix_Internal A_i = A;
 
+  const bool useMerge = controls.isParameter("algorithm") &&
+                        (controls.getParameter("algorithm") == "merge");
+
   // Call single-vector version if appropriate
-  if (x.extent(1) == 1) {
+  if (x.extent(1) == 1 && !useMerge) {
     typedef Kokkos::View<
         typename XVector::const_value_type*,
         typename KokkosKernels::Impl::GetUnifiedLayout<XVector>::array_layout,
@@ -613,6 +624,8 @@ void spmv(KokkosKernels::Experimental::Controls controls, const char mode[],
 #endif
     useNative = useNative || (controls.isParameter("algorithm") &&
                               (controls.getParameter("algorithm") == "native"));
+    // No TPL provides a merge-path SpMM, so use the native one
+    useNative = useNative || useMerge;
 
     if (useNative) {
       return Impl::SPMV_MV<
@@ -843,6 +856,116 @@ void spmv(KokkosKernels::Experimental::Controls controls, const char mode[],
   }
 }
 
+namespace Impl {
+// Run time dimension check of the SellMatrix overloads: x and y must match
+// Op(A) exactly, with the same number of vectors
+template <class AMatrix, class XVector, class YVector>
+void check_sell_spmv_dimensions(const char mode[], const AMatrix& A,
+                                const XVector& x, const YVector& y) {
+  const bool transpose =
+      (mode[0] != NoTranspose[0]) && (mode[0] != Conjugate[0]);
+  const size_t xLen = transpose ? A.numRows() : A.numCols();
+  const size_t yLen = transpose ? A.numCols() : A.numRows();
+  if ((x.extent(1) != y.extent(1)) ||
+      (xLen != static_cast<size_t>(x.extent(0))) ||
+      (yLen != static_cast<size_t>(y.extent(0)))) {
+    std::ostringstream os;
+    os << "KokkosSparse::spmv: Dimensions do not match"
+       << (transpose ? " (transpose)" : "") << ": "
+       << ", A: " << A.numRows() << " x " << A.numCols()
+       << ", x: " << x.extent(0) << " x " << x.extent(1)
+       << ", y: " << y.extent(0) << " x " << y.extent(1);
+    KokkosKernels::Impl::throw_runtime_exception(os.str());
+  }
+}
+}  // namespace Impl
+
+#ifdef DOXY  // hide SFINAE
+template <class AlphaType, class AMatrix, class XVector, class BetaType,
+          class YVector>
+#else
+template <class AlphaType, class AMatrix, class XVector, class BetaType,
+          class YVector,
+          typename std::enable_if<KokkosSparse::Experimental::is_sell_matrix<
+              AMatrix>::value>::type* = nullptr>
+#endif
+void spmv(KokkosKernels::Experimental::Controls /*controls*/,
+          const char mode[], const AlphaType& alpha, const AMatrix& A,
+          const XVector& x, const BetaType& beta, const YVector& y,
+          const RANK_ONE) {
+  // Make sure that x and y have the same rank.
+  static_assert(
+      static_cast<int>(XVector::rank) == static_cast<int>(YVector::rank),
+      "KokkosSparse::spmv: Vector ranks do not match.");
+  // Make sure that x (and therefore y) is rank 1.
+  static_assert(static_cast<int>(XVector::rank) == 1,
+                "KokkosSparse::spmv: Both Vector inputs must have rank 1 "
+                "in order to call this specialization of spmv.");
+  // Make sure that y is non-const.
+  static_assert(std::is_same<typename YVector::value_type,
+                             typename YVector::non_const_value_type>::value,
+                "KokkosSparse::spmv: Output Vector must be non-const.");
+  static_assert(
+      Kokkos::SpaceAccessibility<
+          typename AMatrix::execution_space,
+          typename XVector::device_type::memory_space>::accessible &&
+          Kokkos::SpaceAccessibility<
+              typename AMatrix::execution_space,
+              typename YVector::device_type::memory_space>::accessible,
+      "KokkosSparse::spmv: SellMatrix and vectors must be accessible from "
+      "the same execution space.");
+
+  Impl::check_sell_spmv_dimensions(mode, A, x, y);
+
+  typedef typename YVector::non_const_value_type y_value_type;
+  Impl::spmv_sellmatrix<typename AMatrix::execution_space>(
+      mode, static_cast<y_value_type>(alpha), A, x,
+      static_cast<y_value_type>(beta), y);
+}
+
+#ifdef DOXY  // hide SFINAE
+template <class AlphaType, class AMatrix, class XVector, class BetaType,
+          class YVector>
+#else
+template <class AlphaType, class AMatrix, class XVector, class BetaType,
+          class YVector,
+          typename std::enable_if<KokkosSparse::Experimental::is_sell_matrix<
+              AMatrix>::value>::type* = nullptr>
+#endif
+void spmv(KokkosKernels::Experimental::Controls /*controls*/,
+          const char mode[], const AlphaType& alpha, const AMatrix& A,
+          const XVector& x, const BetaType& beta, const YVector& y,
+          const RANK_TWO) {
+  // Make sure that x and y have the same rank.
+  static_assert(
+      static_cast<int>(XVector::rank) == static_cast<int>(YVector::rank),
+      "KokkosSparse::spmv: Vector ranks do not match.");
+  // Make sure that x (and therefore y) is rank 2.
+  static_assert(static_cast<int>(XVector::rank) == 2,
+                "KokkosSparse::spmv: Both Vector inputs must have rank 2 "
+                "in order to call this specialization of spmv.");
+  // Make sure that y is non-const.
+  static_assert(std::is_same<typename YVector::value_type,
+                             typename YVector::non_const_value_type>::value,
+                "KokkosSparse::spmv: Output Vector must be non-const.");
+  static_assert(
+      Kokkos::SpaceAccessibility<
+          typename AMatrix::execution_space,
+          typename XVector::device_type::memory_space>::accessible &&
+          Kokkos::SpaceAccessibility<
+              typename AMatrix::execution_space,
+              typename YVector::device_type::memory_space>::accessible,
+      "KokkosSparse::spmv: SellMatrix and vectors must be accessible from "
+      "the same execution space.");
+
+  Impl::check_sell_spmv_dimensions(mode, A, x, y);
+
+  typedef typename YVector::non_const_value_type y_value_type;
+  Impl::spmv_sellmatrix<typename AMatrix::execution_space>(
+      mode, static_cast<y_value_type>(alpha), A, x,
+      static_cast<y_value_type>(beta), y);
+}
+
 /// \brief Public interface to local sparse matrix-vector multiply.
 ///
 /// Compute y = beta*y + alpha*Op(A)*x, where x and y are either both
@@ -868,8 +991,18 @@ void spmv(KokkosKernels::Experimental::Controls controls, const char mode[],
 /// enabled for Kokkos::CrsMatrix and Kokkos::Experimental::BsrMatrix on a
 /// single vector, or for Kokkos::Experimental::BsrMatrix with a multivector.
 ///
-/// \tparam AMatrix KokkosSparse::CrsMatrix or
-/// KokkosSparse::Experimental::BsrMatrix
+/// If \c AMatrix is a KokkosSparse::CrsMatrix, controls may have
+/// \c "algorithm" = \c "merge" to use a merge-path SpMV that splits the
+/// nonzeros evenly between threads instead of assigning whole rows. This
+/// helps matrices whose row lengths are very unbalanced. cuSPARSE and
+/// rocSPARSE provide the single vector version when enabled; otherwise the
+/// native implementation is used for all modes, single vectors and
+/// multivectors. The number of row ends and nonzeros processed per thread can
+/// be tuned with \c "items per thread".
+///
+/// \tparam AMatrix KokkosSparse::CrsMatrix,
+/// KokkosSparse::Experimental::BsrMatrix or
+/// KokkosSparse::Experimental::SellMatrix
 ///
 /// \param controls [in] kokkos-kernels control structure
 /// \param mode [in] "N" for no transpose, "T" for transpose, or "C"
@@ -951,12 +1084,13 @@ void spmv(KokkosKernels::Experimental::Controls controls, const char mode[],
 /// argument types
 ///
 /// This is a catch-all interfaceace that throws a compile-time error if \c
-/// AMatrix is not a CrsMatrix, or BsrMatrix
+/// AMatrix is not a CrsMatrix, BsrMatrix or SellMatrix
 ///
 template <class AlphaType, class AMatrix, class XVector, class BetaType,
           class YVector,
           typename std::enable_if<
               !KokkosSparse::Experimental::is_bsr_matrix<AMatrix>::value &&
+              !KokkosSparse::Experimental::is_sell_matrix<AMatrix>::value &&
               !KokkosSparse::is_crs_matrix<AMatrix>::value>::type* = nullptr>
 void spmv(KokkosKernels::Experimental::Controls /*controls*/,
           const char[] /*mode*/, const AlphaType& /*alpha*/,
@@ -965,8 +1099,9 @@ void spmv(KokkosKernels::Experimental::Controls /*controls*/,
   // have to arrange this so that the compiler can't tell this is false until
   // instantiation
   static_assert(KokkosSparse::is_crs_matrix<AMatrix>::value ||
-                    KokkosSparse::Experimental::is_bsr_matrix<AMatrix>::value,
-                "SpMV: AMatrix must be CrsMatrix or BsrMatrix");
+                    KokkosSparse::Experimental::is_bsr_matrix<AMatrix>::value ||
+                    KokkosSparse::Experimental::is_sell_matrix<AMatrix>::value,
+                "SpMV: AMatrix must be CrsMatrix, BsrMatrix or SellMatrix");
 }
 
 // Overload for backward compatibility and also just simpler
@@ -981,6 +1116,292 @@ void spmv(const char mode[], const AlphaType& alpha, const AMatrix& A,
 
 namespace Experimental {
 
+/// \brief Analyze the graph of A and store an SpMV launch plan in the handle.
+///
+/// KokkosSparse::spmv(handle, ...) runs the analysis on its first call. Call
+/// this (or SPMVHandle::reset_analysis) after changing the graph of A: the
+/// plan is not recomputed otherwise. Changing only the values of A keeps the
+/// plan valid.
+///
+/// \tparam AMatrix KokkosSparse::CrsMatrix
+///
+/// \param handle [in/out] SPMVHandle receiving the plan.
+/// \param A [in] The sparse matrix A.
+template <class HandleSizeType, class HandleOrdinalType, class HandleExecSpace,
+          class HandleMemSpace, class AMatrix>
+void spmv_analysis(SPMVHandle<HandleSizeType, HandleOrdinalType,
+                              HandleExecSpace, HandleMemSpace>& handle,
+                   const AMatrix& A) {
+  typedef SPMVHandle<HandleSizeType, HandleOrdinalType, HandleExecSpace,
+                     HandleMemSpace>
+      handle_type;
+  static_assert(KokkosSparse::is_crs_matrix<AMatrix>::value,
+                "KokkosSparse::spmv_analysis: AMatrix must be a CrsMatrix.");
+  static_assert(
+      std::is_same<typename AMatrix::non_const_ordinal_type,
+                   typename handle_type::nnz_lno_t>::value &&
+          std::is_same<typename AMatrix::non_const_size_type,
+                       typename handle_type::size_type>::value &&
+          std::is_same<typename AMatrix::execution_space,
+                       typename handle_type::execution_space>::value,
+      "KokkosSparse::spmv_analysis: SPMVHandle and matrix types do not "
+      "match.");
+
+  typedef KokkosSparse::CrsMatrix<
+      typename AMatrix::const_value_type, typename AMatrix::const_ordinal_type,
+      typename AMatrix::device_type, Kokkos::MemoryTraits<Kokkos::Unmanaged>,
+      typename AMatrix::const_size_type>
+      AMatrix_Internal;
+
+  AMatrix_Internal A_i = A;
+  KokkosSparse::Impl::spmv_analysis(handle, A_i);
+}
+
+}  // namespace Experimental
+
+/// \brief Sparse matrix-vector multiply reusing the plan stored in an
+/// SPMVHandle.
+///
+/// Computes y := beta*y + alpha*op(A)*x like the other overloads. The first
+/// call analyzes the graph of A (see Experimental::spmv_analysis) and later
+/// calls reuse the chosen kernel and its launch parameters until the next
+/// explicit analysis or SPMVHandle::reset_analysis, so repeated products
+/// with the same matrix, e.g. in a Krylov solver, skip the per-call setup.
+/// With SPMVAlgorithm::SPMV_DEFAULT a vendor library is still used when one
+/// is enabled for these types; the other algorithms always run the native
+/// kernels.
+///
+/// \tparam AMatrix KokkosSparse::CrsMatrix with the ordinal, offset,
+///   execution space and memory space types of the handle
+///
+/// \param handle [in/out] SPMVHandle holding the launch plan.
+/// \param mode [in] "N" for no transpose, "T" for transpose, "C" for
+///   conjugate or "H" for conjugate transpose.
+/// \param alpha [in] Scalar multiplier for the matrix A.
+/// \param A [in] The sparse matrix A.
+/// \param x [in] Either a single vector (rank-1 Kokkos::View) or
+///   multivector (rank-2 Kokkos::View).
+/// \param beta [in] Scalar multiplier for the (multi)vector y.
+/// \param y [in/out] Either a single vector (rank-1 Kokkos::View) or
+///   multivector (rank-2 Kokkos::View).  It must have the same number
+///   of columns as x.
+template <class HandleSizeType, class HandleOrdinalType, class HandleExecSpace,
+          class HandleMemSpace, class AlphaType, class AMatrix, class XVector,
+          class BetaType, class YVector>
+void spmv(Experimental::SPMVHandle<HandleSizeType, HandleOrdinalType,
+                                   HandleExecSpace, HandleMemSpace>& handle,
+          const char mode[], const AlphaType& alpha, const AMatrix& A,
+          const XVector& x, const BetaType& beta, const YVector& y) {
+  typedef Experimental::SPMVHandle<HandleSizeType, HandleOrdinalType,
+                                   HandleExecSpace, HandleMemSpace>
+      handle_type;
+  static_assert(KokkosSparse::is_crs_matrix<AMatrix>::value,
+                "KokkosSparse::spmv: the SPMVHandle interface requires a "
+                "CrsMatrix.");
+  static_assert(
+      std::is_same<typename AMatrix::non_const_ordinal_type,
+                   typename handle_type::nnz_lno_t>::value &&
+          std::is_same<typename AMatrix::non_const_size_type,
+                       typename handle_type::size_type>::value &&
+          std::is_same<typename AMatrix::execution_space,
+                       typename handle_type::execution_space>::value &&
+          std::is_same<typename AMatrix::memory_space,
+                       typename handle_type::memory_space>::value,
+      "KokkosSparse::spmv: SPMVHandle and matrix types do not match.");
+  // Make sure that both x and y have the same rank.
+  static_assert(
+      static_cast<int>(XVector::rank) == static_cast<int>(YVector::rank),
+      "KokkosSparse::spmv: Vector ranks do not match.");
+  static_assert(static_cast<int>(XVector::rank) == 1 ||
+                    static_cast<int>(XVector::rank) == 2,
+                "KokkosSparse::spmv: Vector inputs must have rank 1 or 2.");
+  // Make sure that y is non-const.
+  static_assert(std::is_same<typename YVector::value_type,
+                             typename YVector::non_const_value_type>::value,
+                "KokkosSparse::spmv: Output Vector must be non-const.");
+
+  // Check compatibility of dimensions at run time.
+  if ((mode[0] == NoTranspose[0]) || (mode[0] == Conjugate[0])) {
+    if ((x.extent(1) != y.extent(1)) ||
+        (static_cast<size_t>(A.numCols()) !=
+         static_cast<size_t>(x.extent(0))) ||
+        (static_cast<size_t>(A.numRows()) !=
+         static_cast<size_t>(y.extent(0)))) {
+      std::ostringstream os;
+      os << "KokkosSparse::spmv (Handle): Dimensions do not match: "
+         << ", A: " << A.numRows() << " x " << A.numCols()
+         << ", x: " << x.extent(0) << " x " << x.extent(1)
+         << ", y: " << y.extent(0) << " x " << y.extent(1);
+      KokkosKernels::Impl::throw_runtime_exception(os.str());
+    }
+  } else {
+    if ((x.extent(1) != y.extent(1)) ||
+        (static_cast<size_t>(A.numCols()) !=
+         static_cast<size_t>(y.extent(0))) ||
+        (static_cast<size_t>(A.numRows()) !=
+         static_cast<size_t>(x.extent(0)))) {
+      std::ostringstream os;
+      os << "KokkosSparse::spmv (Handle): Dimensions do not match "
+            "(transpose): "
+         << ", A: " << A.numRows() << " x " << A.numCols()
+         << ", x: " << x.extent(0) << " x " << x.extent(1)
+         << ", y: " << y.extent(0) << " x " << y.extent(1);
+      KokkosKernels::Impl::throw_runtime_exception(os.str());
+    }
+  }
+
+  if (alpha == Kokkos::ArithTraits<AlphaType>::zero() || A.numRows() == 0 ||
+      A.numCols() == 0 || A.nnz() == 0) {
+    // Same semantics as the native SpMV: beta = 0 overwrites y, even NaNs.
+    if (beta == Kokkos::ArithTraits<BetaType>::zero())
+      Kokkos::deep_copy(y, Kokkos::ArithTraits<BetaType>::zero());
+    else
+      KokkosBlas::scal(y, beta, y);
+    return;
+  }
+
+  typedef KokkosSparse::CrsMatrix<
+      typename AMatrix::const_value_type, typename AMatrix::const_ordinal_type,
+      typename AMatrix::device_type, Kokkos::MemoryTraits<Kokkos::Unmanaged>,
+      typename AMatrix::const_size_type>
+      AMatrix_Internal;
+
+  AMatrix_Internal A_i = A;
+
+  // The plan is kept until the caller asks for a new analysis. Another graph
+  // is rejected; a graph changed in place must be reanalyzed by the caller.
+  if (handle.is_analysis_complete() &&
+      !handle.is_analyzed_for(A.graph.row_map.data(), A.graph.entries.data(),
+                              A.numRows(), A.nnz())) {
+    std::ostringstream os;
+    os << "KokkosSparse::spmv (Handle): the handle was analyzed for another "
+          "graph, call spmv_analysis or reset_analysis after changing the "
+          "graph of A: A: "
+       << A.numRows() << " rows, " << A.nnz() << " entries";
+    KokkosKernels::Impl::throw_runtime_exception(os.str());
+  }
+
+  const bool useDefault =
+      handle.get_algorithm() == Experimental::SPMVAlgorithm::SPMV_DEFAULT;
+
+  if constexpr (static_cast<int>(XVector::rank) == 1) {
+    typedef Kokkos::View<
+        typename XVector::const_value_type*,
+        typename KokkosKernels::Impl::GetUnifiedLayout<XVector>::array_layout,
+        typename XVector::device_type,
+        Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >
+        XVector_Internal;
+    typedef Kokkos::View<
+        typename YVector::non_const_value_type*,
+        typename KokkosKernels::Impl::GetUnifiedLayout<YVector>::array_layout,
+        typename YVector::device_type, Kokkos::MemoryTraits<Kokkos::Unmanaged> >
+        YVector_Internal;
+
+    constexpr bool tpl_spec_avail = Impl::spmv_tpl_spec_avail<
+        typename AMatrix_Internal::value_type,
+        typename AMatrix_Internal::ordinal_type,
+        typename AMatrix_Internal::device_type,
+        typename AMatrix_Internal::memory_traits,
+        typename AMatrix_Internal::size_type,
+        typename XVector_Internal::value_type*,
+        typename XVector_Internal::array_layout,
+        typename XVector_Internal::device_type,
+        typename XVector_Internal::memory_traits,
+        typename YVector_Internal::value_type*,
+        typename YVector_Internal::array_layout,
+        typename YVector_Internal::device_type,
+        typename YVector_Internal::memory_traits>::value;
+    if (tpl_spec_avail && useDefault) {
+      KokkosKernels::Experimental::Controls controls;
+      spmv(controls, mode, alpha, A, x, beta, y);
+      return;
+    }
+
+    XVector_Internal x_i = x;
+    YVector_Internal y_i = y;
+
+    if (!handle.is_analysis_complete()) Impl::spmv_analysis(handle, A_i);
+    // The native specialization, even when a TPL exists for these types
+    Impl::SPMV<typename AMatrix_Internal::value_type,
+               typename AMatrix_Internal::ordinal_type,
+               typename AMatrix_Internal::device_type,
+               typename AMatrix_Internal::memory_traits,
+               typename AMatrix_Internal::size_type,
+               typename XVector_Internal::value_type*,
+               typename XVector_Internal::array_layout,
+               typename XVector_Internal::device_type,
+               typename XVector_Internal::memory_traits,
+               typename YVector_Internal::value_type*,
+               typename YVector_Internal::array_layout,
+               typename YVector_Internal::device_type,
+               typename YVector_Internal::memory_traits,
+               false>::spmv(handle, mode, alpha, A_i, x_i, beta, y_i);
+  } else {
+    // Single column: use the single vector plan
+    if (x.extent(1) == 1) {
+      spmv(handle, mode, alpha, A, Kokkos::subview(x, Kokkos::ALL(), 0), beta,
+           Kokkos::subview(y, Kokkos::ALL(), 0));
+      return;
+    }
+
+    typedef Kokkos::View<
+        typename XVector::const_value_type**, typename XVector::array_layout,
+        typename XVector::device_type,
+        Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >
+        XVector_Internal;
+    typedef Kokkos::View<typename YVector::non_const_value_type**,
+                         typename YVector::array_layout,
+                         typename YVector::device_type,
+                         Kokkos::MemoryTraits<Kokkos::Unmanaged> >
+        YVector_Internal;
+
+    constexpr bool tpl_spec_avail = Impl::spmv_mv_tpl_spec_avail<
+        typename AMatrix_Internal::value_type,
+        typename AMatrix_Internal::ordinal_type,
+        typename AMatrix_Internal::device_type,
+        typename AMatrix_Internal::memory_traits,
+        typename AMatrix_Internal::size_type,
+        typename XVector_Internal::value_type**,
+        typename XVector_Internal::array_layout,
+        typename XVector_Internal::device_type,
+        typename XVector_Internal::memory_traits,
+        typename YVector_Internal::value_type**,
+        typename YVector_Internal::array_layout,
+        typename YVector_Internal::device_type,
+        typename YVector_Internal::memory_traits>::value;
+    if (tpl_spec_avail && useDefault) {
+      KokkosKernels::Experimental::Controls controls;
+      spmv(controls, mode, alpha, A, x, beta, y);
+      return;
+    }
+
+    XVector_Internal x_i = x;
+    YVector_Internal y_i = y;
+
+    if (!handle.is_analysis_complete()) Impl::spmv_analysis(handle, A_i);
+    // The multivector kernels only take the merge-path chunk size from the
+    // plan
+    Impl::SPMV_MV<
+        typename AMatrix_Internal::value_type,
+        typename AMatrix_Internal::ordinal_type,
+        typename AMatrix_Internal::device_type,
+        typename AMatrix_Internal::memory_traits,
+        typename AMatrix_Internal::size_type,
+        typename XVector_Internal::value_type**,
+        typename XVector_Internal::array_layout,
+        typename XVector_Internal::device_type,
+        typename XVector_Internal::memory_traits,
+        typename YVector_Internal::value_type**,
+        typename YVector_Internal::array_layout,
+        typename YVector_Internal::device_type,
+        typename YVector_Internal::memory_traits,
+        std::is_integral<typename AMatrix_Internal::value_type>::value,
+        false>::spmv_mv(handle, mode, alpha, A_i, x_i, beta, y_i);
+  }
+}
+
+namespace Experimental {
+
 template <class AlphaType, class AMatrix, class XVector, class BetaType,
           class YVector>
 void spmv_struct(const char mode[], const int stencil_type,
@@ -0,0 +1,207 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+/// \file KokkosSparse_spmv_dot.hpp
+/// \brief Sparse matrix-vector multiply fused with a dot product or a norm
+///   of its result, for Krylov solvers.
+
+#ifndef KOKKOSSPARSE_SPMV_DOT_HPP_
+#define KOKKOSSPARSE_SPMV_DOT_HPP_
+
+#include <type_traits>
+#include "KokkosKernels_Controls.hpp"
+#include "KokkosKernels_Error.hpp"
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosSparse_spmv.hpp"
+#include "KokkosSparse_spmv_dot_impl.hpp"
+#include "KokkosBlas1_dot.hpp"
+#include "KokkosBlas1_nrm2.hpp"
+
+namespace KokkosSparse {
+
+namespace Impl {
+
+// Whether KokkosSparse::spmv has a TPL for these types, in which case it
+// calls the TPL unless the controls ask for the native kernels
+template <class AMatrix, class XVector, class YVector>
+constexpr bool spmv_fused_tpl_avail() {
+  typedef KokkosKernels::Impl::GetUnifiedLayout<XVector> XLayout;
+  typedef KokkosKernels::Impl::GetUnifiedLayout<YVector> YLayout;
+  return spmv_tpl_spec_avail<
+      typename AMatrix::const_value_type,
+      typename AMatrix::const_ordinal_type, typename AMatrix::device_type,
+      Kokkos::MemoryTraits<Kokkos::Unmanaged>,
+      typename AMatrix::const_size_type,
+      typename XVector::const_value_type*, typename XLayout::array_layout,
+      typename XVector::device_type,
+      Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess>,
+      typename YVector::non_const_value_type*, typename YLayout::array_layout,
+      typename YVector::device_type,
+      Kokkos::MemoryTraits<Kokkos::Unmanaged>>::value;
+}
+
+// Argument checks and mode dispatch shared by spmv_dot and spmv_nrm2. Returns
+// the 2-norm of y when norm is true, the inner product of y and z otherwise.
+template <bool norm, class AMatrix, class XVector, class YVector,
+          class ZVector>
+typename std::conditional<
+    norm,
+    typename Kokkos::Details::InnerProductSpaceTraits<
+        typename YVector::non_const_value_type>::mag_type,
+    typename Kokkos::Details::InnerProductSpaceTraits<
+        typename YVector::non_const_value_type>::dot_type>::type
+spmv_fused(const KokkosKernels::Experimental::Controls& controls,
+           const char mode[], typename YVector::const_value_type& alpha,
+           const AMatrix& A, const XVector& x,
+           typename YVector::const_value_type& beta, const YVector& y,
+           const ZVector& z) {
+  static_assert(KokkosSparse::is_crs_matrix<AMatrix>::value,
+                "KokkosSparse::spmv_dot: AMatrix must be a CrsMatrix");
+  static_assert(Kokkos::is_view<XVector>::value &&
+                    Kokkos::is_view<YVector>::value &&
+                    Kokkos::is_view<ZVector>::value,
+                "KokkosSparse::spmv_dot: x, y and z must be Kokkos::View");
+  static_assert(static_cast<int>(XVector::rank) == 1 &&
+                    static_cast<int>(YVector::rank) == 1 &&
+                    static_cast<int>(ZVector::rank) == 1,
+                "KokkosSparse::spmv_dot: x, y and z must have rank 1");
+  static_assert(std::is_same<typename YVector::value_type,
+                             typename YVector::non_const_value_type>::value,
+                "KokkosSparse::spmv_dot: Output Vector must be non-const.");
+
+  const bool transpose = mode[0] == Transpose[0] ||
+                         mode[0] == ConjugateTranspose[0];
+  if (!transpose && mode[0] != NoTranspose[0] && mode[0] != Conjugate[0]) {
+    std::ostringstream os;
+    os << "KokkosSparse::spmv_dot: Invalid mode \"" << mode << "\"";
+    KokkosKernels::Impl::throw_runtime_exception(os.str());
+  }
+  const size_t x_len = transpose ? A.numRows() : A.numCols();
+  const size_t y_len = transpose ? A.numCols() : A.numRows();
+  if (x.extent(0) != x_len || y.extent(0) != y_len ||
+      z.extent(0) != y.extent(0)) {
+    std::ostringstream os;
+    os << "KokkosSparse::spmv_dot: Dimensions do not match: "
+       << "A: " << A.numRows() << " x " << A.numCols() << " (mode " << mode
+       << "), x: " << x.extent(0) << ", y: " << y.extent(0)
+       << ", z: " << z.extent(0);
+    KokkosKernels::Impl::throw_runtime_exception(os.str());
+  }
+
+  // The fused kernel is native: do not let it replace a TPL SpMV
+  const bool useTPL = spmv_fused_tpl_avail<AMatrix, XVector, YVector>() &&
+                      !(controls.isParameter("algorithm") &&
+                        controls.getParameter("algorithm") == "native");
+  if (transpose || useTPL) {
+    // With a transpose, Op(A)*x is accumulated with atomics and y is only
+    // final after the whole product: no fusion
+    KokkosSparse::spmv(controls, mode, alpha, A, x, beta, y);
+    if constexpr (norm) {
+      return KokkosBlas::nrm2(y);
+    } else {
+      return KokkosBlas::dot(y, z);
+    }
+  }
+  const auto result =
+      spmv_dot_no_transpose<AMatrix, XVector, YVector, ZVector, norm>(
+          controls, mode, alpha, A, x, beta, y, z);
+  if constexpr (norm) {
+    return result.norm();
+  } else {
+    return result;
+  }
+}
+
+}  // namespace Impl
+
+/// \brief Compute y = beta*y + alpha*Op(A)*x and return the inner product of
+///   the new y with z, KokkosBlas::dot(y, z).
+///
+/// This replaces spmv followed by dot in one kernel: each entry of y enters
+/// the inner product as soon as it is computed, so y is not read back from
+/// memory. The result is the same up to the order of the summation. When
+/// spmv would call a TPL for these types (and the controls do not ask for
+/// "algorithm" = "native"), the TPL spmv and dot run unfused instead.
+///
+/// \tparam AMatrix KokkosSparse::CrsMatrix
+/// \tparam XVector, YVector, ZVector rank-1 Kokkos::View
+///
+/// \param controls [in] Same tuning parameters as the native spmv
+///   ("schedule", "team size", "vector length", "rows per thread")
+/// \param mode [in] "N", "C", "T" or "H". The transposed modes are not
+///   fused: they run spmv and then dot.
+/// \param alpha [in] Multiplier of Op(A)*x
+/// \param A [in] The matrix
+/// \param x [in] Input vector
+/// \param beta [in] Multiplier of y. If zero, y is overwritten
+/// \param y [in/out] Output vector
+/// \param z [in] Second operand of the inner product
+/// \return conj(y)^T z, computed after y is updated
+template <class AMatrix, class XVector, class YVector, class ZVector>
+typename Kokkos::Details::InnerProductSpaceTraits<
+    typename YVector::non_const_value_type>::dot_type
+spmv_dot(const KokkosKernels::Experimental::Controls& controls,
+         const char mode[], typename YVector::const_value_type& alpha,
+         const AMatrix& A, const XVector& x,
+         typename YVector::const_value_type& beta, const YVector& y,
+         const ZVector& z) {
+  return Impl::spmv_fused<false>(controls, mode, alpha, A, x, beta, y, z);
+}
+
+/// \brief Compute y = beta*y + alpha*Op(A)*x and return the inner product of
+///   the new y with z (see above), with default controls.
+template <class AMatrix, class XVector, class YVector, class ZVector>
+typename Kokkos::Details::InnerProductSpaceTraits<
+    typename YVector::non_const_value_type>::dot_type
+spmv_dot(const char mode[], typename YVector::const_value_type& alpha,
+         const AMatrix& A, const XVector& x,
+         typename YVector::const_value_type& beta, const YVector& y,
+         const ZVector& z) {
+  KokkosKernels::Experimental::Controls controls;
+  return spmv_dot(controls, mode, alpha, A, x, beta, y, z);
+}
+
+/// \brief Compute y = beta*y + alpha*Op(A)*x and return the 2-norm of the new
+///   y, KokkosBlas::nrm2(y).
+///
+/// Fused like spmv_dot, with the same arguments except z. The squares are
+/// accumulated relative to the largest entry, so entries whose squares
+/// would overflow or underflow still give an accurate norm.
+template <class AMatrix, class XVector, class YVector>
+typename Kokkos::Details::InnerProductSpaceTraits<
+    typename YVector::non_const_value_type>::mag_type
+spmv_nrm2(const KokkosKernels::Experimental::Controls& controls,
+          const char mode[], typename YVector::const_value_type& alpha,
+          const AMatrix& A, const XVector& x,
+          typename YVector::const_value_type& beta, const YVector& y) {
+  return Impl::spmv_fused<true>(controls, mode, alpha, A, x, beta, y, y);
+}
+
+/// \brief Compute y = beta*y + alpha*Op(A)*x and return the 2-norm of the new
+///   y (see above), with default controls.
+template <class AMatrix, class XVector, class YVector>
+typename Kokkos::Details::InnerProductSpaceTraits<
+    typename YVector::non_const_value_type>::mag_type
+spmv_nrm2(const char mode[], typename YVector::const_value_type& alpha,
+          const AMatrix& A, const XVector& x,
+          typename YVector::const_value_type& beta, const YVector& y) {
+  KokkosKernels::Experimental::Controls controls;
+  return spmv_nrm2(controls, mode, alpha, A, x, beta, y);
+}
+
+}  // namespace KokkosSparse
+
+#endif  // KOKKOSSPARSE_SPMV_DOT_HPP_
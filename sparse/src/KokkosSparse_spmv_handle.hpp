@@ -0,0 +1,240 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#include <Kokkos_Core.hpp>
+#include <string>
+#include <vector>
+
+#ifndef _SPMVHANDLE_HPP
+#define _SPMVHANDLE_HPP
+
+namespace KokkosSparse {
+namespace Experimental {
+
+/// \brief Kernels the SPMV handle can run.
+///
+/// SPMV_DEFAULT lets the analysis pick one of the native kernels from the
+/// row-length distribution of A (or defer to a vendor library when one is
+/// enabled for the matrix and vector types).
+enum class SPMVAlgorithm {
+  SPMV_DEFAULT,      // Chosen by spmv_analysis
+  SPMV_NATIVE,       // Row-parallel native kernel
+  SPMV_MERGE_PATH,   // Merge-path kernel, see KokkosSparse_spmv_impl_merge.hpp
+  SPMV_BINNED_ROWS,  // Contiguous row bins holding the same number of nonzeros
+};
+
+inline std::string spmv_algorithm_name(const SPMVAlgorithm algo) {
+  switch (algo) {
+    case SPMVAlgorithm::SPMV_DEFAULT: return "default";
+    case SPMVAlgorithm::SPMV_NATIVE: return "native";
+    case SPMVAlgorithm::SPMV_MERGE_PATH: return "merge";
+    case SPMVAlgorithm::SPMV_BINNED_ROWS: return "binned rows";
+  }
+  return "unknown";
+}
+
+/// \class SPMVHandle
+/// \brief Persistent state for repeated sparse matrix-vector products with
+/// the same matrix.
+///
+/// The first call to KokkosSparse::spmv(handle, ...) (or an explicit call to
+/// KokkosSparse::Experimental::spmv_analysis) inspects the sparsity pattern
+/// of A once: it builds a row-length histogram, picks a kernel and computes
+/// the launch parameters, plus the row bins of the SPMV_BINNED_ROWS kernel.
+/// Later calls reuse that plan until spmv_analysis or reset_analysis() is
+/// called again. The values of A may change between calls; after changing
+/// its graph, the caller must request a new analysis.
+template <class size_type_, class lno_t_, class ExecutionSpace,
+          class PersistentMemorySpace>
+class SPMVHandle {
+ public:
+  using HandleExecSpace             = ExecutionSpace;
+  using HandlePersistentMemorySpace = PersistentMemorySpace;
+
+  using execution_space = ExecutionSpace;
+  using memory_space    = HandlePersistentMemorySpace;
+  using device_type     = Kokkos::Device<execution_space, memory_space>;
+
+  using size_type       = typename std::remove_const<size_type_>::type;
+  using const_size_type = const size_type;
+
+  using nnz_lno_t       = typename std::remove_const<lno_t_>::type;
+  using const_nnz_lno_t = const nnz_lno_t;
+
+  using nnz_lno_view_t = Kokkos::View<nnz_lno_t *, device_type>;
+
+  /// Bin 0 counts the empty rows, bin b > 0 the rows of length in
+  /// [2^(b-1), 2^b). The last bin also holds all longer rows.
+  static constexpr int num_histogram_bins = 32;
+
+ private:
+  SPMVAlgorithm algorithm;
+
+  // Launch parameters requested by the user, -1 means "pick one"
+  int team_size_request;
+  int vector_length_request;
+  int64_t rows_per_thread_request;
+  int64_t items_per_thread_request;
+
+  // Graph the plan was computed for
+  bool analysis_complete;
+  const size_type *analyzed_row_map;
+  const nnz_lno_t *analyzed_entries;
+  nnz_lno_t analyzed_nrows;
+  size_type analyzed_nnz;
+
+  // Row-length statistics
+  nnz_lno_t max_row_length;
+  double avg_row_length;
+  std::vector<size_type> row_length_histogram;
+
+  // Launch plan
+  SPMVAlgorithm kernel;
+  int team_size;
+  int vector_length;
+  int64_t rows_per_team;
+  bool dynamic_schedule;
+  int64_t items_per_thread;
+  nnz_lno_view_t bin_offsets;
+
+ public:
+  SPMVHandle(const SPMVAlgorithm algorithm_ = SPMVAlgorithm::SPMV_DEFAULT)
+      : algorithm(algorithm_),
+        team_size_request(-1),
+        vector_length_request(-1),
+        rows_per_thread_request(-1),
+        items_per_thread_request(-1),
+        analysis_complete(false),
+        analyzed_row_map(nullptr),
+        analyzed_entries(nullptr),
+        analyzed_nrows(0),
+        analyzed_nnz(0),
+        max_row_length(0),
+        avg_row_length(0),
+        row_length_histogram(num_histogram_bins, 0),
+        kernel(SPMVAlgorithm::SPMV_NATIVE),
+        team_size(-1),
+        vector_length(-1),
+        rows_per_team(-1),
+        dynamic_schedule(false),
+        items_per_thread(-1) {}
+
+  /// Forget the current plan; the next apply analyzes A again. Call this
+  /// after changing the graph of A.
+  void reset_analysis() {
+    analysis_complete = false;
+    bin_offsets       = nnz_lno_view_t();
+  }
+
+  SPMVAlgorithm get_algorithm() const { return algorithm; }
+  void set_algorithm(const SPMVAlgorithm algorithm_) {
+    algorithm = algorithm_;
+    reset_analysis();
+  }
+
+  int get_team_size_request() const { return team_size_request; }
+  void set_team_size_request(const int ts) {
+    team_size_request = ts;
+    reset_analysis();
+  }
+
+  int get_vector_length_request() const { return vector_length_request; }
+  void set_vector_length_request(const int vl) {
+    vector_length_request = vl;
+    reset_analysis();
+  }
+
+  int64_t get_rows_per_thread_request() const {
+    return rows_per_thread_request;
+  }
+  void set_rows_per_thread_request(const int64_t rpt) {
+    rows_per_thread_request = rpt;
+    reset_analysis();
+  }
+
+  int64_t get_items_per_thread_request() const {
+    return items_per_thread_request;
+  }
+  void set_items_per_thread_request(const int64_t ipt) {
+    items_per_thread_request = ipt;
+    reset_analysis();
+  }
+
+  bool is_analysis_complete() const { return analysis_complete; }
+
+  /// Whether the current plan was computed for this graph: the same row map
+  /// and entries allocations with the same dimensions. Changing the graph in
+  /// place is not detected and requires reset_analysis().
+  bool is_analyzed_for(const size_type *row_map, const nnz_lno_t *entries,
+                       const nnz_lno_t nrows, const size_type nnz) const {
+    return analysis_complete && analyzed_row_map == row_map &&
+           analyzed_entries == entries && analyzed_nrows == nrows &&
+           analyzed_nnz == nnz;
+  }
+
+  void set_analysis_complete(const size_type *row_map,
+                             const nnz_lno_t *entries, const nnz_lno_t nrows,
+                             const size_type nnz) {
+    analysis_complete = true;
+    analyzed_row_map  = row_map;
+    analyzed_entries  = entries;
+    analyzed_nrows    = nrows;
+    analyzed_nnz      = nnz;
+  }
+
+  nnz_lno_t get_max_row_length() const { return max_row_length; }
+  void set_max_row_length(const nnz_lno_t len) { max_row_length = len; }
+
+  double get_avg_row_length() const { return avg_row_length; }
+  void set_avg_row_length(const double len) { avg_row_length = len; }
+
+  const std::vector<size_type> &get_row_length_histogram() const {
+    return row_length_histogram;
+  }
+  void set_row_length_histogram(const std::vector<size_type> &hist) {
+    row_length_histogram = hist;
+  }
+
+  /// Kernel selected by the analysis
+  SPMVAlgorithm get_kernel() const { return kernel; }
+  void set_kernel(const SPMVAlgorithm kernel_) { kernel = kernel_; }
+
+  int get_team_size() const { return team_size; }
+  void set_team_size(const int ts) { team_size = ts; }
+
+  int get_vector_length() const { return vector_length; }
+  void set_vector_length(const int vl) { vector_length = vl; }
+
+  int64_t get_rows_per_team() const { return rows_per_team; }
+  void set_rows_per_team(const int64_t rpt) { rows_per_team = rpt; }
+
+  bool use_dynamic_schedule() const { return dynamic_schedule; }
+  void set_dynamic_schedule(const bool dynamic) { dynamic_schedule = dynamic; }
+
+  int64_t get_items_per_thread() const { return items_per_thread; }
+  void set_items_per_thread(const int64_t ipt) { items_per_thread = ipt; }
+
+  /// First row of each row bin, plus numRows at the end
+  nnz_lno_view_t get_bin_offsets() const { return bin_offsets; }
+  void set_bin_offsets(const nnz_lno_view_t &offsets) {
+    bin_offsets = offsets;
+  }
+};
+
+}  // namespace Experimental
+}  // namespace KokkosSparse
+
+#endif
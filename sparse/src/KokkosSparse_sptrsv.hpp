@@ -221,8 +221,8 @@ void sptrsv_solve(KernelHandle *handle, lno_row_view_t_ rowmap,
                 "sptrsv: x is not a Kokkos::View.");
   static_assert((int)BType::rank == (int)XType::rank,
                 "sptrsv: The ranks of b and x do not match.");
-  static_assert(BType::rank == 1,
-                "sptrsv: b and x must both either have rank 1.");
+  static_assert(BType::rank == 1 || BType::rank == 2,
+                "sptrsv: b and x must both either have rank 1 or rank 2.");
   static_assert(std::is_same<typename XType::value_type,
                              typename XType::non_const_value_type>::value,
                 "sptrsv: The output x must be nonconst.");
@@ -279,14 +279,14 @@ void sptrsv_solve(KernelHandle *handle, lno_row_view_t_ rowmap,
       Values_Internal;
 
   typedef Kokkos::View<
-      typename BType::const_value_type *,
+      typename BType::const_data_type,
       typename KokkosKernels::Impl::GetUnifiedLayout<BType>::array_layout,
       typename BType::device_type,
       Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::RandomAccess> >
       BType_Internal;
 
   typedef Kokkos::View<
-      typename XType::non_const_value_type *,
+      typename XType::non_const_data_type,
       typename KokkosKernels::Impl::GetUnifiedLayout<XType>::array_layout,
       typename XType::device_type, Kokkos::MemoryTraits<Kokkos::Unmanaged> >
       XType_Internal;
@@ -299,8 +299,45 @@ void sptrsv_solve(KernelHandle *handle, lno_row_view_t_ rowmap,
   XType_Internal x_i = x;
 
   auto sptrsv_handle = handle->get_sptrsv_handle();
-  if (sptrsv_handle->get_algorithm() ==
-      KokkosSparse::Experimental::SPTRSVAlgorithm::SPTRSV_CUSPARSE) {
+  if constexpr (static_cast<int>(BType::rank) == 2) {
+    // Multiple right-hand sides, one per column of b and x
+    auto algm = sptrsv_handle->get_algorithm();
+    if (sptrsv_handle->get_block_size() == 1 &&
+        (algm == SPTRSVAlgorithm::SEQLVLSCHD_RP ||
+         algm == SPTRSVAlgorithm::SEQLVLSCHD_TP1 ||
+         algm == SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN ||
+         algm == SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE ||
+         algm == SPTRSVAlgorithm::JACOBI)) {
+      // One pass over the level schedule, or one rank-2 SpMV per Jacobi
+      // sweep, for all the columns
+      KokkosSparse::Impl::SPTRSV_SOLVE<
+          const_handle_type, RowMap_Internal, Entries_Internal,
+          Values_Internal, BType_Internal,
+          XType_Internal>::sptrsv_solve(&tmp_handle, rowmap_i, entries_i,
+                                        values_i, b_i, x_i);
+    } else {
+      // cuSPARSE, the supernodal algorithms and block values solve the
+      // columns one at a time, through contiguous copies since a column may
+      // be strided. The supernodal solves work in place on x_j.
+      typedef Kokkos::View<typename XType::non_const_value_type *,
+                           typename XType::device_type>
+          column_t;
+      column_t b_j(Kokkos::view_alloc(Kokkos::WithoutInitializing, "b_j"),
+                   b.extent(0));
+      column_t x_j(Kokkos::view_alloc(Kokkos::WithoutInitializing, "x_j"),
+                   x.extent(0));
+      for (size_t j = 0; j < b.extent(1); j++) {
+        Kokkos::deep_copy(b_j, Kokkos::subview(b, Kokkos::ALL(), j));
+        Kokkos::deep_copy(x_j, Kokkos::subview(x, Kokkos::ALL(), j));
+        sptrsv_solve(handle, rowmap, entries, values, b_j, x_j);
+        Kokkos::deep_copy(Kokkos::subview(x, Kokkos::ALL(), j), x_j);
+      }
+    }
+  } else if (sptrsv_handle->get_algorithm() ==
+             KokkosSparse::Experimental::SPTRSVAlgorithm::SPTRSV_CUSPARSE) {
+    if (sptrsv_handle->get_block_size() > 1)
+      throw std::runtime_error(
+          "sptrsv_solve: block values need a level-scheduled algorithm");
     typedef typename KernelHandle::SPTRSVHandleType sptrsvHandleType;
     sptrsvHandleType *sh = handle->get_sptrsv_handle();
     auto nrows           = sh->get_nrows();
@@ -322,6 +359,8 @@ void sptrsv_solve(KernelHandle *handle, lno_row_view_t_ rowmap,
 
 #if defined(KOKKOSKERNELS_ENABLE_SUPERNODAL_SPTRSV)
 // ---------------------------------------------------------------------
+// Supernodal solve; x and b are vectors (rank 1) or have one right-hand
+// side per column (rank 2)
 template <typename KernelHandle, class XType>
 void sptrsv_solve(KernelHandle *handle, XType x, XType b) {
   auto crsmat  = handle->get_sptrsv_handle()->get_crsmat();
@@ -17,6 +17,7 @@
 #include <Kokkos_Core.hpp>
 #include <iostream>
 #include <string>
+#include <limits>
 
 #ifndef KOKKOSSPARSE_SPTRSVHANDLE_HPP
 #define KOKKOSSPARSE_SPTRSVHANDLE_HPP
@@ -49,7 +50,11 @@ enum class SPTRSVAlgorithm {
   SUPERNODAL_ETREE,
   SUPERNODAL_DAG,
   SUPERNODAL_SPMV,
-  SUPERNODAL_SPMV_DAG
+  SUPERNODAL_SPMV_DAG,
+  SEQLVLSCHD_SYNCFREE,  // host: runs of small levels in one parallel region,
+                        // synchronized row to row instead of by barriers
+  JACOBI  // approximate: a fixed number of Jacobi sweeps, x += D^{-1}(b - Tx),
+          // each an SpMV; exact once the sweeps reach the number of levels
 };
 
 template <class size_type_, class lno_t_, class scalar_t_, class ExecutionSpace,
@@ -312,6 +317,25 @@ class SPTRSVHandle {
   size_type num_chain_entries;
   signed_integral_t chain_threshold;
 
+  // Symbolic: merged level regions of SEQLVLSCHD_SYNCFREE
+  host_signed_nnz_lno_view_t h_merged_level_ptr;
+  size_type num_merged_regions;
+  signed_integral_t merge_threshold;
+
+  // Solve: SEQLVLSCHD_SYNCFREE completion flags of the rows. A row is done
+  // when its flag equals the epoch of the current solve, so the flags never
+  // need to be reset between solves.
+  int_row_view_t syncfree_done;
+  int syncfree_epoch;
+
+  // Solve: JACOBI sweeps, inverse diagonal and residual workspace
+  int num_jacobi_sweeps;
+  nnz_scalar_view_t jacobi_inv_diag;
+  nnz_scalar_view_t jacobi_work;
+
+  // Solve: size of the dense blocks of BSR values, 1 for point CRS
+  size_type block_size;
+
   bool symbolic_complete;
   bool numeric_complete;
   bool require_symbolic_lvlsched_phase;
@@ -321,7 +345,8 @@ class SPTRSVHandle {
     if (algm == SPTRSVAlgorithm::SEQLVLSCHD_RP ||
         algm == SPTRSVAlgorithm::SEQLVLSCHD_TP1
         /*|| algm == SPTRSVAlgorithm::SEQLVLSCHED_TP2*/
-        || algm == SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN
+        || algm == SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN ||
+        algm == SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE
 #ifdef KOKKOSKERNELS_ENABLE_SUPERNODAL_SPTRSV
         || algm == SPTRSVAlgorithm::SUPERNODAL_NAIVE ||
         algm == SPTRSVAlgorithm::SUPERNODAL_ETREE ||
@@ -448,6 +473,15 @@ class SPTRSVHandle {
         h_chain_ptr(),
         num_chain_entries(0),
         chain_threshold(-1),
+        h_merged_level_ptr(),
+        num_merged_regions(0),
+        merge_threshold(-1),
+        syncfree_done(),
+        syncfree_epoch(0),
+        num_jacobi_sweeps(5),
+        jacobi_inv_diag(),
+        jacobi_work(),
+        block_size(1),
         symbolic_complete(symbolic_complete_),
         numeric_complete(numeric_complete_),
         require_symbolic_lvlsched_phase(false),
@@ -750,6 +784,13 @@ class SPTRSVHandle {
                                             "nodes_grouped_by_level"),
                          nrows_);
 
+      if (algm == SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE) {
+        h_merged_level_ptr =
+            host_signed_nnz_lno_view_t("h_merged_level_ptr", nrows_ + 1);
+        syncfree_done  = int_row_view_t("syncfree_done", nrows_);
+        syncfree_epoch = 0;
+      }
+
 #if 0
       std::cout << "  newinit_handle: level schedule allocs" << std::endl;
       std::cout << "  ll.extent = " << level_list.extent(0) << std::endl;
@@ -760,6 +801,15 @@ class SPTRSVHandle {
 #endif
     }
 
+    if (algm == SPTRSVAlgorithm::JACOBI) {
+      jacobi_inv_diag = nnz_scalar_view_t(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, "jacobi_inv_diag"),
+          nrows_);
+      jacobi_work = nnz_scalar_view_t(
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, "jacobi_work"),
+          nrows_);
+    }
+
     if (stored_diagonal) {
       diagonal_offsets = nnz_lno_view_t(
           Kokkos::view_alloc(Kokkos::WithoutInitializing, "diagonal_offsets"),
@@ -928,6 +978,59 @@ class SPTRSVHandle {
     return h_chain_ptr;
   }
 
+  inline host_signed_nnz_lno_view_t get_host_merged_level_ptr() const {
+    return h_merged_level_ptr;
+  }
+
+  size_type get_num_merged_regions() const { return num_merged_regions; }
+  void set_num_merged_regions(const size_type nregions) {
+    this->num_merged_regions = nregions;
+  }
+
+  // Levels with at most this many rows are merged with their small
+  // neighbors by SEQLVLSCHD_SYNCFREE; -1 picks a default from the
+  // concurrency of the execution space. Takes effect at the next symbolic.
+  void set_merge_threshold(const signed_integral_t threshold) {
+    this->merge_threshold = threshold;
+  }
+  signed_integral_t get_merge_threshold() const {
+    return this->merge_threshold;
+  }
+
+  int_row_view_t get_syncfree_done() const { return syncfree_done; }
+
+  // Returns the epoch marking the rows solved by the next solve
+  int next_syncfree_epoch() {
+    if (syncfree_epoch == std::numeric_limits<int>::max()) {
+      Kokkos::deep_copy(syncfree_done, 0);
+      syncfree_epoch = 0;
+    }
+    return ++syncfree_epoch;
+  }
+
+  // Sweeps of the JACOBI solve: more sweeps are more accurate, and as many
+  // sweeps as the triangle has levels give the exact solution
+  void set_num_jacobi_sweeps(const int sweeps) {
+    if (sweeps < 0)
+      throw std::runtime_error(
+          "SPTRSVHandle: the number of Jacobi sweeps must be nonnegative");
+    this->num_jacobi_sweeps = sweeps;
+  }
+  int get_num_jacobi_sweeps() const { return this->num_jacobi_sweeps; }
+
+  nnz_scalar_view_t get_jacobi_inv_diag() const { return jacobi_inv_diag; }
+  nnz_scalar_view_t get_jacobi_work() const { return jacobi_work; }
+
+  // Solve with BSR values of block_size x block_size blocks: the row map and
+  // entries are the block graph and nrows the number of block rows. The
+  // diagonal blocks must hold their LU factors, as spiluk_numeric leaves them.
+  void set_block_size(const size_type bs) {
+    if (bs < 1)
+      throw std::runtime_error("SPTRSVHandle: block size must be at least 1");
+    this->block_size = bs;
+  }
+  size_type get_block_size() const { return this->block_size; }
+
   KOKKOS_INLINE_FUNCTION
   nnz_lno_view_t get_nodes_per_level() const { return nodes_per_level; }
 
@@ -1030,6 +1133,11 @@ class SPTRSVHandle {
       std::cout << "SEQLVLSCHD_TP1CHAIN" << std::endl;
     ;
 
+    if (algm == SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE)
+      std::cout << "SEQLVLSCHD_SYNCFREE" << std::endl;
+
+    if (algm == SPTRSVAlgorithm::JACOBI) std::cout << "JACOBI" << std::endl;
+
     if (algm == SPTRSVAlgorithm::SPTRSV_CUSPARSE)
       std::cout << "SPTRSV_CUSPARSE" << std::endl;
     ;
@@ -1063,6 +1171,11 @@ class SPTRSVHandle {
     if (algm == SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN)
       ret_string = "SEQLVLSCHD_TP1CHAIN";
 
+    if (algm == SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE)
+      ret_string = "SEQLVLSCHD_SYNCFREE";
+
+    if (algm == SPTRSVAlgorithm::JACOBI) ret_string = "JACOBI";
+
     if (algm == SPTRSVAlgorithm::SPTRSV_CUSPARSE)
       ret_string = "SPTRSV_CUSPARSE";
 
@@ -1080,6 +1193,10 @@ class SPTRSVHandle {
      * SPTRSVAlgorithm::SEQLVLSCHED_TP2;*/
     else if (name == "SPTRSV_TEAMPOLICY1CHAIN")
       return SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN;
+    else if (name == "SPTRSV_SYNCFREE")
+      return SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE;
+    else if (name == "SPTRSV_JACOBI")
+      return SPTRSVAlgorithm::JACOBI;
     else if (name == "SPTRSV_CUSPARSE")
       return SPTRSVAlgorithm::SPTRSV_CUSPARSE;
     else
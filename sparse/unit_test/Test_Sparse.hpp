@@ -37,6 +37,8 @@
 #include "Test_Sparse_trsv.hpp"
 #include "Test_Sparse_par_ilut.hpp"
 #include "Test_Sparse_gmres.hpp"
+#include "Test_Sparse_cg.hpp"
+#include "Test_Sparse_IOUtils.hpp"
 #include "Test_Sparse_Transpose.hpp"
 #include "Test_Sparse_TestUtils_RandCsMat.hpp"
 #include "Test_Sparse_ccs2crs.hpp"
@@ -0,0 +1,240 @@
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+
+#include "KokkosSparse_IOUtils.hpp"
+#include "KokkosSparse_SortCrs.hpp"
+
+namespace Test {
+
+// Compare the host arrays produced by the serial MatrixMarket reader on
+// filename and by the parallel one on parallelFilename
+template <typename lno_t, typename size_type, typename scalar_t>
+void check_same_mtx_read(const char *filename, bool symmetrize,
+                         bool remove_diagonal, bool transpose,
+                         const char *parallelFilename = nullptr) {
+  lno_t nr1, nc1, nr2, nc2, *adj1, *adj2;
+  size_type ne1, ne2, *xadj1, *xadj2;
+  scalar_t *ew1, *ew2;
+  KokkosSparse::Impl::read_mtx<lno_t, size_type, scalar_t>(
+      filename, &nr1, &nc1, &ne1, &xadj1, &adj1, &ew1, symmetrize,
+      remove_diagonal, transpose);
+  KokkosSparse::Impl::read_mtx_parallel<lno_t, size_type, scalar_t>(
+      parallelFilename ? parallelFilename : filename, &nr2, &nc2, &ne2,
+      &xadj2, &adj2, &ew2, symmetrize, remove_diagonal, transpose);
+  ASSERT_EQ(nr1, nr2);
+  ASSERT_EQ(nc1, nc2);
+  ASSERT_EQ(ne1, ne2);
+  for (lno_t i = 0; i <= nr1; i++) ASSERT_EQ(xadj1[i], xadj2[i]);
+  for (size_type i = 0; i < ne1; i++) {
+    ASSERT_EQ(adj1[i], adj2[i]);
+    ASSERT_EQ(ew1[i], ew2[i]);
+  }
+  delete[] xadj1;
+  delete[] adj1;
+  delete[] ew1;
+  delete[] xadj2;
+  delete[] adj2;
+  delete[] ew2;
+}
+
+template <typename crsMat_t>
+void check_same_crs(const crsMat_t &A, const crsMat_t &B) {
+  ASSERT_EQ(A.numRows(), B.numRows());
+  ASSERT_EQ(A.numCols(), B.numCols());
+  ASSERT_EQ(A.nnz(), B.nnz());
+  auto Arowmap = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                     A.graph.row_map);
+  auto Aentries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                      A.graph.entries);
+  auto Avalues =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), A.values);
+  auto Browmap = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                     B.graph.row_map);
+  auto Bentries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                      B.graph.entries);
+  auto Bvalues =
+      Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), B.values);
+  for (size_t i = 0; i < Arowmap.extent(0); i++)
+    ASSERT_EQ(Arowmap(i), Browmap(i));
+  for (size_t i = 0; i < Aentries.extent(0); i++) {
+    ASSERT_EQ(Aentries(i), Bentries(i));
+    ASSERT_EQ(Avalues(i), Bvalues(i));
+  }
+}
+
+template <typename scalar_t, typename lno_t, typename size_type,
+          typename device>
+void run_test_mtx_parallel_read(lno_t numRows, lno_t numCols,
+                                size_type nnz) {
+  using crsMat_t =
+      KokkosSparse::CrsMatrix<scalar_t, lno_t, device, void, size_type>;
+  crsMat_t A = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      numRows, numCols, nnz, 2, numCols / 2);
+  A          = KokkosSparse::sort_and_merge_matrix(A);
+
+  // The random matrix round-trips exactly through MatrixMarket
+  std::string filename = "kk_test_io_" + std::to_string(numRows) + ".mtx";
+  KokkosSparse::Impl::write_kokkos_crst_matrix(A, filename.c_str());
+  crsMat_t B =
+      KokkosSparse::Impl::read_kokkos_crst_matrix<crsMat_t>(filename.c_str());
+  check_same_crs(A, B);
+  crsMat_t Bp = KokkosSparse::Impl::read_kokkos_crst_matrix<crsMat_t>(
+      filename.c_str(), true);
+  check_same_crs(A, Bp);
+  check_same_mtx_read<lno_t, size_type, scalar_t>(filename.c_str(), false,
+                                                  true, false);
+  check_same_mtx_read<lno_t, size_type, scalar_t>(filename.c_str(), false,
+                                                  false, true);
+
+  // Binary CRS files: read back with a copy or directly mapped
+  std::string binName = "kk_test_io_" + std::to_string(numRows) + ".kkcrs";
+  KokkosSparse::Impl::write_kokkos_crst_matrix(A, binName.c_str());
+  crsMat_t C =
+      KokkosSparse::Impl::read_kokkos_crst_matrix<crsMat_t>(binName.c_str());
+  check_same_crs(A, C);
+  {
+    KokkosSparse::Impl::MappedCrsMatrix<scalar_t, lno_t, size_type> mapped(
+        binName);
+    const auto &M = mapped.matrix();
+    ASSERT_EQ(M.numRows(), A.numRows());
+    ASSERT_EQ(M.numCols(), A.numCols());
+    ASSERT_EQ(M.nnz(), A.nnz());
+    auto Avalues =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), A.values);
+    auto Aentries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                        A.graph.entries);
+    for (size_type i = 0; i < A.nnz(); i++) {
+      ASSERT_EQ(M.graph.entries(i), Aentries(i));
+      ASSERT_EQ(M.values(i), Avalues(i));
+    }
+  }
+  // A binary file with other types is rejected
+  EXPECT_THROW(KokkosSparse::Impl::read_crs_binary<
+                   KokkosSparse::CrsMatrix<char, lno_t, device, void,
+                                           size_type>>(binName.c_str()),
+               std::runtime_error);
+  // So is a header whose counts do not match its offsets
+  {
+    using KokkosSparse::Impl::CrsBinaryHeader;
+    std::fstream fs(binName, std::ios::in | std::ios::out | std::ios::binary);
+    int64_t nnzPlusOne = int64_t(A.nnz()) + 1;
+    fs.seekp(offsetof(CrsBinaryHeader, nnz));
+    fs.write(reinterpret_cast<const char *>(&nnzPlusOne), sizeof(int64_t));
+  }
+  EXPECT_THROW(
+      KokkosSparse::Impl::read_kokkos_crst_matrix<crsMat_t>(binName.c_str()),
+      std::runtime_error);
+
+  // A matrix with an empty row map round-trips with a single zero offset
+  {
+    crsMat_t empty;
+    KokkosSparse::Impl::write_kokkos_crst_matrix(empty, binName.c_str());
+    crsMat_t F =
+        KokkosSparse::Impl::read_kokkos_crst_matrix<crsMat_t>(binName.c_str());
+    ASSERT_EQ(F.numRows(), 0);
+    ASSERT_EQ(F.nnz(), size_type(0));
+  }
+
+  // The cached reader creates the cache on the first call and uses it on the
+  // second
+  std::string cacheName = filename + ".kkcrs";
+  std::remove(cacheName.c_str());
+  crsMat_t D = KokkosSparse::Impl::read_kokkos_crst_matrix_cached<crsMat_t>(
+      filename.c_str());
+  check_same_crs(A, D);
+  EXPECT_GT(KokkosKernels::Impl::kk_get_file_size(cacheName.c_str()), 0u);
+  crsMat_t E = KokkosSparse::Impl::read_kokkos_crst_matrix_cached<crsMat_t>(
+      filename.c_str());
+  check_same_crs(A, E);
+
+  std::remove(filename.c_str());
+  std::remove(binName.c_str());
+  std::remove(cacheName.c_str());
+}
+
+// Symmetric pattern file. The parallel reader also gets a copy with
+// comments and blank lines among the entries, which it skips.
+template <typename scalar_t, typename lno_t, typename size_type>
+void run_test_mtx_parallel_read_symmetric() {
+  const char *filename      = "kk_test_io_symmetric.mtx";
+  const char *commentedName = "kk_test_io_symmetric_commented.mtx";
+  for (bool commented : {false, true}) {
+    std::ofstream os(commented ? commentedName : filename);
+    os << "%%MatrixMarket matrix coordinate pattern symmetric\n"
+       << "% a comment\n"
+       << "%\n"
+       << "5 5 8\n"
+       << "1 1\n"
+       << "2 1\n"
+       << (commented ? "\n" : "") << "3 2\n"
+       << (commented ? "% a comment among the entries\n" : "") << "3 3\n"
+       << "  4 1  \n"
+       << "5 4\r\n"
+       << "5 5\n"
+       << "5 2";
+  }
+  for (int flags = 0; flags < 4; flags++) {
+    check_same_mtx_read<lno_t, size_type, scalar_t>(filename, false, flags & 1,
+                                                    flags & 2, commentedName);
+  }
+  std::remove(commentedName);
+
+  // Number of entries does not match the header
+  {
+    std::ofstream os(filename);
+    os << "%%MatrixMarket matrix coordinate real general\n"
+       << "2 2 3\n"
+       << "1 1 1.0\n"
+       << "2 2 1.0\n";
+  }
+  lno_t nr, nc, *adj;
+  size_type ne, *xadj;
+  scalar_t *ew;
+  EXPECT_THROW((KokkosSparse::Impl::read_mtx_parallel<lno_t, size_type,
+                                                      scalar_t>(
+                   filename, &nr, &nc, &ne, &xadj, &adj, &ew)),
+               std::runtime_error);
+  std::remove(filename);
+}
+
+}  // namespace Test
+
+template <typename scalar_t, typename lno_t, typename size_type,
+          typename device>
+void test_io_utils() {
+  Test::run_test_mtx_parallel_read<scalar_t, lno_t, size_type, device>(
+      2000, 1500, 40000);
+  Test::run_test_mtx_parallel_read<scalar_t, lno_t, size_type, device>(
+      30, 70, 200);
+  Test::run_test_mtx_parallel_read_symmetric<scalar_t, lno_t, size_type>();
+}
+
+#define KOKKOSKERNELS_EXECUTE_TEST(SCALAR, ORDINAL, OFFSET, DEVICE)          \
+  TEST_F(TestCategory,                                                       \
+         sparse##_##io_utils##_##SCALAR##_##ORDINAL##_##OFFSET##_##DEVICE) { \
+    test_io_utils<SCALAR, ORDINAL, OFFSET, DEVICE>();                        \
+  }
+
+#include <Test_Common_Test_All_Type_Combos.hpp>
+
+#undef KOKKOSKERNELS_EXECUTE_TEST
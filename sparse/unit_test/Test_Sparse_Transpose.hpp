@@ -124,6 +124,47 @@ void testTranspose(int numRows, int numCols, bool doValues) {
   }
 }
 
+// On host execution spaces, the transpose comes out with sorted rows: check
+// that sorting it again changes nothing.
+template <typename exec_space>
+void testTransposeSorted(int numRows, int numCols) {
+  using range_pol = Kokkos::RangePolicy<exec_space>;
+  using scalar_t  = default_scalar;
+  using lno_t     = default_lno_t;
+  using size_type = default_size_type;
+  using mem_space = typename exec_space::memory_space;
+  using device_t  = Kokkos::Device<exec_space, mem_space>;
+  using crsMat_t  = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, device_t,
+                                                    void, size_type>;
+  using c_entries_t = typename crsMat_t::index_type;
+  using entries_t   = typename crsMat_t::index_type::non_const_type;
+  using values_t    = typename crsMat_t::values_type::non_const_type;
+
+  if (KokkosKernels::Impl::kk_is_gpu_exec_space<exec_space>()) return;
+  size_type nnz = 10 * numRows;
+  crsMat_t A    = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      numRows, numCols, nnz, 3 * 10, numRows / 2);
+  crsMat_t At = KokkosSparse::Impl::transpose_matrix(A);
+  entries_t sorted_entries("sorted entries", At.nnz());
+  values_t sorted_values("sorted values", At.nnz());
+  Kokkos::deep_copy(sorted_entries, At.graph.entries);
+  Kokkos::deep_copy(sorted_values, At.values);
+  KokkosSparse::sort_crs_matrix<exec_space>(At.graph.row_map, sorted_entries,
+                                            sorted_values);
+  size_type entriesDiffs;
+  Kokkos::parallel_reduce(
+      range_pol(0, At.nnz()),
+      ExactCompare<size_type, c_entries_t>(At.graph.entries, sorted_entries),
+      entriesDiffs);
+  EXPECT_EQ(size_type(0), entriesDiffs);
+  size_type valuesDiffs;
+  Kokkos::parallel_reduce(
+      range_pol(0, At.nnz()),
+      ExactCompare<size_type, values_t>(At.values, sorted_values),
+      valuesDiffs);
+  EXPECT_EQ(size_type(0), valuesDiffs);
+}
+
 template <class bsrMat_t>
 void CompareBsrMatrices(bsrMat_t& A, bsrMat_t& B) {
   using exec_space  = typename bsrMat_t::execution_space;
@@ -304,6 +345,8 @@ TEST_F(TestCategory, sparse_transpose_matrix) {
   testTranspose<TestExecSpace>(4000, 2000, true);
   testTranspose<TestExecSpace>(2000, 4000, true);
   testTranspose<TestExecSpace>(2000, 2000, true);
+  testTransposeSorted<TestExecSpace>(4000, 2000);
+  testTransposeSorted<TestExecSpace>(100, 3000);
 }
 
 TEST_F(TestCategory, sparse_transpose_graph) {
@@ -0,0 +1,212 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 4.0
+//       Copyright (2022) National Technology & Engineering
+//               Solutions of Sandia, LLC (NTESS).
+//
+// Under the terms of Contract DE-NA0003525 with NTESS,
+// the U.S. Government retains certain rights in this software.
+//
+// Part of Kokkos, under the Apache License v2.0 with LLVM Exceptions.
+// See https://kokkos.org/LICENSE for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//@HEADER
+*/
+
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+
+#include <vector>
+
+#include "KokkosSparse_CrsMatrix.hpp"
+#include "KokkosBlas1_nrm2.hpp"
+#include "KokkosBlas1_axpby.hpp"
+#include "KokkosSparse_spmv.hpp"
+#include "KokkosSparse_cg.hpp"
+#include "KokkosSparse_MatrixPrec.hpp"
+#include "KokkosSparse_ChebyshevPrec.hpp"
+
+namespace Test {
+
+template <class T>
+struct CgTolMeta {
+  static constexpr T value = 1e-8;
+};
+
+template <>
+struct CgTolMeta<float> {
+  static constexpr float value = 1e-4;  // Lower tolerance for floats
+};
+
+// Symmetric positive definite 5-point stencil on a gridX x gridY grid. The
+// diagonal varies from row to row so that Jacobi preconditioning is not a
+// plain scaling. If jacobi is true, the inverse of the diagonal is returned
+// instead.
+template <typename crsMat_t>
+crsMat_t make_cg_test_matrix(int gridX, int gridY, bool jacobi) {
+  using size_type = typename crsMat_t::non_const_size_type;
+  using lno_t     = typename crsMat_t::non_const_ordinal_type;
+  using scalar_t  = typename crsMat_t::non_const_value_type;
+  lno_t n         = gridX * gridY;
+  std::vector<size_type> rowmap(1, 0);
+  std::vector<lno_t> entries;
+  std::vector<scalar_t> values;
+  for (lno_t j = 0; j < gridY; j++) {
+    for (lno_t i = 0; i < gridX; i++) {
+      lno_t row     = i + j * gridX;
+      scalar_t diag = scalar_t(5 + row % 7);
+      if (jacobi) {
+        entries.push_back(row);
+        values.push_back(scalar_t(1) / diag);
+      } else {
+        if (j > 0) {
+          entries.push_back(row - gridX);
+          values.push_back(scalar_t(-1));
+        }
+        if (i > 0) {
+          entries.push_back(row - 1);
+          values.push_back(scalar_t(-1));
+        }
+        entries.push_back(row);
+        values.push_back(diag);
+        if (i < gridX - 1) {
+          entries.push_back(row + 1);
+          values.push_back(scalar_t(-1));
+        }
+        if (j < gridY - 1) {
+          entries.push_back(row + gridX);
+          values.push_back(scalar_t(-1));
+        }
+      }
+      rowmap.push_back(entries.size());
+    }
+  }
+  typename crsMat_t::row_map_type::non_const_type rowmapDev("rowmap", n + 1);
+  typename crsMat_t::index_type::non_const_type entriesDev("entries",
+                                                           entries.size());
+  typename crsMat_t::values_type::non_const_type valuesDev("values",
+                                                           values.size());
+  auto rowmapHost  = Kokkos::create_mirror_view(rowmapDev);
+  auto entriesHost = Kokkos::create_mirror_view(entriesDev);
+  auto valuesHost  = Kokkos::create_mirror_view(valuesDev);
+  for (size_t k = 0; k < rowmap.size(); k++) rowmapHost(k) = rowmap[k];
+  for (size_t k = 0; k < entries.size(); k++) {
+    entriesHost(k) = entries[k];
+    valuesHost(k)  = values[k];
+  }
+  Kokkos::deep_copy(rowmapDev, rowmapHost);
+  Kokkos::deep_copy(entriesDev, entriesHost);
+  Kokkos::deep_copy(valuesDev, valuesHost);
+  return crsMat_t("A", n, n, entries.size(), valuesDev, rowmapDev, entriesDev);
+}
+
+template <typename scalar_t, typename lno_t, typename size_type,
+          typename device>
+void run_test_cg() {
+  using exe_space = typename device::execution_space;
+  using mem_space = typename device::memory_space;
+  using sp_matrix_type =
+      KokkosSparse::CrsMatrix<scalar_t, lno_t, device, void, size_type>;
+  using KernelHandle = KokkosKernels::Experimental::KokkosKernelsHandle<
+      size_type, lno_t, scalar_t, exe_space, mem_space, mem_space>;
+  using float_t = typename Kokkos::ArithTraits<scalar_t>::mag_type;
+
+  constexpr int gridX    = 60;
+  constexpr int gridY    = 50;
+  constexpr lno_t n      = gridX * gridY;
+  constexpr auto tol     = CgTolMeta<float_t>::value;
+  constexpr bool verbose = false;
+
+  auto A = make_cg_test_matrix<sp_matrix_type>(gridX, gridY, false);
+  KokkosSparse::Experimental::MatrixPrec<sp_matrix_type> jacobi(
+      make_cg_test_matrix<sp_matrix_type>(gridX, gridY, true));
+
+  KernelHandle kh;
+  kh.create_cg_handle(500, tol);
+  auto cg_handle = kh.get_cg_handle();
+  using CGHandle = typename std::remove_reference<decltype(*cg_handle)>::type;
+  using ViewVectorType = typename CGHandle::nnz_value_view_t;
+
+  ViewVectorType X("X", n);    // Solution and initial guess
+  ViewVectorType Wj("Wj", n);  // For checking residuals at end.
+  ViewVectorType B(Kokkos::view_alloc(Kokkos::WithoutInitializing, "B"), n);
+
+  const typename CGHandle::Variant variants[] = {
+      CGHandle::Standard, CGHandle::SingleReduction, CGHandle::Pipelined};
+  for (auto variant : variants) {
+    for (bool usePrec : {false, true}) {
+      cg_handle->reset_handle(500, tol);
+      cg_handle->set_variant(variant);
+      cg_handle->set_verbose(verbose);
+
+      // Make rhs ones so that results are repeatable:
+      Kokkos::deep_copy(B, 1.0);
+      Kokkos::deep_copy(X, 0.0);
+
+      KokkosSparse::Experimental::cg(&kh, A, B, X,
+                                     usePrec ? &jacobi : nullptr);
+
+      // Double check residuals at end of solve:
+      float_t nrmB = KokkosBlas::nrm2(B);
+      KokkosSparse::spmv("N", 1.0, A, X, 0.0, Wj);  // wj = Ax
+      KokkosBlas::axpy(-1.0, Wj, B);                // b = b-Ax.
+      float_t endRes = KokkosBlas::nrm2(B) / nrmB;
+
+      EXPECT_LT(endRes, cg_handle->get_tol());
+      EXPECT_EQ(cg_handle->get_conv_flag_val(), CGHandle::Flag::Conv);
+      EXPECT_GT(cg_handle->get_num_iters(), 0);
+    }
+  }
+
+  // A Chebyshev polynomial preconditioner converges, in fewer iterations
+  // than plain CG.
+  KokkosSparse::Experimental::ChebyshevPrec<sp_matrix_type> chebyshev(A, 4);
+  chebyshev.initialize();
+  chebyshev.compute();
+  EXPECT_GT(chebyshev.getLambdaMax(), chebyshev.getLambdaMin());
+  int iters[2];
+  for (bool usePrec : {false, true}) {
+    cg_handle->reset_handle(500, tol);
+    cg_handle->set_variant(CGHandle::Standard);
+    Kokkos::deep_copy(B, 1.0);
+    Kokkos::deep_copy(X, 0.0);
+    KokkosSparse::Experimental::cg(&kh, A, B, X,
+                                   usePrec ? &chebyshev : nullptr);
+    float_t nrmB = KokkosBlas::nrm2(B);
+    KokkosSparse::spmv("N", 1.0, A, X, 0.0, Wj);
+    KokkosBlas::axpy(-1.0, Wj, B);
+    EXPECT_LT(KokkosBlas::nrm2(B) / nrmB, cg_handle->get_tol());
+    EXPECT_EQ(cg_handle->get_conv_flag_val(), CGHandle::Flag::Conv);
+    iters[usePrec] = cg_handle->get_num_iters();
+  }
+  EXPECT_LT(iters[1], iters[0]);
+
+  // A zero right-hand side gives the zero solution without iterating.
+  cg_handle->reset_handle(500, tol);
+  Kokkos::deep_copy(B, 0.0);
+  Kokkos::deep_copy(X, 1.0);
+  KokkosSparse::Experimental::cg(&kh, A, B, X);
+  EXPECT_EQ(KokkosBlas::nrm2(X), float_t(0));
+  EXPECT_EQ(cg_handle->get_conv_flag_val(), CGHandle::Flag::Conv);
+}
+
+}  // namespace Test
+
+template <typename scalar_t, typename lno_t, typename size_type,
+          typename device>
+void test_cg() {
+  Test::run_test_cg<scalar_t, lno_t, size_type, device>();
+}
+
+#define KOKKOSKERNELS_EXECUTE_TEST(SCALAR, ORDINAL, OFFSET, DEVICE)    \
+  TEST_F(TestCategory,                                                 \
+         sparse##_##cg##_##SCALAR##_##ORDINAL##_##OFFSET##_##DEVICE) { \
+    test_cg<SCALAR, ORDINAL, OFFSET, DEVICE>();                        \
+  }
+
+#include <Test_Common_Test_All_Type_Combos.hpp>
+
+#undef KOKKOSKERNELS_EXECUTE_TEST
@@ -21,6 +21,7 @@
 
 #include <string>
 #include <stdexcept>
+#include <type_traits>
 
 #include "KokkosSparse_CrsMatrix.hpp"
 #include "KokkosKernels_IOUtils.hpp"
@@ -131,6 +132,85 @@ void run_test_gmres() {
     EXPECT_EQ(conv_flag, GMRESHandle::Flag::Conv);
   }
 
+  // Test s-step
+  {
+    gmres_handle->reset_handle(m, tol);
+    gmres_handle->set_ortho(GMRESHandle::Ortho::SStep);
+    gmres_handle->set_s_step(4);
+    gmres_handle->set_verbose(verbose);
+
+    // reset X for next gmres call
+    Kokkos::deep_copy(X, 0.0);
+
+    gmres(&kh, A, B, X);
+
+    // Double check residuals at end of solve:
+    float_t nrmB = KokkosBlas::nrm2(B);
+    KokkosSparse::spmv("N", 1.0, A, X, 0.0, Wj);  // wj = Ax
+    KokkosBlas::axpy(-1.0, Wj, B);                // b = b-Ax.
+    float_t endRes = KokkosBlas::nrm2(B) / nrmB;
+
+    const auto conv_flag = gmres_handle->get_conv_flag_val();
+
+    EXPECT_LT(endRes, gmres_handle->get_tol());
+    EXPECT_EQ(conv_flag, GMRESHandle::Flag::Conv);
+    // The well-conditioned blocks go through CholQR2
+    EXPECT_GT(gmres_handle->get_num_sstep_blocks(), 0);
+  }
+
+  // Test s-step on the identity: the Krylov basis of a block is rank
+  // deficient, so CholQR2 fails and the column falls back to CGS2
+  {
+    auto I = KokkosSparse::Impl::kk_generate_diag_matrix<sp_matrix_type>(n);
+    Kokkos::deep_copy(I.values, 1.0);
+    gmres_handle->reset_handle(m, tol);
+    gmres_handle->set_ortho(GMRESHandle::Ortho::SStep);
+    gmres_handle->set_s_step(4);
+    gmres_handle->set_verbose(verbose);
+
+    ViewVectorType Bi("Bi", n);
+    Kokkos::deep_copy(Bi, 1.0);
+    Kokkos::deep_copy(X, 0.0);
+
+    gmres(&kh, I, Bi, X);
+
+    KokkosBlas::axpy(-1.0, X, Bi);  // b = b-Ix.
+    EXPECT_LT(KokkosBlas::nrm2(Bi) / Kokkos::sqrt(float_t(n)),
+              gmres_handle->get_tol());
+    EXPECT_EQ(gmres_handle->get_conv_flag_val(), GMRESHandle::Flag::Conv);
+    EXPECT_GT(gmres_handle->get_num_sstep_fallbacks(), 0);
+    EXPECT_EQ(gmres_handle->get_num_sstep_blocks(), 0);
+  }
+
+  // Test mixed precision
+  {
+    gmres_handle->reset_handle(m, tol);
+    gmres_handle->set_precision(GMRESHandle::Precision::Mixed);
+    gmres_handle->set_verbose(verbose);
+
+    // reset X for next gmres call
+    Kokkos::deep_copy(X, 0.0);
+
+    // Only double and complex double have a lower precision
+    if constexpr (!std::is_same<float_t, double>::value) {
+      EXPECT_THROW(gmres(&kh, A, B, X), std::invalid_argument);
+      gmres_handle->set_precision(GMRESHandle::Precision::Working);
+    }
+
+    gmres(&kh, A, B, X);
+
+    // Double check residuals at end of solve:
+    float_t nrmB = KokkosBlas::nrm2(B);
+    KokkosSparse::spmv("N", 1.0, A, X, 0.0, Wj);  // wj = Ax
+    KokkosBlas::axpy(-1.0, Wj, B);                // b = b-Ax.
+    float_t endRes = KokkosBlas::nrm2(B) / nrmB;
+
+    const auto conv_flag = gmres_handle->get_conv_flag_val();
+
+    EXPECT_LT(endRes, gmres_handle->get_tol());
+    EXPECT_EQ(conv_flag, GMRESHandle::Flag::Conv);
+  }
+
   // Test GSS2 with simple preconditioner
   {
     gmres_handle->reset_handle(m, tol);
@@ -257,6 +257,92 @@ void test_spadd_known_columns() {
   ASSERT_EQ(A.nnz(), C.nnz());
 }
 
+// Test the n-ary add C = sum_k alpha_k A_k against a dense sum on the host,
+// then reuse its symbolic phase with new coefficients and values.
+template <typename scalar_t, typename lno_t, typename size_type, class Device>
+void test_spadd_nary(int numInputs, lno_t numRows, lno_t numCols,
+                     size_type minNNZ, size_type maxNNZ, bool sortRows) {
+  using crsMat_t = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device,
+                                                    void, size_type>;
+  using KAT      = Kokkos::ArithTraits<scalar_t>;
+  using magnitude_t = typename KAT::mag_type;
+  using KernelHandle =
+      typename KokkosKernels::Experimental::KokkosKernelsHandle<
+          size_type, lno_t, scalar_t, typename Device::execution_space,
+          typename Device::memory_space, typename Device::memory_space>;
+
+  srand((numRows << 1) ^ numCols ^ numInputs);
+  std::vector<crsMat_t> A;
+  for (int k = 0; k < numInputs; k++)
+    A.push_back(randomMatrix<crsMat_t, lno_t>(numRows, numCols, minNNZ,
+                                              maxNNZ, sortRows));
+
+  KernelHandle handle;
+  handle.create_spadd_handle(sortRows);
+  crsMat_t C;
+  KokkosSparse::spadd_symbolic(&handle, A, C);
+
+  for (int pass = 0; pass < 2; pass++) {
+    std::vector<scalar_t> alpha;
+    for (int k = 0; k < numInputs; k++)
+      alpha.push_back(KAT::one() * magnitude_t(k + 1 + pass));
+    if (pass) {
+      for (auto& Ak : A) {
+        auto values = Kokkos::create_mirror_view(Ak.values);
+        for (size_t i = 0; i < values.extent(0); i++)
+          values(i) = KAT::one() * magnitude_t(rand() % 100);
+        Kokkos::deep_copy(Ak.values, values);
+      }
+    }
+    KokkosSparse::spadd_numeric(&handle, alpha, A, C);
+
+    auto Crowmap = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                       C.graph.row_map);
+    auto Centries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                        C.graph.entries);
+    auto Cvalues =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), C.values);
+    std::vector<std::vector<scalar_t>> correct(
+        numRows, std::vector<scalar_t>(numCols, KAT::zero()));
+    std::vector<std::vector<bool>> nonzeros(numRows,
+                                            std::vector<bool>(numCols, false));
+    for (int k = 0; k < numInputs; k++) {
+      auto rowmap = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                        A[k].graph.row_map);
+      auto entries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                         A[k].graph.entries);
+      auto values =
+          Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), A[k].values);
+      for (lno_t row = 0; row < numRows; row++) {
+        for (size_type i = rowmap(row); i < rowmap(row + 1); i++) {
+          correct[row][entries(i)] += alpha[k] * values(i);
+          nonzeros[row][entries(i)] = true;
+        }
+      }
+    }
+    for (lno_t row = 0; row < numRows; row++) {
+      size_type nz = std::count(nonzeros[row].begin(), nonzeros[row].end(),
+                                true);
+      ASSERT_EQ(Crowmap(row + 1) - Crowmap(row), nz)
+          << "sum row " << row << ", pass " << pass;
+      for (size_type i = Crowmap(row); i < Crowmap(row + 1); i++) {
+        if (i > Crowmap(row)) {
+          ASSERT_LT(Centries(i - 1), Centries(i))
+              << "C row " << row << " is not sorted";
+        }
+        lno_t Ccol = Centries(i);
+        ASSERT_TRUE(nonzeros[row][Ccol]);
+        magnitude_t maxError =
+            KAT::abs(KAT::one() * magnitude_t(numInputs) * KAT::epsilon() *
+                     (KAT::abs(correct[row][Ccol]) + KAT::one()));
+        ASSERT_LE(KAT::abs(correct[row][Ccol] - Cvalues(i)), maxError)
+            << "sum row " << row << ", column " << Ccol << ", pass " << pass;
+      }
+    }
+  }
+  handle.destroy_spadd_handle();
+}
+
 #define KOKKOSKERNELS_EXECUTE_TEST(SCALAR, ORDINAL, OFFSET, DEVICE)                   \
   TEST_F(                                                                             \
       TestCategory,                                                                   \
@@ -266,6 +352,8 @@ void test_spadd_known_columns() {
     test_spadd<SCALAR, ORDINAL, OFFSET, DEVICE>(100, 100, 50, 100, true);             \
     test_spadd<SCALAR, ORDINAL, OFFSET, DEVICE>(50, 50, 75, 100, true);               \
     test_spadd_known_columns<SCALAR, ORDINAL, OFFSET, DEVICE>();                      \
+    test_spadd_nary<SCALAR, ORDINAL, OFFSET, DEVICE>(4, 100, 100, 10, 40, true);      \
+    test_spadd_nary<SCALAR, ORDINAL, OFFSET, DEVICE>(1, 10, 10, 0, 2, true);          \
   }                                                                                   \
   TEST_F(                                                                             \
       TestCategory,                                                                   \
@@ -274,6 +362,8 @@ void test_spadd_known_columns() {
     test_spadd<SCALAR, ORDINAL, OFFSET, DEVICE>(10, 10, 0, 2, false);                 \
     test_spadd<SCALAR, ORDINAL, OFFSET, DEVICE>(100, 100, 50, 100, false);            \
     test_spadd<SCALAR, ORDINAL, OFFSET, DEVICE>(50, 50, 75, 100, false);              \
+    test_spadd_nary<SCALAR, ORDINAL, OFFSET, DEVICE>(4, 100, 100, 10, 40, false);     \
+    test_spadd_nary<SCALAR, ORDINAL, OFFSET, DEVICE>(3, 50, 50, 75, 100, false);      \
   }
 
 #include <Test_Common_Test_All_Type_Combos.hpp>
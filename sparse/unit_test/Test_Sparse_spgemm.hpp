@@ -23,8 +23,13 @@
 #include "Test_Sparse_Utils.hpp"
 #include <string>
 #include <stdexcept>
+#include <vector>
+#include <algorithm>
 
 #include "KokkosSparse_spgemm.hpp"
+#include "KokkosSparse_spgemm_triple.hpp"
+#include "KokkosSparse_spgemm_masked.hpp"
+#include "KokkosSparse_spgemm_chunked.hpp"
 #include "KokkosSparse_CrsMatrix.hpp"
 
 #include <gtest/gtest.h>
@@ -468,6 +473,354 @@ void test_issue402() {
       << "SpGEMM still has issue 402 bug; C=AA' is incorrect!\n";
 }
 
+// Multiply in row blocks under a memory budget of about a quarter of C, check
+// that the blocks tile the rows of C, and compare the concatenated product
+// against a plain SpGEMM.
+template <typename scalar_t, typename lno_t, typename size_type,
+          typename device>
+void test_spgemm_chunked(lno_t m, lno_t k, lno_t n, size_type nnz,
+                         lno_t bandwidth, lno_t row_size_variance) {
+#if defined(KOKKOSKERNELS_ENABLE_TPL_ARMPL)
+  {
+    std::cerr
+        << "TEST SKIPPED: See "
+           "https://github.com/kokkos/kokkos-kernels/issues/1542 for details."
+        << std::endl;
+    return;
+  }
+#endif  // KOKKOSKERNELS_ENABLE_TPL_ARMPL
+  using namespace Test;
+  typedef CrsMatrix<scalar_t, lno_t, device, void, size_type> crsMat_t;
+  typedef KokkosKernels::Experimental::KokkosKernelsHandle<
+      size_type, lno_t, scalar_t, typename device::execution_space,
+      typename device::memory_space, typename device::memory_space>
+      KernelHandle;
+
+  crsMat_t A = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      m, k, nnz, row_size_variance, bandwidth);
+  crsMat_t B = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      k, n, nnz, row_size_variance, bandwidth);
+  crsMat_t Cgold = KokkosSparse::spgemm<crsMat_t>(A, false, B, false);
+  KokkosSparse::sort_crs_matrix(Cgold);
+
+  const size_t c_bytes = Cgold.nnz() * (sizeof(lno_t) + sizeof(scalar_t)) +
+                         (m + 1) * 2 * sizeof(size_type);
+  KernelHandle kh;
+  kh.create_spgemm_handle(SPGEMM_KK);
+  kh.get_spgemm_handle()->set_memory_budget(c_bytes / 4);
+
+  size_t num_blocks = 0, next_row = 0;
+  KokkosSparse::spgemm_chunked<crsMat_t>(
+      kh, A, B, [&](const size_t first, const crsMat_t &Cblock) {
+        EXPECT_EQ(first, next_row);
+        EXPECT_LE(Cblock.nnz() * (sizeof(lno_t) + sizeof(scalar_t)),
+                  c_bytes / 4);
+        next_row += Cblock.numRows();
+        num_blocks++;
+      });
+  EXPECT_EQ(next_row, size_t(m));
+  EXPECT_GT(num_blocks, size_t(1));
+
+  crsMat_t C = KokkosSparse::spgemm_chunked<crsMat_t>(kh, A, B);
+  EXPECT_TRUE((is_same_matrix<crsMat_t, device>(C, Cgold)));
+  // The products ran on handles of their own
+  EXPECT_FALSE(kh.get_spgemm_handle()->is_symbolic_called());
+
+  // Not even one row fits
+  kh.get_spgemm_handle()->set_memory_budget(1);
+  EXPECT_THROW(KokkosSparse::spgemm_chunked<crsMat_t>(kh, A, B),
+               std::runtime_error);
+  kh.destroy_spgemm_handle();
+}
+
+// Compare the row-binned numeric phase, with each accumulator type, against
+// the debug SpGEMM. A wide spread of row lengths fills several bins.
+template <typename scalar_t, typename lno_t, typename size_type,
+          typename device>
+void test_spgemm_row_binning(lno_t m, lno_t k, lno_t n, size_type nnz,
+                             lno_t bandwidth, lno_t row_size_variance) {
+#if defined(KOKKOSKERNELS_ENABLE_TPL_ARMPL)
+  {
+    std::cerr
+        << "TEST SKIPPED: See "
+           "https://github.com/kokkos/kokkos-kernels/issues/1542 for details."
+        << std::endl;
+    return;
+  }
+#endif  // KOKKOSKERNELS_ENABLE_TPL_ARMPL
+  using namespace Test;
+  typedef CrsMatrix<scalar_t, lno_t, device, void, size_type> crsMat_t;
+  typedef KokkosKernels::Experimental::KokkosKernelsHandle<
+      size_type, lno_t, scalar_t, typename device::execution_space,
+      typename device::memory_space, typename device::memory_space>
+      KernelHandle;
+
+  crsMat_t A = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      m, k, nnz, row_size_variance, bandwidth);
+  crsMat_t B = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      k, n, nnz, row_size_variance, bandwidth);
+
+  for (auto accumulator :
+       {SPGEMM_ACC_DEFAULT, SPGEMM_ACC_DENSE, SPGEMM_ACC_SPARSE}) {
+    KernelHandle kh;
+    kh.create_spgemm_handle(SPGEMM_KK);
+    kh.get_spgemm_handle()->set_accumulator_type(accumulator);
+    kh.get_spgemm_handle()->set_row_binning(true);
+
+    crsMat_t C, Cgold;
+    KokkosSparse::spgemm_symbolic(kh, A, false, B, false, C);
+    KokkosSparse::spgemm_numeric(kh, A, false, B, false, C);
+    EXPECT_TRUE(kh.get_spgemm_handle()->are_row_bins_computed());
+    run_spgemm<crsMat_t, device>(A, B, SPGEMM_DEBUG, Cgold, false);
+    EXPECT_TRUE((is_same_matrix<crsMat_t, device>(C, Cgold)))
+        << "accumulator " << int(accumulator);
+
+    // The bins are reused with the new values
+    randomize_matrix_values(A.values);
+    randomize_matrix_values(B.values);
+    KokkosSparse::spgemm_numeric(kh, A, false, B, false, C);
+    run_spgemm<crsMat_t, device>(A, B, SPGEMM_DEBUG, Cgold, false);
+    EXPECT_TRUE((is_same_matrix<crsMat_t, device>(C, Cgold)))
+        << "reuse, accumulator " << int(accumulator);
+    kh.destroy_spgemm_handle();
+  }
+}
+
+// Record the contribution map in the first numeric phase, gather through it
+// in the next ones, and drop it when the symbolic phase runs again.
+template <typename scalar_t, typename lno_t, typename size_type,
+          typename device>
+void test_spgemm_reuse_map(lno_t m, lno_t k, lno_t n, size_type nnz,
+                           lno_t bandwidth, lno_t row_size_variance) {
+#if defined(KOKKOSKERNELS_ENABLE_TPL_ARMPL)
+  {
+    std::cerr
+        << "TEST SKIPPED: See "
+           "https://github.com/kokkos/kokkos-kernels/issues/1542 for details."
+        << std::endl;
+    return;
+  }
+#endif  // KOKKOSKERNELS_ENABLE_TPL_ARMPL
+  using namespace Test;
+  typedef CrsMatrix<scalar_t, lno_t, device, void, size_type> crsMat_t;
+  typedef KokkosKernels::Experimental::KokkosKernelsHandle<
+      size_type, lno_t, scalar_t, typename device::execution_space,
+      typename device::memory_space, typename device::memory_space>
+      KernelHandle;
+
+  crsMat_t A = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      m, k, nnz, row_size_variance, bandwidth);
+  crsMat_t B = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      k, n, nnz, row_size_variance, bandwidth);
+
+  for (auto algorithm : {SPGEMM_KK, SPGEMM_KK_LP, SPGEMM_DEBUG}) {
+    KernelHandle kh;
+    kh.create_spgemm_handle(algorithm);
+    auto sh = kh.get_spgemm_handle();
+    sh->set_numeric_reuse_map(true);
+
+    crsMat_t C, Cgold;
+    KokkosSparse::spgemm_symbolic(kh, A, false, B, false, C);
+    KokkosSparse::spgemm_numeric(kh, A, false, B, false, C);
+    EXPECT_TRUE(sh->is_reuse_map_computed());
+    EXPECT_EQ(sh->reuse_map_rowmap.extent(0), size_t(m) + 1);
+    run_spgemm<crsMat_t, device>(A, B, SPGEMM_DEBUG, Cgold, false);
+    EXPECT_TRUE((is_same_matrix<crsMat_t, device>(C, Cgold)))
+        << "algorithm " << int(algorithm);
+
+    for (int iter = 0; iter < 2; ++iter) {
+      randomize_matrix_values(A.values);
+      randomize_matrix_values(B.values);
+      KokkosSparse::spgemm_numeric(kh, A, false, B, false, C);
+      run_spgemm<crsMat_t, device>(A, B, SPGEMM_DEBUG, Cgold, false);
+      EXPECT_TRUE((is_same_matrix<crsMat_t, device>(C, Cgold)))
+          << "gather " << iter << ", algorithm " << int(algorithm);
+    }
+
+    sh->set_call_symbolic();
+    EXPECT_FALSE(sh->is_reuse_map_computed());
+    kh.destroy_spgemm_handle();
+  }
+}
+
+// Compare spgemm_triple and spgemm_ptap against two plain SpGEMMs, then
+// change the values of A and P and check the reused symbolic phase.
+template <typename scalar_t, typename lno_t, typename size_type,
+          typename device>
+void test_spgemm_triple(lno_t m, lno_t k, lno_t n, size_type nnz,
+                        lno_t bandwidth, lno_t row_size_variance) {
+#if defined(KOKKOSKERNELS_ENABLE_TPL_ARMPL)
+  {
+    std::cerr
+        << "TEST SKIPPED: See "
+           "https://github.com/kokkos/kokkos-kernels/issues/1542 for details."
+        << std::endl;
+    return;
+  }
+#endif  // KOKKOSKERNELS_ENABLE_TPL_ARMPL
+  using namespace Test;
+  typedef CrsMatrix<scalar_t, lno_t, device, void, size_type> crsMat_t;
+  typedef KokkosKernels::Experimental::KokkosKernelsHandle<
+      size_type, lno_t, scalar_t, typename device::execution_space,
+      typename device::memory_space, typename device::memory_space>
+      KernelHandle;
+
+  crsMat_t R = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      m, k, nnz, row_size_variance, bandwidth);
+  crsMat_t A = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      k, k, nnz, row_size_variance, bandwidth);
+  crsMat_t P = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      k, n, nnz, row_size_variance, bandwidth);
+
+  auto reference = [](const crsMat_t &X, const crsMat_t &Y,
+                      const crsMat_t &Z) {
+    crsMat_t XY  = KokkosSparse::spgemm<crsMat_t>(X, false, Y, false);
+    crsMat_t XYZ = KokkosSparse::spgemm<crsMat_t>(XY, false, Z, false);
+    KokkosSparse::sort_crs_matrix(XYZ);
+    return XYZ;
+  };
+
+  for (auto spgemm_algorithm : {SPGEMM_KK, SPGEMM_KK_MEMORY, SPGEMM_KK_SPEED}) {
+    KernelHandle kh;
+    kh.create_spgemm_handle(spgemm_algorithm);
+
+    crsMat_t C;
+    KokkosSparse::spgemm_triple_symbolic(kh, R, A, P, C);
+    KokkosSparse::spgemm_triple_numeric(kh, R, A, P, C);
+    EXPECT_TRUE((is_same_matrix<crsMat_t, device>(C, reference(R, A, P))))
+        << "RAP, algorithm " << int(spgemm_algorithm);
+
+    randomize_matrix_values(A.values);
+    randomize_matrix_values(P.values);
+    KokkosSparse::spgemm_triple_numeric(kh, R, A, P, C);
+    EXPECT_TRUE((is_same_matrix<crsMat_t, device>(C, reference(R, A, P))))
+        << "RAP reuse, algorithm " << int(spgemm_algorithm);
+    kh.destroy_spgemm_handle();
+
+    kh.create_spgemm_handle(spgemm_algorithm);
+    crsMat_t Pt = KokkosSparse::Impl::transpose_matrix(P);
+    KokkosSparse::spgemm_ptap_symbolic(kh, A, P, C);
+    KokkosSparse::spgemm_ptap_numeric(kh, A, P, C);
+    EXPECT_TRUE((is_same_matrix<crsMat_t, device>(C, reference(Pt, A, P))))
+        << "PtAP, algorithm " << int(spgemm_algorithm);
+
+    randomize_matrix_values(A.values);
+    randomize_matrix_values(P.values);
+    Pt = KokkosSparse::Impl::transpose_matrix(P);
+    KokkosSparse::spgemm_ptap_numeric(kh, A, P, C);
+    EXPECT_TRUE((is_same_matrix<crsMat_t, device>(C, reference(Pt, A, P))))
+        << "PtAP reuse, algorithm " << int(spgemm_algorithm);
+    kh.destroy_spgemm_handle();
+  }
+
+  crsMat_t C = KokkosSparse::spgemm_triple<crsMat_t>(R, A, P);
+  EXPECT_TRUE((is_same_matrix<crsMat_t, device>(C, reference(R, A, P))));
+}
+
+// Compare masked_spgemm with both mask modes against A*B filtered on the
+// host, then change the values of A and B and check the reused symbolic
+// phase.
+template <typename scalar_t, typename lno_t, typename size_type,
+          typename device>
+void test_spgemm_masked(lno_t m, lno_t k, lno_t n, size_type nnz,
+                        lno_t bandwidth, lno_t row_size_variance) {
+#if defined(KOKKOSKERNELS_ENABLE_TPL_ARMPL)
+  {
+    std::cerr
+        << "TEST SKIPPED: See "
+           "https://github.com/kokkos/kokkos-kernels/issues/1542 for details."
+        << std::endl;
+    return;
+  }
+#endif  // KOKKOSKERNELS_ENABLE_TPL_ARMPL
+  using namespace Test;
+  typedef CrsMatrix<scalar_t, lno_t, device, void, size_type> crsMat_t;
+  typedef typename crsMat_t::row_map_type::non_const_type lno_view_t;
+  typedef typename crsMat_t::index_type::non_const_type lno_nnz_view_t;
+  typedef typename crsMat_t::values_type::non_const_type scalar_view_t;
+  typedef KokkosKernels::Experimental::KokkosKernelsHandle<
+      size_type, lno_t, scalar_t, typename device::execution_space,
+      typename device::memory_space, typename device::memory_space>
+      KernelHandle;
+
+  crsMat_t A = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      m, k, nnz, row_size_variance, bandwidth);
+  crsMat_t B = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      k, n, nnz, row_size_variance, bandwidth);
+  crsMat_t M = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      m, n, nnz, row_size_variance, bandwidth);
+  KokkosSparse::sort_crs_matrix(M);
+
+  auto reference = [&](const bool complement) {
+    crsMat_t AB = KokkosSparse::spgemm<crsMat_t>(A, false, B, false);
+    KokkosSparse::sort_crs_matrix(AB);
+    auto ABrowmap = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                        AB.graph.row_map);
+    auto ABentries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                         AB.graph.entries);
+    auto ABvalues =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), AB.values);
+    auto Mrowmap = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                       M.graph.row_map);
+    auto Mentries = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                        M.graph.entries);
+    std::vector<size_type> rowmap(m + 1, 0);
+    std::vector<lno_t> entries;
+    std::vector<scalar_t> values;
+    for (lno_t i = 0; i < m; i++) {
+      const lno_t *mbegin = Mentries.data() + Mrowmap(i);
+      const lno_t *mend   = Mentries.data() + Mrowmap(i + 1);
+      for (size_type p = ABrowmap(i); p < ABrowmap(i + 1); p++) {
+        if (std::binary_search(mbegin, mend, ABentries(p)) == complement)
+          continue;
+        entries.push_back(ABentries(p));
+        values.push_back(ABvalues(p));
+      }
+      rowmap[i + 1] = entries.size();
+    }
+    lno_view_t Crowmap("C rowmap", m + 1);
+    lno_nnz_view_t Centries("C entries", entries.size());
+    scalar_view_t Cvalues("C values", values.size());
+    auto Crowmap_h  = Kokkos::create_mirror_view(Crowmap);
+    auto Centries_h = Kokkos::create_mirror_view(Centries);
+    auto Cvalues_h  = Kokkos::create_mirror_view(Cvalues);
+    for (lno_t i = 0; i <= m; i++) Crowmap_h(i) = rowmap[i];
+    for (size_t p = 0; p < entries.size(); p++) {
+      Centries_h(p) = entries[p];
+      Cvalues_h(p)  = values[p];
+    }
+    Kokkos::deep_copy(Crowmap, Crowmap_h);
+    Kokkos::deep_copy(Centries, Centries_h);
+    Kokkos::deep_copy(Cvalues, Cvalues_h);
+    return crsMat_t("C", m, n, entries.size(), Cvalues, Crowmap, Centries);
+  };
+
+  for (auto spgemm_algorithm : {SPGEMM_KK, SPGEMM_KK_MEMORY, SPGEMM_KK_SPEED}) {
+    for (bool complement : {false, true}) {
+      KernelHandle kh;
+      kh.create_spgemm_handle(spgemm_algorithm);
+
+      crsMat_t C;
+      KokkosSparse::masked_spgemm_symbolic(kh, A, B, M, complement, C);
+      KokkosSparse::masked_spgemm_numeric(kh, A, B, C);
+      EXPECT_TRUE((is_same_matrix<crsMat_t, device>(C, reference(complement))))
+          << "algorithm " << int(spgemm_algorithm) << ", complement "
+          << complement;
+
+      randomize_matrix_values(A.values);
+      randomize_matrix_values(B.values);
+      KokkosSparse::masked_spgemm_numeric(kh, A, B, C);
+      EXPECT_TRUE((is_same_matrix<crsMat_t, device>(C, reference(complement))))
+          << "reuse, algorithm " << int(spgemm_algorithm) << ", complement "
+          << complement;
+      kh.destroy_spgemm_handle();
+    }
+  }
+
+  crsMat_t C = KokkosSparse::masked_spgemm<crsMat_t>(A, B, M);
+  EXPECT_TRUE((is_same_matrix<crsMat_t, device>(C, reference(false))));
+}
+
 #define KOKKOSKERNELS_EXECUTE_TEST(SCALAR, ORDINAL, OFFSET, DEVICE)            \
   TEST_F(TestCategory,                                                         \
          sparse##_##spgemm##_##SCALAR##_##ORDINAL##_##OFFSET##_##DEVICE) {     \
@@ -513,6 +866,16 @@ void test_issue402() {
     test_spgemm_symbolic<SCALAR, ORDINAL, OFFSET, DEVICE>(true, false);        \
     test_spgemm_symbolic<SCALAR, ORDINAL, OFFSET, DEVICE>(false, false);       \
     test_issue402<SCALAR, ORDINAL, OFFSET, DEVICE>();                          \
+    test_spgemm_chunked<SCALAR, ORDINAL, OFFSET, DEVICE>(1000, 800, 600,       \
+                                                         800 * 10, 100, 5);    \
+    test_spgemm_row_binning<SCALAR, ORDINAL, OFFSET, DEVICE>(                  \
+        2000, 1500, 1000, 1500 * 20, 500, 40);                                 \
+    test_spgemm_reuse_map<SCALAR, ORDINAL, OFFSET, DEVICE>(                    \
+        1000, 800, 600, 800 * 10, 100, 5);                                     \
+    test_spgemm_triple<SCALAR, ORDINAL, OFFSET, DEVICE>(800, 1000, 300,        \
+                                                        1000 * 10, 100, 5);    \
+    test_spgemm_masked<SCALAR, ORDINAL, OFFSET, DEVICE>(800, 1000, 300,        \
+                                                        1000 * 10, 100, 5);    \
   }
 
 // test_spgemm<SCALAR,ORDINAL,OFFSET,DEVICE>(50000, 50000 * 30, 100, 10);
@@ -26,6 +26,7 @@
 #include "KokkosBlas1_nrm2.hpp"
 #include "KokkosSparse_spmv.hpp"
 #include "KokkosSparse_spiluk.hpp"
+#include "KokkosSparse_sptrsv.hpp"
 
 #include <gtest/gtest.h>
 
@@ -260,6 +261,179 @@ void run_test_spiluk() {
 
     kh.destroy_spiluk_handle();
   }
+
+  // SPILUKAlgorithm::FIXED_POINT
+  {
+    kh.create_spiluk_handle(SPILUKAlgorithm::FIXED_POINT, nrows, 4 * nrows,
+                            4 * nrows);
+
+    auto spiluk_handle = kh.get_spiluk_handle();
+    // Enough sweeps for the fixed point to converge on this small matrix
+    spiluk_handle->set_num_sweeps(20);
+
+    // Allocate L and U as outputs
+    RowMapType L_row_map("L_row_map", nrows + 1);
+    EntriesType L_entries("L_entries", spiluk_handle->get_nnzL());
+    ValuesType L_values("L_values", spiluk_handle->get_nnzL());
+    RowMapType U_row_map("U_row_map", nrows + 1);
+    EntriesType U_entries("U_entries", spiluk_handle->get_nnzU());
+    ValuesType U_values("U_values", spiluk_handle->get_nnzU());
+
+    typename KernelHandle::const_nnz_lno_t fill_lev = 2;
+
+    spiluk_symbolic(&kh, fill_lev, row_map, entries, L_row_map, L_entries,
+                    U_row_map, U_entries);
+
+    Kokkos::fence();
+
+    Kokkos::resize(L_entries, spiluk_handle->get_nnzL());
+    Kokkos::resize(L_values, spiluk_handle->get_nnzL());
+    Kokkos::resize(U_entries, spiluk_handle->get_nnzU());
+    Kokkos::resize(U_values, spiluk_handle->get_nnzU());
+
+    spiluk_handle->print_algorithm();
+    spiluk_numeric(&kh, fill_lev, row_map, entries, values, L_row_map,
+                   L_entries, L_values, U_row_map, U_entries, U_values);
+
+    Kokkos::fence();
+
+    // Checking
+    typedef CrsMatrix<scalar_t, lno_t, device, void, size_type> crsMat_t;
+    crsMat_t A("A_Mtx", nrows, nrows, nnz, values, row_map, entries);
+    crsMat_t L("L_Mtx", nrows, nrows, spiluk_handle->get_nnzL(), L_values,
+               L_row_map, L_entries);
+    crsMat_t U("U_Mtx", nrows, nrows, spiluk_handle->get_nnzU(), U_values,
+               U_row_map, U_entries);
+
+    // Create a reference view e set to all 1's
+    ValuesType e_one("e_one", nrows);
+    Kokkos::deep_copy(e_one, 1.0);
+
+    // Create two views for spmv results
+    ValuesType bb("bb", nrows);
+    ValuesType bb_tmp("bb_tmp", nrows);
+
+    // Compute norm2(L*U*e_one - A*e_one)/norm2(A*e_one)
+    KokkosSparse::spmv("N", ONE, A, e_one, ZERO, bb);
+
+    typename AT::mag_type bb_nrm = KokkosBlas::nrm2(bb);
+
+    KokkosSparse::spmv("N", ONE, U, e_one, ZERO, bb_tmp);
+    KokkosSparse::spmv("N", ONE, L, bb_tmp, MONE, bb);
+
+    typename AT::mag_type diff_nrm = KokkosBlas::nrm2(bb);
+
+    EXPECT_TRUE((diff_nrm / bb_nrm) < 1e-4);
+
+    kh.destroy_spiluk_handle();
+  }
+
+  // Block ILU(k) of the matrix with 2x2 blocks, followed by the block
+  // triangular solves: with full fill the factorization is exact
+  for (auto algm :
+       {SPILUKAlgorithm::SEQLVLSCHD_RP, SPILUKAlgorithm::SEQLVLSCHD_TP1}) {
+    const size_type bs = 2;
+    ValuesType block_values("block_values", nnz * bs * bs);
+    ValuesType rhs("rhs", nrows * bs);
+    auto hblock_values = Kokkos::create_mirror_view(block_values);
+    auto hrhs          = Kokkos::create_mirror_view(rhs);
+    // rhs = A * ones
+    Kokkos::deep_copy(hrhs, ZERO);
+    for (size_type i = 0; i < nrows; ++i) {
+      for (size_type k = hrow_map(i); k < hrow_map(i + 1); ++k) {
+        for (size_type r = 0; r < bs; ++r) {
+          for (size_type c = 0; c < bs; ++c) {
+            scalar_t v = hvalues(k) * scalar_t(r == c ? 1.0 : 0.1 + 0.1 * r);
+            if (r == c && size_type(hentries(k)) == i) v += ONE;
+            hblock_values(k * bs * bs + r * bs + c) = v;
+            hrhs(i * bs + r) += v;
+          }
+        }
+      }
+    }
+    Kokkos::deep_copy(block_values, hblock_values);
+    Kokkos::deep_copy(rhs, hrhs);
+
+    kh.create_spiluk_handle(algm, nrows, nrows * nrows, nrows * nrows);
+    auto spiluk_handle = kh.get_spiluk_handle();
+    spiluk_handle->set_block_size(bs);
+
+    RowMapType L_row_map("L_row_map", nrows + 1);
+    EntriesType L_entries("L_entries", spiluk_handle->get_nnzL());
+    RowMapType U_row_map("U_row_map", nrows + 1);
+    EntriesType U_entries("U_entries", spiluk_handle->get_nnzU());
+
+    typename KernelHandle::const_nnz_lno_t fill_lev = nrows;
+
+    spiluk_symbolic(&kh, fill_lev, row_map, entries, L_row_map, L_entries,
+                    U_row_map, U_entries);
+
+    Kokkos::fence();
+
+    ValuesType L_values("L_values", spiluk_handle->get_nnzL() * bs * bs);
+    ValuesType U_values("U_values", spiluk_handle->get_nnzU() * bs * bs);
+
+    spiluk_handle->print_algorithm();
+    spiluk_numeric(&kh, fill_lev, row_map, entries, block_values, L_row_map,
+                   L_entries, L_values, U_row_map, U_entries, U_values);
+
+    Kokkos::fence();
+
+    // Solve L U x = A * ones
+    ValuesType y("y", nrows * bs);
+    ValuesType x("x", nrows * bs);
+    {
+      KernelHandle khL;
+      khL.create_sptrsv_handle(SPTRSVAlgorithm::SEQLVLSCHD_RP, nrows, true);
+      khL.get_sptrsv_handle()->set_block_size(bs);
+      sptrsv_symbolic(&khL, L_row_map, L_entries);
+      sptrsv_solve(&khL, L_row_map, L_entries, L_values, rhs, y);
+      khL.destroy_sptrsv_handle();
+
+      KernelHandle khU;
+      khU.create_sptrsv_handle(SPTRSVAlgorithm::SEQLVLSCHD_RP, nrows, false);
+      khU.get_sptrsv_handle()->set_block_size(bs);
+      sptrsv_symbolic(&khU, U_row_map, U_entries);
+      sptrsv_solve(&khU, U_row_map, U_entries, U_values, y, x);
+      khU.destroy_sptrsv_handle();
+    }
+    Kokkos::fence();
+
+    auto hx = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), x);
+    for (size_type i = 0; i < nrows * bs; ++i)
+      EXPECT_LT(AT::abs(hx(i) - ONE), 1e-4);
+
+    // The pivots are shifted by the tiny of the handle: a zero matrix gets
+    // U = tiny I and finite factors
+    const auto tiny = spiluk_handle->get_block_pivot_tiny();
+    EXPECT_GT(tiny, 0);
+    Kokkos::deep_copy(block_values, ZERO);
+    spiluk_numeric(&kh, fill_lev, row_map, entries, block_values, L_row_map,
+                   L_entries, L_values, U_row_map, U_entries, U_values);
+    auto hU =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), U_values);
+    auto hUr =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), U_row_map);
+    auto hUe =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), U_entries);
+    for (size_type i = 0; i < nrows; ++i) {
+      for (size_type k = hUr(i); k < hUr(i + 1); ++k) {
+        for (size_type r = 0; r < bs; ++r) {
+          for (size_type c = 0; c < bs; ++c) {
+            const scalar_t expected =
+                (size_type(hUe(k)) == i && r == c) ? scalar_t(tiny) : ZERO;
+            EXPECT_EQ(hU((k * bs + r) * bs + c), expected);
+          }
+        }
+      }
+    }
+    auto hL =
+        Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), L_values);
+    for (size_type i = 0; i < hL.extent(0); ++i)
+      EXPECT_LE(AT::abs(hL(i)), AT::abs(ONE));
+
+    kh.destroy_spiluk_handle();
+  }
 }
 
 }  // namespace Test
@@ -18,6 +18,7 @@
 #include <Kokkos_Random.hpp>
 
 #include <KokkosSparse_spmv.hpp>
+#include <KokkosSparse_spmv_dot.hpp>
 #include <KokkosKernels_TestUtils.hpp>
 #include <KokkosKernels_Test_Structured_Matrix.hpp>
 #include <KokkosKernels_IOUtils.hpp>
@@ -941,6 +942,483 @@ void test_spmv_controls(lno_t numRows, size_type nnz, lno_t bandwidth,
                             max_error);
 }  // test_spmv_controls
 
+// check the fused spmv_dot and spmv_nrm2 against spmv followed by dot and nrm2
+template <typename scalar_t, typename lno_t, typename size_type, class Device>
+void test_spmv_dot(lno_t numRows, size_type nnz, lno_t bandwidth,
+                   lno_t row_size_variance) {
+  using crsMat_t = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device,
+                                                    void, size_type>;
+  using ExecSpace     = typename crsMat_t::execution_space;
+  using my_exec_space = Kokkos::RangePolicy<ExecSpace>;
+  using vector_type   = typename crsMat_t::values_type::non_const_type;
+  using mag_t         = typename Kokkos::ArithTraits<scalar_t>::mag_type;
+  using AT            = Kokkos::ArithTraits<scalar_t>;
+
+  constexpr mag_t max_x   = static_cast<mag_t>(1);
+  constexpr mag_t max_y   = static_cast<mag_t>(1);
+  constexpr mag_t max_val = static_cast<mag_t>(1);
+  const mag_t eps         = 10 * Kokkos::ArithTraits<mag_t>::eps();
+
+  // rectangular, so that the transposed modes change the vector lengths
+  const lno_t numCols = numRows + numRows / 3;
+  crsMat_t A = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      numRows, numCols, nnz, row_size_variance, bandwidth);
+  const lno_t max_nnz_per_row =
+      numRows ? (nnz / numRows + row_size_variance) : 0;
+
+  Kokkos::Random_XorShift64_Pool<ExecSpace> rand_pool(13718);
+  Kokkos::fill_random(A.values, rand_pool, randomUpperBound<scalar_t>(max_val));
+
+  // without "native", the fused kernels are replaced by a TPL if there is one
+  std::vector<KokkosKernels::Experimental::Controls> controls(3);
+  controls[1].setParameter("schedule", "dynamic");
+  controls[1].setParameter("team size", "2");
+  controls[2].setParameter("algorithm", "native");
+
+  std::vector<char> modes           = {'N', 'C', 'T', 'H'};
+  std::vector<double> testAlphaBeta = {0.0, 1.0, -1.0, 2.5};
+  for (auto mode : modes) {
+    const bool transpose = mode == 'T' || mode == 'H';
+    const lno_t xLen     = transpose ? numRows : numCols;
+    const lno_t yLen     = transpose ? numCols : numRows;
+    for (double alpha : testAlphaBeta) {
+      for (double beta : testAlphaBeta) {
+        const mag_t max_error = Kokkos::abs(beta) * max_y +
+                                Kokkos::abs(alpha) * max_nnz_per_row *
+                                    max_val * max_x;
+        for (const auto &c : controls) {
+          vector_type x("x", xLen), y("y", yLen), z("z", yLen),
+              expected_y("expected y", yLen);
+          Kokkos::fill_random(x, rand_pool,
+                              randomUpperBound<scalar_t>(max_x));
+          Kokkos::fill_random(y, rand_pool,
+                              randomUpperBound<scalar_t>(max_y));
+          Kokkos::fill_random(z, rand_pool, randomUpperBound<scalar_t>(1));
+          Kokkos::deep_copy(expected_y, y);
+          Test::sequential_spmv(A, x, expected_y, alpha, beta, mode);
+
+          const auto dot = KokkosSparse::spmv_dot(c, &mode, alpha, A, x, beta,
+                                                  y, z);
+          int num_errors = 0;
+          Kokkos::parallel_reduce(
+              "KokkosSparse::Test::spmv_dot", my_exec_space(0, yLen),
+              Test::fSPMV<vector_type, vector_type>(expected_y, y, eps,
+                                                    max_error),
+              num_errors);
+          EXPECT_EQ(num_errors, 0) << "spmv_dot, mode " << mode << ", alpha "
+                                   << alpha << ", beta " << beta;
+          // only the order of the summation differs from dot
+          const mag_t tol = yLen * eps * (1 + max_error);
+          EXPECT_LE(AT::abs(dot - KokkosBlas::dot(y, z)), tol)
+              << "spmv_dot, mode " << mode << ", alpha " << alpha
+              << ", beta " << beta;
+
+          Kokkos::fill_random(y, rand_pool,
+                              randomUpperBound<scalar_t>(max_y));
+          Kokkos::deep_copy(expected_y, y);
+          Test::sequential_spmv(A, x, expected_y, alpha, beta, mode);
+          const mag_t nrm =
+              KokkosSparse::spmv_nrm2(c, &mode, alpha, A, x, beta, y);
+          num_errors = 0;
+          Kokkos::parallel_reduce(
+              "KokkosSparse::Test::spmv_nrm2", my_exec_space(0, yLen),
+              Test::fSPMV<vector_type, vector_type>(expected_y, y, eps,
+                                                    max_error),
+              num_errors);
+          EXPECT_EQ(num_errors, 0) << "spmv_nrm2, mode " << mode
+                                   << ", alpha " << alpha << ", beta " << beta;
+          EXPECT_LE(Kokkos::abs(nrm - KokkosBlas::nrm2(y)), tol)
+              << "spmv_nrm2, mode " << mode << ", alpha " << alpha
+              << ", beta " << beta;
+        }
+      }
+    }
+  }
+
+  // the squares of these entries overflow, their norm does not
+  if (numRows > 0) {
+    const mag_t big = Kokkos::ArithTraits<mag_t>::max() / (4 * numRows);
+    vector_type x("x", numCols), y("y", numRows);
+    Kokkos::deep_copy(y, scalar_t(1));
+    char mode       = 'N';
+    const mag_t nrm = KokkosSparse::spmv_nrm2(controls[2], &mode, scalar_t(0),
+                                              A, x, scalar_t(big), y);
+    const mag_t expected = big * Kokkos::sqrt(mag_t(numRows));
+    EXPECT_LE(Kokkos::abs(nrm - expected), numRows * eps * expected);
+  }
+}  // test_spmv_dot
+
+// check the merge-path algorithm with few items per thread, so that most rows
+// are split between several threads, through the Controls interface and
+// through every SPMVHandle algorithm. Each handle is reused for all the
+// products, and analyzed again for a second matrix with a different graph.
+template <typename scalar_t, typename lno_t, typename size_type,
+          typename layout, class Device>
+void test_spmv_merge(lno_t numRows, size_type nnz, lno_t bandwidth,
+                     lno_t row_size_variance, int numMV) {
+  using crsMat_t = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device,
+                                                    void, size_type>;
+  using ExecSpace     = typename crsMat_t::execution_space;
+  using MemSpace      = typename crsMat_t::memory_space;
+  using my_exec_space = Kokkos::RangePolicy<ExecSpace>;
+  using vector_type   = typename crsMat_t::values_type::non_const_type;
+  using mv_type       = Kokkos::View<scalar_t **, layout, Device>;
+  using mag_t         = typename Kokkos::ArithTraits<scalar_t>::mag_type;
+  using handle_t =
+      KokkosSparse::Experimental::SPMVHandle<size_type, lno_t, ExecSpace,
+                                             MemSpace>;
+  using KokkosSparse::Experimental::SPMVAlgorithm;
+
+  constexpr mag_t max_x   = static_cast<mag_t>(1);
+  constexpr mag_t max_y   = static_cast<mag_t>(1);
+  constexpr mag_t max_val = static_cast<mag_t>(1);
+  const mag_t eps         = 10 * Kokkos::ArithTraits<mag_t>::eps();
+
+  Kokkos::Random_XorShift64_Pool<ExecSpace> rand_pool(13718);
+  std::vector<crsMat_t> mats;
+  for (lno_t variance : {row_size_variance, 2 * row_size_variance}) {
+    mats.push_back(KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+        numRows, numRows, nnz, variance, bandwidth));
+    Kokkos::fill_random(mats.back().values, rand_pool,
+                        randomUpperBound<scalar_t>(max_val));
+  }
+  const lno_t max_nnz_per_row =
+      numRows ? (nnz / numRows + 2 * row_size_variance) : 0;
+
+  KokkosKernels::Experimental::Controls controls;
+  controls.setParameter("algorithm", "merge");
+  controls.setParameter("items per thread", "7");
+
+  // The Controls interface first, then one handle per algorithm
+  std::vector<SPMVAlgorithm> algos = {
+      SPMVAlgorithm::SPMV_DEFAULT, SPMVAlgorithm::SPMV_NATIVE,
+      SPMVAlgorithm::SPMV_MERGE_PATH, SPMVAlgorithm::SPMV_BINNED_ROWS};
+  std::vector<char> modes           = {'N', 'C', 'T', 'H'};
+  std::vector<double> testAlphaBeta = {0.0, 1.0, -1.0, 2.5};
+  for (int variant = -1; variant < static_cast<int>(algos.size()); ++variant) {
+    const bool useHandle = variant >= 0;
+    const SPMVAlgorithm algo =
+        useHandle ? algos[variant] : SPMVAlgorithm::SPMV_MERGE_PATH;
+    handle_t handle(algo);
+    if (algo == SPMVAlgorithm::SPMV_MERGE_PATH)
+      handle.set_items_per_thread_request(7);
+    const std::string name =
+        useHandle ? "handle spmv (" +
+                        KokkosSparse::Experimental::spmv_algorithm_name(algo) +
+                        ")"
+                  : std::string("merge spmv");
+
+    for (const crsMat_t &input_mat : mats) {
+      if (useHandle) {
+        KokkosSparse::Experimental::spmv_analysis(handle, input_mat);
+        EXPECT_TRUE(handle.is_analysis_complete());
+        EXPECT_TRUE(handle.is_analyzed_for(input_mat.graph.row_map.data(),
+                                           input_mat.graph.entries.data(),
+                                           input_mat.numRows(),
+                                           input_mat.nnz()));
+        if (algo != SPMVAlgorithm::SPMV_DEFAULT) {
+          EXPECT_EQ(handle.get_kernel(), algo);
+        }
+        size_type hist_rows = 0;
+        for (auto count : handle.get_row_length_histogram()) hist_rows += count;
+        EXPECT_EQ(hist_rows, static_cast<size_type>(numRows));
+        if (handle.get_kernel() == SPMVAlgorithm::SPMV_BINNED_ROWS) {
+          auto offsets = Kokkos::create_mirror_view_and_copy(
+              Kokkos::HostSpace(), handle.get_bin_offsets());
+          ASSERT_GE(offsets.extent(0), 2u);
+          EXPECT_EQ(offsets(0), 0);
+          EXPECT_EQ(offsets(offsets.extent(0) - 1), numRows);
+          for (size_t b = 1; b < offsets.extent(0); ++b)
+            EXPECT_LE(offsets(b - 1), offsets(b));
+        }
+      }
+
+      for (auto mode : modes) {
+        for (double alpha : testAlphaBeta) {
+          for (double beta : testAlphaBeta) {
+            const mag_t max_error =
+                beta * max_y + alpha * max_nnz_per_row * max_val * max_x;
+
+            vector_type x("x", numRows), y("y", numRows),
+                expected_y("y", numRows);
+            Kokkos::fill_random(x, rand_pool,
+                                randomUpperBound<scalar_t>(max_x));
+            Kokkos::fill_random(y, rand_pool,
+                                randomUpperBound<scalar_t>(max_y));
+            Kokkos::deep_copy(expected_y, y);
+            Test::sequential_spmv(input_mat, x, expected_y, alpha, beta, mode);
+            if (useHandle)
+              KokkosSparse::spmv(handle, &mode, alpha, input_mat, x, beta, y);
+            else
+              KokkosSparse::spmv(controls, &mode, alpha, input_mat, x, beta,
+                                 y);
+            int num_errors = 0;
+            Kokkos::parallel_reduce(
+                "KokkosSparse::Test::spmv_merge", my_exec_space(0, numRows),
+                Test::fSPMV<vector_type, vector_type>(expected_y, y, eps,
+                                                      max_error),
+                num_errors);
+            EXPECT_EQ(num_errors, 0) << name << ", mode " << mode << ", alpha "
+                                     << alpha << ", beta " << beta;
+
+            mv_type X("X", numRows, numMV), Y("Y", numRows, numMV),
+                expected_Y("Y", numRows, numMV);
+            Kokkos::fill_random(X, rand_pool,
+                                randomUpperBound<scalar_t>(max_x));
+            Kokkos::fill_random(Y, rand_pool,
+                                randomUpperBound<scalar_t>(max_y));
+            Kokkos::deep_copy(expected_Y, Y);
+            if (useHandle)
+              KokkosSparse::spmv(handle, &mode, alpha, input_mat, X, beta, Y);
+            else
+              KokkosSparse::spmv(controls, &mode, alpha, input_mat, X, beta,
+                                 Y);
+            for (int k = 0; k < numMV; ++k) {
+              auto x_k        = Kokkos::subview(X, Kokkos::ALL(), k);
+              auto y_k        = Kokkos::subview(Y, Kokkos::ALL(), k);
+              auto expected_k = Kokkos::subview(expected_Y, Kokkos::ALL(), k);
+              Test::sequential_spmv(input_mat, x_k, expected_k, alpha, beta,
+                                    mode);
+              num_errors = 0;
+              Kokkos::parallel_reduce(
+                  "KokkosSparse::Test::spmv_mv_merge",
+                  my_exec_space(0, numRows),
+                  Test::fSPMV<decltype(expected_k), decltype(y_k)>(
+                      expected_k, y_k, eps, max_error),
+                  num_errors);
+              EXPECT_EQ(num_errors, 0)
+                  << name << " multivector, mode " << mode << ", alpha "
+                  << alpha << ", beta " << beta << ", vector " << k;
+            }
+          }
+        }
+      }
+    }
+
+    // The plan is only recomputed on request: another graph, even one of
+    // the same dimensions, is rejected until the handle is reset
+    if (useHandle && numRows > 0) {
+      const crsMat_t &last = mats.back();
+      typename crsMat_t::row_map_type::non_const_type row_map(
+          "row_map", last.graph.row_map.extent(0));
+      typename crsMat_t::index_type::non_const_type entries(
+          "entries", last.graph.entries.extent(0));
+      Kokkos::deep_copy(row_map, last.graph.row_map);
+      Kokkos::deep_copy(entries, last.graph.entries);
+      crsMat_t copy("copy", last.numRows(), last.numCols(), last.nnz(),
+                    last.values, row_map, entries);
+      vector_type x("x", numRows), y("y", numRows);
+      EXPECT_THROW(KokkosSparse::spmv(handle, "N", 1.0, copy, x, 0.0, y),
+                   std::runtime_error);
+      handle.reset_analysis();
+      KokkosSparse::spmv(handle, "N", 1.0, copy, x, 0.0, y);
+      EXPECT_TRUE(handle.is_analyzed_for(row_map.data(), entries.data(),
+                                         copy.numRows(), copy.nnz()));
+    }
+    if (useHandle && numRows > 1) {
+      crsMat_t smaller =
+          KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+              numRows / 2, numRows / 2, nnz / 2, row_size_variance,
+              bandwidth);
+      vector_type x("x", numRows / 2), y("y", numRows / 2);
+      EXPECT_THROW(KokkosSparse::spmv(handle, "N", 1.0, smaller, x, 0.0, y),
+                   std::runtime_error);
+      handle.reset_analysis();
+      KokkosSparse::spmv(handle, "N", 1.0, smaller, x, 0.0, y);
+      EXPECT_TRUE(handle.is_analyzed_for(smaller.graph.row_map.data(),
+                                         smaller.graph.entries.data(),
+                                         smaller.numRows(), smaller.nnz()));
+    }
+  }
+}  // test_spmv_merge
+
+// check the SELL-C-sigma conversion and its spmv, including chunk sizes that
+// do not divide the number of rows and sorting windows spanning several chunks
+template <typename scalar_t, typename lno_t, typename size_type,
+          typename layout, class Device>
+void test_spmv_sell(lno_t numRows, size_type nnz, lno_t bandwidth,
+                    lno_t row_size_variance, int numMV) {
+  using crsMat_t = typename KokkosSparse::CrsMatrix<scalar_t, lno_t, Device,
+                                                    void, size_type>;
+  using sellMat_t =
+      KokkosSparse::Experimental::SellMatrix<scalar_t, lno_t, Device, void,
+                                             size_type>;
+  using ExecSpace     = typename crsMat_t::execution_space;
+  using my_exec_space = Kokkos::RangePolicy<ExecSpace>;
+  using vector_type   = typename crsMat_t::values_type::non_const_type;
+  using mv_type       = Kokkos::View<scalar_t **, layout, Device>;
+  using mag_t         = typename Kokkos::ArithTraits<scalar_t>::mag_type;
+
+  constexpr mag_t max_x   = static_cast<mag_t>(1);
+  constexpr mag_t max_y   = static_cast<mag_t>(1);
+  constexpr mag_t max_val = static_cast<mag_t>(1);
+  const mag_t eps         = 10 * Kokkos::ArithTraits<mag_t>::eps();
+
+  crsMat_t input_mat = KokkosSparse::Impl::kk_generate_sparse_matrix<crsMat_t>(
+      numRows, numRows, nnz, row_size_variance, bandwidth);
+  const lno_t max_nnz_per_row =
+      numRows ? (nnz / numRows + row_size_variance) : 0;
+
+  Kokkos::Random_XorShift64_Pool<ExecSpace> rand_pool(13718);
+  Kokkos::fill_random(input_mat.values, rand_pool,
+                      randomUpperBound<scalar_t>(max_val));
+
+  // {chunk size, sigma}, -1 picks the default
+  const std::vector<std::pair<lno_t, lno_t>> layouts = {
+      {-1, -1}, {1, 1}, {8, 1}, {4, 64}};
+  for (const auto &sell_layout : layouts) {
+    sellMat_t A(input_mat, sell_layout.first, sell_layout.second);
+    EXPECT_EQ(A.numRows(), input_mat.numRows());
+    EXPECT_EQ(A.numCols(), input_mat.numCols());
+    EXPECT_EQ(A.nnz(), input_mat.nnz());
+    EXPECT_GE(A.numStoredEntries(), A.nnz());
+    EXPECT_EQ(A.numStoredEntries() % A.chunkSize(), size_type(0));
+
+    // row_perm is a permutation that keeps rows inside their sigma window
+    auto perm = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                    A.row_perm);
+    std::vector<int> seen(numRows, 0);
+    for (lno_t p = 0; p < numRows; ++p) {
+      ASSERT_TRUE(perm(p) >= 0 && perm(p) < numRows);
+      EXPECT_EQ(perm(p) / A.sigma(), p / A.sigma());
+      ++seen[perm(p)];
+    }
+    for (lno_t i = 0; i < numRows; ++i) EXPECT_EQ(seen[i], 1);
+
+    const std::string sell_name = "C=" + std::to_string(A.chunkSize()) +
+                                  " sigma=" + std::to_string(A.sigma());
+    std::vector<char> modes           = {'N', 'C', 'T', 'H'};
+    std::vector<double> testAlphaBeta = {0.0, 1.0, -1.0, 2.5};
+    for (auto mode : modes) {
+      for (double alpha : testAlphaBeta) {
+        for (double beta : testAlphaBeta) {
+          const mag_t max_error =
+              beta * max_y + alpha * max_nnz_per_row * max_val * max_x;
+
+          vector_type x("x", numRows), y("y", numRows),
+              expected_y("y", numRows);
+          Kokkos::fill_random(x, rand_pool, randomUpperBound<scalar_t>(max_x));
+          Kokkos::fill_random(y, rand_pool, randomUpperBound<scalar_t>(max_y));
+          Kokkos::deep_copy(expected_y, y);
+          Test::sequential_spmv(input_mat, x, expected_y, alpha, beta, mode);
+          KokkosSparse::spmv(&mode, alpha, A, x, beta, y);
+          int num_errors = 0;
+          Kokkos::parallel_reduce(
+              "KokkosSparse::Test::spmv_sell", my_exec_space(0, y.extent(0)),
+              Test::fSPMV<vector_type, vector_type>(expected_y, y, eps,
+                                                    max_error),
+              num_errors);
+          EXPECT_EQ(num_errors, 0)
+              << "sell spmv (" << sell_name << "), mode " << mode
+              << ", alpha " << alpha << ", beta " << beta;
+
+          mv_type X("X", numRows, numMV), Y("Y", numRows, numMV),
+              expected_Y("Y", numRows, numMV);
+          Kokkos::fill_random(X, rand_pool, randomUpperBound<scalar_t>(max_x));
+          Kokkos::fill_random(Y, rand_pool, randomUpperBound<scalar_t>(max_y));
+          Kokkos::deep_copy(expected_Y, Y);
+          KokkosSparse::spmv(&mode, alpha, A, X, beta, Y);
+          for (int k = 0; k < numMV; ++k) {
+            auto x_k        = Kokkos::subview(X, Kokkos::ALL(), k);
+            auto y_k        = Kokkos::subview(Y, Kokkos::ALL(), k);
+            auto expected_k = Kokkos::subview(expected_Y, Kokkos::ALL(), k);
+            Test::sequential_spmv(input_mat, x_k, expected_k, alpha, beta,
+                                  mode);
+            num_errors = 0;
+            Kokkos::parallel_reduce(
+                "KokkosSparse::Test::spmv_mv_sell",
+                my_exec_space(0, y_k.extent(0)),
+                Test::fSPMV<decltype(expected_k), decltype(y_k)>(
+                    expected_k, y_k, eps, max_error),
+                num_errors);
+            EXPECT_EQ(num_errors, 0)
+                << "sell spmv_mv (" << sell_name << "), mode " << mode
+                << ", alpha " << alpha << ", beta " << beta << ", vector "
+                << k;
+          }
+        }
+      }
+    }
+  }
+
+  // Mismatched vector lengths are rejected, also by the SellMatrix overloads
+  // themselves
+  {
+    sellMat_t A(input_mat);
+    vector_type x("x", numRows), y("y", numRows + 1);
+    mv_type X("X", numRows, numMV), Y("Y", numRows + 1, numMV);
+    KokkosKernels::Experimental::Controls controls;
+    for (const char *mode : {"N", "T"}) {
+      EXPECT_THROW(KokkosSparse::spmv(mode, 1.0, A, x, 0.0, y),
+                   std::runtime_error);
+      EXPECT_THROW(KokkosSparse::spmv(controls, mode, 1.0, A, x, 0.0, y,
+                                      KokkosSparse::RANK_ONE()),
+                   std::runtime_error);
+      EXPECT_THROW(KokkosSparse::spmv(controls, mode, 1.0, A, X, 0.0, Y,
+                                      KokkosSparse::RANK_TWO()),
+                   std::runtime_error);
+    }
+  }
+
+  // Padding is masked out: an infinite x(0) does not reach the padding of
+  // the empty row 1
+  {
+    using rowmap_t  = typename crsMat_t::row_map_type::non_const_type;
+    using entries_t = typename crsMat_t::index_type::non_const_type;
+    rowmap_t rowmap("rowmap", 4);
+    entries_t entries("entries", 3);
+    vector_type values("values", 3);
+    auto rowmap_h  = Kokkos::create_mirror_view(rowmap);
+    auto entries_h = Kokkos::create_mirror_view(entries);
+    auto values_h  = Kokkos::create_mirror_view(values);
+    // row 0: columns 1 and 2, row 1: empty, row 2: column 0
+    rowmap_h(0) = 0;
+    rowmap_h(1) = 2;
+    rowmap_h(2) = 2;
+    rowmap_h(3) = 3;
+    entries_h(0) = 1;
+    entries_h(1) = 2;
+    entries_h(2) = 0;
+    for (int k = 0; k < 3; ++k) values_h(k) = scalar_t(1);
+    Kokkos::deep_copy(rowmap, rowmap_h);
+    Kokkos::deep_copy(entries, entries_h);
+    Kokkos::deep_copy(values, values_h);
+    crsMat_t small("small", 3, 3, 3, values, rowmap, entries);
+    sellMat_t A(small, 4, 1);
+
+    const scalar_t inf(Kokkos::ArithTraits<mag_t>::infinity());
+    vector_type x("x", 3), y("y", 3);
+    Kokkos::deep_copy(x, scalar_t(1));
+    Kokkos::deep_copy(Kokkos::subview(x, 0), inf);
+    KokkosSparse::spmv("N", 1.0, A, x, 0.0, y);
+    auto y_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), y);
+    EXPECT_EQ(y_h(0), scalar_t(2));
+    EXPECT_EQ(y_h(1), scalar_t(0));
+
+    // Transposed, only row 2 has column 0
+    Kokkos::deep_copy(y, scalar_t(0));
+    KokkosSparse::spmv("T", 1.0, A, x, 0.0, y);
+    Kokkos::deep_copy(y_h, y);
+    EXPECT_EQ(y_h(0), scalar_t(1));
+  }
+
+  // Without rows, the transpose still scales y, which has numCols entries
+  {
+    const lno_t numCols = 7;
+    typename sellMat_t::chunk_map_type::non_const_type chunkmap("chunkmap",
+                                                                 1);
+    sellMat_t A("empty", 0, numCols, 0, 1, 1, chunkmap,
+                typename sellMat_t::index_type("entries", 0),
+                typename sellMat_t::values_type("values", 0),
+                typename sellMat_t::perm_type("perm", 0));
+    vector_type x("x", 0), y("y", numCols);
+    Kokkos::deep_copy(y, scalar_t(1));
+    KokkosSparse::spmv("T", 1.0, A, x, 2.0, y);
+    auto y_h = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), y);
+    for (lno_t i = 0; i < numCols; ++i) EXPECT_EQ(y_h(i), scalar_t(2));
+  }
+}  // test_spmv_sell
+
 // call it if ordinal int and, scalar float and double are instantiated.
 template <class DeviceType>
 void test_github_issue_101() {
@@ -1588,6 +2066,7 @@ void test_spmv_bsrmatrix(lno_t blockSize, lno_t k, y_scalar_t alpha,
                                                false);                         \
     test_spmv_controls<SCALAR, ORDINAL, OFFSET, DEVICE>(10000, 10000 * 20,     \
                                                         100, 5);               \
+    test_spmv_dot<SCALAR, ORDINAL, OFFSET, DEVICE>(1000, 1000 * 10, 200, 9);   \
   }
 
 #define EXECUTE_TEST_MV(SCALAR, ORDINAL, OFFSET, LAYOUT, DEVICE)                    \
@@ -1608,6 +2087,10 @@ void test_spmv_bsrmatrix(lno_t blockSize, lno_t k, y_scalar_t alpha,
         10000, 10000 * 2, 100, 5, false, 5);                                        \
     test_spmv_mv_heavy<SCALAR, ORDINAL, OFFSET, Kokkos::LAYOUT, DEVICE>(            \
         200, 200 * 10, 60, 4, 30);                                                  \
+    test_spmv_merge<SCALAR, ORDINAL, OFFSET, Kokkos::LAYOUT, DEVICE>(               \
+        1000, 1000 * 10, 200, 9, 3);                                                \
+    test_spmv_sell<SCALAR, ORDINAL, OFFSET, Kokkos::LAYOUT, DEVICE>(                \
+        997, 997 * 10, 200, 9, 3);                                                  \
   }
 
 #define EXECUTE_TEST_STRUCT(SCALAR, ORDINAL, OFFSET, DEVICE)                   \
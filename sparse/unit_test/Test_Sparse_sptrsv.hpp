@@ -18,6 +18,7 @@
 #include <Kokkos_Core.hpp>
 
 #include <string>
+#include <vector>
 #include <stdexcept>
 
 #include "KokkosKernels_IOUtils.hpp"
@@ -492,6 +493,157 @@ void run_test_sptrsv() {
       kh.destroy_sptrsv_handle();
     }
 
+    {
+      KernelHandle kh;
+      bool is_lower_tri = false;
+      kh.create_sptrsv_handle(SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE, nrows,
+                              is_lower_tri);
+      // Merge every level into one region so the rows synchronize pairwise
+      kh.get_sptrsv_handle()->set_merge_threshold(nrows);
+
+      sptrsv_symbolic(&kh, row_map, entries);
+      Kokkos::fence();
+
+      // Solve twice: the second solve must not see the flags of the first
+      for (int solve = 0; solve < 2; ++solve) {
+        Kokkos::deep_copy(lhs, ZERO);
+        sptrsv_solve(&kh, row_map, entries, values, rhs, lhs);
+        Kokkos::fence();
+
+        scalar_t sum = 0.0;
+        Kokkos::parallel_reduce(
+            Kokkos::RangePolicy<typename device::execution_space>(
+                0, lhs.extent(0)),
+            ReductionCheck<ValuesType, scalar_t, lno_t>(lhs), sum);
+        if (sum != lhs.extent(0)) {
+          std::cout << "Upper Tri Solve FAILURE" << std::endl;
+          kh.get_sptrsv_handle()->print_algorithm();
+        }
+        EXPECT_TRUE(sum == scalar_t(lhs.extent(0)));
+      }
+
+      kh.destroy_sptrsv_handle();
+    }
+
+    {
+      KernelHandle kh;
+      bool is_lower_tri = false;
+      kh.create_sptrsv_handle(SPTRSVAlgorithm::JACOBI, nrows, is_lower_tri);
+      // As many sweeps as rows make the approximate solve exact
+      kh.get_sptrsv_handle()->set_num_jacobi_sweeps(nrows);
+
+      sptrsv_symbolic(&kh, row_map, entries);
+      Kokkos::fence();
+
+      Kokkos::deep_copy(lhs, ZERO);
+      sptrsv_solve(&kh, row_map, entries, values, rhs, lhs);
+      Kokkos::fence();
+
+      scalar_t sum = 0.0;
+      Kokkos::parallel_reduce(
+          Kokkos::RangePolicy<typename device::execution_space>(
+              0, lhs.extent(0)),
+          ReductionCheck<ValuesType, scalar_t, lno_t>(lhs), sum);
+      auto err = Kokkos::ArithTraits<scalar_t>::abs(sum - scalar_t(nrows));
+      if (err > 1e-4) {
+        std::cout << "Upper Tri Solve FAILURE" << std::endl;
+        kh.get_sptrsv_handle()->print_algorithm();
+      }
+      EXPECT_LT(err, 1e-4);
+
+      kh.destroy_sptrsv_handle();
+    }
+
+    {
+      // Default sweeps (5): check the relative residual ||b - Tx|| / ||b||
+      using mag_t = typename Kokkos::ArithTraits<scalar_t>::mag_type;
+      KernelHandle kh;
+      bool is_lower_tri = false;
+      kh.create_sptrsv_handle(SPTRSVAlgorithm::JACOBI, nrows, is_lower_tri);
+      EXPECT_EQ(kh.get_sptrsv_handle()->get_num_jacobi_sweeps(), 5);
+
+      sptrsv_symbolic(&kh, row_map, entries);
+      Kokkos::fence();
+
+      Kokkos::deep_copy(lhs, ZERO);
+      sptrsv_solve(&kh, row_map, entries, values, rhs, lhs);
+      Kokkos::fence();
+
+      ValuesType res("res", nrows);
+      Kokkos::deep_copy(res, rhs);
+      KokkosSparse::spmv("N", -ONE, triMtx, lhs, ONE, res);
+      auto hres = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), res);
+      auto hrhs = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), rhs);
+      mag_t res_norm = 0, rhs_norm = 0;
+      for (size_type i = 0; i < nrows; ++i) {
+        res_norm += Kokkos::ArithTraits<scalar_t>::abs(hres(i)) *
+                    Kokkos::ArithTraits<scalar_t>::abs(hres(i));
+        rhs_norm += Kokkos::ArithTraits<scalar_t>::abs(hrhs(i)) *
+                    Kokkos::ArithTraits<scalar_t>::abs(hrhs(i));
+      }
+      mag_t rel_res = Kokkos::sqrt(res_norm) / Kokkos::sqrt(rhs_norm);
+      if (rel_res > 1e-4) {
+        std::cout << "Upper Tri Solve FAILURE" << std::endl;
+        kh.get_sptrsv_handle()->print_algorithm();
+      }
+      EXPECT_LT(rel_res, 1e-4);
+
+      kh.destroy_sptrsv_handle();
+    }
+
+    {
+      // Multiple right-hand sides: column j of B is (j+1) rhs, so column j
+      // of the solution is j+1 everywhere
+      typedef Kokkos::View<scalar_t **, device> MultiVectorType;
+      const int nrhs = 3;
+      MultiVectorType B("B", nrows, nrhs);
+      MultiVectorType X("X", nrows, nrhs);
+      {
+        auto hrhs =
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), rhs);
+        auto hB = Kokkos::create_mirror_view(B);
+        for (size_type i = 0; i < nrows; ++i)
+          for (int j = 0; j < nrhs; ++j) hB(i, j) = scalar_t(j + 1) * hrhs(i);
+        Kokkos::deep_copy(B, hB);
+      }
+
+      std::vector<SPTRSVAlgorithm> algorithms = {
+          SPTRSVAlgorithm::SEQLVLSCHD_RP, SPTRSVAlgorithm::SEQLVLSCHD_TP1,
+          SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN,
+          SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE, SPTRSVAlgorithm::JACOBI};
+      for (auto algm : algorithms) {
+        KernelHandle kh;
+        bool is_lower_tri = false;
+        kh.create_sptrsv_handle(algm, nrows, is_lower_tri);
+        if (algm == SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN)
+          kh.get_sptrsv_handle()->reset_chain_threshold(1);
+        if (algm == SPTRSVAlgorithm::JACOBI)
+          kh.get_sptrsv_handle()->set_num_jacobi_sweeps(nrows);
+
+        sptrsv_symbolic(&kh, row_map, entries);
+        Kokkos::fence();
+
+        Kokkos::deep_copy(X, ZERO);
+        sptrsv_solve(&kh, row_map, entries, values, B, X);
+        Kokkos::fence();
+
+        auto hX = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), X);
+        bool success = true;
+        for (size_type i = 0; i < nrows; ++i)
+          for (int j = 0; j < nrhs; ++j)
+            if (Kokkos::ArithTraits<scalar_t>::abs(hX(i, j) -
+                                                   scalar_t(j + 1)) > 1e-4)
+              success = false;
+        if (!success) {
+          std::cout << "Upper Tri Multi-RHS Solve FAILURE" << std::endl;
+          kh.get_sptrsv_handle()->print_algorithm();
+        }
+        EXPECT_TRUE(success);
+
+        kh.destroy_sptrsv_handle();
+      }
+    }
+
 #ifdef KOKKOSKERNELS_ENABLE_TPL_CUSPARSE
     if (std::is_same<size_type, int>::value &&
         std::is_same<lno_t, int>::value &&
@@ -811,6 +963,157 @@ void run_test_sptrsv() {
       kh.destroy_sptrsv_handle();
     }
 
+    {
+      KernelHandle kh;
+      bool is_lower_tri = true;
+      kh.create_sptrsv_handle(SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE, nrows,
+                              is_lower_tri);
+      // Merge every level into one region so the rows synchronize pairwise
+      kh.get_sptrsv_handle()->set_merge_threshold(nrows);
+
+      sptrsv_symbolic(&kh, row_map, entries);
+      Kokkos::fence();
+
+      // Solve twice: the second solve must not see the flags of the first
+      for (int solve = 0; solve < 2; ++solve) {
+        Kokkos::deep_copy(lhs, ZERO);
+        sptrsv_solve(&kh, row_map, entries, values, rhs, lhs);
+        Kokkos::fence();
+
+        scalar_t sum = 0.0;
+        Kokkos::parallel_reduce(
+            Kokkos::RangePolicy<typename device::execution_space>(
+                0, lhs.extent(0)),
+            ReductionCheck<ValuesType, scalar_t, lno_t>(lhs), sum);
+        if (sum != lhs.extent(0)) {
+          std::cout << "Lower Tri Solve FAILURE" << std::endl;
+          kh.get_sptrsv_handle()->print_algorithm();
+        }
+        EXPECT_TRUE(sum == scalar_t(lhs.extent(0)));
+      }
+
+      kh.destroy_sptrsv_handle();
+    }
+
+    {
+      KernelHandle kh;
+      bool is_lower_tri = true;
+      kh.create_sptrsv_handle(SPTRSVAlgorithm::JACOBI, nrows, is_lower_tri);
+      // As many sweeps as rows make the approximate solve exact
+      kh.get_sptrsv_handle()->set_num_jacobi_sweeps(nrows);
+
+      sptrsv_symbolic(&kh, row_map, entries);
+      Kokkos::fence();
+
+      Kokkos::deep_copy(lhs, ZERO);
+      sptrsv_solve(&kh, row_map, entries, values, rhs, lhs);
+      Kokkos::fence();
+
+      scalar_t sum = 0.0;
+      Kokkos::parallel_reduce(
+          Kokkos::RangePolicy<typename device::execution_space>(
+              0, lhs.extent(0)),
+          ReductionCheck<ValuesType, scalar_t, lno_t>(lhs), sum);
+      auto err = Kokkos::ArithTraits<scalar_t>::abs(sum - scalar_t(nrows));
+      if (err > 1e-4) {
+        std::cout << "Lower Tri Solve FAILURE" << std::endl;
+        kh.get_sptrsv_handle()->print_algorithm();
+      }
+      EXPECT_LT(err, 1e-4);
+
+      kh.destroy_sptrsv_handle();
+    }
+
+    {
+      // Default sweeps (5): check the relative residual ||b - Tx|| / ||b||
+      using mag_t = typename Kokkos::ArithTraits<scalar_t>::mag_type;
+      KernelHandle kh;
+      bool is_lower_tri = true;
+      kh.create_sptrsv_handle(SPTRSVAlgorithm::JACOBI, nrows, is_lower_tri);
+      EXPECT_EQ(kh.get_sptrsv_handle()->get_num_jacobi_sweeps(), 5);
+
+      sptrsv_symbolic(&kh, row_map, entries);
+      Kokkos::fence();
+
+      Kokkos::deep_copy(lhs, ZERO);
+      sptrsv_solve(&kh, row_map, entries, values, rhs, lhs);
+      Kokkos::fence();
+
+      ValuesType res("res", nrows);
+      Kokkos::deep_copy(res, rhs);
+      KokkosSparse::spmv("N", -ONE, triMtx, lhs, ONE, res);
+      auto hres = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), res);
+      auto hrhs = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), rhs);
+      mag_t res_norm = 0, rhs_norm = 0;
+      for (size_type i = 0; i < nrows; ++i) {
+        res_norm += Kokkos::ArithTraits<scalar_t>::abs(hres(i)) *
+                    Kokkos::ArithTraits<scalar_t>::abs(hres(i));
+        rhs_norm += Kokkos::ArithTraits<scalar_t>::abs(hrhs(i)) *
+                    Kokkos::ArithTraits<scalar_t>::abs(hrhs(i));
+      }
+      mag_t rel_res = Kokkos::sqrt(res_norm) / Kokkos::sqrt(rhs_norm);
+      if (rel_res > 1e-4) {
+        std::cout << "Lower Tri Solve FAILURE" << std::endl;
+        kh.get_sptrsv_handle()->print_algorithm();
+      }
+      EXPECT_LT(rel_res, 1e-4);
+
+      kh.destroy_sptrsv_handle();
+    }
+
+    {
+      // Multiple right-hand sides: column j of B is (j+1) rhs, so column j
+      // of the solution is j+1 everywhere
+      typedef Kokkos::View<scalar_t **, device> MultiVectorType;
+      const int nrhs = 3;
+      MultiVectorType B("B", nrows, nrhs);
+      MultiVectorType X("X", nrows, nrhs);
+      {
+        auto hrhs =
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), rhs);
+        auto hB = Kokkos::create_mirror_view(B);
+        for (size_type i = 0; i < nrows; ++i)
+          for (int j = 0; j < nrhs; ++j) hB(i, j) = scalar_t(j + 1) * hrhs(i);
+        Kokkos::deep_copy(B, hB);
+      }
+
+      std::vector<SPTRSVAlgorithm> algorithms = {
+          SPTRSVAlgorithm::SEQLVLSCHD_RP, SPTRSVAlgorithm::SEQLVLSCHD_TP1,
+          SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN,
+          SPTRSVAlgorithm::SEQLVLSCHD_SYNCFREE, SPTRSVAlgorithm::JACOBI};
+      for (auto algm : algorithms) {
+        KernelHandle kh;
+        bool is_lower_tri = true;
+        kh.create_sptrsv_handle(algm, nrows, is_lower_tri);
+        if (algm == SPTRSVAlgorithm::SEQLVLSCHD_TP1CHAIN)
+          kh.get_sptrsv_handle()->reset_chain_threshold(1);
+        if (algm == SPTRSVAlgorithm::JACOBI)
+          kh.get_sptrsv_handle()->set_num_jacobi_sweeps(nrows);
+
+        sptrsv_symbolic(&kh, row_map, entries);
+        Kokkos::fence();
+
+        Kokkos::deep_copy(X, ZERO);
+        sptrsv_solve(&kh, row_map, entries, values, B, X);
+        Kokkos::fence();
+
+        auto hX = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), X);
+        bool success = true;
+        for (size_type i = 0; i < nrows; ++i)
+          for (int j = 0; j < nrhs; ++j)
+            if (Kokkos::ArithTraits<scalar_t>::abs(hX(i, j) -
+                                                   scalar_t(j + 1)) > 1e-4)
+              success = false;
+        if (!success) {
+          std::cout << "Lower Tri Multi-RHS Solve FAILURE" << std::endl;
+          kh.get_sptrsv_handle()->print_algorithm();
+        }
+        EXPECT_TRUE(success);
+
+        kh.destroy_sptrsv_handle();
+      }
+    }
+
 #ifdef KOKKOSKERNELS_ENABLE_TPL_CUSPARSE
     if (std::is_same<size_type, int>::value &&
         std::is_same<lno_t, int>::value &&
@@ -974,6 +1277,31 @@ void run_test_sptrsv() {
       }
       EXPECT_TRUE(sum == scalar_t(X.extent(0)));
 
+      // > solve several right-hand sides at once, column j scaled by j + 1
+      {
+        typedef Kokkos::View<scalar_t **, device> MultiVectorType;
+        const int nrhs = 3;
+        MultiVectorType BB("BB", nrows, nrhs);
+        MultiVectorType XX("XX", nrows, nrhs);
+        auto hB  = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), B);
+        auto hBB = Kokkos::create_mirror_view(BB);
+        for (size_type i = 0; i < nrows; ++i)
+          for (int j = 0; j < nrhs; ++j) hBB(i, j) = scalar_t(j + 1) * hB(i);
+        Kokkos::deep_copy(BB, hBB);
+
+        sptrsv_solve(&khL, &khU, XX, BB);
+        Kokkos::fence();
+
+        auto hXX = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), XX);
+        for (size_type i = 0; i < nrows; ++i)
+          for (int j = 0; j < nrhs; ++j)
+            EXPECT_LE(Kokkos::ArithTraits<scalar_t>::abs(hXX(i, j) -
+                                                         scalar_t(j + 1)),
+                      1e-4)
+                << "Supernode Tri Multi-RHS Solve, row " << i << ", column "
+                << j;
+      }
+
       khL.destroy_sptrsv_handle();
       khU.destroy_sptrsv_handle();
     }
@@ -63,6 +63,8 @@ struct Parameters {
   double first_level_hash_cut_off;
   double compression_cut_off;
   size_t MaxColDenseAcc;
+  bool row_binning;
+  bool numeric_reuse_map;
   // 0 - no flush
   // 1 - soft flush
   // 2 - hard flush with rand.
@@ -106,6 +108,8 @@ struct Parameters {
     first_level_hash_cut_off = 0.50;
     compression_cut_off      = 0.85;
     MaxColDenseAcc           = 250000;
+    row_binning              = false;
+    numeric_reuse_map        = false;
   }
 };
 }  // namespace Experiment
@@ -449,6 +449,26 @@ crsMat_t symmetrize(crsMat_t A) {
                   new_entries);
 }
 
+// Device CRS graph of the adjacency lists adj, in the order they are given
+template <typename rowmap_t, typename entries_t, typename lno_t>
+void adjacency_to_crs(const std::vector<std::vector<lno_t>>& adj,
+                      rowmap_t& rowmap, entries_t& entries) {
+  const lno_t numVerts = adj.size();
+  rowmap               = rowmap_t("Rowmap", numVerts + 1);
+  auto rowmapHost      = Kokkos::create_mirror_view(rowmap);
+  rowmapHost(0)        = 0;
+  for (lno_t i = 0; i < numVerts; i++)
+    rowmapHost(i + 1) = rowmapHost(i) + adj[i].size();
+  entries          = entries_t("Entries", rowmapHost(numVerts));
+  auto entriesHost = Kokkos::create_mirror_view(entries);
+  for (lno_t i = 0; i < numVerts; i++) {
+    for (size_t j = 0; j < adj[i].size(); j++)
+      entriesHost(rowmapHost(i) + j) = adj[i][j];
+  }
+  Kokkos::deep_copy(rowmap, rowmapHost);
+  Kokkos::deep_copy(entries, entriesHost);
+}
+
 // create_random_x_vector and create_random_y_vector can be used together to
 // generate a random linear system Ax = y.
 template <typename vec_t>